@@ -0,0 +1,72 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic_uint64_t allocationCount(0);
+
+#ifdef ALLOCATION_COUNTING
+// Allocate memory and count it
+static void* CountedAlloc(size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = malloc(size == 0 ? 1 : size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+// Allocate aligned memory and count it
+static void* CountedAlignedAlloc(size_t size, std::align_val_t align)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	size_t alignment = (size_t)align;
+#ifdef _WIN32
+	void* ptr = _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+	void* ptr = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+// Free aligned memory
+static void AlignedFree(void* ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return CountedAlignedAlloc(size, align); }
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+#endif
+
+// Check if this build counts allocations
+bool IsCountingAllocations()
+{
+#ifdef ALLOCATION_COUNTING
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Get the amount of allocations made since the program started
+uint64_t GetAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+// --------------------------------------------------------
+// Counts heap allocations made with operator new on any thread.
+//
+// Only builds with ALLOCATION_COUNTING defined replace
+// operator new, other builds always report 0. Used to check
+// that a steady state frame does not allocate
+// --------------------------------------------------------
+
+// --------------------------------------------------------
+// Check if this build counts allocations
+// --------------------------------------------------------
+bool IsCountingAllocations();
+
+// --------------------------------------------------------
+// Get the amount of allocations made since the program started
+// --------------------------------------------------------
+uint64_t GetAllocationCount();
\ No newline at end of file
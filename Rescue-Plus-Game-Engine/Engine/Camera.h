@@ -30,6 +30,8 @@ private:
 	void CreateProjectionMatrix();
 
 public:
+	typedef ComponentLookupBases<Camera, Component> LookupBases;
+
 	// --------------------------------------------------------
 	// Constructor - Set up the camera
 	//
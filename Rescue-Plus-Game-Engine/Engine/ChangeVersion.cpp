@@ -0,0 +1,29 @@
+#include "ChangeVersion.h"
+
+static uint32_t frameVersion = 1;
+//Starts at 1 so a system that never read changes (version 0) sees everything
+static ChangeVersion changeVersion = 1;
+
+// Get the current frame
+uint32_t GetFrameVersion()
+{
+	return frameVersion;
+}
+
+// Advance the global frame counter (once per frame)
+void AdvanceFrameVersion()
+{
+	frameVersion++;
+}
+
+// Get the version data that changes now is stamped with
+ChangeVersion CurrentChangeVersion()
+{
+	return changeVersion;
+}
+
+// Get the version a system has now seen every change up to, and advance the change counter
+ChangeVersion ObserveChanges()
+{
+	return changeVersion++;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+// --------------------------------------------------------
+// A version stamped on data when it changes.
+//
+// Versions come from a global change counter. Data is stamped
+// with the current version when it changes, and a system that
+// reads changes takes the version with ObserveChanges() and
+// keeps it as the last version it has seen. Observing advances
+// the counter, so anything that changes afterwards is newer than
+// what the system has seen, even in the same frame
+// --------------------------------------------------------
+typedef uint32_t ChangeVersion;
+
+// --------------------------------------------------------
+// Get the current frame (advanced once per frame, used to
+// schedule work over frames)
+// --------------------------------------------------------
+uint32_t GetFrameVersion();
+
+// --------------------------------------------------------
+// Advance the global frame counter (once per frame)
+// --------------------------------------------------------
+void AdvanceFrameVersion();
+
+// --------------------------------------------------------
+// Get the version data that changes now is stamped with
+// --------------------------------------------------------
+ChangeVersion CurrentChangeVersion();
+
+// --------------------------------------------------------
+// Get the version a system has now seen every change up to,
+// and advance the change counter. Call it before reading
+// changes and keep the result as the last seen version
+// --------------------------------------------------------
+ChangeVersion ObserveChanges();
+
+// --------------------------------------------------------
+// Check if something changed after a system last saw it
+//
+// version - the version the data last changed on
+// lastSeen - the version the system got from ObserveChanges()
+//		when it last read changes (0 if it never did)
+// --------------------------------------------------------
+inline bool ChangedSince(ChangeVersion version, ChangeVersion lastSeen)
+{
+	return version > lastSeen;
+}
\ No newline at end of file
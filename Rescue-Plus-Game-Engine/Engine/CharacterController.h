@@ -35,6 +35,8 @@ private:
 	void OnScaleChanged(DirectX::XMFLOAT3 scale) override {};
 
 public:
+	typedef ComponentLookupBases<CharacterController, ColliderBase> LookupBases;
+
 	CharacterController(GameObject* gameObject, float radius, float height);
 	~CharacterController();
 
@@ -21,14 +21,17 @@ ColliderBase::ColliderBase(GameObject* gameObject, ColliderType type) : Componen
 	collisionResolver = new CollisionResolver();
 	this->type = type;
 
-	gameObject->AddListenerOnPositionChanged(std::bind(&ColliderBase::OnPositionChanged, this,
-		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-	gameObject->AddListenerOnRotationChanged(std::bind(&ColliderBase::OnRotationChanged, this,
-		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+	positionListener = gameObject->AddListenerOnPositionChanged(
+		MakeDelegate<&ColliderBase::OnPositionChanged>(this));
+	rotationListener = gameObject->AddListenerOnRotationChanged(
+		MakeDelegate<&ColliderBase::OnRotationChanged>(this));
 }
 
 ColliderBase::~ColliderBase()
 { 
+	gameObject()->RemoveListenerOnPositionChanged(positionListener);
+	gameObject()->RemoveListenerOnRotationChanged(rotationListener);
+
 	if (collisionResolver != nullptr)
 		delete collisionResolver;
 }
@@ -137,6 +140,7 @@ Collider::Collider(GameObject* gameObject, ColliderType type, bool isTrigger,
 	this->isTrigger = isTrigger;
 
 	staticActor = nullptr;
+	pendingActorIndex = PHYSICS_NOT_PENDING;
 	attachedRigidBody = nullptr;
 	isInChildObj = false;
 }
@@ -148,9 +152,6 @@ Collider::~Collider()
 		DeAttachFromRB(false);
 	else
 		DeAttachFromStatic();
-
-	//gameObject()->RemoveListenerOnPositionChanged(std::bind(&Collider::OnPositionChanged, this,
-	//	std::placeholders::_1, std::placeholders::_2));
 }
 
 // Set the collider shape's filters
@@ -205,7 +206,8 @@ void Collider::OnPositionChanged(DirectX::XMFLOAT3 position, bool fromParent, bo
 
 void Collider::OnRotationChanged(DirectX::XMFLOAT4 rotation, bool fromParent, bool fromPhysics)
 {
-	if (!fromPhysics && ((attachedRigidBody != nullptr && !fromParent)
+	//A shape on the rigidbody's own gameobject turns with the body
+	if (!fromPhysics && ((attachedRigidBody != nullptr && !fromParent && isInChildObj)
 		|| (staticActor != nullptr)))
 		ReAttach();
 }
@@ -234,7 +236,7 @@ void Collider::DeAttachFromStatic()
 {
 	if (staticActor != nullptr)
 	{
-		PhysicsManager::GetInstance()->RemoveActor(staticActor);
+		PhysicsManager::GetInstance()->RemoveActor(staticActor, &pendingActorIndex);
 		staticActor->release();
 		staticActor = nullptr;
 	}
@@ -280,7 +282,8 @@ void Collider::AttachToRB(RigidBody* rigidBody, bool isChildObj)
 	PxRigidDynamic* rb = rigidBody->GetRigidBody();
 	rb->attachShape(*tempShape);
 
-	if (!(rb->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+	//Actors waiting in an actor batch are not in a scene yet
+	if (rb->getScene() != nullptr && !(rb->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
 		rb->wakeUp();
 
 	//Get the actual shape and store it
@@ -318,9 +321,14 @@ void Collider::AttachToStatic()
 
 	//Attach
 	if (staticActor != nullptr)
+	{
+		//Take the old actor out of the batch too, it can't be added after it is released
+		PhysicsManager::GetInstance()->RemoveActor(staticActor, &pendingActorIndex);
 		staticActor->release();
+	}
 	staticActor = PxCreateStatic(*physics, tr, *tempShape);
-	PhysicsManager::GetInstance()->AddActor(staticActor);
+	if (gameObject()->GetEnabled())
+		PhysicsManager::GetInstance()->AddActor(staticActor, &pendingActorIndex);
 	
 	//Get the actual shape and store it
 	PxShape** shapes = new PxShape*[staticActor->getNbShapes()];
@@ -334,6 +342,18 @@ void Collider::AttachToStatic()
 	delete[] shapes;
 }
 
+// Add or remove the static actor from the physics scene
+void Collider::SetInScene(bool inScene)
+{
+	//Shapes on a rigidbody go with the rigidbody
+	if (staticActor == nullptr)
+		return;
+
+	if (inScene)
+		PhysicsManager::GetInstance()->AddActor(staticActor, &pendingActorIndex);
+	else PhysicsManager::GetInstance()->RemoveActor(staticActor, &pendingActorIndex);
+}
+
 // Get this shape's transform based on its position from the parent
 PxTransform Collider::GetChildTransform()
 {
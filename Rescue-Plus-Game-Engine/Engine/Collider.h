@@ -22,6 +22,7 @@ protected:
 	PhysicsMaterial* physicsMaterial;
 	RigidBody* attachedRigidBody;
 	physx::PxRigidStatic* staticActor;
+	uint32_t pendingActorIndex;	//The static actor's place in the PhysicsManager's actor batch
 	DirectX::XMFLOAT3 center;
 	bool isTrigger;
 	bool isInChildObj;
@@ -81,6 +82,8 @@ protected:
 	physx::PxTransform GetChildTransform();
 
 public:
+	typedef ComponentLookupBases<Collider, ColliderBase> LookupBases;
+
 	// --------------------------------------------------------
 	// Clean up the collider instance
 	// --------------------------------------------------------
@@ -136,6 +139,13 @@ public:
 	// Set if this collider is a trigger shape
 	// --------------------------------------------------------
 	void SetTrigger(bool isTrigger);
+
+	// --------------------------------------------------------
+	// WARNING: THIS IS FOR INTERNAL ENGINE USE ONLY. DO NOT USE
+	// Add or remove the static actor from the physics scene
+	// (called by GameObject::SetEnabled)
+	// --------------------------------------------------------
+	void SetInScene(bool inScene);
 };
 
 // --------------------------------------------------------
@@ -151,6 +161,8 @@ private:
 	physx::PxShape* GenerateShape(physx::PxPhysics* physics);
 
 public:
+	typedef ComponentLookupBases<BoxCollider, Collider> LookupBases;
+
 	BoxCollider(GameObject* gameObject, DirectX::XMFLOAT3 size = DirectX::XMFLOAT3(1, 1, 1), bool isTrigger = false,
 		PhysicsMaterial* physicsMaterial = nullptr, DirectX::XMFLOAT3 center = DirectX::XMFLOAT3(0, 0, 0));
 
@@ -186,6 +198,8 @@ private:
 	physx::PxShape* GenerateShape(physx::PxPhysics* physics);
 
 public:
+	typedef ComponentLookupBases<SphereCollider, Collider> LookupBases;
+
 	SphereCollider(GameObject* gameObject, float radius = 1.0f, bool isTrigger = false,
 		PhysicsMaterial* physicsMaterial = nullptr, DirectX::XMFLOAT3 center = DirectX::XMFLOAT3(0, 0, 0));
 
@@ -222,6 +236,8 @@ private:
 	physx::PxShape* GenerateShape(physx::PxPhysics* physics);
 
 public:
+	typedef ComponentLookupBases<CapsuleCollider, Collider> LookupBases;
+
 	CapsuleCollider(GameObject* gameObject, float radius = 1.0f, float height = 2.0f,
 		CapsuleDirection dir = CapsuleDirection::X, bool isTrigger = false,
 		PhysicsMaterial* physicsMaterial = nullptr, DirectX::XMFLOAT3 center = DirectX::XMFLOAT3(0, 0, 0));
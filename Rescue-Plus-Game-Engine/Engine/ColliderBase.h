@@ -16,6 +16,8 @@ class ColliderBase : public Component
 {
 private:
 	ColliderType type;
+	ListenerToken positionListener;
+	ListenerToken rotationListener;
 
 	// --------------------------------------------------------
 	// The attached GameObject's position changed
@@ -56,6 +58,8 @@ protected:
 	virtual void SetFilterData(physx::PxShape* shape) = 0;
 
 public:
+	typedef ComponentLookupBases<ColliderBase, Component> LookupBases;
+
 	~ColliderBase();
 
 	// --------------------------------------------------------
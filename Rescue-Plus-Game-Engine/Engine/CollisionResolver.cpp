@@ -97,54 +97,56 @@ void CollisionResolver::AddExitCollision(Collision collision)
 // (OnTriggerEnter, OnTriggerStay, OnTriggerExit)
 void CollisionResolver::ResolveCollisions(GameObject* obj)
 {
-	vector<UserComponent*> cntrlr, colEnt, colSty, colExt, trigEnt, trigSty, trigExt;
+	//Callbacks can add or remove components, so loop by index
+	// over the live lists instead of copying them
+	const vector<UserComponent*> *cntrlr, *colEnt, *colSty, *colExt, *trigEnt, *trigSty, *trigExt;
 	obj->GetCollisionAndTriggerCallbackComponents(&cntrlr, &colEnt, &colSty, &colExt,
 		&trigEnt, &trigSty, &trigExt);
 
-	if (colEnt.size() > 0 || trigEnt.size() > 0)
+	if (colEnt->size() > 0 || trigEnt->size() > 0)
 	{
 		//Run all OnEnters
 		for (auto iter = enterCollisions.begin(); iter != enterCollisions.end(); iter++)
 		{
 			if ((*iter).isTrigger)
-				for each(UserComponent* uc in trigEnt)
-					uc->OnTriggerEnter((*iter).col);
+				for (size_t i = 0; i < trigEnt->size(); i++)
+					(*trigEnt)[i]->OnTriggerEnter((*iter).col);
 			else
-				for each (UserComponent* uc in colEnt)
-					uc->OnCollisionEnter((*iter).col);
+				for (size_t i = 0; i < colEnt->size(); i++)
+					(*colEnt)[i]->OnCollisionEnter((*iter).col);
 		}
 	}
 	
-	if (colSty.size() > 0 || trigSty.size() > 0)
+	if (colSty->size() > 0 || trigSty->size() > 0)
 	{
 		//Run all OnStays
 		for (auto iter = stayCollisions.begin(); iter != stayCollisions.end(); iter++)
 		{
 			if ((*iter).isTrigger)
-				for each(UserComponent* uc in trigSty)
-					uc->OnTriggerStay((*iter).col);
+				for (size_t i = 0; i < trigSty->size(); i++)
+					(*trigSty)[i]->OnTriggerStay((*iter).col);
 			else
-				for each (UserComponent* uc in colSty)
-					uc->OnCollisionStay((*iter).col);
+				for (size_t i = 0; i < colSty->size(); i++)
+					(*colSty)[i]->OnCollisionStay((*iter).col);
 		}
 	}
 
 	//Run all OnExits
 	if (exitCollisions.size() > 0)
 	{
-		if (colExt.size() > 0 || trigExt.size() > 0)
+		if (colExt->size() > 0 || trigExt->size() > 0)
 		{
 			for (auto iter = exitCollisions.begin(); iter != exitCollisions.end(); iter++)
 			{
 				if ((*iter).isTrigger)
-					for each(UserComponent* uc in trigExt)
-						uc->OnTriggerExit((*iter).col);
+					for (size_t i = 0; i < trigExt->size(); i++)
+						(*trigExt)[i]->OnTriggerExit((*iter).col);
 				else if((*iter).isController)
-					for each (UserComponent * uc in cntrlr)
-						uc->OnControllerCollision((*iter).col);
+					for (size_t i = 0; i < cntrlr->size(); i++)
+						(*cntrlr)[i]->OnControllerCollision((*iter).col);
 				else
-					for each (UserComponent* uc in colExt)
-						uc->OnCollisionExit((*iter).col);
+					for (size_t i = 0; i < colExt->size(); i++)
+						(*colExt)[i]->OnCollisionExit((*iter).col);
 			}
 		}
 		//Still need to clear
@@ -1,12 +1,26 @@
 #pragma once
+#include <cstddef>
+#include "ComponentType.h"
+#include "ChangeVersion.h"
 
 class GameObject;
+class ComponentPoolBase;
 class Component
 {
 private:
+	//The pool that allocated this component
+	template <typename T, size_t ChunkSize> friend class ComponentPool;
+	friend class ComponentManager;
+	ComponentPoolBase* pool;
+
 	GameObject* attatchedGameObject;
+	ChangeVersion changeVersion;
 
 public:
+	//Classes this component can be found by in GetComponent<T>
+	// (Component itself is found without the lookup)
+	typedef ComponentBaseList<> LookupBases;
+
 	// --------------------------------------------------------
 	//Construct a component
 	// --------------------------------------------------------
@@ -31,12 +45,24 @@ public:
 	// Get the GameObject this component is tied to
 	// --------------------------------------------------------
 	GameObject* gameObject() { return attatchedGameObject; }
+
+	// --------------------------------------------------------
+	// Mark this component's data as changed
+	// --------------------------------------------------------
+	void MarkChanged() { changeVersion = CurrentChangeVersion(); }
+
+	// --------------------------------------------------------
+	// Get the version this component last changed on
+	// --------------------------------------------------------
+	ChangeVersion GetChangeVersion() { return changeVersion; }
 };
 
 struct Collision;
 class UserComponent : public Component
 {
 public:
+	typedef ComponentLookupBases<UserComponent, Component> LookupBases;
+
 	// --------------------------------------------------------
 	//Construct a component
 	// --------------------------------------------------------
@@ -0,0 +1,50 @@
+#include "ComponentManager.h"
+
+// Free all pools (all components should already be destroyed)
+void ComponentManager::Release()
+{
+	for (size_t i = 0; i < pools.size(); i++)
+	{
+		delete pools[i];
+	}
+	pools.clear();
+	poolMap.clear();
+}
+
+// Destroy a component and return it to its pool
+void ComponentManager::DestroyComponent(Component* component)
+{
+	if (component == nullptr)
+		return;
+
+	//Components not made by a pool were allocated with new
+	if (component->pool == nullptr)
+		delete component;
+	else component->pool->Destroy(component);
+}
+
+// Move a component into its pool's active or inactive range
+void ComponentManager::SetComponentActive(Component* component, bool active)
+{
+	if (component != nullptr && component->pool != nullptr)
+		component->pool->SetActive(component, active);
+}
+
+// Run Update() for every active component, one type at a time
+void ComponentManager::Update(float deltaTime)
+{
+	//New pools can be made during an update
+	for (size_t i = 0; i < pools.size(); i++)
+	{
+		pools[i]->Update(deltaTime);
+	}
+}
+
+// Run FixedUpdate() for every active component, one type at a time
+void ComponentManager::FixedUpdate(float deltaTime)
+{
+	for (size_t i = 0; i < pools.size(); i++)
+	{
+		pools[i]->FixedUpdate(deltaTime);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include "ComponentPool.h"
+
+// --------------------------------------------------------
+// Owns the pools that every component is allocated from
+// and updates components type by type
+// --------------------------------------------------------
+class ComponentManager
+{
+private:
+	// --------------------------------------------------------
+	// Singleton Constructor - Set up the singleton instance of the ComponentManager
+	// --------------------------------------------------------
+	ComponentManager() { }
+	~ComponentManager() { Release(); }
+
+	//Pools in the order their type was first created
+	std::vector<ComponentPoolBase*> pools;
+	std::unordered_map<ComponentTypeId, ComponentPoolBase*> poolMap;
+
+public:
+	// --------------------------------------------------------
+	// Get the singleton instance of the ComponentManager
+	// --------------------------------------------------------
+	static ComponentManager* GetInstance()
+	{
+		static ComponentManager instance;
+		return &instance;
+	}
+
+	//Delete this
+	ComponentManager(ComponentManager const&) = delete;
+	void operator=(ComponentManager const&) = delete;
+
+	// --------------------------------------------------------
+	// Free all pools (all components should already be destroyed)
+	// --------------------------------------------------------
+	void Release();
+
+	// --------------------------------------------------------
+	// Get the pool for a component type (creates it if needed)
+	// --------------------------------------------------------
+	template <typename T>
+	ComponentPool<T>* GetPool()
+	{
+		auto iter = poolMap.find(ComponentTypeIdOf<T>);
+		if (iter != poolMap.end())
+			return static_cast<ComponentPool<T>*>(iter->second);
+
+		ComponentPool<T>* pool = new ComponentPool<T>();
+		pools.push_back(pool);
+		poolMap.insert({ ComponentTypeIdOf<T>, pool });
+		return pool;
+	}
+
+	// --------------------------------------------------------
+	// Create a component in its type's pool
+	// --------------------------------------------------------
+	template <typename T, typename... Args>
+	T* CreateComponent(GameObject* gameObject, Args... args)
+	{
+		return GetPool<T>()->Create(gameObject, args...);
+	}
+
+	// --------------------------------------------------------
+	// Destroy a component and return it to its pool
+	// --------------------------------------------------------
+	void DestroyComponent(Component* component);
+
+	// --------------------------------------------------------
+	// Move a component into its pool's active or inactive range
+	// --------------------------------------------------------
+	void SetComponentActive(Component* component, bool active);
+
+	// --------------------------------------------------------
+	// Run Update() for every active component, one type at a time
+	// --------------------------------------------------------
+	void Update(float deltaTime);
+
+	// --------------------------------------------------------
+	// Run FixedUpdate() for every active component, one type at a time
+	// --------------------------------------------------------
+	void FixedUpdate(float deltaTime);
+};
\ No newline at end of file
@@ -0,0 +1,592 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include "Component.h"
+#include "UpdateLod.h"
+
+#define POOL_INVALID_INDEX UINT32_MAX
+
+// --------------------------------------------------------
+// Base class for a pool of one component type
+// --------------------------------------------------------
+class ComponentPoolBase
+{
+public:
+	virtual ~ComponentPoolBase() { }
+
+	// --------------------------------------------------------
+	// Update every active component in this pool
+	// --------------------------------------------------------
+	virtual void Update(float deltaTime) = 0;
+
+	// --------------------------------------------------------
+	// Update every active component in this pool at the fixed timestep
+	// --------------------------------------------------------
+	virtual void FixedUpdate(float deltaTime) = 0;
+
+	// --------------------------------------------------------
+	// Destroy a component that was created by this pool
+	// --------------------------------------------------------
+	virtual void Destroy(Component* component) = 0;
+
+	// --------------------------------------------------------
+	// Move a component into the active or inactive range
+	// (called when its GameObject is enabled or disabled)
+	// --------------------------------------------------------
+	virtual void SetActive(Component* component, bool active) = 0;
+
+	// --------------------------------------------------------
+	// Get the amount of live components in this pool
+	// --------------------------------------------------------
+	virtual size_t GetCount() = 0;
+};
+
+// --------------------------------------------------------
+// A pool allocator for one component type.
+//
+// Components are allocated from fixed size chunks so they never
+// move and are packed together in memory. Components that override
+// Update or FixedUpdate are kept in dense lists so the whole pool
+// can be updated in one loop with a non-virtual call.
+//
+// The update lists are partitioned: components on enabled
+// GameObjects come first, so only that range is looped over.
+//
+// Types that declare an UpdateRate (see UpdateLod.h) are not in
+// the update list. Their active components are split into lists
+// by update interval and phase, and each frame only the lists
+// whose turn it is are looped over. A component's interval is
+// picked again every time it updates, and it is passed the time
+// since its last update.
+// --------------------------------------------------------
+template <typename T, size_t ChunkSize = 64>
+class ComponentPool : public ComponentPoolBase
+{
+private:
+	//Storage for one component. The component data is first so
+	// a component pointer is also a pointer to its slot
+	struct Slot
+	{
+		alignas(T) unsigned char data[sizeof(T)];
+		uint32_t updateIndex;
+		uint32_t fixedUpdateIndex;
+		uint32_t lodList;
+		uint32_t lodIndex;
+		uint32_t lodTick;
+		double lodTime;
+		Slot* nextFree;
+	};
+
+	//A list of components to update. [0, activeCount) are active
+	struct UpdateList
+	{
+		std::vector<T*> items;
+		size_t activeCount;
+		uint32_t Slot::* index;
+	};
+
+	static constexpr bool HasUpdate =
+		!std::is_same<decltype(&Component::Update), decltype(&T::Update)>::value;
+	static constexpr bool HasFixedUpdate =
+		!std::is_same<decltype(&Component::FixedUpdate), decltype(&T::FixedUpdate)>::value;
+	static constexpr bool HasUpdateRate = HasUpdate && HasUpdateLod<T>::value;
+	static constexpr bool HasUpdateList = HasUpdate && !HasUpdateRate;
+	static constexpr uint32_t LodListCount = (1u << UPDATE_LOD_LEVELS) - 1;
+
+	std::vector<Slot*> chunks;
+	Slot* freeList;
+	size_t count;
+	size_t capacity;
+
+	UpdateList updateList;
+	UpdateList fixedUpdateList;
+
+	//Scheduled components. Level L's lists start at (1 << L) - 1,
+	// one per phase, and the list for frame F is (F mod (1 << L))
+	std::vector<T*> lodLists[LodListCount];
+	uint32_t lodNextPhase[UPDATE_LOD_LEVELS];
+	uint32_t lodTick;
+	double lodClock;
+
+	//Components removed while a list is being updated are nulled
+	// out and the lists are compacted afterwards. Activity changes
+	// are applied afterwards too, so no component is skipped
+	bool dispatching;
+	bool listsDirty;
+	std::vector<std::pair<T*, bool>> pendingActivity;
+
+	// --------------------------------------------------------
+	// Get the slot a component lives in
+	// --------------------------------------------------------
+	static Slot* GetSlot(T* component)
+	{
+		return reinterpret_cast<Slot*>(component);
+	}
+
+	// --------------------------------------------------------
+	// Allocate a new chunk and add it to the free list
+	// --------------------------------------------------------
+	void AllocateChunk()
+	{
+		Slot* chunk = new Slot[ChunkSize];
+		chunks.push_back(chunk);
+		capacity += ChunkSize;
+
+		//Link the chunk into the free list
+		for (size_t i = 0; i < ChunkSize; i++)
+		{
+			chunk[i].nextFree = (i + 1 < ChunkSize) ? &chunk[i + 1] : freeList;
+		}
+		freeList = chunk;
+	}
+
+	// --------------------------------------------------------
+	// Get a free slot, allocating a new chunk if needed
+	// --------------------------------------------------------
+	Slot* AllocateSlot()
+	{
+		if (freeList == nullptr)
+			AllocateChunk();
+
+		Slot* slot = freeList;
+		freeList = slot->nextFree;
+		slot->updateIndex = POOL_INVALID_INDEX;
+		slot->fixedUpdateIndex = POOL_INVALID_INDEX;
+		slot->lodList = POOL_INVALID_INDEX;
+		return slot;
+	}
+
+	// --------------------------------------------------------
+	// Put a component at an index in a list
+	// --------------------------------------------------------
+	static void Place(UpdateList* list, size_t index, T* component)
+	{
+		list->items[index] = component;
+		if (component != nullptr)
+			GetSlot(component)->*(list->index) = (uint32_t)index;
+	}
+
+	// --------------------------------------------------------
+	// Swap two entries in a list
+	// --------------------------------------------------------
+	static void Swap(UpdateList* list, size_t a, size_t b)
+	{
+		T* componentA = list->items[a];
+		Place(list, a, list->items[b]);
+		Place(list, b, componentA);
+	}
+
+	// --------------------------------------------------------
+	// Add a component to a list
+	// --------------------------------------------------------
+	static void AddToList(UpdateList* list, T* component, bool active)
+	{
+		list->items.push_back(component);
+		GetSlot(component)->*(list->index) = (uint32_t)(list->items.size() - 1);
+
+		//Move it to the end of the active range
+		if (active)
+		{
+			Swap(list, list->items.size() - 1, list->activeCount);
+			list->activeCount++;
+		}
+	}
+
+	// --------------------------------------------------------
+	// Move a component into the active or inactive range of a list
+	// --------------------------------------------------------
+	static void SetActiveInList(UpdateList* list, T* component, bool active)
+	{
+		uint32_t index = GetSlot(component)->*(list->index);
+		if (index == POOL_INVALID_INDEX)
+			return;
+
+		if (active && index >= list->activeCount)
+		{
+			Swap(list, index, list->activeCount);
+			list->activeCount++;
+		}
+		else if (!active && index < list->activeCount)
+		{
+			list->activeCount--;
+			Swap(list, index, list->activeCount);
+		}
+	}
+
+	// --------------------------------------------------------
+	// Remove a component from a list
+	// --------------------------------------------------------
+	void RemoveFromList(UpdateList* list, T* component)
+	{
+		uint32_t& index = GetSlot(component)->*(list->index);
+		if (index == POOL_INVALID_INDEX)
+			return;
+
+		if (dispatching)
+		{
+			list->items[index] = nullptr;
+			listsDirty = true;
+		}
+		else
+		{
+			//Keep the active range packed, then swap with the last and pop
+			if (index < list->activeCount)
+			{
+				list->activeCount--;
+				Swap(list, index, list->activeCount);
+			}
+			Place(list, index, list->items.back());
+			list->items.pop_back();
+		}
+
+		index = POOL_INVALID_INDEX;
+	}
+
+	// --------------------------------------------------------
+	// Add a component to the schedule at a level. Phases are
+	// handed out in turn so the load is spread across frames
+	// --------------------------------------------------------
+	void AddToLod(T* component, uint32_t level)
+	{
+		uint32_t phase = lodNextPhase[level]++ & ((1u << level) - 1);
+		uint32_t listIndex = (1u << level) - 1 + phase;
+
+		Slot* slot = GetSlot(component);
+		slot->lodList = listIndex;
+		slot->lodIndex = (uint32_t)lodLists[listIndex].size();
+		lodLists[listIndex].push_back(component);
+	}
+
+	// --------------------------------------------------------
+	// Swap an entry in a schedule list with the last and pop
+	// --------------------------------------------------------
+	void SwapRemoveLod(uint32_t listIndex, uint32_t index)
+	{
+		std::vector<T*>& list = lodLists[listIndex];
+		T* last = list.back();
+		list[index] = last;
+		if (last != nullptr)
+			GetSlot(last)->lodIndex = index;
+		list.pop_back();
+	}
+
+	// --------------------------------------------------------
+	// Remove a component from the schedule
+	// --------------------------------------------------------
+	void RemoveFromLod(T* component)
+	{
+		Slot* slot = GetSlot(component);
+		if (slot->lodList == POOL_INVALID_INDEX)
+			return;
+
+		if (dispatching)
+		{
+			lodLists[slot->lodList][slot->lodIndex] = nullptr;
+			listsDirty = true;
+		}
+		else SwapRemoveLod(slot->lodList, slot->lodIndex);
+
+		slot->lodList = POOL_INVALID_INDEX;
+	}
+
+	// --------------------------------------------------------
+	// Add a component to or remove it from the schedule
+	// --------------------------------------------------------
+	void SetActiveInLod(T* component, bool active)
+	{
+		Slot* slot = GetSlot(component);
+		if (active && slot->lodList == POOL_INVALID_INDEX)
+		{
+			//Time spent disabled isn't passed to Update
+			slot->lodTime = lodClock;
+			slot->lodTick = lodTick;
+			AddToLod(component, 0);
+		}
+		else if (!active)
+			RemoveFromLod(component);
+	}
+
+	// --------------------------------------------------------
+	// Remove nulled out entries from a schedule list
+	// --------------------------------------------------------
+	void CompactLodList(std::vector<T*>* list)
+	{
+		size_t write = 0;
+		for (size_t read = 0; read < list->size(); read++)
+		{
+			T* component = (*list)[read];
+			if (component == nullptr)
+				continue;
+
+			GetSlot(component)->lodIndex = (uint32_t)write;
+			(*list)[write++] = component;
+		}
+		list->resize(write);
+	}
+
+	// --------------------------------------------------------
+	// Remove nulled out entries from a list, keeping the ranges
+	// --------------------------------------------------------
+	static void CompactList(UpdateList* list)
+	{
+		size_t write = 0;
+		size_t newActiveCount = 0;
+		for (size_t read = 0; read < list->items.size(); read++)
+		{
+			T* component = list->items[read];
+			if (component == nullptr)
+				continue;
+
+			if (read < list->activeCount)
+				newActiveCount++;
+			Place(list, write++, component);
+		}
+		list->items.resize(write);
+		list->activeCount = newActiveCount;
+	}
+
+	// --------------------------------------------------------
+	// Compact the lists and apply activity changes made during an update
+	// --------------------------------------------------------
+	void FinishDispatch()
+	{
+		dispatching = false;
+		if (listsDirty)
+		{
+			CompactList(&updateList);
+			CompactList(&fixedUpdateList);
+			if constexpr (HasUpdateRate)
+			{
+				for (uint32_t i = 0; i < LodListCount; i++)
+					CompactLodList(&lodLists[i]);
+			}
+			listsDirty = false;
+		}
+
+		for (size_t i = 0; i < pendingActivity.size(); i++)
+		{
+			SetActiveInList(&updateList, pendingActivity[i].first, pendingActivity[i].second);
+			SetActiveInList(&fixedUpdateList, pendingActivity[i].first, pendingActivity[i].second);
+			if constexpr (HasUpdateRate)
+				SetActiveInLod(pendingActivity[i].first, pendingActivity[i].second);
+		}
+		pendingActivity.clear();
+	}
+
+	// --------------------------------------------------------
+	// Update the scheduled components whose turn it is this frame
+	// --------------------------------------------------------
+	void UpdateScheduled(float deltaTime)
+	{
+		UpdateLodViewer* viewer = UpdateLodViewer::GetInstance();
+		uint32_t frame = GetFrameVersion();
+		lodClock += deltaTime;
+		lodTick++;
+		dispatching = true;
+
+		for (uint32_t level = 0; level < UPDATE_LOD_LEVELS; level++)
+		{
+			uint32_t listIndex = (1u << level) - 1 + (frame & ((1u << level) - 1));
+			std::vector<T*>& list = lodLists[listIndex];
+
+			//Backwards, so moving a component out of this list
+			// only swaps in one that was already updated
+			for (size_t i = list.size(); i > 0; i--)
+			{
+				T* c = list[i - 1];
+				if (c == nullptr)
+					continue;
+
+				//Already updated this frame before moving to a slower level
+				Slot* slot = GetSlot(c);
+				if (slot->lodTick == lodTick)
+					continue;
+
+				uint32_t newLevel = viewer->GetLevel(T::UpdateRate, c->gameObject());
+				if (newLevel != level)
+				{
+					SwapRemoveLod(listIndex, (uint32_t)(i - 1));
+					AddToLod(c, newLevel);
+				}
+
+				float elapsed = (float)(lodClock - slot->lodTime);
+				slot->lodTime = lodClock;
+				slot->lodTick = lodTick;
+				c->T::Update(elapsed);
+			}
+		}
+
+		FinishDispatch();
+	}
+
+public:
+	ComponentPool()
+	{
+		freeList = nullptr;
+		count = 0;
+		capacity = 0;
+		dispatching = false;
+		listsDirty = false;
+		updateList.activeCount = 0;
+		updateList.index = &Slot::updateIndex;
+		fixedUpdateList.activeCount = 0;
+		fixedUpdateList.index = &Slot::fixedUpdateIndex;
+		for (uint32_t i = 0; i < UPDATE_LOD_LEVELS; i++)
+			lodNextPhase[i] = 0;
+		lodTick = 0;
+		lodClock = 0;
+	}
+
+	// --------------------------------------------------------
+	// Free all chunks (components should already be destroyed)
+	// --------------------------------------------------------
+	~ComponentPool()
+	{
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			delete[] chunks[i];
+		}
+		chunks.clear();
+	}
+
+	// --------------------------------------------------------
+	// Create a component in this pool
+	// --------------------------------------------------------
+	template <typename... Args>
+	T* Create(GameObject* gameObject, Args... args)
+	{
+		Slot* slot = AllocateSlot();
+		T* component = new (slot->data) T(gameObject, args...);
+		component->pool = this;
+		count++;
+
+		bool active = component->gameObject()->GetEnabled();
+		if constexpr (HasUpdateList)
+			AddToList(&updateList, component, active);
+		if constexpr (HasUpdateRate)
+			SetActiveInLod(component, active);
+		if constexpr (HasFixedUpdate)
+			AddToList(&fixedUpdateList, component, active);
+
+		return component;
+	}
+
+	// --------------------------------------------------------
+	// Make sure a number of components can be created without
+	// allocating (used when spawning in bulk)
+	// --------------------------------------------------------
+	void Reserve(size_t amount)
+	{
+		while (capacity < count + amount)
+		{
+			AllocateChunk();
+		}
+
+		if constexpr (HasUpdateList)
+			updateList.items.reserve(updateList.items.size() + amount);
+		if constexpr (HasFixedUpdate)
+			fixedUpdateList.items.reserve(fixedUpdateList.items.size() + amount);
+	}
+
+	// --------------------------------------------------------
+	// Destroy a component that was created by this pool
+	// --------------------------------------------------------
+	void Destroy(Component* component) override
+	{
+		T* c = static_cast<T*>(component);
+		RemoveFromList(&updateList, c);
+		RemoveFromList(&fixedUpdateList, c);
+		if constexpr (HasUpdateRate)
+			RemoveFromLod(c);
+
+		//Drop any activity change waiting on this component
+		for (size_t i = 0; i < pendingActivity.size(); i++)
+		{
+			if (pendingActivity[i].first == c)
+			{
+				pendingActivity[i] = pendingActivity.back();
+				pendingActivity.pop_back();
+				i--;
+			}
+		}
+
+		c->~T();
+		count--;
+
+		Slot* slot = GetSlot(c);
+		slot->nextFree = freeList;
+		freeList = slot;
+	}
+
+	// --------------------------------------------------------
+	// Move a component into the active or inactive range
+	// --------------------------------------------------------
+	void SetActive(Component* component, bool active) override
+	{
+		T* c = static_cast<T*>(component);
+		if (dispatching)
+		{
+			pendingActivity.push_back(std::make_pair(c, active));
+			return;
+		}
+
+		SetActiveInList(&updateList, c, active);
+		SetActiveInList(&fixedUpdateList, c, active);
+		if constexpr (HasUpdateRate)
+			SetActiveInLod(c, active);
+	}
+
+	// --------------------------------------------------------
+	// Update every active component in this pool
+	// --------------------------------------------------------
+	void Update(float deltaTime) override
+	{
+		if constexpr (HasUpdateRate)
+			UpdateScheduled(deltaTime);
+		else if constexpr (HasUpdate)
+		{
+			dispatching = true;
+
+			//Components added during the update are updated this frame too
+			for (size_t i = 0; i < updateList.activeCount; i++)
+			{
+				T* c = updateList.items[i];
+				if (c != nullptr)
+					c->T::Update(deltaTime);
+			}
+
+			FinishDispatch();
+		}
+	}
+
+	// --------------------------------------------------------
+	// Update every active component in this pool at the fixed timestep
+	// --------------------------------------------------------
+	void FixedUpdate(float deltaTime) override
+	{
+		if constexpr (HasFixedUpdate)
+		{
+			dispatching = true;
+
+			for (size_t i = 0; i < fixedUpdateList.activeCount; i++)
+			{
+				T* c = fixedUpdateList.items[i];
+				if (c != nullptr)
+					c->T::FixedUpdate(deltaTime);
+			}
+
+			FinishDispatch();
+		}
+	}
+
+	// --------------------------------------------------------
+	// Get the amount of live components in this pool
+	// --------------------------------------------------------
+	size_t GetCount() override
+	{
+		return count;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+typedef uint64_t ComponentTypeId;
+
+// --------------------------------------------------------
+// Hash a string with 64 bit FNV-1a (usable at compile time)
+// --------------------------------------------------------
+constexpr uint64_t Fnv1a64(const char* str)
+{
+	uint64_t hash = 14695981039346656037ull;
+	while (*str != 0)
+	{
+		hash ^= (uint64_t)(unsigned char)(*str);
+		hash *= 1099511628211ull;
+		str++;
+	}
+	return hash;
+}
+
+// --------------------------------------------------------
+// Get the type ID of a component type.
+// The compiler's signature string is unique per type,
+// so hashing it gives a stable ID without RTTI
+// --------------------------------------------------------
+template <typename T>
+constexpr ComponentTypeId GetComponentTypeId()
+{
+#if defined(_MSC_VER)
+	return Fnv1a64(__FUNCSIG__);
+#else
+	return Fnv1a64(__PRETTY_FUNCTION__);
+#endif
+}
+
+// --------------------------------------------------------
+// Compile time type ID of a component type
+// --------------------------------------------------------
+template <typename T>
+constexpr ComponentTypeId ComponentTypeIdOf = GetComponentTypeId<T>();
+
+// --------------------------------------------------------
+// A list of classes a component can be found by with
+// GameObject::GetComponent, itself and its bases
+// --------------------------------------------------------
+template <typename... Bases>
+struct ComponentBaseList { };
+
+// --------------------------------------------------------
+// Put a component in front of its parent's lookup list
+// --------------------------------------------------------
+template <typename Self, typename ParentList>
+struct ComponentBaseListPrepend;
+
+template <typename Self, typename... ParentBases>
+struct ComponentBaseListPrepend<Self, ComponentBaseList<ParentBases...>>
+{
+	typedef ComponentBaseList<Self, ParentBases...> Type;
+};
+
+// --------------------------------------------------------
+// The lookup list of a component: itself, then everything
+// its parent can be found by. Every component that is looked
+// up with GetComponent declares
+//		typedef ComponentLookupBases<Self, Parent> LookupBases;
+// so a component is found by every class between it and
+// Component. Classes that don't declare it inherit their
+// parent's list, and can't be looked up themselves
+// --------------------------------------------------------
+template <typename Self, typename Parent>
+using ComponentLookupBases = typename ComponentBaseListPrepend<Self, typename Parent::LookupBases>::Type;
+
+// --------------------------------------------------------
+// Check if a lookup list has a class in it
+// --------------------------------------------------------
+template <typename T, typename List>
+struct ComponentBaseListHas;
+
+template <typename T, typename... Bases>
+struct ComponentBaseListHas<T, ComponentBaseList<Bases...>>
+	: std::integral_constant<bool, (std::is_same<T, Bases>::value || ...)> { };
+
+// --------------------------------------------------------
+// True if T declared its own LookupBases, so components
+// derived from it are filed under it
+// --------------------------------------------------------
+template <typename T>
+constexpr bool IsLookupComponent = ComponentBaseListHas<T, typename T::LookupBases>::value;
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "D3D11RenderDevice.h"
+#include <cstdio>
+#include <cstring>
+
+// The D3D11 objects behind render handles
+static inline ID3D11Buffer* ToD3D11(RenderBuffer* buffer) { return reinterpret_cast<ID3D11Buffer*>(buffer); }
+static inline ID3D11DeviceChild* ToD3D11(RenderShader* shader) { return reinterpret_cast<ID3D11DeviceChild*>(shader); }
+static inline ID3D11ShaderResourceView* const* ToD3D11(RenderShaderResource* const* srvs) { return reinterpret_cast<ID3D11ShaderResourceView* const*>(srvs); }
+static inline ID3D11SamplerState* ToD3D11(RenderSampler* sampler) { return reinterpret_cast<ID3D11SamplerState*>(sampler); }
+static inline ID3D11InputLayout* ToD3D11(RenderInputLayout* inputLayout) { return reinterpret_cast<ID3D11InputLayout*>(inputLayout); }
+static inline ID3D11RasterizerState* ToD3D11(RenderRasterizerState* state) { return reinterpret_cast<ID3D11RasterizerState*>(state); }
+static inline ID3D11DepthStencilState* ToD3D11(RenderDepthStencilState* state) { return reinterpret_cast<ID3D11DepthStencilState*>(state); }
+static inline ID3D11BlendState* ToD3D11(RenderBlendState* state) { return reinterpret_cast<ID3D11BlendState*>(state); }
+static inline ID3D11RenderTargetView* ToD3D11(RenderTargetView* target) { return reinterpret_cast<ID3D11RenderTargetView*>(target); }
+static inline ID3D11DepthStencilView* ToD3D11(RenderDepthStencilView* depthStencil) { return reinterpret_cast<ID3D11DepthStencilView*>(depthStencil); }
+
+// The D3D11 format of an index format
+static DXGI_FORMAT ToD3D11(RenderIndexFormat format)
+{
+	switch (format)
+	{
+		case RenderIndexFormat::UInt16: return DXGI_FORMAT_R16_UINT;
+		case RenderIndexFormat::UInt32: return DXGI_FORMAT_R32_UINT;
+		default: return DXGI_FORMAT_UNKNOWN;
+	}
+}
+
+// The D3D11 topology of a render topology
+static D3D11_PRIMITIVE_TOPOLOGY ToD3D11(RenderTopology topology)
+{
+	switch (topology)
+	{
+		case RenderTopology::PointList: return D3D11_PRIMITIVE_TOPOLOGY_POINTLIST;
+		case RenderTopology::LineList: return D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
+		case RenderTopology::LineStrip: return D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP;
+		case RenderTopology::TriangleList: return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+		case RenderTopology::TriangleStrip: return D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+		default: return D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	}
+}
+
+// The D3D11 clear flags of a depth clear
+static UINT ToD3D11(DepthClear clear)
+{
+	switch (clear)
+	{
+		case DepthClear::Depth: return D3D11_CLEAR_DEPTH;
+		case DepthClear::Stencil: return D3D11_CLEAR_STENCIL;
+		default: return D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL;
+	}
+}
+
+// Constructor - Send commands to a device context
+D3D11RenderDevice::D3D11RenderDevice(ID3D11DeviceContext* context)
+{
+	this->context = context;
+}
+
+// Bind a vertex buffer to slot 0
+void D3D11RenderDevice::SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	ID3D11Buffer* d3dBuffer = ToD3D11(buffer);
+	context->IASetVertexBuffers(0, 1, &d3dBuffer, &stride, &offset);
+}
+
+// Bind an index buffer
+void D3D11RenderDevice::SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format)
+{
+	context->IASetIndexBuffer(ToD3D11(buffer), ToD3D11(format), 0);
+}
+
+// Copy data into a whole buffer
+void D3D11RenderDevice::UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	context->UpdateSubresource(ToD3D11(buffer), 0, 0, data, 0, 0);
+}
+
+// Bind a per-instance vertex buffer to slot 1
+void D3D11RenderDevice::SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	ID3D11Buffer* d3dBuffer = ToD3D11(buffer);
+	context->IASetVertexBuffers(1, 1, &d3dBuffer, &stride, &offset);
+}
+
+// Overwrite the start of a dynamic buffer
+void D3D11RenderDevice::WriteBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	if (FAILED(context->Map(ToD3D11(buffer), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+	{
+		printf("Failed to map a dynamic buffer\n");
+		return;
+	}
+	memcpy(mapped.pData, data, size);
+	context->Unmap(ToD3D11(buffer), 0);
+}
+
+// Bind a shader to a stage
+void D3D11RenderDevice::SetShader(ShaderStage stage, RenderShader* shader)
+{
+	ID3D11DeviceChild* d3dShader = ToD3D11(shader);
+	switch (stage)
+	{
+		case ShaderStage::Vertex: context->VSSetShader(static_cast<ID3D11VertexShader*>(d3dShader), 0, 0); break;
+		case ShaderStage::Pixel: context->PSSetShader(static_cast<ID3D11PixelShader*>(d3dShader), 0, 0); break;
+		case ShaderStage::Domain: context->DSSetShader(static_cast<ID3D11DomainShader*>(d3dShader), 0, 0); break;
+		case ShaderStage::Hull: context->HSSetShader(static_cast<ID3D11HullShader*>(d3dShader), 0, 0); break;
+		case ShaderStage::Geometry: context->GSSetShader(static_cast<ID3D11GeometryShader*>(d3dShader), 0, 0); break;
+		case ShaderStage::Compute: context->CSSetShader(static_cast<ID3D11ComputeShader*>(d3dShader), 0, 0); break;
+		default: break;
+	}
+}
+
+// Bind a constant buffer to a stage
+void D3D11RenderDevice::SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer)
+{
+	ID3D11Buffer* d3dBuffer = ToD3D11(buffer);
+	switch (stage)
+	{
+		case ShaderStage::Vertex: context->VSSetConstantBuffers(slot, 1, &d3dBuffer); break;
+		case ShaderStage::Pixel: context->PSSetConstantBuffers(slot, 1, &d3dBuffer); break;
+		case ShaderStage::Domain: context->DSSetConstantBuffers(slot, 1, &d3dBuffer); break;
+		case ShaderStage::Hull: context->HSSetConstantBuffers(slot, 1, &d3dBuffer); break;
+		case ShaderStage::Geometry: context->GSSetConstantBuffers(slot, 1, &d3dBuffer); break;
+		case ShaderStage::Compute: context->CSSetConstantBuffers(slot, 1, &d3dBuffer); break;
+		default: break;
+	}
+}
+
+// Bind shader resource views to a stage
+void D3D11RenderDevice::SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs)
+{
+	ID3D11ShaderResourceView* const* d3dSRVs = ToD3D11(srvs);
+	switch (stage)
+	{
+		case ShaderStage::Vertex: context->VSSetShaderResources(startSlot, count, d3dSRVs); break;
+		case ShaderStage::Pixel: context->PSSetShaderResources(startSlot, count, d3dSRVs); break;
+		case ShaderStage::Domain: context->DSSetShaderResources(startSlot, count, d3dSRVs); break;
+		case ShaderStage::Hull: context->HSSetShaderResources(startSlot, count, d3dSRVs); break;
+		case ShaderStage::Geometry: context->GSSetShaderResources(startSlot, count, d3dSRVs); break;
+		case ShaderStage::Compute: context->CSSetShaderResources(startSlot, count, d3dSRVs); break;
+		default: break;
+	}
+}
+
+// Bind a sampler to a stage
+void D3D11RenderDevice::SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler)
+{
+	ID3D11SamplerState* d3dSampler = ToD3D11(sampler);
+	switch (stage)
+	{
+		case ShaderStage::Vertex: context->VSSetSamplers(slot, 1, &d3dSampler); break;
+		case ShaderStage::Pixel: context->PSSetSamplers(slot, 1, &d3dSampler); break;
+		case ShaderStage::Domain: context->DSSetSamplers(slot, 1, &d3dSampler); break;
+		case ShaderStage::Hull: context->HSSetSamplers(slot, 1, &d3dSampler); break;
+		case ShaderStage::Geometry: context->GSSetSamplers(slot, 1, &d3dSampler); break;
+		case ShaderStage::Compute: context->CSSetSamplers(slot, 1, &d3dSampler); break;
+		default: break;
+	}
+}
+
+// Set the input layout
+void D3D11RenderDevice::SetInputLayout(RenderInputLayout* inputLayout)
+{
+	context->IASetInputLayout(ToD3D11(inputLayout));
+}
+
+// Set the primitive topology
+void D3D11RenderDevice::SetPrimitiveTopology(RenderTopology topology)
+{
+	context->IASetPrimitiveTopology(ToD3D11(topology));
+}
+
+// Set the rasterizer state
+void D3D11RenderDevice::SetRasterizerState(RenderRasterizerState* state)
+{
+	context->RSSetState(ToD3D11(state));
+}
+
+// Set the depth stencil state
+void D3D11RenderDevice::SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef)
+{
+	context->OMSetDepthStencilState(ToD3D11(state), stencilRef);
+}
+
+// Set the blend state
+void D3D11RenderDevice::SetBlendState(RenderBlendState* state)
+{
+	context->OMSetBlendState(ToD3D11(state), 0, 0xFFFFFFFF);
+}
+
+// Bind a render target and depth buffer
+void D3D11RenderDevice::SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil)
+{
+	ID3D11RenderTargetView* d3dTarget = ToD3D11(target);
+	if (d3dTarget == nullptr)
+		context->OMSetRenderTargets(0, 0, ToD3D11(depthStencil));
+	else context->OMSetRenderTargets(1, &d3dTarget, ToD3D11(depthStencil));
+}
+
+// Set the viewport
+void D3D11RenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	D3D11_VIEWPORT vp = {};
+	vp.TopLeftX = viewport.x;
+	vp.TopLeftY = viewport.y;
+	vp.Width = viewport.width;
+	vp.Height = viewport.height;
+	vp.MinDepth = viewport.minDepth;
+	vp.MaxDepth = viewport.maxDepth;
+	context->RSSetViewports(1, &vp);
+}
+
+// Clear a render target to a color
+void D3D11RenderDevice::ClearRenderTarget(RenderTargetView* target, const float color[4])
+{
+	context->ClearRenderTargetView(ToD3D11(target), color);
+}
+
+// Clear a depth buffer
+void D3D11RenderDevice::ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil)
+{
+	context->ClearDepthStencilView(ToD3D11(depthStencil), ToD3D11(clear), depth, stencil);
+}
+
+// Draw indexed triangles with the bound buffers
+void D3D11RenderDevice::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	context->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+// Draw instances of indexed triangles with the bound buffers
+void D3D11RenderDevice::DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+// Always this device, it is where commands end up
+RenderDevice* D3D11RenderDevice::GetBackend()
+{
+	return this;
+}
+
+// Get the device context commands are sent to
+ID3D11DeviceContext* D3D11RenderDevice::GetContext()
+{
+	return context;
+}
\ No newline at end of file
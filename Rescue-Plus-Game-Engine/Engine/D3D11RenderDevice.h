@@ -0,0 +1,71 @@
+#pragma once
+#include <d3d11.h>
+#include "RenderDevice.h"
+
+// --------------------------------------------------------
+// Render handles for D3D11 objects. A handle is the object's
+// pointer, so these only change its type
+// --------------------------------------------------------
+inline RenderBuffer* ToHandle(ID3D11Buffer* buffer) { return reinterpret_cast<RenderBuffer*>(buffer); }
+inline RenderShader* ToHandle(ID3D11VertexShader* shader) { return reinterpret_cast<RenderShader*>(shader); }
+inline RenderShader* ToHandle(ID3D11PixelShader* shader) { return reinterpret_cast<RenderShader*>(shader); }
+inline RenderShader* ToHandle(ID3D11DomainShader* shader) { return reinterpret_cast<RenderShader*>(shader); }
+inline RenderShader* ToHandle(ID3D11HullShader* shader) { return reinterpret_cast<RenderShader*>(shader); }
+inline RenderShader* ToHandle(ID3D11GeometryShader* shader) { return reinterpret_cast<RenderShader*>(shader); }
+inline RenderShader* ToHandle(ID3D11ComputeShader* shader) { return reinterpret_cast<RenderShader*>(shader); }
+inline RenderShaderResource* ToHandle(ID3D11ShaderResourceView* srv) { return reinterpret_cast<RenderShaderResource*>(srv); }
+inline RenderSampler* ToHandle(ID3D11SamplerState* sampler) { return reinterpret_cast<RenderSampler*>(sampler); }
+inline RenderInputLayout* ToHandle(ID3D11InputLayout* inputLayout) { return reinterpret_cast<RenderInputLayout*>(inputLayout); }
+inline RenderRasterizerState* ToHandle(ID3D11RasterizerState* state) { return reinterpret_cast<RenderRasterizerState*>(state); }
+inline RenderDepthStencilState* ToHandle(ID3D11DepthStencilState* state) { return reinterpret_cast<RenderDepthStencilState*>(state); }
+inline RenderBlendState* ToHandle(ID3D11BlendState* state) { return reinterpret_cast<RenderBlendState*>(state); }
+inline RenderTargetView* ToHandle(ID3D11RenderTargetView* target) { return reinterpret_cast<RenderTargetView*>(target); }
+inline RenderDepthStencilView* ToHandle(ID3D11DepthStencilView* depthStencil) { return reinterpret_cast<RenderDepthStencilView*>(depthStencil); }
+
+// --------------------------------------------------------
+// Sends render commands straight to a D3D11 device context
+// --------------------------------------------------------
+class D3D11RenderDevice : public RenderDevice
+{
+private:
+	ID3D11DeviceContext* context;
+
+public:
+	D3D11RenderDevice(ID3D11DeviceContext* context);
+
+	void SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format);
+	void UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size);
+	void SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void WriteBuffer(RenderBuffer* buffer, const void* data, size_t size);
+
+	void SetShader(ShaderStage stage, RenderShader* shader);
+	void SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer);
+	void SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs);
+	void SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler);
+
+	void SetInputLayout(RenderInputLayout* inputLayout);
+	void SetPrimitiveTopology(RenderTopology topology);
+	void SetRasterizerState(RenderRasterizerState* state);
+	void SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef);
+	void SetBlendState(RenderBlendState* state);
+
+	void SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil);
+	void SetViewport(const RenderViewport& viewport);
+	void ClearRenderTarget(RenderTargetView* target, const float color[4]);
+	void ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil);
+
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex);
+	void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance);
+
+	// --------------------------------------------------------
+	// Always this device, it is where commands end up
+	// --------------------------------------------------------
+	RenderDevice* GetBackend();
+
+	// --------------------------------------------------------
+	// Get the device context commands are sent to, for code
+	// that has to talk to D3D11 directly
+	// --------------------------------------------------------
+	ID3D11DeviceContext* GetContext();
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+// --------------------------------------------------------
+// A callable reference to a free function or a member function
+// of an object.
+//
+// Stores an object pointer and a stub function pointer, so making,
+// copying and calling a delegate never allocates
+// --------------------------------------------------------
+template <typename Signature>
+class Delegate;
+
+template <typename... Args>
+class Delegate<void(Args...)>
+{
+private:
+	typedef void(*Stub)(void* object, Args... args);
+
+	void* object;
+	Stub stub;
+
+	Delegate(void* object, Stub stub) : object(object), stub(stub) { }
+
+	// --------------------------------------------------------
+	// Call a member function on an object
+	// --------------------------------------------------------
+	template <typename C, void (C::*Method)(Args...)>
+	static void MethodStub(void* object, Args... args)
+	{
+		(static_cast<C*>(object)->*Method)(args...);
+	}
+
+	// --------------------------------------------------------
+	// Call a free function
+	// --------------------------------------------------------
+	template <void(*Function)(Args...)>
+	static void FunctionStub(void* object, Args... args)
+	{
+		Function(args...);
+	}
+
+public:
+	// --------------------------------------------------------
+	// Create an unbound delegate
+	// --------------------------------------------------------
+	Delegate() : object(nullptr), stub(nullptr) { }
+
+	// --------------------------------------------------------
+	// Create a delegate to a member function of an object
+	// --------------------------------------------------------
+	template <typename C, void (C::*Method)(Args...)>
+	static Delegate FromMethod(C* object)
+	{
+		return Delegate(object, &MethodStub<C, Method>);
+	}
+
+	// --------------------------------------------------------
+	// Create a delegate to a free function
+	// --------------------------------------------------------
+	template <void(*Function)(Args...)>
+	static Delegate FromFunction()
+	{
+		return Delegate(nullptr, &FunctionStub<Function>);
+	}
+
+	// --------------------------------------------------------
+	// Check if this delegate points to a function
+	// --------------------------------------------------------
+	bool IsBound() const { return stub != nullptr; }
+
+	// --------------------------------------------------------
+	// Call the function this delegate points to
+	// --------------------------------------------------------
+	void operator()(Args... args) const
+	{
+		stub(object, args...);
+	}
+
+	bool operator==(const Delegate& other) const
+	{
+		return object == other.object && stub == other.stub;
+	}
+
+	bool operator!=(const Delegate& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+// --------------------------------------------------------
+// Deduces the delegate type of a member function pointer
+// --------------------------------------------------------
+template <typename T>
+struct DelegateMethodTraits;
+
+template <typename C, typename... Args>
+struct DelegateMethodTraits<void (C::*)(Args...)>
+{
+	typedef C Class;
+	typedef Delegate<void(Args...)> Type;
+};
+
+// --------------------------------------------------------
+// Create a delegate to a member function of an object
+//
+// Usage: MakeDelegate<&MyClass::MyMethod>(this)
+// --------------------------------------------------------
+template <auto Method, typename T>
+typename DelegateMethodTraits<decltype(Method)>::Type MakeDelegate(T* object)
+{
+	typedef DelegateMethodTraits<decltype(Method)> Traits;
+	return Traits::Type::template FromMethod<typename Traits::Class, Method>(object);
+}
\ No newline at end of file
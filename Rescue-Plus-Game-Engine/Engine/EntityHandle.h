@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+#define INVALID_ENTITY_INDEX UINT32_MAX
+
+// --------------------------------------------------------
+// A handle to a GameObject in the EntityManager.
+//
+// The index points to a slot in the manager and the generation
+// is bumped every time that slot is freed, so a handle to a
+// removed GameObject can always be detected as stale
+// --------------------------------------------------------
+struct EntityHandle
+{
+	uint32_t index;
+	uint32_t generation;
+
+	EntityHandle() : index(INVALID_ENTITY_INDEX), generation(0) { }
+	EntityHandle(uint32_t index, uint32_t generation)
+		: index(index), generation(generation) { }
+
+	// --------------------------------------------------------
+	// Check if this handle was ever assigned to a GameObject
+	// (does not check if the GameObject is still alive)
+	// --------------------------------------------------------
+	bool IsAssigned() const { return index != INVALID_ENTITY_INDEX; }
+
+	bool operator==(const EntityHandle& other) const
+	{
+		return index == other.index && generation == other.generation;
+	}
+
+	bool operator!=(const EntityHandle& other) const
+	{
+		return !(*this == other);
+	}
+};
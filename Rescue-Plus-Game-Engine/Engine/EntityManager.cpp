@@ -1,4 +1,5 @@
 #include "EntityManager.h"
+#include "SpatialIndex.h"
 
 // Releases the entities in the Entity Manager
 void EntityManager::Release()
@@ -7,119 +8,389 @@ void EntityManager::Release()
 	{
 		if (entities[i]) { delete entities[i]; }
 	}
+
+	entities.clear();
+	activeEntityCount = 0;
+	entitySlotIndices.clear();
+	slots.clear();
+	freeSlots.clear();
+	nameMap.clear();
+	remove_entities.clear();
+
+	//Every entity is gone, so readers have nothing left to read
+	transformChangesStart += transformChanges.size();
+	transformChanges.clear();
+	for (uint64_t& position : transformReaders)
+	{
+		if (position != TRANSFORM_READER_FREE)
+			position = transformChangesStart;
+	}
+
+	//All components are gone, so free their pools
+	ComponentManager::GetInstance()->Release();
+	SpatialIndex::GetInstance()->Release();
 }
 
 //Adds an entity to the Entity Manager with a unique ID.
 void EntityManager::AddEntity(GameObject* e)
 {
-	//Check the iterator of the entity
-	if (std::find(entities.begin(), entities.end(), e) != entities.end())
+	//Check if the entity already owns a live slot
+	if (IsValid(e->handle))
 	{
 		printf("Cannot add entity %s because it is already in entity manager", e->GetName().c_str());
 		return;
 	}
 
-	//Add to the list
+	//Reuse a free slot or make a new one
+	uint32_t slotIndex;
+	if (freeSlots.size() > 0)
+	{
+		slotIndex = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = (uint32_t)slots.size();
+		slots.push_back(EntitySlot{ 0, 0, 0 });
+	}
+
+	//Add to the dense list
+	slots[slotIndex].denseIndex = (uint32_t)entities.size();
 	entities.push_back(e);
+	entitySlotIndices.push_back(slotIndex);
+
+	e->handle = EntityHandle(slotIndex, slots[slotIndex].generation);
+	AddToNameIndex(slotIndex, e->nameId);
+
+	//Readers see new entities as changed
+	LogTransformChange(e);
+
+	//Move to the end of the enabled range
+	if (e->GetEnabled())
+	{
+		SwapEntities(slots[slotIndex].denseIndex, (uint32_t)activeEntityCount);
+		activeEntityCount++;
+	}
+}
+
+// Make room for a number of new entities
+void EntityManager::Reserve(size_t amount)
+{
+	entities.reserve(entities.size() + amount);
+	entitySlotIndices.reserve(entitySlotIndices.size() + amount);
+	if (freeSlots.size() < amount)
+		slots.reserve(slots.size() + amount - freeSlots.size());
 }
 
 //Gets an entity from the Entity Manager with a certain name.
-GameObject* EntityManager::GetEntity(std::string id)
+GameObject* EntityManager::GetEntity(const std::string& id)
 {
-	for (auto i = 0; i < entities.size(); i++)
+	auto it = nameMap.find(StringId(id));
+	if (it == nameMap.end())
+		return nullptr;
+
+	//Names that hash the same share a bucket, compare the strings
+	for (uint32_t slotIndex : it->second.slots)
 	{
-		if (entities[i]->GetName() == id) {
-			return entities[i];
+		GameObject* entity = entities[slots[slotIndex].denseIndex];
+		if (entity->GetName() == id)
+			return entity;
+	}
+	return nullptr;
+}
+
+//Gets an entity from the Entity Manager with a hashed name.
+GameObject* EntityManager::GetEntity(StringId id)
+{
+	auto it = nameMap.find(id);
+	if (it == nameMap.end() || it->second.slots.size() < 1)
+		return nullptr;
+
+	//Every entity in the bucket has the same name unless the names collided
+	if (it->second.collided)
+	{
+		printf("Entity names collide on id %u, look the entity up by its name\n", id.id);
+		return nullptr;
+	}
+	return entities[slots[it->second.slots[0]].denseIndex];
+}
+
+// Get an entity by its handle (null if the handle is stale)
+GameObject* EntityManager::GetEntity(EntityHandle handle)
+{
+	if (!IsValid(handle))
+		return nullptr;
+
+	return entities[slots[handle.index].denseIndex];
+}
+
+// Check if a handle still points to a live entity
+bool EntityManager::IsValid(EntityHandle handle)
+{
+	return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+}
+
+// Get the amount of entities in the manager
+size_t EntityManager::GetEntityCount()
+{
+	return entities.size();
+}
+
+// Get the amount of enabled entities in the manager
+size_t EntityManager::GetActiveEntityCount()
+{
+	return activeEntityCount;
+}
+
+// Swap two entities in the dense list
+void EntityManager::SwapEntities(uint32_t a, uint32_t b)
+{
+	if (a == b)
+		return;
+
+	std::swap(entities[a], entities[b]);
+	std::swap(entitySlotIndices[a], entitySlotIndices[b]);
+	slots[entitySlotIndices[a]].denseIndex = a;
+	slots[entitySlotIndices[b]].denseIndex = b;
+}
+
+// Move an entity into the enabled or disabled range
+void EntityManager::SetEntityActive(GameObject* entity, bool active)
+{
+	if (!IsValid(entity->handle))
+		return;
+
+	uint32_t denseIndex = slots[entity->handle.index].denseIndex;
+	if (active && denseIndex >= activeEntityCount)
+	{
+		SwapEntities(denseIndex, (uint32_t)activeEntityCount);
+		activeEntityCount++;
+	}
+	else if (!active && denseIndex < activeEntityCount)
+	{
+		activeEntityCount--;
+		SwapEntities(denseIndex, (uint32_t)activeEntityCount);
+	}
+
+	//Disabled entities are added back to the spatial index in its next sync,
+	// enabling one counts as a transform change so readers pick it up
+	if (!active)
+		SpatialIndex::GetInstance()->Remove(entity);
+	else entity->MarkTransformChanged();
+}
+
+// Start reading the transform change log
+size_t EntityManager::AddTransformReader()
+{
+	//Changes from here on get a newer version, so they are logged
+	ObserveChanges();
+
+	uint64_t end = transformChangesStart + transformChanges.size();
+	transformReaderCount++;
+	for (size_t i = 0; i < transformReaders.size(); i++)
+	{
+		if (transformReaders[i] == TRANSFORM_READER_FREE)
+		{
+			transformReaders[i] = end;
+			return i;
 		}
 	}
 
-	return nullptr;
+	transformReaders.push_back(end);
+	return transformReaders.size() - 1;
+}
+
+// Stop reading the transform change log
+void EntityManager::RemoveTransformReader(size_t reader)
+{
+	transformReaders[reader] = TRANSFORM_READER_FREE;
+	transformReaderCount--;
+	TrimTransformChanges();
+}
+
+// Log an entity's transform change for the readers
+void EntityManager::LogTransformChange(GameObject* entity)
+{
+	//Entities are logged once they are in the manager
+	if (transformReaderCount == 0 || !IsValid(entity->handle))
+		return;
+
+	std::lock_guard<std::mutex> lock(transformChangesLock);
+	transformChanges.push_back(TransformChange{ entity->handle, entity->GetTransformVersion() });
+}
+
+// Drop the transform changes every reader has read
+void EntityManager::TrimTransformChanges()
+{
+	uint64_t read = transformChangesStart + transformChanges.size();
+	for (uint64_t position : transformReaders)
+	{
+		if (position < read)
+			read = position;
+	}
+
+	//Shift the log once at least half of it can go, so dropping stays cheap
+	size_t drop = (size_t)(read - transformChangesStart);
+	if (drop == 0 || drop * 2 < transformChanges.size())
+		return;
+
+	transformChanges.erase(transformChanges.begin(), transformChanges.begin() + drop);
+	transformChangesStart = read;
+}
+
+// Add an entity's slot to the name index
+void EntityManager::AddToNameIndex(uint32_t slotIndex, StringId name)
+{
+	auto inserted = nameMap.emplace(name, NameBucket{ std::vector<uint32_t>(), false });
+	NameBucket& bucket = inserted.first->second;
+
+	//Check the name against the one already in the bucket
+	if (!bucket.collided && bucket.slots.size() > 0)
+	{
+		GameObject* entity = entities[slots[slotIndex].denseIndex];
+		GameObject* other = entities[slots[bucket.slots[0]].denseIndex];
+		if (entity->GetName() != other->GetName())
+		{
+			printf("Entity name id collision between \"%s\" and \"%s\"\n", entity->GetName().c_str(), other->GetName().c_str());
+			bucket.collided = true;
+		}
+	}
+
+	slots[slotIndex].nameIndex = (uint32_t)bucket.slots.size();
+	bucket.slots.push_back(slotIndex);
+}
+
+// Remove an entity's slot from the name index
+void EntityManager::RemoveFromNameIndex(uint32_t slotIndex, StringId name)
+{
+	auto it = nameMap.find(name);
+	if (it == nameMap.end())
+		return;
+
+	//Swap with the last and pop
+	std::vector<uint32_t>& bucket = it->second.slots;
+	uint32_t nameIndex = slots[slotIndex].nameIndex;
+	uint32_t movedSlot = bucket.back();
+	bucket[nameIndex] = movedSlot;
+	slots[movedSlot].nameIndex = nameIndex;
+	bucket.pop_back();
+
+	if (bucket.size() == 0)
+		nameMap.erase(it);
+}
+
+// Move an entity to a new name bucket (called by GameObject::SetName)
+void EntityManager::RenameEntity(GameObject* entity, StringId oldName, StringId newName)
+{
+	if (!IsValid(entity->handle))
+		return;
+
+	RemoveFromNameIndex(entity->handle.index, oldName);
+	AddToNameIndex(entity->handle.index, newName);
 }
 
 // Remove an entity by its object
 void EntityManager::RemoveEntityFromList(GameObject* entity, bool release)
 {
-	GameObject* org = entity;
-	std::vector<GameObject*>::iterator it = std::find(entities.begin(), entities.end(), entity);
+	if (!IsValid(entity->handle))
+		return;
 
-	//Erase entity
-	entities.erase(it);
+	uint32_t slotIndex = entity->handle.index;
+	RemoveFromNameIndex(slotIndex, entity->nameId);
+
+	//Keep the enabled range packed, then swap with the last and pop
+	SetEntityActive(entity, false);
+	SwapEntities(slots[slotIndex].denseIndex, (uint32_t)entities.size() - 1);
+	entities.pop_back();
+	entitySlotIndices.pop_back();
+
+	//Invalidate all handles to this slot and free it
+	slots[slotIndex].generation++;
+	freeSlots.push_back(slotIndex);
+	entity->handle = EntityHandle();
 
 	//Delete instance if user wants to
 	if (release)
-		delete org;
+		delete entity;
 
 	return;
 }
 
 // Remove an entity by its name
-void EntityManager::RemoveEntity(std::string name, bool deleteEntity)
+void EntityManager::RemoveEntity(const std::string& name, bool deleteEntity)
 {
-	for (auto i = 0; i < entities.size(); i++)
+	GameObject* entity = GetEntity(name);
+	if (entity == nullptr)
 	{
-		if (entities[i]->GetName() == name)
-		{
-			entities[i]->SetEnabled(false);
-			remove_entities.push_back(EntityRemoval{ entities[i], deleteEntity });
-			return;
-		}
+		printf("Entity of name %s does not exist in EntityManager. Cannot remove\n", name.c_str());
+		return;
 	}
 
-	printf("Entity of name %s does not exist in EntityManager. Cannot remove\n", name.c_str());
+	entity->SetEnabled(false);
+	remove_entities.push_back(EntityRemoval{ entity->handle, deleteEntity });
 }
 
 // Remove an entity by its object
 void EntityManager::RemoveEntity(GameObject* entity, bool deleteEntity)
 {
-	//Get the iterator of the entity
-	std::vector<GameObject*>::iterator it = std::find(entities.begin(), entities.end(), entity);
-	if (it == entities.end())
+	//Check the entity's handle
+	if (!IsValid(entity->handle))
 	{
 		printf("Cannot remove entity %s because it is not in entity manager\n", entity->GetName().c_str());
 		return;
 	}
 
 	entity->SetEnabled(false);
-	remove_entities.push_back(EntityRemoval{entity, deleteEntity});
+	remove_entities.push_back(EntityRemoval{ entity->handle, deleteEntity });
 	return;
 }
 
-// Run FixedUpdate() for all entities in the manager
-void EntityManager::FixedUpdate(float deltaTime)
+// Remove an entity by its handle
+void EntityManager::RemoveEntity(EntityHandle handle, bool deleteEntity)
 {
-	//Update entities
-	for (size_t i = 0; i < entities.size(); i++)
+	GameObject* entity = GetEntity(handle);
+	if (entity == nullptr)
 	{
-		if (entities[i] && entities[i]->GetEnabled())
-		{
-			entities[i]->FixedUpdate(deltaTime);
-		}
+		printf("Cannot remove entity because its handle is stale\n");
+		return;
 	}
 
-	//Remove entities
+	entity->SetEnabled(false);
+	remove_entities.push_back(EntityRemoval{ handle, deleteEntity });
+}
+
+// Remove all entities queued for removal
+void EntityManager::FlushRemovals()
+{
 	for (size_t i = 0; i < remove_entities.size(); i++)
 	{
-		RemoveEntityFromList(remove_entities[i].e, remove_entities[i].release);
+		//An entity queued more than once is gone after its first removal
+		GameObject* entity = GetEntity(remove_entities[i].handle);
+		if (entity != nullptr)
+			RemoveEntityFromList(entity, remove_entities[i].release);
 	}
 	remove_entities.clear();
 }
 
+// Run FixedUpdate() for all entities in the manager
+void EntityManager::FixedUpdate(float deltaTime)
+{
+	//Update components type by type
+	ComponentManager::GetInstance()->FixedUpdate(deltaTime);
+
+	//Remove entities
+	FlushRemovals();
+}
+
 // Run Update() for all entities in the manager
 void EntityManager::Update(float deltaTime)
 {
-	//Update entities
-	for (size_t i = 0; i < entities.size(); i++)
-	{
-		if (entities[i] && entities[i]->GetEnabled())
-		{
-			entities[i]->Update(deltaTime);
-		}
-	}
+	//Update components type by type
+	ComponentManager::GetInstance()->Update(deltaTime);
 
 	//Remove entities
-	for (size_t i = 0; i < remove_entities.size(); i++)
-	{
-		RemoveEntityFromList(remove_entities[i].e, remove_entities[i].release);
-	}
-	remove_entities.clear();
+	FlushRemovals();
+
+	//Move entities that changed in the spatial index
+	SpatialIndex::GetInstance()->Sync();
 }
\ No newline at end of file
@@ -1,30 +1,147 @@
 #pragma once
 #include <vector>
+#include <unordered_map>
 #include <GameObject.h>
 #include <string>
+#include <mutex>
+#include "EntityHandle.h"
+#include "ComponentManager.h"
 
 struct EntityRemoval {
-	GameObject* e;
+	EntityHandle handle;	//Checked when flushed, so an entity queued twice is removed once
 	bool release;
 };
 
+// --------------------------------------------------------
+// A slot in the entity slot map
+//
+// denseIndex - where the entity lives in the dense entity list
+// nameIndex - where the entity lives in its name bucket
+// generation - bumped every time the slot is freed
+// --------------------------------------------------------
+struct EntitySlot {
+	uint32_t denseIndex;
+	uint32_t nameIndex;
+	uint32_t generation;
+};
+
+// --------------------------------------------------------
+// An entity whose transform changed, and the version it
+// changed on. An entity is logged again every time it changes
+// after a reader observed, so only its newest entry is read
+// --------------------------------------------------------
+struct TransformChange {
+	EntityHandle handle;
+	ChangeVersion version;
+};
+
+//Marks a transform change reader slot that is not in use
+#define TRANSFORM_READER_FREE UINT64_MAX
+
+// --------------------------------------------------------
+// Tag for a GameObject's transform in query filters
+// --------------------------------------------------------
+struct Transform { };
+
+// --------------------------------------------------------
+// Query filter for entities whose T changed since a version
+//
+// Changed<Transform> - the entity's position, rotation or scale
+// Changed<SomeComponent> - the entity's SomeComponent was marked changed
+// --------------------------------------------------------
+template <typename T>
+struct Changed
+{
+	static bool Test(GameObject* entity, ChangeVersion since)
+	{
+		T* component = entity->GetComponent<T>();
+		return component != nullptr && ChangedSince(component->GetChangeVersion(), since);
+	}
+};
+
+template <>
+struct Changed<Transform>
+{
+	static bool Test(GameObject* entity, ChangeVersion since)
+	{
+		return ChangedSince(entity->GetTransformVersion(), since);
+	}
+};
+
 class EntityManager
 {
 private:
 	// --------------------------------------------------------
 	// Singleton Constructor - Set up the singleton instance of the EntityManager
 	// --------------------------------------------------------
-	EntityManager() { }
+	EntityManager() { activeEntityCount = 0; transformChangesStart = 0; transformReaderCount = 0; }
 	~EntityManager() { };
 
-	std::vector<GameObject*> entities;       //A vector of entities
-	std::vector<EntityRemoval> remove_entities;       //A vector of entities
+	//Slot map of entities. Entities are stored densely so updates
+	// are a straight loop, and slots give O(1) handle lookups.
+	// Enabled entities are kept in [0, activeEntityCount)
+	std::vector<GameObject*> entities;			//Dense list of entities
+	size_t activeEntityCount;
+	std::vector<uint32_t> entitySlotIndices;	//Dense index -> slot index
+	std::vector<EntitySlot> slots;				//Slot index -> dense index
+	std::vector<uint32_t> freeSlots;			//Slots that can be reused
+	std::vector<EntityRemoval> remove_entities;	//Entities to remove at the end of the frame
+
+	// --------------------------------------------------------
+	// The slots of entities whose names hash to the same id
+	//
+	// collided - different names share the id, so the id alone
+	//			  can't tell which entity was meant
+	// --------------------------------------------------------
+	struct NameBucket {
+		std::vector<uint32_t> slots;
+		bool collided;
+	};
+
+	//Hashed name index. Names are not unique, so each name maps to
+	// a bucket of slot indices
+	std::unordered_map<StringId, NameBucket> nameMap;
+
+	//Log of entities whose transform changed, for systems that follow
+	// transforms. Readers keep their position in the log, entries
+	// every reader has read are dropped
+	std::vector<TransformChange> transformChanges;
+	uint64_t transformChangesStart;			//Log position of transformChanges[0]
+	std::vector<uint64_t> transformReaders;	//Log position each reader has read up to
+	size_t transformReaderCount;
+	std::mutex transformChangesLock;		//Physics jobs set transforms in parallel
 
 	// --------------------------------------------------------
 	// Remove an entity by its object
 	// --------------------------------------------------------
 	void RemoveEntityFromList(GameObject* entity, bool release);
 
+	// --------------------------------------------------------
+	// Swap two entities in the dense list
+	// --------------------------------------------------------
+	void SwapEntities(uint32_t a, uint32_t b);
+
+	// --------------------------------------------------------
+	// Add an entity's slot to the name index (the entity must
+	// already have its new name)
+	// --------------------------------------------------------
+	void AddToNameIndex(uint32_t slotIndex, StringId name);
+
+	// --------------------------------------------------------
+	// Remove an entity's slot from the name index
+	// --------------------------------------------------------
+	void RemoveFromNameIndex(uint32_t slotIndex, StringId name);
+
+	// --------------------------------------------------------
+	// Remove all entities queued for removal
+	// --------------------------------------------------------
+	void FlushRemovals();
+
+	// --------------------------------------------------------
+	// Drop the transform changes every reader has read
+	// --------------------------------------------------------
+	void TrimTransformChanges();
+
 public:
 
 	// Returns an Entity Manager Instance ---
@@ -52,20 +169,143 @@ public:
 	void AddEntity(GameObject* entity);
 
 	// --------------------------------------------------------
-	// Get an entity by its name
+	// Make room for a number of new entities (used when spawning in bulk)
+	// --------------------------------------------------------
+	void Reserve(size_t amount);
+
+	// --------------------------------------------------------
+	// Get an entity by its name. The id version returns null
+	// if different names share the id, use the string version
+	// for those
+	// --------------------------------------------------------
+	GameObject* GetEntity(const std::string& name);
+	GameObject* GetEntity(StringId name);
+
+	// --------------------------------------------------------
+	// Get an entity by its handle (null if the handle is stale)
+	// --------------------------------------------------------
+	GameObject* GetEntity(EntityHandle handle);
+
+	// --------------------------------------------------------
+	// Check if a handle still points to a live entity
+	// --------------------------------------------------------
+	bool IsValid(EntityHandle handle);
+
+	// --------------------------------------------------------
+	// Get the amount of entities in the manager
+	// --------------------------------------------------------
+	size_t GetEntityCount();
+
+	// --------------------------------------------------------
+	// Get the amount of enabled entities in the manager
+	// --------------------------------------------------------
+	size_t GetActiveEntityCount();
+
+	// --------------------------------------------------------
+	// Run a function on every enabled entity
 	// --------------------------------------------------------
-	GameObject* GetEntity(std::string name);
+	template <typename Func>
+	void ForEachActive(Func func)
+	{
+		for (size_t i = 0; i < activeEntityCount; i++)
+		{
+			func(entities[i]);
+		}
+	}
+
+	// --------------------------------------------------------
+	// Run a function on every entity that passes a filter
+	//
+	// since - the version the caller got from ObserveChanges()
+	//		when it last ran
+	// Usage: ForEach<Changed<Transform>>(lastSeen, [](GameObject* e) { ... });
+	// --------------------------------------------------------
+	template <typename Filter, typename Func>
+	void ForEach(ChangeVersion since, Func func)
+	{
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			if (Filter::Test(entities[i], since))
+				func(entities[i]);
+		}
+	}
+
+	// --------------------------------------------------------
+	// Start reading the transform change log. The reader sees
+	// every entity whose transform changes from now on, earlier
+	// changes have to be picked up by looking at every entity
+	// returns the reader's id
+	// --------------------------------------------------------
+	size_t AddTransformReader();
+
+	// --------------------------------------------------------
+	// Stop reading the transform change log
+	// --------------------------------------------------------
+	void RemoveTransformReader(size_t reader);
+
+	// --------------------------------------------------------
+	// Run a function on every live entity whose transform changed
+	// since a reader last read, once each. Entities changed by
+	// the function are read again next time. Can't be called
+	// while jobs are setting transforms
+	// --------------------------------------------------------
+	template <typename Func>
+	void ReadTransformChanges(size_t reader, Func func)
+	{
+		//Changes made from here on get a newer version and are logged again
+		ObserveChanges();
+
+		for (size_t i = (size_t)(transformReaders[reader] - transformChangesStart); i < transformChanges.size(); i++)
+		{
+			TransformChange change = transformChanges[i];
+			GameObject* entity = GetEntity(change.handle);
+			if (entity != nullptr && entity->GetTransformVersion() == change.version)
+				func(entity);
+		}
+
+		transformReaders[reader] = transformChangesStart + transformChanges.size();
+		TrimTransformChanges();
+	}
+
+	// --------------------------------------------------------
+	// FOR INTERNAL ENGINE USE ONLY
+	//
+	// Log an entity's transform change for the readers
+	// (called by GameObject when its transform version changes)
+	// --------------------------------------------------------
+	void LogTransformChange(GameObject* entity);
 
 	// --------------------------------------------------------
 	// Remove an entity by its name
 	// --------------------------------------------------------
-	void RemoveEntity(std::string name, bool deleteEntity = true);
+	void RemoveEntity(const std::string& name, bool deleteEntity = true);
 
 	// --------------------------------------------------------
 	// Remove an entity by its object
 	// --------------------------------------------------------
 	void RemoveEntity(GameObject* entity, bool deleteEntity = true);
 
+	// --------------------------------------------------------
+	// Remove an entity by its handle
+	// --------------------------------------------------------
+	void RemoveEntity(EntityHandle handle, bool deleteEntity = true);
+
+	// --------------------------------------------------------
+	// FOR INTERNAL ENGINE USE ONLY
+	//
+	// Move an entity to a new name bucket (called by GameObject::SetName
+	// after it sets the new name)
+	// --------------------------------------------------------
+	void RenameEntity(GameObject* entity, StringId oldName, StringId newName);
+
+	// --------------------------------------------------------
+	// FOR INTERNAL ENGINE USE ONLY
+	//
+	// Move an entity into the enabled or disabled range
+	// (called by GameObject::SetEnabled)
+	// --------------------------------------------------------
+	void SetEntityActive(GameObject* entity, bool active);
+
 	// --------------------------------------------------------
 	// Run Update() for all entities in the manager
 	// --------------------------------------------------------
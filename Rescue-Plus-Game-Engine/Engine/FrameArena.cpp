@@ -0,0 +1,137 @@
+#include "FrameArena.h"
+
+//Generations are unique across arenas, so a thread's block
+//can't be mistaken for one of another arena at the same address
+static std::atomic<size_t> nextGeneration(1);
+
+// --------------------------------------------------------
+// The block a thread allocates from
+// --------------------------------------------------------
+struct FrameArenaBlock
+{
+	FrameArena* arena;
+	size_t generation;
+	unsigned char* current;
+	unsigned char* end;
+};
+static thread_local FrameArenaBlock threadBlocks[FRAME_ARENA_THREAD_BLOCKS] = { };
+static thread_local unsigned int nextThreadBlock = 0;
+
+// Get this thread's block for an arena, replacing the oldest if it has none
+static FrameArenaBlock& GetThreadBlock(FrameArena* arena, size_t generation)
+{
+	for (unsigned int i = 0; i < FRAME_ARENA_THREAD_BLOCKS; i++)
+	{
+		//Blocks from before the last reset are gone
+		if (threadBlocks[i].arena == arena)
+		{
+			if (threadBlocks[i].generation != generation)
+				threadBlocks[i] = FrameArenaBlock{ arena, generation, nullptr, nullptr };
+			return threadBlocks[i];
+		}
+	}
+
+	FrameArenaBlock& block = threadBlocks[nextThreadBlock];
+	nextThreadBlock = (nextThreadBlock + 1) % FRAME_ARENA_THREAD_BLOCKS;
+	block = FrameArenaBlock{ arena, generation, nullptr, nullptr };
+	return block;
+}
+
+// Round a pointer up to an alignment
+static inline unsigned char* AlignPointer(unsigned char* pointer, size_t alignment)
+{
+	return (unsigned char*)(((uintptr_t)pointer + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+// Create a frame arena
+FrameArena::FrameArena(size_t capacity)
+{
+	this->capacity = capacity;
+	memory = new unsigned char[capacity];
+	offset = 0;
+	generation = nextGeneration++;
+	overflowSize = 0;
+	grows = 0;
+}
+
+// Free the arena's memory
+FrameArena::~FrameArena()
+{
+	for (unsigned char* block : overflowBlocks)
+		delete[] block;
+	delete[] memory;
+}
+
+// Allocate bytes from the shared offset
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	//Reserve enough to align the start wherever it lands
+	size_t start = offset.fetch_add(size + alignment - 1, std::memory_order_relaxed);
+	if (start + size + alignment - 1 > capacity)
+		return AllocateOverflow(size, alignment);
+	return AlignPointer(memory + start, alignment);
+}
+
+// Allocate bytes from the heap when the memory is used up
+void* FrameArena::AllocateOverflow(size_t size, size_t alignment)
+{
+	unsigned char* block = new unsigned char[size + alignment - 1];
+
+	std::lock_guard<std::mutex> lock(overflowLock);
+	overflowBlocks.push_back(block);
+	overflowSize += size + alignment - 1;
+	return AlignPointer(block, alignment);
+}
+
+// Allocate bytes from this thread's block
+void* FrameArena::AllocateLocal(size_t size, size_t alignment)
+{
+	FrameArenaBlock& block = GetThreadBlock(this, generation);
+
+	unsigned char* start = AlignPointer(block.current, alignment);
+	if (block.current == nullptr || start + size > block.end)
+	{
+		if (size + alignment > FRAME_ARENA_BLOCK_SIZE / 4)
+			return Allocate(size, alignment);
+
+		block.current = (unsigned char*)Allocate(FRAME_ARENA_BLOCK_SIZE, 16);
+		block.end = block.current + FRAME_ARENA_BLOCK_SIZE;
+		start = AlignPointer(block.current, alignment);
+	}
+
+	block.current = start + size;
+	return start;
+}
+
+// Free everything allocated since the last reset
+void FrameArena::Reset()
+{
+	//Grow to fit the last frame, so the next one does not overflow.
+	// Overflowing allocations moved the offset too, so it is the whole frame
+	size_t used = offset.load();
+	if (used > capacity)
+	{
+		size_t newCapacity = capacity * 2;
+		while (newCapacity < used)
+			newCapacity *= 2;
+
+		delete[] memory;
+		memory = new unsigned char[newCapacity];
+		capacity = newCapacity;
+		grows++;
+	}
+
+	for (unsigned char* block : overflowBlocks)
+		delete[] block;
+	overflowBlocks.clear();
+	overflowSize = 0;
+	offset = 0;
+	generation = nextGeneration++;
+}
+
+// Get how much of the arena was used since the last reset
+FrameArenaStats FrameArena::GetStats()
+{
+	size_t used = offset.load();
+	return FrameArenaStats{ used < capacity ? used : capacity, capacity, overflowSize, grows };
+}
\ No newline at end of file
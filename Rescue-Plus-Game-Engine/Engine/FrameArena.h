@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+//Bytes a frame arena starts with
+#define FRAME_ARENA_DEFAULT_SIZE (4 * 1024 * 1024)
+//Bytes each thread takes from an arena at a time, bigger
+// allocations go to the arena directly
+#define FRAME_ARENA_BLOCK_SIZE (64 * 1024)
+//Arenas a thread keeps a block in at once, so a thread that
+// alternates between arenas keeps using its blocks
+#define FRAME_ARENA_THREAD_BLOCKS 4
+
+// --------------------------------------------------------
+// How much of a frame arena was used
+// --------------------------------------------------------
+struct FrameArenaStats
+{
+	size_t used;		//Bytes handed out since the last reset
+	size_t capacity;	//Bytes in the arena's memory
+	size_t overflow;	//Bytes that did not fit and came from the heap
+	size_t grows;		//Times the memory was reallocated to fit a frame
+};
+
+// --------------------------------------------------------
+// An array allocated from a frame arena
+// --------------------------------------------------------
+template <typename T>
+struct FrameArray
+{
+	T* data = nullptr;
+	size_t count = 0;
+
+	T* begin() const { return data; }
+	T* end() const { return data + count; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+};
+
+// --------------------------------------------------------
+// A linear allocator for one frame's transient render data.
+//
+// Allocating moves an offset, and everything is freed at
+// once by Reset(). Each render frame owns an arena, so one
+// frame's data is written while the other frame's is drawn.
+//
+// Parallel producers allocate through AllocateLocal(), which
+// hands out a block per thread and arena, and only touches the
+// shared offset when that block runs out. If a frame needs more
+// than the arena has, the rest comes from the heap and the
+// next reset grows the arena to fit, so a steady state
+// frame never allocates.
+//
+// Nothing allocated here is constructed or destroyed, only
+// trivially copyable data can be kept in an arena
+// --------------------------------------------------------
+class FrameArena
+{
+private:
+	unsigned char* memory;
+	size_t capacity;
+	std::atomic<size_t> offset;
+	size_t generation;		//Changes on reset, thread blocks from before are dropped
+
+	std::mutex overflowLock;
+	std::vector<unsigned char*> overflowBlocks;
+	size_t overflowSize;
+	size_t grows;
+
+	// --------------------------------------------------------
+	// Allocate from the heap when the memory is used up
+	// --------------------------------------------------------
+	void* AllocateOverflow(size_t size, size_t alignment);
+
+public:
+	// --------------------------------------------------------
+	// Create a frame arena
+	//
+	// capacity - bytes it starts with
+	// --------------------------------------------------------
+	FrameArena(size_t capacity = FRAME_ARENA_DEFAULT_SIZE);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// --------------------------------------------------------
+	// Allocate bytes from the shared offset, safe on any thread
+	// --------------------------------------------------------
+	void* Allocate(size_t size, size_t alignment);
+
+	// --------------------------------------------------------
+	// Allocate bytes from this thread's block, safe on any
+	// thread and cheaper than Allocate() for small sizes
+	// --------------------------------------------------------
+	void* AllocateLocal(size_t size, size_t alignment);
+
+	// --------------------------------------------------------
+	// Allocate an array from this thread's block, its elements
+	// are not constructed
+	// --------------------------------------------------------
+	template <typename T>
+	FrameArray<T> AllocateArray(size_t count)
+	{
+		T* data = count > 0 ? (T*)AllocateLocal(sizeof(T) * count, alignof(T)) : nullptr;
+		return FrameArray<T>{ data, count };
+	}
+
+	// --------------------------------------------------------
+	// Free everything allocated since the last reset. Nothing
+	// can allocate from the arena while it resets
+	// --------------------------------------------------------
+	void Reset();
+
+	// --------------------------------------------------------
+	// Get how much of the arena was used since the last reset
+	// --------------------------------------------------------
+	FrameArenaStats GetStats();
+};
\ No newline at end of file
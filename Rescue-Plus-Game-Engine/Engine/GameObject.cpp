@@ -2,6 +2,9 @@
 #include "Renderer.h"
 #include "EntityManager.h"
 #include "RigidBody.h"
+#include "Collider.h"
+#include "SpatialIndex.h"
+#include <algorithm>
 
 // For the DirectX Math library
 using namespace DirectX;
@@ -11,6 +14,8 @@ using namespace std;
 Component::Component(GameObject* gameObject)
 {
 	this->attatchedGameObject = gameObject;
+	this->pool = nullptr;
+	this->changeVersion = CurrentChangeVersion();
 }
 
 //Have to put these here for the Collision definition
@@ -24,9 +29,15 @@ void UserComponent::OnTriggerExit(Collision collision) {}
 
 // Constructor - Set up the gameobject.
 GameObject::GameObject()
+	: GameObject("GameObject")
+{ }
+
+// Constructor - Set up the gameobject.
+GameObject::GameObject(string name)
 {
 	//Set default transformation values
 	parent = nullptr;
+	transformVersion = 0;
 	world = XMFLOAT4X4();
 	position = XMFLOAT3(0, 0, 0);
 	localPosition = XMFLOAT3(0, 0, 0);
@@ -36,26 +47,21 @@ GameObject::GameObject()
 	RebuildWorld();
 
 	enabled = true;
-	name = "GameObject";
+	this->name = name;
+	nameId = StringId(name);
+	spatialId = SPATIAL_INVALID_ID;
 
 	EntityManager::GetInstance()->AddEntity(this);
 }
 
-// Constructor - Set up the gameobject.
-GameObject::GameObject(string name)
-	: GameObject()
-{
-	this->name = name;
-}
-
 // Destructor for when an instance is deleted
 // Destroys all children too
 GameObject::~GameObject()
 { 
-	//Delete all components
+	//Return all components to their pools
 	for (auto c : components)
 	{
-		delete c;
+		ComponentManager::GetInstance()->DestroyComponent(c);
 	}
 }
 
@@ -68,21 +74,85 @@ bool GameObject::GetEnabled()
 // Enable or disable the gameobject
 void GameObject::SetEnabled(bool enabled)
 {
+	if (this->enabled == enabled)
+		return;
 	this->enabled = enabled;
+
+	//Move this and its components between the active and inactive
+	// ranges so disabled objects are never looped over
+	EntityManager::GetInstance()->SetEntityActive(this, enabled);
+	for (auto c : components)
+	{
+		ComponentManager::GetInstance()->SetComponentActive(c, enabled);
+	}
+
+	//Mesh renderers are kept in the renderer's lists too
+	auto iter = lower_bound(componentLookup.begin(), componentLookup.end(), ComponentTypeIdOf<MeshRenderer>,
+		[](const ComponentLookup& lookup, ComponentTypeId id) { return lookup.id < id; });
+	for (; iter != componentLookup.end() && iter->id == ComponentTypeIdOf<MeshRenderer>; iter++)
+	{
+		Renderer::GetInstance()->SetMeshRendererActive(static_cast<MeshRenderer*>(iter->component), enabled);
+	}
+
+	//Disabled objects are taken out of the physics scene, but keep
+	// their actors and shapes so enabling them again doesn't allocate
+	RigidBody* rigidBody = GetComponent<RigidBody>();
+	if (rigidBody != nullptr)
+		rigidBody->SetInScene(enabled);
+
+	//Each static collider has its own actor
+	iter = lower_bound(componentLookup.begin(), componentLookup.end(), ComponentTypeIdOf<Collider>,
+		[](const ComponentLookup& lookup, ComponentTypeId id) { return lookup.id < id; });
+	for (; iter != componentLookup.end() && iter->id == ComponentTypeIdOf<Collider>; iter++)
+	{
+		static_cast<Collider*>(iter->component)->SetInScene(enabled);
+	}
+}
+
+// Get the version the transform last changed on
+ChangeVersion GameObject::GetTransformVersion()
+{
+	return transformVersion;
+}
+
+// Stamp the transform with the current change version and log the first change after a read
+void GameObject::MarkTransformChanged()
+{
+	ChangeVersion version = CurrentChangeVersion();
+	if (transformVersion == version)
+		return;
+
+	transformVersion = version;
+	EntityManager::GetInstance()->LogTransformChange(this);
 }
 
 // Set the name of this gameobject
 void GameObject::SetName(string name)
 {
+	StringId newId(name);
 	this->name = name;
+	EntityManager::GetInstance()->RenameEntity(this, nameId, newId);
+	nameId = newId;
 }
 
 // Get the name of this gameobject
-string GameObject::GetName()
+const string& GameObject::GetName()
 {
 	return name;
 }
 
+// Get the hashed name of this gameobject
+StringId GameObject::GetNameId()
+{
+	return nameId;
+}
+
+// Get the EntityManager handle of this gameobject
+EntityHandle GameObject::GetHandle()
+{
+	return handle;
+}
+
 // Set the parent of this GameObject
 void GameObject::SetParent(GameObject* parent)
 {
@@ -124,7 +194,7 @@ void GameObject::RemoveChild(GameObject* child)
 }
 
 // Get the children of this gameobject
-vector<GameObject*> GameObject::GetChildren()
+const vector<GameObject*>& GameObject::GetChildren()
 {
 	return children;
 }
@@ -137,39 +207,80 @@ void GameObject::AddChild(GameObject* child)
 	children.push_back(child);
 }
 
-// Get lists of all user components that have collision or trigger callbacks
-void GameObject::GetCollisionAndTriggerCallbackComponents(vector<UserComponent*>* cntrlr,
-	vector<UserComponent*>* colEnt, vector<UserComponent*>* colSty, 
-	vector<UserComponent*>* colExt, vector<UserComponent*>* trigEnt, 
-	vector<UserComponent*>* trigSty, vector<UserComponent*>* trigExt)
-{
-	*cntrlr = onControllerCollisionComponents;
-	*colEnt = onCollisionEnterComponents;
-	*colSty = onCollisionStayComponents;
-	*colExt = onCollisionExitComponents;
-	*trigEnt = onTriggerEnterComponents;
-	*trigSty = onTriggerStayComponents;
-	*trigExt = onTriggerExitComponents;
-}
-
-// Update this gameobject's components
-void GameObject::Update(float deltaTime)
-{ 
-	for (auto c : updateComponents)
-	{
-		c->Update(deltaTime);
-	}
+// Add a component to the lookup under a type ID
+void GameObject::RegisterComponentLookup(ComponentTypeId id, Component* component)
+{
+	//Insert after any components with the same ID so the first one added is found first
+	auto iter = upper_bound(componentLookup.begin(), componentLookup.end(), id,
+		[](ComponentTypeId id, const ComponentLookup& lookup) { return id < lookup.id; });
+	componentLookup.insert(iter, ComponentLookup{ id, component });
+}
+
+// Find where the components listed under a type ID start in the lookup
+size_t GameObject::FindComponentIndex(ComponentTypeId id)
+{
+	auto iter = lower_bound(componentLookup.begin(), componentLookup.end(), id,
+		[](const ComponentLookup& lookup, ComponentTypeId id) { return lookup.id < id; });
+	return iter - componentLookup.begin();
+}
+
+// Find the first component listed under a type ID
+Component* GameObject::FindComponent(ComponentTypeId id)
+{
+	size_t index = FindComponentIndex(id);
+	if (index < componentLookup.size() && componentLookup[index].id == id)
+		return componentLookup[index].component;
+
+	return nullptr;
 }
 
-// Update this gameobject's components at the fixed timestep
-void GameObject::FixedUpdate(float deltaTime)
+// Remove a pointer from a component list, keeping the order
+template <typename T>
+static void RemoveFromComponentList(vector<T*>* list, Component* component)
 {
-	for (auto c : fixedUpdateComponents)
+	for (auto iter = list->begin(); iter != list->end(); iter++)
 	{
-		c->FixedUpdate(deltaTime);
+		if (*iter == component)
+		{
+			list->erase(iter);
+			return;
+		}
 	}
 }
 
+// Remove a component from the component list, every callback list and the lookup
+void GameObject::UnregisterComponent(Component* component)
+{
+	RemoveFromComponentList(&components, component);
+	RemoveFromComponentList(&onControllerCollisionComponents, component);
+	RemoveFromComponentList(&onCollisionEnterComponents, component);
+	RemoveFromComponentList(&onCollisionStayComponents, component);
+	RemoveFromComponentList(&onCollisionExitComponents, component);
+	RemoveFromComponentList(&onTriggerEnterComponents, component);
+	RemoveFromComponentList(&onTriggerStayComponents, component);
+	RemoveFromComponentList(&onTriggerExitComponents, component);
+
+	//A component can be listed under more than one type
+	componentLookup.erase(remove_if(componentLookup.begin(), componentLookup.end(),
+		[component](const ComponentLookup& lookup) { return lookup.component == component; }),
+		componentLookup.end());
+}
+
+// Get lists of all user components that have collision or trigger callbacks
+void GameObject::GetCollisionAndTriggerCallbackComponents(const vector<UserComponent*>** cntrlr,
+	const vector<UserComponent*>** colEnt, const vector<UserComponent*>** colSty, 
+	const vector<UserComponent*>** colExt, const vector<UserComponent*>** trigEnt, 
+	const vector<UserComponent*>** trigSty, const vector<UserComponent*>** trigExt)
+{
+	*cntrlr = &onControllerCollisionComponents;
+	*colEnt = &onCollisionEnterComponents;
+	*colSty = &onCollisionStayComponents;
+	*colExt = &onCollisionExitComponents;
+	*trigEnt = &onTriggerEnterComponents;
+	*trigSty = &onTriggerStayComponents;
+	*trigExt = &onTriggerExitComponents;
+}
+
 // Get the world matrix for this GameObject (rebuilding if necessary)
 XMFLOAT4X4 GameObject::GetWorldMatrix()
 {
@@ -223,39 +334,37 @@ void GameObject::RebuildWorld()
 	worldDirty = false;
 }
 
-//TODO: Add removal to the messenger
-
 // Add a listener to onPositionChanged
-void GameObject::AddListenerOnPositionChanged(function<void(DirectX::XMFLOAT3, bool, bool)> function)
+ListenerToken GameObject::AddListenerOnPositionChanged(Delegate<void(XMFLOAT3, bool, bool)> listener)
 {
-	onPositionChanged.AddListener(function);
+	return onPositionChanged.AddListener(listener);
 }
 // Remove a listener from onPositionChanged
-void GameObject::RemoveListenerOnPositionChanged(function<void(DirectX::XMFLOAT3, bool, bool)> function)
+void GameObject::RemoveListenerOnPositionChanged(ListenerToken token)
 {
-	onPositionChanged.RemoveListener(function);
+	onPositionChanged.RemoveListener(token);
 }
 
 // Add a listener to onRotationChanged
-void GameObject::AddListenerOnRotationChanged(function<void(DirectX::XMFLOAT4, bool, bool)> function)
+ListenerToken GameObject::AddListenerOnRotationChanged(Delegate<void(XMFLOAT4, bool, bool)> listener)
 {
-	onRotationChanged.AddListener(function);
+	return onRotationChanged.AddListener(listener);
 }
-// Remove a listener from onScaleChanged
-void GameObject::RemoveListenerOnRotationChanged(function<void(DirectX::XMFLOAT4, bool, bool)> function)
+// Remove a listener from onRotationChanged
+void GameObject::RemoveListenerOnRotationChanged(ListenerToken token)
 {
-	onRotationChanged.RemoveListener(function);
+	onRotationChanged.RemoveListener(token);
 }
 
-// Remove a listener from onRotationChanged
-void GameObject::AddListenerOnScaleChanged(function<void(DirectX::XMFLOAT3)> function)
+// Add a listener to onScaleChanged
+ListenerToken GameObject::AddListenerOnScaleChanged(Delegate<void(XMFLOAT3)> listener)
 {
-	onScaleChanged.AddListener(function);
+	return onScaleChanged.AddListener(listener);
 }
-// Add a listener to onScaleChanged
-void GameObject::RemoveListenerOnScaleChanged(function<void(DirectX::XMFLOAT3)> function)
+// Remove a listener from onScaleChanged
+void GameObject::RemoveListenerOnScaleChanged(ListenerToken token)
 {
-	onScaleChanged.RemoveListener(function);
+	onScaleChanged.RemoveListener(token);
 }
 
 // Get the position for this GameObject
@@ -275,6 +384,7 @@ void GameObject::SetPosition(XMFLOAT3 newPosition, bool setLocal,
 	bool fromParent, bool fromPhysics)
 {
 	worldDirty = true;
+	MarkTransformChanged();
 	position = newPosition;
 
 	//Update the local position
@@ -409,6 +519,7 @@ void GameObject::SetRotation(DirectX::XMFLOAT4 newQuatRotation, bool setLocal,
 	bool fromParent, bool fromPhysics)
 {
 	worldDirty = true;
+	MarkTransformChanged();
 	rotation = newQuatRotation;
 
 	CalculateAxis();
@@ -559,6 +670,7 @@ XMFLOAT3 GameObject::GetScale()
 void GameObject::SetScale(XMFLOAT3 newScale)
 {
 	worldDirty = true;
+	MarkTransformChanged();
 
 	scale = newScale;
 	onScaleChanged.Invoke(scale);
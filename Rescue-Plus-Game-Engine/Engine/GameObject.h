@@ -1,11 +1,14 @@
 #pragma once
 #include <DirectXMath.h>
 #include "Component.h"
+#include "ComponentManager.h"
 #include <vector>
 #include <string>
 #include <type_traits>
 #include "Messenger.hpp"
 #include "MiscHelpers.h"
+#include "EntityHandle.h"
+#include "StringId.h"
 
 // --------------------------------------------------------
 // A GameObject definition.
@@ -15,6 +18,14 @@
 class GameObject
 {
 private:
+	//The EntityManager owns the handle
+	friend class EntityManager;
+	EntityHandle handle;
+
+	//The SpatialIndex owns the id
+	friend class SpatialIndex;
+	uint32_t spatialId;
+
 	//Parenting
 	GameObject* parent;
 	std::vector<GameObject*> children;
@@ -34,20 +45,20 @@ private:
 	DirectX::XMFLOAT4 localRotation;
 	DirectX::XMFLOAT3 scale;
 	bool worldDirty;
+	ChangeVersion transformVersion;
 
 	//Messengers
 	Messenger<DirectX::XMFLOAT3, bool, bool> onPositionChanged;
 	Messenger<DirectX::XMFLOAT4, bool, bool> onRotationChanged;
 	Messenger<DirectX::XMFLOAT3> onScaleChanged;
 
-	//Components
+	//Components. Update and FixedUpdate are run per component
+	// type by the ComponentManager.
 	std::vector<Component*> components;
 	//Make separate lists for components that implement
-	// each overrideable function. This prevents looping
+	// each overrideable callback. This prevents looping
 	// and function calls on components that don't implement
-	// a certain overrideable function
-	std::vector<Component*> updateComponents;
-	std::vector<Component*> fixedUpdateComponents;
+	// a certain overrideable callback
 	std::vector<UserComponent*> onControllerCollisionComponents;
 	std::vector<UserComponent*> onCollisionEnterComponents;
 	std::vector<UserComponent*> onCollisionStayComponents;
@@ -56,6 +67,54 @@ private:
 	std::vector<UserComponent*> onTriggerStayComponents;
 	std::vector<UserComponent*> onTriggerExitComponents;
 
+	//Sorted lookup of components by type ID. A component is
+	// listed under its own type and each class in its LookupBases
+	struct ComponentLookup
+	{
+		ComponentTypeId id;
+		Component* component;
+	};
+	std::vector<ComponentLookup> componentLookup;
+
+	// --------------------------------------------------------
+	// Add a component to the lookup under a type ID
+	// --------------------------------------------------------
+	void RegisterComponentLookup(ComponentTypeId id, Component* component);
+
+	// --------------------------------------------------------
+	// Find where the components listed under a type ID start
+	// in the lookup (its size if there are none)
+	// --------------------------------------------------------
+	size_t FindComponentIndex(ComponentTypeId id);
+
+	// --------------------------------------------------------
+	// Find the first component listed under a type ID
+	// --------------------------------------------------------
+	Component* FindComponent(ComponentTypeId id);
+
+	// --------------------------------------------------------
+	// Stamp the transform with the current change version, and
+	// log it with the EntityManager the first time it changes
+	// after a reader observed
+	// --------------------------------------------------------
+	void MarkTransformChanged();
+
+	// --------------------------------------------------------
+	// Remove a component from the component list, every
+	// callback list and the lookup (does not delete it)
+	// --------------------------------------------------------
+	void UnregisterComponent(Component* component);
+
+	// --------------------------------------------------------
+	// Add a component to the lookup under each of its base types
+	// --------------------------------------------------------
+	template <typename T, typename... Bases>
+	void RegisterComponentBases(T* component, ComponentBaseList<Bases...>)
+	{
+		((std::is_same<T, Bases>::value ? (void)0
+			: RegisterComponentLookup(ComponentTypeIdOf<Bases>, component)), ...);
+	}
+
 	// --------------------------------------------------------
 	// Remove a child from a gameobject
 	// --------------------------------------------------------
@@ -104,6 +163,7 @@ private:
 protected:
 	bool enabled;
 	std::string name;
+	StringId nameId;
 
 public:
 
@@ -137,6 +197,12 @@ public:
 	// --------------------------------------------------------
 	void SetEnabled(bool enabled);
 
+	// --------------------------------------------------------
+	// Get the version the transform (position, rotation
+	// or scale) last changed on
+	// --------------------------------------------------------
+	ChangeVersion GetTransformVersion();
+
 	// --------------------------------------------------------
 	// Set the name of this gameobject
 	// --------------------------------------------------------
@@ -145,7 +211,17 @@ public:
 	// --------------------------------------------------------
 	// Get the name of this gameobject
 	// --------------------------------------------------------
-	std::string GetName();
+	const std::string& GetName();
+
+	// --------------------------------------------------------
+	// Get the hashed name of this gameobject
+	// --------------------------------------------------------
+	StringId GetNameId();
+
+	// --------------------------------------------------------
+	// Get the EntityManager handle of this gameobject
+	// --------------------------------------------------------
+	EntityHandle GetHandle();
 
 	// --------------------------------------------------------
 	// Set the parent of this GameObject
@@ -160,7 +236,7 @@ public:
 	// --------------------------------------------------------
 	// Get the children of this gameobject
 	// --------------------------------------------------------
-	std::vector<GameObject*> GetChildren();
+	const std::vector<GameObject*>& GetChildren();
 
 	// --------------------------------------------------------
 	// Add a component of a specific type (must derive from component)
@@ -170,16 +246,14 @@ public:
 	{
 		static_assert(std::is_base_of<Component, T>::value, "Can't add a component not derived from Component\n");
 		
-		//Push new T
-		T* component = new T(this, args...);
+		//Push new T (allocated from its type's pool, which
+		// also handles Update and FixedUpdate)
+		T* component = ComponentManager::GetInstance()->CreateComponent<T>(this, args...);
 		components.push_back(component);
 
-		//Update and fixed update
-		//if (&Component::Update != &T::Update)
-		if(!std::is_same<decltype(&Component::Update), decltype(&T::Update)>::value)
-			updateComponents.push_back(component);
-		if (!std::is_same<decltype(&Component::FixedUpdate), decltype(&T::FixedUpdate)>::value)
-			fixedUpdateComponents.push_back(component);
+		//Type lookup
+		RegisterComponentLookup(ComponentTypeIdOf<T>, component);
+		RegisterComponentBases(component, typename T::LookupBases());
 
 		//User componenets
 		if constexpr(std::is_base_of<UserComponent, T>())
@@ -211,26 +285,39 @@ public:
 	// --------------------------------------------------------
 	// Get a component of a specific type (must derive from component
 	//		and be in the gameobject's component list)
+	//
+	// Components are found by their exact type or by a base type
+	// listed in their LookupBases. T must declare its own
+	// LookupBases, or components derived from it would not be
+	// found
 	// --------------------------------------------------------
 	template <typename T>
 	T* GetComponent()
 	{
-		static_assert(std::is_base_of<Component, T>::value, "Can't remove a component not derived from Component\n");
+		static_assert(std::is_base_of<Component, T>::value, "Can't get a component not derived from Component\n");
+		static_assert(std::is_same<Component, T>::value || IsLookupComponent<T>,
+			"Can't get a component that does not declare typedef ComponentLookupBases<T, Parent> LookupBases\n");
 
-		//Try to find it
-		for (auto iter = components.begin(); iter != components.end(); iter++)
+		if constexpr (std::is_same<Component, T>::value)
+			return components.size() > 0 ? components[0] : nullptr;
+		else return static_cast<T*>(FindComponent(ComponentTypeIdOf<T>));
+	}
+
+	// --------------------------------------------------------
+	// Run a function on every component of a specific type
+	// (or derived from it) on this gameobject
+	// --------------------------------------------------------
+	template <typename T, typename Func>
+	void ForEachComponent(Func func)
+	{
+		static_assert(IsLookupComponent<T>,
+			"Can't find components that do not declare typedef ComponentLookupBases<T, Parent> LookupBases\n");
+
+		for (size_t i = FindComponentIndex(ComponentTypeIdOf<T>);
+			i < componentLookup.size() && componentLookup[i].id == ComponentTypeIdOf<T>; i++)
 		{
-			try
-			{
-				T* c = dynamic_cast<T*>(*iter); // try to cast
-				if(c)
-					return c;
-			}
-			catch (...)
-			{	}
+			func(static_cast<T*>(componentLookup[i].component));
 		}
-
-		return nullptr;
 	}
 
 	// --------------------------------------------------------
@@ -243,72 +330,31 @@ public:
 		static_assert(std::is_base_of<Component, T>::value, "Can't remove a component not derived from Component\n");
 
 		//Try to find it
-		T* c;
-		bool found = RemoveTypeFromVector(&components, &c);
-		
-		if (found)
+		T* c = GetComponent<T>();
+		if (c)
 		{
-			//Remove update and fixed update
-			if (!std::is_same<decltype(&Component::Update), decltype(&T::Update)>::value)
-				RemoveTypeFromVector(&updateComponents);
-			if (!std::is_same<decltype(&Component::FixedUpdate), decltype(&T::FixedUpdate)>::value)
-				RemoveTypeFromVector(&fixedUpdateComponents);
-
-			//Remove user components
-			if constexpr (std::is_base_of<UserComponent, T>())
-			{
-				//Controller collisions
-				if (!std::is_same<decltype(&UserComponent::OnControllerCollision), decltype(&T::OnControllerCollision)>::value)
-					RemoveTypeFromVector(&onControllerCollisionComponents);
-
-				//Collisions
-				if (!std::is_same<decltype(&UserComponent::OnCollisionEnter), decltype(&T::OnCollisionEnter)>::value)
-					RemoveTypeFromVector(&onCollisionEnterComponents);
-				if (!std::is_same<decltype(&UserComponent::OnCollisionStay), decltype(&T::OnCollisionStay)>::value)
-					RemoveTypeFromVector(&onCollisionStayComponents);
-				if (!std::is_same<decltype(&UserComponent::OnCollisionExit), decltype(&T::OnCollisionExit)>::value)
-					RemoveTypeFromVector(&onCollisionExitComponents);
-
-				//Triggers
-				if (!std::is_same<decltype(&UserComponent::OnTriggerEnter), decltype(&T::OnTriggerEnter)>::value)
-					RemoveTypeFromVector(&onTriggerEnterComponents);
-				if (!std::is_same<decltype(&UserComponent::OnTriggerStay), decltype(&T::OnTriggerStay)>::value)
-					RemoveTypeFromVector(&onTriggerStayComponents);
-				if (!std::is_same<decltype(&UserComponent::OnTriggerExit), decltype(&T::OnTriggerExit)>::value)
-					RemoveTypeFromVector(&onTriggerExitComponents);
-			}
-
-			//Delete
-			delete c;
+			UnregisterComponent(c);
+			ComponentManager::GetInstance()->DestroyComponent(c);
 		}
 #if defined(DEBUG) || defined(_DEBUG)
 		else 
-			printf("Could not find a component of type '%s' in %s\n", typeid(T).name(), name.c_str());
+			printf("Could not find a component to remove in %s\n", name.c_str());
 #endif // DEBUG
 	}
 
 	// --------------------------------------------------------
 	// Get lists of all user components that have collision or
-	// trigger callbacks
+	// trigger callbacks. The lists are not copied, they change
+	// if a callback adds or removes components
 	// --------------------------------------------------------
 	void GetCollisionAndTriggerCallbackComponents(
-		std::vector<UserComponent*>* cntrlr,
-		std::vector<UserComponent*>* colEnt,
-		std::vector<UserComponent*>* colSty,
-		std::vector<UserComponent*>* colExt,
-		std::vector<UserComponent*>* trigEnt,
-		std::vector<UserComponent*>* trigSty,
-		std::vector<UserComponent*>* trigExt);
-
-	// --------------------------------------------------------
-	// Update all componenets in this gameObject
-	// --------------------------------------------------------
-	void Update(float deltaTime);
-
-	// --------------------------------------------------------
-	// Update all componenets in this gameObject
-	// --------------------------------------------------------
-	void FixedUpdate(float deltaTime);
+		const std::vector<UserComponent*>** cntrlr,
+		const std::vector<UserComponent*>** colEnt,
+		const std::vector<UserComponent*>** colSty,
+		const std::vector<UserComponent*>** colExt,
+		const std::vector<UserComponent*>** trigEnt,
+		const std::vector<UserComponent*>** trigSty,
+		const std::vector<UserComponent*>** trigExt);
 
 	// --------------------------------------------------------
 	// Get the world matrix for this GameObject (rebuilding if necessary)
@@ -335,30 +381,36 @@ public:
 
 	// --------------------------------------------------------
 	// Add a listener to onPositionChanged
+	//
+	// Returns a token to remove the listener with
 	// --------------------------------------------------------
-	void AddListenerOnPositionChanged(std::function<void(DirectX::XMFLOAT3, bool, bool)> function);
+	ListenerToken AddListenerOnPositionChanged(Delegate<void(DirectX::XMFLOAT3, bool, bool)> listener);
 	// --------------------------------------------------------
 	// Remove a listener from onPositionChanged
 	// --------------------------------------------------------
-	void RemoveListenerOnPositionChanged(std::function<void(DirectX::XMFLOAT3, bool, bool)> function);
+	void RemoveListenerOnPositionChanged(ListenerToken token);
 
 	// --------------------------------------------------------
 	// Add a listener to onRotationChanged
+	//
+	// Returns a token to remove the listener with
 	// --------------------------------------------------------
-	void AddListenerOnRotationChanged(std::function<void(DirectX::XMFLOAT4, bool, bool)> function);
+	ListenerToken AddListenerOnRotationChanged(Delegate<void(DirectX::XMFLOAT4, bool, bool)> listener);
 	// --------------------------------------------------------
 	// Remove a listener from onRotationChanged
 	// --------------------------------------------------------
-	void RemoveListenerOnRotationChanged(std::function<void(DirectX::XMFLOAT4, bool, bool)> function);
+	void RemoveListenerOnRotationChanged(ListenerToken token);
 
 	// --------------------------------------------------------
 	// Add a listener to onScaleChanged
+	//
+	// Returns a token to remove the listener with
 	// --------------------------------------------------------
-	void AddListenerOnScaleChanged(std::function<void(DirectX::XMFLOAT3)> function);
+	ListenerToken AddListenerOnScaleChanged(Delegate<void(DirectX::XMFLOAT3)> listener);
 	// --------------------------------------------------------
 	// Remove a listener from onScaleChanged
 	// --------------------------------------------------------
-	void RemoveListenerOnScaleChanged(std::function<void(DirectX::XMFLOAT3)> function);
+	void RemoveListenerOnScaleChanged(ListenerToken token);
 
 	// --------------------------------------------------------
 	// Get the position for this GameObject
@@ -24,6 +24,12 @@ static std::atomic_bool workerThreadsActive = true;
 static std::atomic_uint32_t jobsToDeleteCount;
 static Job* jobsToDelete[MAX_JOBS];
 
+//Finished jobs kept for reuse, so running jobs every frame
+// does not allocate once enough jobs exist
+static mutex freeJobLock;
+static Job* freeJobs[MAX_JOBS];
+static unsigned freeJobCount = 0;
+
 //Thread local queue
 thread_local static WorkStealingQueue* workQueue = nullptr;
 
@@ -59,9 +65,18 @@ static bool HasJobCompleted(const Job* job)
 	return job->unfinishedJobs == -1;
 }
 
-// Allocate a new job
+// Allocate a new job (reusing a finished one if there is one)
 static Job* AllocateJob()
 {
+	{
+		lock_guard<mutex> lock(freeJobLock);
+		if (freeJobCount > 0)
+		{
+			Job* job = freeJobs[--freeJobCount];
+			job->continuationCount = 0;
+			return job;
+		}
+	}
 	return new Job();
 }
 
@@ -116,6 +131,7 @@ static void Finish(Job* job)
 	const int32_t unfinishedJobs = --(job->unfinishedJobs);
 	if (unfinishedJobs == 0)
 	{
+		Job* parent = job->parent;
 		const int32_t index = ++jobsToDeleteCount;
 
 		if (index >= MAX_JOBS)
@@ -123,12 +139,15 @@ static void Finish(Job* job)
 
 		jobsToDelete[index - 1] = job;
 
-		if (job->parent)
+		//Mark it completed before finishing the parent. Once a Wait on
+		// it or its parent returns the job can be reused, so it isn't
+		// touched after this
+		job->unfinishedJobs--;
+
+		if (parent)
 		{
-			Finish(job->parent);
+			Finish(parent);
 		}
-
-		job->unfinishedJobs--;
 	}
 }
 
@@ -223,6 +242,11 @@ void JobSystem::Release()
 
 	//Delete all jobs and job queues
 	DeleteFinishedJobs();
+	for (unsigned i = 0; i < freeJobCount; i++)
+	{
+		delete freeJobs[i];
+	}
+	freeJobCount = 0;
 	for (unsigned i = 0; i < workerThreadCount + 1; i++)
 	{
 		if (jobQueues[i])
@@ -275,6 +299,28 @@ Job* JobSystem::CreateJobAsChild(Job* parent, JobFunction function, void* data)
 	return job;
 }
 
+Job* JobSystem::CreateJob(JobFunction function, const void* data, size_t size)
+{
+	Job* job = CreateJob(function);
+	if (size > sizeof(job->data))
+	{
+		throw length_error("Data being passed into thread is too large. Allocate on heap and pass in pointer instead.");
+	}
+	memcpy(job->data, data, size);
+	return job;
+}
+
+Job* JobSystem::CreateJobAsChild(Job* parent, JobFunction function, const void* data, size_t size)
+{
+	Job* job = CreateJobAsChild(parent, function);
+	if (size > sizeof(job->data))
+	{
+		throw length_error("Data being passed into thread is too large. Allocate on heap and pass in pointer instead.");
+	}
+	memcpy(job->data, data, size);
+	return job;
+}
+
 void JobSystem::Run(Job* job)
 {
 	WorkStealingQueue* queue = GetWorkerThreadQueue();
@@ -302,12 +348,16 @@ void JobSystem::Wait(const Job* job)
 
 void JobSystem::DeleteFinishedJobs()
 {
+	lock_guard<mutex> lock(freeJobLock);
 	for(unsigned i = 0; i < jobsToDeleteCount; i++)
 	{
 		Job* job = jobsToDelete[i];
 		if (job)
 		{
-			delete job;
+			//Keep it for the next job
+			if (freeJobCount < MAX_JOBS)
+				freeJobs[freeJobCount++] = job;
+			else delete job;
 			jobsToDelete[i] = nullptr;
 		}
 	}
@@ -26,6 +26,14 @@ public:
 	static Job* CreateJob(JobFunction function, void* data);
 	static Job* CreateJobAsChild(Job* parent, JobFunction function);
 	static Job* CreateJobAsChild(Job* parent, JobFunction function, void* data);
+
+	// --------------------------------------------------------
+	// Create a job and copy size bytes of data into it (the
+	// overloads above only copy a pointer's worth)
+	// --------------------------------------------------------
+	static Job* CreateJob(JobFunction function, const void* data, size_t size);
+	static Job* CreateJobAsChild(Job* parent, JobFunction function, const void* data, size_t size);
+
 	static void Run(Job* job);
 	static void Wait(const Job* job);
 	static void DeleteFinishedJobs();
@@ -15,6 +15,7 @@ void LightManager::Release()
 void LightManager::Init()
 {
 	listDirty = true;
+	lastSyncVersion = 0;
 	ambientLight = new AmbientLightStruct();
 	ambientLight->Color = XMFLOAT3(0, 0, 0);
 	ambientLight->Intensity = 1;
@@ -238,8 +239,11 @@ int LightManager::GetLightAmnt()
 // Get the array of light structs for sending to a shader
 LightStruct* LightManager::GetLightStructArray()
 {
+	//Rebuild when lights were added or removed,
+	// otherwise only copy lights that changed
 	if (listDirty)
 		RebuildLightLists();
+	else SyncChangedLights();
 
 	//return lightStructArray[0];
 	return lightStructArr;
@@ -251,6 +255,7 @@ void LightManager::RebuildLightLists()
 	RebuildLightStructArray();
 	RebuildShadowLightList();
 	listDirty = false;
+	lastSyncVersion = ObserveChanges();
 }
 
 // Rebuild the light struct array from all lights in the lightList
@@ -267,6 +272,22 @@ void LightManager::RebuildLightStructArray()
 	}
 }
 
+// Copy lights that changed since the last sync into the light struct array
+void LightManager::SyncChangedLights()
+{
+	ChangeVersion seen = ObserveChanges();
+	for (size_t i = 0; i < lightList.size(); i++)
+	{
+		Light* light = lightList[i];
+		if (ChangedSince(light->GetChangeVersion(), lastSyncVersion) ||
+			ChangedSince(light->gameObject()->GetTransformVersion(), lastSyncVersion))
+		{
+			lightStructArr[i] = *(light->GetLightStruct());
+		}
+	}
+	lastSyncVersion = seen;
+}
+
 // Set whether this light is in the light manager.
 // THIS FUNCTION CAN ONLY BE ACCESSED BY THE LIGHT MANAGER
 //		IN LightManager.cpp
@@ -276,7 +297,7 @@ void SetInLightManager(Light* light, bool val)
 }
 
 // Get all lights that cast shadows
-std::vector<Light*> LightManager::GetShadowCastingLights()
+const std::vector<Light*>& LightManager::GetShadowCastingLights()
 {
 	if (listDirty)
 		RebuildLightLists();
@@ -26,19 +26,13 @@ private:
 	//Light struct array helpers
 	bool listDirty;
 	LightStruct* lightStructArr;
+	ChangeVersion lastSyncVersion;
 
 	//Shadow descs
 	D3D11_TEXTURE2D_DESC shadowTexDesc;
 	D3D11_DEPTH_STENCIL_VIEW_DESC shadowDSDesc;
 	D3D11_SHADER_RESOURCE_VIEW_DESC shadowSRVDesc;
 
-	// --------------------------------------------------------
-	//Set the light manager's light list to dirty
-	// THIS FRIEND FUNCTION CAN ONLY BE ACCESSED BY THE LIGHT
-	//		IN Lights.cpp
-	// --------------------------------------------------------
-	friend void SetLightListDirty(LightManager* lightManager);
-
 	// --------------------------------------------------------
 	// Rebuild the light struct array and the shadow light list
 	// --------------------------------------------------------
@@ -54,6 +48,12 @@ private:
 	// --------------------------------------------------------
 	void RebuildLightStructArray();
 
+	// --------------------------------------------------------
+	// Copy lights that changed since the last sync into the
+	// light struct array
+	// --------------------------------------------------------
+	void SyncChangedLights();
+
 public:
 	// --------------------------------------------------------
 	// Get the singleton instance of the LightManager
@@ -170,7 +170,7 @@ public:
 	// --------------------------------------------------------
 	// Get all lights that cast shadows
 	// --------------------------------------------------------
-	std::vector<Light*> GetShadowCastingLights();
+	const std::vector<Light*>& GetShadowCastingLights();
 
 	// --------------------------------------------------------
 	// Get the shadow texture description for creating shadowTexs
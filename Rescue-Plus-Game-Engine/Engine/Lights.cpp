@@ -77,8 +77,7 @@ LightType Light::GetType()
 // Set the diffuse color of this light
 void Light::SetColor(XMFLOAT3 color)
 {
-	if (inLightManager)
-		SetLightListDirty(LightManager::GetInstance());
+	MarkChanged();
 
 	lightStruct->Color = color;
 }
@@ -86,8 +85,7 @@ void Light::SetColor(XMFLOAT3 color)
 // Set the diffuse color of this light
 void Light::SetColor(float r, float g, float b)
 {
-	if (inLightManager)
-		SetLightListDirty(LightManager::GetInstance());
+	MarkChanged();
 
 	lightStruct->Color = XMFLOAT3(r, g, b);
 }
@@ -107,8 +105,7 @@ float Light::GetIntensity()
 // Set the intensity for this light
 void Light::SetIntensity(float intensity)
 {
-	if (inLightManager)
-		SetLightListDirty(LightManager::GetInstance());
+	MarkChanged();
 
 	lightStruct->Intensity = intensity;
 }
@@ -261,8 +258,7 @@ PointLight::~PointLight()
 // Set the radius of this light
 void PointLight::SetRadius(float radius)
 {
-	if (inLightManager)
-		SetLightListDirty(LightManager::GetInstance());
+	MarkChanged();
 
 	lightStruct->Range = radius;
 }
@@ -335,8 +331,7 @@ SpotLight::~SpotLight()
 // Set the falloff of this spotlight
 void SpotLight::SetSpotFalloff(float spotFallOff)
 {
-	if (inLightManager)
-		SetLightListDirty(LightManager::GetInstance());
+	MarkChanged();
 
 	lightStruct->SpotFalloff = spotFallOff;
 }
@@ -350,8 +345,7 @@ float SpotLight::GetSpotFalloff()
 // Set the spot radius of this light
 void SpotLight::SetRange(float spotRadius)
 {
-	if (inLightManager)
-		SetLightListDirty(LightManager::GetInstance());
+	MarkChanged();
 
 	lightStruct->Range = spotRadius;
 }
@@ -399,11 +393,4 @@ DirectX::XMFLOAT4X4 SpotLight::GetProjectionMatrix()
 	printf("Spot light shadow maps are not supported (yet)");
 	return shadowProj;
 }
-#pragma endregion
-
-//Set the light manager's light list to dirty
-// THIS FRIEND FUNCTION CAN ONLY BE ACCESSED BY THE LIGHT
-//		IN Lights.cpp
-void SetLightListDirty(LightManager* lightManager) {
-	lightManager->listDirty = true;
-}
\ No newline at end of file
+#pragma endregion
\ No newline at end of file
@@ -74,6 +74,7 @@ protected:
 	virtual void CalculateProjMatrix() = 0;
 
 public:
+	typedef ComponentLookupBases<Light, Component> LookupBases;
 
 	// --------------------------------------------------------
 	// Constructor - Set up a light with default values.
@@ -191,6 +192,8 @@ protected:
 	virtual void CalculateProjMatrix();
 
 public:
+	typedef ComponentLookupBases<DirectionalLight, Light> LookupBases;
+
 	// --------------------------------------------------------
 	// Constructor - Set up a directional light with default values.
 	// --------------------------------------------------------
@@ -244,6 +247,8 @@ protected:
 	virtual void CalculateProjMatrix();
 
 public:
+	typedef ComponentLookupBases<PointLight, Light> LookupBases;
+
 	// --------------------------------------------------------
 	// Constructor - Set up a point light with default values.
 	// --------------------------------------------------------
@@ -303,6 +308,8 @@ protected:
 	virtual void CalculateProjMatrix();
 
 public:
+	typedef ComponentLookupBases<SpotLight, Light> LookupBases;
+
 	// --------------------------------------------------------
 	// Constructor - Set up a spot light with default values.
 	// --------------------------------------------------------
@@ -11,14 +11,14 @@ MAT_Skybox::MAT_Skybox(SimpleVertexShader* vertexShader, SimplePixelShader* pixe
 MAT_Skybox::~MAT_Skybox()
 { }
 
-void MAT_Skybox::PrepareMaterialCombo(GameObject* entityObj, Camera* camera)
+void MAT_Skybox::PrepareMaterialCombo(const RenderFrame& frame)
 {
-	vertexShader->SetMatrix4x4("view", camera->GetViewMatrix());
-	vertexShader->SetMatrix4x4("projection", camera->GetProjectionMatrix());
+	vertexShader->SetMatrix4x4(SID("view"), frame.camera.view);
+	vertexShader->SetMatrix4x4(SID("projection"), frame.camera.projection);
 	vertexShader->CopyAllBufferData();
 	vertexShader->SetShader();
 
-	pixelShader->SetShaderResourceView("Sky", skySRV);
-	pixelShader->SetSamplerState("BasicSampler", sampler);
+	pixelShader->SetShaderResourceView(SID("Sky"), skySRV);
+	pixelShader->SetSamplerState(SID("BasicSampler"), sampler);
 	pixelShader->SetShader();
 }
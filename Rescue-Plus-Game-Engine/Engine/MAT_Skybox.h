@@ -14,8 +14,8 @@ public:
 	// --------------------------------------------------------
 	// Prepare the sky's shader's shader variables
 	// --------------------------------------------------------
-	void PrepareMaterialCombo(GameObject* entityObj, Camera* camera) override;
+	void PrepareMaterialCombo(const RenderFrame& frame) override;
 
-	void PrepareMaterialObject(GameObject* entityObj) override {}
+	void PrepareMaterialObject(const RenderProxy& proxy) override {}
 };
 
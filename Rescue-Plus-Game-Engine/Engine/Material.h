@@ -2,6 +2,7 @@
 #include "SimpleShader.h"
 #include "GameObject.h"
 #include "Camera.h"
+#include "RenderFrame.h"
 
 // --------------------------------------------------------
 // A material definition.
@@ -42,13 +43,17 @@ public:
 
 	// --------------------------------------------------------
 	// Prepare this material's shader's per MatMesh combo variables
+	//
+	// frame - the camera and lights of the frame being drawn
 	// --------------------------------------------------------
-	virtual void PrepareMaterialCombo(GameObject* entityObj, Camera* cam) = 0;
+	virtual void PrepareMaterialCombo(const RenderFrame& frame) = 0;
 
 	// --------------------------------------------------------
 	// Prepare this material's shader's per object variables
+	//
+	// proxy - the object's data in the frame being drawn
 	// --------------------------------------------------------
-	virtual void PrepareMaterialObject(GameObject* entityObj) = 0;
+	virtual void PrepareMaterialObject(const RenderProxy& proxy) = 0;
 	
 	// --------------------------------------------------------
 	// Set the alpha of this material
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <iostream>
 #include <DirectXMath.h>
+#include <cstring>
 
 using namespace DirectX;
 
@@ -12,6 +13,10 @@ Mesh::Mesh(Vertex* vertices, int vertexCount, unsigned* indices, int indexCount,
 	//Initialize
 	vertexBuffer = 0;
 	indexBuffer = 0;
+	this->vertexCount = 0;
+	boundsCenter = XMFLOAT3(0, 0, 0);
+	boundsExtents = XMFLOAT3(0, 0, 0);
+	boundsRadius = 0;
 
 	CreateBuffers(vertices, vertexCount, indices, indexCount, device);
 
@@ -25,6 +30,11 @@ Mesh::Mesh(const char* objFile, ID3D11Device* device)
 	std::ifstream obj(objFile);
 	this->indexBuffer = nullptr;
 	this->vertexBuffer = nullptr;
+	this->indexCount = 0;
+	this->vertexCount = 0;
+	this->boundsCenter = XMFLOAT3(0, 0, 0);
+	this->boundsExtents = XMFLOAT3(0, 0, 0);
+	this->boundsRadius = 0;
 
 	// Check for successful open
 	if (!obj.is_open())
@@ -211,6 +221,8 @@ void Mesh::CreateBuffers(Vertex* vertices, int vertexCount, unsigned* indices, i
 {
 	// Calculate the tangents before copying to buffer
 	CalculateTangents(vertices, vertexCount, indices, indexCount);
+	CalculateBounds(vertices, vertexCount);
+	this->vertexCount = vertexCount;
 
 	// Create the VERTEX BUFFER description -----------------------------------
 	// - The description is created on the stack because we only need
@@ -253,6 +265,32 @@ void Mesh::CreateBuffers(Vertex* vertices, int vertexCount, unsigned* indices, i
 	device->CreateBuffer(&ibd, &initialIndexData, &indexBuffer);
 }
 
+// Calculates the box and sphere around the vertices
+void Mesh::CalculateBounds(Vertex* verts, int numVerts)
+{
+	if (numVerts < 1)
+		return;
+
+	XMVECTOR boxMin = XMLoadFloat3(&verts[0].Position);
+	XMVECTOR boxMax = boxMin;
+	for (int i = 1; i < numVerts; i++)
+	{
+		XMVECTOR pos = XMLoadFloat3(&verts[i].Position);
+		boxMin = XMVectorMin(boxMin, pos);
+		boxMax = XMVectorMax(boxMax, pos);
+	}
+
+	XMVECTOR center = XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f);
+	XMStoreFloat3(&boundsCenter, center);
+	XMStoreFloat3(&boundsExtents, XMVectorSubtract(boxMax, center));
+
+	//Sphere around the box center that holds every vertex
+	XMVECTOR radiusSq = XMVectorZero();
+	for (int i = 0; i < numVerts; i++)
+		radiusSq = XMVectorMax(radiusSq, XMVector3LengthSq(XMVectorSubtract(XMLoadFloat3(&verts[i].Position), center)));
+	boundsRadius = sqrtf(XMVectorGetX(radiusSq));
+}
+
 // Calculates the tangents of the vertices in a mesh
 // Code adapted from: http://www.terathon.com/code/tangent.html
 void Mesh::CalculateTangents(Vertex* verts, int numVerts, unsigned int* indices, int numIndices)
@@ -345,6 +383,70 @@ int Mesh::GetIndexCount()
 	return indexCount;
 }
 
+// Get the number of vertices in this mesh
+int Mesh::GetVertexCount()
+{
+	return vertexCount;
+}
+
+// Copy a GPU buffer into memory through a staging buffer
+static bool ReadBuffer(ID3D11Device* device, ID3D11DeviceContext* context,
+	ID3D11Buffer* buffer, void* dest, size_t size)
+{
+	D3D11_BUFFER_DESC desc;
+	buffer->GetDesc(&desc);
+	desc.Usage = D3D11_USAGE_STAGING;
+	desc.BindFlags = 0;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	desc.MiscFlags = 0;
+
+	ID3D11Buffer* staging = nullptr;
+	if (FAILED(device->CreateBuffer(&desc, 0, &staging)))
+		return false;
+	context->CopyResource(staging, buffer);
+
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	bool read = SUCCEEDED(context->Map(staging, 0, D3D11_MAP_READ, 0, &mapped));
+	if (read)
+	{
+		memcpy(dest, mapped.pData, size);
+		context->Unmap(staging, 0);
+	}
+	staging->Release();
+	return read;
+}
+
+// Copy this mesh's vertices and indices back from the GPU
+bool Mesh::ReadGeometry(ID3D11Device* device, ID3D11DeviceContext* context,
+	std::vector<Vertex>* vertices, std::vector<unsigned>* indices)
+{
+	if (vertexBuffer == nullptr || indexBuffer == nullptr)
+		return false;
+
+	vertices->resize(vertexCount);
+	indices->resize(indexCount);
+	return ReadBuffer(device, context, vertexBuffer, vertices->data(), sizeof(Vertex) * vertexCount) &&
+		ReadBuffer(device, context, indexBuffer, indices->data(), sizeof(unsigned) * indexCount);
+}
+
+// Get the center of this mesh's bounding box
+XMFLOAT3 Mesh::GetBoundsCenter()
+{
+	return boundsCenter;
+}
+
+// Get the half size of this mesh's bounding box
+XMFLOAT3 Mesh::GetBoundsExtents()
+{
+	return boundsExtents;
+}
+
+// Get the radius of the sphere around this mesh
+float Mesh::GetBoundsRadius()
+{
+	return boundsRadius;
+}
+
 bool Mesh::IsMeshLoaded()
 {
 	return (this->indexBuffer != nullptr) && (this->vertexBuffer != nullptr);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <d3d11.h>
+#include <vector>
 #include "Vertex.h"
 
 // --------------------------------------------------------
@@ -14,6 +15,12 @@ private:
 	ID3D11Buffer* vertexBuffer;
 	ID3D11Buffer* indexBuffer;
 	int indexCount;
+	int vertexCount;
+
+	//Local space bounds
+	DirectX::XMFLOAT3 boundsCenter;
+	DirectX::XMFLOAT3 boundsExtents;
+	float boundsRadius;
 
 	// --------------------------------------------------------
 	// Create the vertex and index buffers for the mesh
@@ -25,6 +32,11 @@ private:
 	// --------------------------------------------------------
 	void CalculateTangents(Vertex* verts, int numVerts, unsigned int* indices, int numIndices);
 
+	// --------------------------------------------------------
+	// Calculates the box and sphere around the vertices
+	// --------------------------------------------------------
+	void CalculateBounds(Vertex* verts, int numVerts);
+
 public:
 	// --------------------------------------------------------
 	// Constructor - Set up fields and buffers
@@ -66,6 +78,36 @@ public:
 	// --------------------------------------------------------
 	int GetIndexCount();
 
+	// --------------------------------------------------------
+	// Get the number of vertices in this mesh
+	// --------------------------------------------------------
+	int GetVertexCount();
+
+	// --------------------------------------------------------
+	// Copy this mesh's vertices and indices back from the GPU
+	// (slow, for load time tools like static batching)
+	//
+	// returns false if the buffers could not be read
+	// --------------------------------------------------------
+	bool ReadGeometry(ID3D11Device* device, ID3D11DeviceContext* context,
+		std::vector<Vertex>* vertices, std::vector<unsigned>* indices);
+
+	// --------------------------------------------------------
+	// Get the center of this mesh's bounding box (local space)
+	// --------------------------------------------------------
+	DirectX::XMFLOAT3 GetBoundsCenter();
+
+	// --------------------------------------------------------
+	// Get the half size of this mesh's bounding box
+	// --------------------------------------------------------
+	DirectX::XMFLOAT3 GetBoundsExtents();
+
+	// --------------------------------------------------------
+	// Get the radius of the sphere around this mesh, centered
+	// on the bounding box
+	// --------------------------------------------------------
+	float GetBoundsRadius();
+
 	// --------------------------------------------------------
 	// Check if this mesh is loaded into memory
 	// --------------------------------------------------------
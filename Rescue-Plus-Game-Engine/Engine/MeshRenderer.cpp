@@ -1,6 +1,5 @@
 #include "Renderer.h"
 #include "ResourceManager.h"
-#include <sstream> 
 
 // For the DirectX Math library
 using namespace DirectX;
@@ -11,21 +10,20 @@ MeshRenderer::MeshRenderer(GameObject* gameObject, Mesh* mesh, Material* materia
 {
 	//Defaults if null is passed in
 	if (mesh == nullptr)
-		mesh = ResourceManager::GetInstance()->GetMesh("Assets\\Models\\Basic\\cube.obj");
+		mesh = ResourceManager::GetInstance()->GetMesh(SID("Assets\\Models\\Basic\\cube.obj"));
 	if (material == nullptr)
-		material = ResourceManager::GetInstance()->GetMaterial("white");
+		material = ResourceManager::GetInstance()->GetMaterial(SID("white"));
 
 	this->mesh = mesh;
 	this->material = material;
+	this->renderIndex = 0;
+	this->boundsIndex = 0;
+	this->renderLayer = 0;
+	this->isStatic = false;
+	this->batched = false;
 
-	//Create a unique identifer (combination of the two addresses).
-	//	Used in the renderer
-	const void * addressMat = static_cast<const void*>(material);
-	const void * addressMesh = static_cast<const void*>(mesh);
-	std::stringstream ss;
-	ss << addressMat << addressMesh;
-	std::string temp = ss.str();
-	identifier = ss.str();
+	//Create a unique identifer. Used in the renderer
+	identifier = MakeMatMeshIdentifier(mesh, material);
 
 	Renderer::GetInstance()->AddMeshRenderer(this);
 }
@@ -33,7 +31,9 @@ MeshRenderer::MeshRenderer(GameObject* gameObject, Mesh* mesh, Material* materia
 // Destructor for when an instance is deleted
 MeshRenderer::~MeshRenderer()
 { 
-	Renderer::GetInstance()->RemoveMeshRenderer(this);
+	//Batched renderers were already taken out
+	if (!batched)
+		Renderer::GetInstance()->RemoveMeshRenderer(this);
 }
 
 // Get the material this MeshRenderer uses
@@ -49,7 +49,48 @@ Mesh* MeshRenderer::GetMesh()
 }
 
 // Get the material/mesh identifier
-std::string MeshRenderer::GetMatMeshIdentifier()
+MatMeshIdentifier MeshRenderer::GetMatMeshIdentifier()
 {
 	return identifier;
+}
+
+// Set the layer this MeshRenderer is drawn in
+void MeshRenderer::SetRenderLayer(unsigned int layer)
+{
+	if (layer > 15)
+	{
+		printf("Render layer %u is out of range (0 to 15)\n", layer);
+		layer = 15;
+	}
+	renderLayer = layer;
+}
+
+// Get the layer this MeshRenderer is drawn in
+unsigned int MeshRenderer::GetRenderLayer()
+{
+	return renderLayer;
+}
+
+// Mark this MeshRenderer as never moving
+void MeshRenderer::SetStatic(bool isStatic)
+{
+	this->isStatic = isStatic;
+}
+
+// Check if this MeshRenderer is marked as never moving
+bool MeshRenderer::GetStatic()
+{
+	return isStatic;
+}
+
+// Check if a static batch draws this MeshRenderer instead
+bool MeshRenderer::GetBatched()
+{
+	return batched;
+}
+
+// Make the material/mesh identifier
+MatMeshIdentifier MeshRenderer::MakeMatMeshIdentifier(Mesh* mesh, Material* material)
+{
+	return MatMeshIdentifier{ material, mesh };
 }
\ No newline at end of file
@@ -3,6 +3,36 @@
 #include <DirectXMath.h>
 #include "Mesh.h"
 #include "Material.h"
+#include <functional>
+
+// --------------------------------------------------------
+// The material and mesh pair the renderer groups
+// MeshRenderers by
+// --------------------------------------------------------
+struct MatMeshIdentifier
+{
+	Material* material;
+	Mesh* mesh;
+
+	bool operator==(const MatMeshIdentifier& other) const
+	{
+		return material == other.material && mesh == other.mesh;
+	}
+};
+
+namespace std
+{
+	//Combine the two addresses
+	template<>
+	struct hash<MatMeshIdentifier>
+	{
+		size_t operator()(const MatMeshIdentifier& identifier) const
+		{
+			size_t hash = std::hash<Material*>()(identifier.material);
+			return hash ^ (std::hash<Mesh*>()(identifier.mesh) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+		}
+	};
+}
 
 // --------------------------------------------------------
 // A mesh renderer definition.
@@ -15,9 +45,22 @@ private:
 	//Rendering
 	Mesh* mesh;
 	Material* material;
-	std::string identifier;
+	MatMeshIdentifier identifier;
+	unsigned int renderLayer;
+	bool isStatic;
+
+	//Where this is in the renderer's list
+	friend class Renderer;
+	size_t renderIndex;
+	bool batched;	//Drawn by a static batch instead of on its own
+
+	//Where this is in the renderer's bounds
+	friend class RenderBounds;
+	size_t boundsIndex;
 
 public:
+	typedef ComponentLookupBases<MeshRenderer, Component> LookupBases;
+
 	// --------------------------------------------------------
 	// Constructor - Set up the MeshRenderer.
 	// MeshRenderers are automatically added to the Renderer
@@ -45,5 +88,37 @@ public:
 	// --------------------------------------------------------
 	// Get the material/mesh identifier
 	// --------------------------------------------------------
-	std::string GetMatMeshIdentifier();
+	MatMeshIdentifier GetMatMeshIdentifier();
+
+	// --------------------------------------------------------
+	// Set the layer this is drawn in. Lower layers are drawn
+	// first in each pass (0 to 15, defaults to 0)
+	// --------------------------------------------------------
+	void SetRenderLayer(unsigned int layer);
+
+	// --------------------------------------------------------
+	// Get the layer this is drawn in
+	// --------------------------------------------------------
+	unsigned int GetRenderLayer();
+
+	// --------------------------------------------------------
+	// Mark this as never moving, so static batches can merge
+	// it with others. Set before the batches are built
+	// --------------------------------------------------------
+	void SetStatic(bool isStatic);
+
+	// --------------------------------------------------------
+	// Check if this is marked as never moving
+	// --------------------------------------------------------
+	bool GetStatic();
+
+	// --------------------------------------------------------
+	// Check if a static batch draws this instead
+	// --------------------------------------------------------
+	bool GetBatched();
+
+	// --------------------------------------------------------
+	// Make the material/mesh identifier for a mesh and material
+	// --------------------------------------------------------
+	static MatMeshIdentifier MakeMatMeshIdentifier(Mesh* mesh, Material* material);
 };
\ No newline at end of file
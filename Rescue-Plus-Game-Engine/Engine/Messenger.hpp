@@ -1,41 +1,169 @@
 #pragma once
 #include <vector>
-#include <functional>
+#include <tuple>
+#include <cstdint>
+#include "Delegate.h"
+
+//Listeners stored inside the messenger before it allocates
+#define MESSENGER_INLINE_LISTENERS 4
+#define MESSENGER_INVALID_INDEX UINT32_MAX
+
+// --------------------------------------------------------
+// Returned when adding a listener and used to remove it
+// --------------------------------------------------------
+struct ListenerToken
+{
+	uint32_t index;
+	uint32_t generation;
+
+	ListenerToken() : index(MESSENGER_INVALID_INDEX), generation(0) { }
+	ListenerToken(uint32_t index, uint32_t generation)
+		: index(index), generation(generation) { }
+
+	// --------------------------------------------------------
+	// Check if this token was ever assigned to a listener
+	// --------------------------------------------------------
+	bool IsAssigned() const { return index != MESSENGER_INVALID_INDEX; }
+};
+
+// --------------------------------------------------------
+// How a messenger sends its messages
+//
+// Immediate - listeners are called in Invoke()
+// Deferred - messages are queued in Invoke() and sent in Flush()
+// --------------------------------------------------------
+enum class DispatchMode { Immediate, Deferred };
 
 // --------------------------------------------------------
 // A class for holding and sending messages
+//
+// Listeners are delegates kept in slots. The first few slots
+// live inside the messenger so most messengers never allocate
 // --------------------------------------------------------
 template<typename... Args>
 class Messenger
 {
+public:
+	typedef Delegate<void(Args...)> Listener;
+
 private:
-	std::vector<std::function<void(Args... args)>> actions;
+	struct Slot
+	{
+		Listener listener;
+		uint32_t generation;
+		uint32_t nextFree;
+	};
+
+	Slot inlineSlots[MESSENGER_INLINE_LISTENERS];
+	std::vector<Slot> overflowSlots;
+	uint32_t slotCount;
+	uint32_t freeHead;
+	uint32_t listenerCount;
+
+	//Deferred dispatch
+	DispatchMode mode;
+	std::vector<std::tuple<Args...>> pending;
+	std::vector<std::tuple<Args...>> flushing;
+
+	// --------------------------------------------------------
+	// Get a slot by its index
+	// --------------------------------------------------------
+	Slot& GetSlot(uint32_t index)
+	{
+		if (index < MESSENGER_INLINE_LISTENERS)
+			return inlineSlots[index];
+		return overflowSlots[index - MESSENGER_INLINE_LISTENERS];
+	}
+
+	// --------------------------------------------------------
+	// Call every listener
+	// --------------------------------------------------------
+	void Dispatch(Args... args)
+	{
+		//Listeners added during dispatch are called too
+		for (uint32_t i = 0; i < slotCount; i++)
+		{
+			Slot& slot = GetSlot(i);
+			if (slot.listener.IsBound())
+				slot.listener(args...);
+		}
+	}
 
 public:
+	Messenger()
+	{
+		slotCount = 0;
+		freeHead = MESSENGER_INVALID_INDEX;
+		listenerCount = 0;
+		mode = DispatchMode::Immediate;
+	}
 
 	// --------------------------------------------------------
 	// Add a listiner to this messenger
 	// --------------------------------------------------------
-	void AddListener(std::function<void(Args... args)> function)
+	ListenerToken AddListener(Listener listener)
 	{
-		actions.push_back(function);
+		//Reuse a free slot or make a new one
+		uint32_t index;
+		if (freeHead != MESSENGER_INVALID_INDEX)
+		{
+			index = freeHead;
+			freeHead = GetSlot(index).nextFree;
+		}
+		else
+		{
+			index = slotCount++;
+			if (index >= MESSENGER_INLINE_LISTENERS)
+				overflowSlots.push_back(Slot{ Listener(), 0, MESSENGER_INVALID_INDEX });
+			else inlineSlots[index].generation = 0;
+		}
+
+		Slot& slot = GetSlot(index);
+		slot.listener = listener;
+		slot.nextFree = MESSENGER_INVALID_INDEX;
+		listenerCount++;
+
+		return ListenerToken(index, slot.generation);
 	}
 
 	// --------------------------------------------------------
 	// Remove a listener from this messenger
+	// (stale or unassigned tokens are ignored)
 	// --------------------------------------------------------
-	//TODO: Add removal
-	void RemoveListener(std::function<void(Args... args)> function)
+	void RemoveListener(ListenerToken token)
 	{
-		//for (auto iter = actions.begin(); iter != actions.end(); iter++)
-		//{
-		//	if (*iter == function)
-		//	{
-		//		std::iter_swap(iter, actions.end() - 1);
-		//		actions.pop_back();
-		//		break;
-		//	}
-		//}
+		if (token.index >= slotCount)
+			return;
+
+		Slot& slot = GetSlot(token.index);
+		if (slot.generation != token.generation || !slot.listener.IsBound())
+			return;
+
+		//Safe during dispatch, the slot is skipped once it is unbound
+		slot.listener = Listener();
+		slot.generation++;
+		slot.nextFree = freeHead;
+		freeHead = token.index;
+		listenerCount--;
+	}
+
+	// --------------------------------------------------------
+	// Get the amount of listeners on this messenger
+	// --------------------------------------------------------
+	uint32_t GetListenerCount()
+	{
+		return listenerCount;
+	}
+
+	// --------------------------------------------------------
+	// Set how this messenger sends its messages
+	// (switching to immediate flushes queued messages)
+	// --------------------------------------------------------
+	void SetDispatchMode(DispatchMode mode)
+	{
+		this->mode = mode;
+		if (mode == DispatchMode::Immediate)
+			Flush();
 	}
 
 	// --------------------------------------------------------
@@ -43,9 +171,25 @@ public:
 	// --------------------------------------------------------
 	void Invoke(Args... args)
 	{
-		for (auto iter = actions.begin(); iter != actions.end(); iter++)
+		if (listenerCount == 0)
+			return;
+
+		if (mode == DispatchMode::Deferred)
+			pending.emplace_back(args...);
+		else Dispatch(args...);
+	}
+
+	// --------------------------------------------------------
+	// Send all messages queued in deferred mode
+	// --------------------------------------------------------
+	void Flush()
+	{
+		//Swap so messages sent during the flush are queued for the next one
+		flushing.swap(pending);
+		for (size_t i = 0; i < flushing.size(); i++)
 		{
-			(*iter)(args...);
+			std::apply([this](Args... args) { Dispatch(args...); }, flushing[i]);
 		}
+		flushing.clear();
 	}
 };
\ No newline at end of file
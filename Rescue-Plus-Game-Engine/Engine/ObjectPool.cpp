@@ -0,0 +1,98 @@
+#include "ObjectPool.h"
+#include "EntityManager.h"
+
+using namespace DirectX;
+using namespace std;
+
+// Create a pool for a prefab
+ObjectPool::ObjectPool(Prefab* prefab)
+{
+	this->prefab = prefab;
+	stats = {};
+}
+
+// Create a number of disabled objects up front
+void ObjectPool::Prewarm(size_t count)
+{
+	vector<PrefabTransform> transforms(count, PrefabTransform(XMFLOAT3(0, 0, 0)));
+	vector<GameObject*> objects;
+	prefab->Instantiate(transforms, &objects);
+
+	freeObjects.reserve(freeObjects.size() + count);
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		objects[i]->SetEnabled(false);
+		freeObjects.push_back(objects[i]->GetHandle());
+	}
+	stats.instantiated += count;
+	stats.freeCount = freeObjects.size();
+}
+
+// Get an enabled object at a position
+GameObject* ObjectPool::Acquire(XMFLOAT3 position, XMFLOAT4 rotation)
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+
+	//Reuse a released object (skipping any removed or
+	// enabled by something else while in the pool)
+	while (freeObjects.size() > 0)
+	{
+		GameObject* obj = entityManager->GetEntity(freeObjects.back());
+		freeObjects.pop_back();
+		stats.freeCount = freeObjects.size();
+		if (obj == nullptr || obj->GetEnabled())
+			continue;
+
+		//Move it while disabled so nothing reacts to the jump
+		obj->SetPosition(position);
+		obj->SetRotation(rotation);
+		obj->SetEnabled(true);
+		stats.reused++;
+		return obj;
+	}
+
+	stats.instantiated++;
+	return prefab->Instantiate(position, rotation);
+}
+
+// Disable an object and return it to the pool
+void ObjectPool::Release(GameObject* obj)
+{
+	if (!obj->GetEnabled())
+	{
+		printf("Cannot release %s to the pool because it is already disabled\n", obj->GetName().c_str());
+		return;
+	}
+
+	obj->SetEnabled(false);
+	freeObjects.push_back(obj->GetHandle());
+	stats.released++;
+	stats.freeCount = freeObjects.size();
+}
+
+// Remove every object waiting in the pool from the EntityManager
+void ObjectPool::Clear()
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+	for (size_t i = 0; i < freeObjects.size(); i++)
+	{
+		if (entityManager->IsValid(freeObjects[i]))
+			entityManager->RemoveEntity(freeObjects[i]);
+	}
+	freeObjects.clear();
+	stats.freeCount = 0;
+}
+
+// Get the counters for this pool
+ObjectPoolStats ObjectPool::GetStats()
+{
+	return stats;
+}
+
+// Reset the counters (the free count is kept)
+void ObjectPool::ResetStats()
+{
+	size_t freeCount = stats.freeCount;
+	stats = {};
+	stats.freeCount = freeCount;
+}
\ No newline at end of file
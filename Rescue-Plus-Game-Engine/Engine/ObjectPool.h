@@ -0,0 +1,71 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include "Prefab.h"
+#include "EntityHandle.h"
+
+// --------------------------------------------------------
+// Counters for an object pool
+// --------------------------------------------------------
+struct ObjectPoolStats
+{
+	size_t instantiated;	//Objects created from the prefab (these allocate)
+	size_t reused;			//Acquires served by a released object
+	size_t released;		//Objects returned to the pool
+	size_t freeCount;		//Objects waiting in the pool right now
+};
+
+// --------------------------------------------------------
+// A pool of disabled GameObjects made from a prefab.
+//
+// Released objects are disabled instead of removed, which takes
+// them out of the update lists, the renderer and the physics
+// scene but keeps their components, actors and shapes. Acquiring
+// one moves it and enables it again without allocating
+// --------------------------------------------------------
+class ObjectPool
+{
+private:
+	Prefab* prefab;
+	std::vector<EntityHandle> freeObjects;
+	ObjectPoolStats stats;
+
+public:
+	// --------------------------------------------------------
+	// Create a pool for a prefab (the prefab must outlive the pool)
+	// --------------------------------------------------------
+	ObjectPool(Prefab* prefab);
+
+	// --------------------------------------------------------
+	// Create a number of disabled objects up front
+	// --------------------------------------------------------
+	void Prewarm(size_t count);
+
+	// --------------------------------------------------------
+	// Get an enabled object at a position, reusing a released
+	// one if there is one
+	// --------------------------------------------------------
+	GameObject* Acquire(DirectX::XMFLOAT3 position,
+		DirectX::XMFLOAT4 rotation = DirectX::XMFLOAT4(0, 0, 0, 1));
+
+	// --------------------------------------------------------
+	// Disable an object and return it to the pool
+	// --------------------------------------------------------
+	void Release(GameObject* obj);
+
+	// --------------------------------------------------------
+	// Remove every object waiting in the pool from the EntityManager
+	// (objects that are in use are left alone)
+	// --------------------------------------------------------
+	void Clear();
+
+	// --------------------------------------------------------
+	// Get the counters for this pool
+	// --------------------------------------------------------
+	ObjectPoolStats GetStats();
+
+	// --------------------------------------------------------
+	// Reset the counters (the free count is kept)
+	// --------------------------------------------------------
+	void ResetStats();
+};
\ No newline at end of file
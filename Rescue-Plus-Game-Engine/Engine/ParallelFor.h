@@ -25,19 +25,19 @@ template <typename JobData>
 void parallel_for_job(Job* job, const void* jobData)
 {
 	const JobData* data = static_cast<const JobData*>(jobData);
-	const JobData::SplitterType& splitter = data->splitter;
+	const typename JobData::SplitterType& splitter = data->splitter;
 
-	if (splitter.Split<JobData::DataType>(data->count))
+	if (splitter.template Split<typename JobData::DataType>(data->count))
 	{
 		// split in two
 		const unsigned int leftCount = data->count / 2u;
 		const JobData leftData(data->data, leftCount, data->function, splitter);
-		Job* left = JobSystem::CreateJobAsChild(job, &parallel_for_job<JobData>, (void*)&leftData);
+		Job* left = JobSystem::CreateJobAsChild(job, &parallel_for_job<JobData>, &leftData, sizeof(JobData));
 		JobSystem::Run(left);
 
 		const unsigned int rightCount = data->count - leftCount;
 		const JobData rightData(data->data + leftCount, rightCount, data->function, splitter);
-		Job* right = JobSystem::CreateJobAsChild(job, &parallel_for_job<JobData>, (void*)&rightData);
+		Job* right = JobSystem::CreateJobAsChild(job, &parallel_for_job<JobData>, &rightData, sizeof(JobData));
 		JobSystem::Run(right);
 	}
 	else
@@ -53,8 +53,6 @@ Job* parallel_for(T* data, unsigned int count, void(*function)(T*, unsigned int)
 	typedef parallel_for_job_data<T, S> JobData;
 	const JobData jobData(data, count, function, splitter);
 
-	unsigned long long size = sizeof(JobData);
-
-	Job* job = JobSystem::CreateJob(&parallel_for_job<JobData>, (void*)&jobData);
+	Job* job = JobSystem::CreateJob(&parallel_for_job<JobData>, &jobData, sizeof(JobData));
 	return job;
 }
\ No newline at end of file
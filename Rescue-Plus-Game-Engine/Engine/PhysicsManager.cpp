@@ -316,19 +316,67 @@ float PhysicsManager::GetGravity()
 }
 
 // Add a rigidbody to the sim
-void PhysicsManager::AddActor(PxActor* actor)
+void PhysicsManager::AddActor(PxActor* actor, uint32_t* pendingIndex)
 {
-	if (foundation && scene)
+	//Already queued or in the scene
+	if (*pendingIndex != PHYSICS_NOT_PENDING || actor->getScene() != nullptr)
+		return;
+
+	if (actorBatchDepth > 0)
+	{
+		*pendingIndex = (uint32_t)pendingActors.size();
+		pendingActors.push_back(actor);
+		pendingIndices.push_back(pendingIndex);
+	}
+	else if (foundation && scene)
 		scene->addActor(*actor);
 }
 
 // Remove a rigidbody from the sim
-void PhysicsManager::RemoveActor(PxActor* actor)
+void PhysicsManager::RemoveActor(PxActor* actor, uint32_t* pendingIndex)
 {
-	if (foundation && scene)
+	//Actors still in the batch were never added to the scene,
+	// swap the last one into the hole
+	uint32_t index = *pendingIndex;
+	if (index != PHYSICS_NOT_PENDING)
+	{
+		pendingActors[index] = pendingActors.back();
+		pendingIndices[index] = pendingIndices.back();
+		*pendingIndices[index] = index;
+		pendingActors.pop_back();
+		pendingIndices.pop_back();
+		*pendingIndex = PHYSICS_NOT_PENDING;
+		return;
+	}
+
+	if (foundation && scene && actor->getScene() == scene)
 		scene->removeActor(*actor);
 }
 
+// Start queueing added actors instead of adding them one by one
+void PhysicsManager::BeginActorBatch()
+{
+	actorBatchDepth++;
+}
+
+// Add all queued actors to the scene in one call
+void PhysicsManager::EndActorBatch()
+{
+	if (actorBatchDepth < 1)
+		return;
+
+	actorBatchDepth--;
+	if (actorBatchDepth == 0 && pendingActors.size() > 0)
+	{
+		if (foundation && scene)
+			scene->addActors(pendingActors.data(), (PxU32)pendingActors.size());
+		for (uint32_t* pendingIndex : pendingIndices)
+			*pendingIndex = PHYSICS_NOT_PENDING;
+		pendingActors.clear();
+		pendingIndices.clear();
+	}
+}
+
 // Set the filter data of the controller
 PxQueryFilterData GetQueryFilterData(CollisionLayers layers)
 {
@@ -1,9 +1,13 @@
 #pragma once
 #include <DirectXMath.h>
 #include <limits>
+#include <vector>
 #include "PxSimulationEventCallback.h"
 #include <PxPhysicsAPI.h>
 
+//Pending index of an actor that is not queued in an actor batch
+#define PHYSICS_NOT_PENDING UINT32_MAX
+
 class PhysicsManager : public physx::PxSimulationEventCallback, 
 	public physx::PxUserControllerHitReport,
 	public physx::PxQueryFilterCallback
@@ -17,6 +21,12 @@ private:
 	
 	physx::PxControllerManager* controllerManager;
 
+	//Actors queued between BeginActorBatch and EndActorBatch, and
+	// where each actor's owner keeps its index in the queue
+	std::vector<physx::PxActor*> pendingActors;
+	std::vector<uint32_t*> pendingIndices;
+	int actorBatchDepth;
+
 #ifdef DEBUG_PHYSICS
 	physx::PxPvd* pvd;
 #endif
@@ -24,7 +34,7 @@ private:
 	// --------------------------------------------------------
 	// Singleton Constructor - Set up the singleton instance of the Physics
 	// --------------------------------------------------------
-	PhysicsManager() { Init(); }
+	PhysicsManager() { actorBatchDepth = 0; Init(); }
 	~PhysicsManager() { };
 
 	// --------------------------------------------------------
@@ -104,12 +114,27 @@ public:
 	
 	// --------------------------------------------------------
 	// Add a rigidbody to the sim
+	//
+	// pendingIndex - kept by the actor's owner, the actor's place
+	//		in the batch queue (start it at PHYSICS_NOT_PENDING)
+	// --------------------------------------------------------
+	void AddActor(physx::PxActor* actor, uint32_t* pendingIndex);
+
+	// --------------------------------------------------------
+	// Remove a rigidbody from the sim (ignored if it isn't in it)
+	//
+	// pendingIndex - the index given to AddActor
+	// --------------------------------------------------------
+	void RemoveActor(physx::PxActor* actor, uint32_t* pendingIndex);
+
+	// --------------------------------------------------------
+	// Start queueing added actors instead of adding them one by one
 	// --------------------------------------------------------
-	void AddActor(physx::PxActor* actor);
+	void BeginActorBatch();
 
 	// --------------------------------------------------------
-	// Remove a rigidbody from the sim
+	// Add all queued actors to the scene in one call
 	// --------------------------------------------------------
-	void RemoveActor(physx::PxActor* actor);
+	void EndActorBatch();
 };
 
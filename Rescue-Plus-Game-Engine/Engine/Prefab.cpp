@@ -0,0 +1,72 @@
+#include "Prefab.h"
+#include "EntityManager.h"
+#include "PhysicsManager.h"
+
+using namespace DirectX;
+using namespace std;
+
+// Create a prefab. Instances are named after it
+Prefab::Prefab(string name, XMFLOAT3 scale)
+{
+	this->name = name;
+	this->scale = scale;
+	rigidBodyCount = 0;
+}
+
+// Destroy the prefab (does not affect instances)
+Prefab::~Prefab()
+{
+	for (size_t i = 0; i < components.size(); i++)
+	{
+		delete components[i];
+	}
+	components.clear();
+}
+
+// Create one instance of this prefab for each transform
+void Prefab::Instantiate(const vector<PrefabTransform>& transforms, vector<GameObject*>* outObjects)
+{
+	size_t count = transforms.size();
+	if (count == 0)
+		return;
+
+	//Grow storage once for every instance
+	EntityManager::GetInstance()->Reserve(count);
+	for (size_t i = 0; i < components.size(); i++)
+	{
+		components[i]->Reserve(count);
+	}
+	if (outObjects != nullptr)
+		outObjects->reserve(outObjects->size() + count);
+
+	//Queue actors so they are added to the scene together
+	PhysicsManager* physicsManager = PhysicsManager::GetInstance();
+	physicsManager->BeginActorBatch();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		//Set the transform before any components listen to it
+		GameObject* obj = new GameObject(name);
+		obj->SetPosition(transforms[i].position);
+		obj->SetRotation(transforms[i].rotation);
+		obj->SetScale(scale);
+
+		for (size_t c = 0; c < components.size(); c++)
+		{
+			components[c]->AddTo(obj);
+		}
+
+		if (outObjects != nullptr)
+			outObjects->push_back(obj);
+	}
+
+	physicsManager->EndActorBatch();
+}
+
+// Create one instance of this prefab
+GameObject* Prefab::Instantiate(XMFLOAT3 position, XMFLOAT4 rotation)
+{
+	vector<GameObject*> objects;
+	Instantiate(vector<PrefabTransform>{ PrefabTransform(position, rotation) }, &objects);
+	return objects[0];
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "GameObject.h"
+#include "RigidBody.h"
+#include "Renderer.h"
+
+// --------------------------------------------------------
+// Where to place one instance of a prefab
+// --------------------------------------------------------
+struct PrefabTransform
+{
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT4 rotation;
+
+	PrefabTransform(DirectX::XMFLOAT3 position,
+		DirectX::XMFLOAT4 rotation = DirectX::XMFLOAT4(0, 0, 0, 1))
+		: position(position), rotation(rotation) { }
+};
+
+// --------------------------------------------------------
+// Base class for a component stored in a prefab
+// --------------------------------------------------------
+class PrefabComponentBase
+{
+public:
+	virtual ~PrefabComponentBase() { }
+
+	// --------------------------------------------------------
+	// Reserve pool space for a number of instances
+	// --------------------------------------------------------
+	virtual void Reserve(size_t count) = 0;
+
+	// --------------------------------------------------------
+	// Add this component to an instance
+	// --------------------------------------------------------
+	virtual void AddTo(GameObject* gameObject) = 0;
+};
+
+// --------------------------------------------------------
+// A component type and the arguments to construct it with
+// --------------------------------------------------------
+template <typename T, typename... Args>
+class PrefabComponent : public PrefabComponentBase
+{
+private:
+	std::tuple<Args...> args;
+
+public:
+	PrefabComponent(Args... args) : args(args...) { }
+
+	void Reserve(size_t count) override
+	{
+		ComponentManager::GetInstance()->GetPool<T>()->Reserve(count);
+
+		//Grow the render list the instances will go in
+		if constexpr (std::is_same<MeshRenderer, T>::value)
+		{
+			std::apply([count](Args... args) {
+				Renderer::GetInstance()->ReserveMeshRenderers(args..., count); }, args);
+		}
+	}
+
+	void AddTo(GameObject* gameObject) override
+	{
+		std::apply([gameObject](Args... args) { gameObject->AddComponent<T>(args...); }, args);
+	}
+};
+
+// --------------------------------------------------------
+// A description of a GameObject that can be instantiated
+// many times in one call.
+//
+// Instances are created with their transforms already set,
+// component pools and render lists are grown once up front, and
+// all PhysX actors are added to the scene in one batch at the end
+// --------------------------------------------------------
+class Prefab
+{
+private:
+	std::string name;
+	DirectX::XMFLOAT3 scale;
+	std::vector<PrefabComponentBase*> components;
+
+	//Rigidbodies are added first so colliders attach straight to them
+	// instead of making a static actor that is thrown away
+	size_t rigidBodyCount;
+
+public:
+	// --------------------------------------------------------
+	// Create a prefab. Instances are named after it
+	// --------------------------------------------------------
+	Prefab(std::string name, DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1, 1, 1));
+
+	// --------------------------------------------------------
+	// Destroy the prefab (does not affect instances)
+	// --------------------------------------------------------
+	~Prefab();
+
+	//Delete this
+	Prefab(Prefab const&) = delete;
+	void operator=(Prefab const&) = delete;
+
+	// --------------------------------------------------------
+	// Add a component of a specific type (must derive from component)
+	// Every instance gets one, constructed with these arguments
+	// --------------------------------------------------------
+	template <typename T, typename... Args>
+	void AddComponent(Args... args)
+	{
+		static_assert(std::is_base_of<Component, T>::value, "Can't add a component not derived from Component\n");
+
+		PrefabComponentBase* component = new PrefabComponent<T, Args...>(args...);
+		if constexpr (std::is_same<RigidBody, T>::value)
+			components.insert(components.begin() + rigidBodyCount++, component);
+		else components.push_back(component);
+	}
+
+	// --------------------------------------------------------
+	// Create one instance of this prefab for each transform
+	//
+	// transforms - where to place each instance
+	// outObjects - the created instances (optional output)
+	// --------------------------------------------------------
+	void Instantiate(const std::vector<PrefabTransform>& transforms,
+		std::vector<GameObject*>* outObjects = nullptr);
+
+	// --------------------------------------------------------
+	// Create one instance of this prefab
+	// --------------------------------------------------------
+	GameObject* Instantiate(DirectX::XMFLOAT3 position,
+		DirectX::XMFLOAT4 rotation = DirectX::XMFLOAT4(0, 0, 0, 1));
+};
\ No newline at end of file
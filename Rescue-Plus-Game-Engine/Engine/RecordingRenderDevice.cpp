@@ -0,0 +1,339 @@
+#include "RecordingRenderDevice.h"
+#include <cstdio>
+#include <cstring>
+
+// Create a recording device
+RecordingRenderDevice::RecordingRenderDevice(RenderDevice* target, bool logCommands)
+{
+	this->target = target;
+	this->logCommands = logCommands;
+	ResetState();
+	ResetStats();
+}
+
+// Count a command and log it
+void RecordingRenderDevice::Record(RenderCommandType type, ShaderStage stage, unsigned int value, const void* object)
+{
+	stats.commands++;
+	stats.commandCounts[(size_t)type]++;
+	if (logCommands)
+		commands.push_back(RenderCommand{ type, stage, value, object });
+}
+
+// Count a bind as a state change or a redundant bind
+template <typename T>
+bool RecordingRenderDevice::Bind(T* bound, T value)
+{
+	if (*bound == value)
+	{
+		stats.redundantBinds++;
+		return false;
+	}
+
+	*bound = value;
+	stats.stateChanges++;
+	return true;
+}
+
+// Bind a vertex buffer to slot 0
+void RecordingRenderDevice::SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	Record(RenderCommandType::SetVertexBuffer, ShaderStage::Count, stride, buffer);
+	if (vertexBuffer == buffer && vertexStride == stride && vertexOffset == offset)
+		stats.redundantBinds++;
+	else
+	{
+		vertexBuffer = buffer;
+		vertexStride = stride;
+		vertexOffset = offset;
+		stats.stateChanges++;
+	}
+
+	if (target) target->SetVertexBuffer(buffer, stride, offset);
+}
+
+// Bind an index buffer
+void RecordingRenderDevice::SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format)
+{
+	Record(RenderCommandType::SetIndexBuffer, ShaderStage::Count, (unsigned int)format, buffer);
+	Bind(&indexBuffer, buffer);
+	if (target) target->SetIndexBuffer(buffer, format);
+}
+
+// Copy data into a whole buffer
+void RecordingRenderDevice::UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	Record(RenderCommandType::UpdateBuffer, ShaderStage::Count, (unsigned int)size, buffer);
+	stats.bufferUpdates++;
+	if (target) target->UpdateBuffer(buffer, data, size);
+}
+
+// Bind a per-instance vertex buffer to slot 1
+void RecordingRenderDevice::SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	Record(RenderCommandType::SetInstanceBuffer, ShaderStage::Count, stride, buffer);
+	if (instanceBuffer == buffer && instanceStride == stride && instanceOffset == offset)
+		stats.redundantBinds++;
+	else
+	{
+		instanceBuffer = buffer;
+		instanceStride = stride;
+		instanceOffset = offset;
+		stats.stateChanges++;
+	}
+
+	if (target) target->SetInstanceBuffer(buffer, stride, offset);
+}
+
+// Overwrite the start of a dynamic buffer
+void RecordingRenderDevice::WriteBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	Record(RenderCommandType::WriteBuffer, ShaderStage::Count, (unsigned int)size, buffer);
+	stats.bufferUpdates++;
+	if (target) target->WriteBuffer(buffer, data, size);
+}
+
+// Bind a shader to a stage
+void RecordingRenderDevice::SetShader(ShaderStage stage, RenderShader* shader)
+{
+	Record(RenderCommandType::SetShader, stage, 0, shader);
+	if (Bind(&shaders[(size_t)stage], shader))
+		stats.shaderChanges++;
+	if (target) target->SetShader(stage, shader);
+}
+
+// Bind a constant buffer to a stage
+void RecordingRenderDevice::SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer)
+{
+	Record(RenderCommandType::SetConstantBuffer, stage, slot, buffer);
+	if (slot < RENDER_DEVICE_TRACKED_SLOTS)
+		Bind(&constantBuffers[(size_t)stage][slot], buffer);
+	else stats.stateChanges++;
+	if (target) target->SetConstantBuffer(stage, slot, buffer);
+}
+
+// Bind shader resource views to a stage
+void RecordingRenderDevice::SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs)
+{
+	Record(RenderCommandType::SetShaderResources, stage, startSlot, count == 1 ? srvs[0] : nullptr);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (startSlot + i < RENDER_DEVICE_TRACKED_SLOTS)
+			Bind(&shaderResources[(size_t)stage][startSlot + i], srvs[i]);
+		else stats.stateChanges++;
+	}
+	if (target) target->SetShaderResources(stage, startSlot, count, srvs);
+}
+
+// Bind a sampler to a stage
+void RecordingRenderDevice::SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler)
+{
+	Record(RenderCommandType::SetSampler, stage, slot, sampler);
+	if (slot < RENDER_DEVICE_TRACKED_SLOTS)
+		Bind(&samplers[(size_t)stage][slot], sampler);
+	else stats.stateChanges++;
+	if (target) target->SetSampler(stage, slot, sampler);
+}
+
+// Set the input layout
+void RecordingRenderDevice::SetInputLayout(RenderInputLayout* inputLayout)
+{
+	Record(RenderCommandType::SetInputLayout, ShaderStage::Count, 0, inputLayout);
+	Bind(&this->inputLayout, inputLayout);
+	if (target) target->SetInputLayout(inputLayout);
+}
+
+// Set the primitive topology
+void RecordingRenderDevice::SetPrimitiveTopology(RenderTopology topology)
+{
+	Record(RenderCommandType::SetPrimitiveTopology, ShaderStage::Count, (unsigned int)topology, nullptr);
+	Bind(&this->topology, topology);
+	if (target) target->SetPrimitiveTopology(topology);
+}
+
+// Set the rasterizer state
+void RecordingRenderDevice::SetRasterizerState(RenderRasterizerState* state)
+{
+	Record(RenderCommandType::SetRasterizerState, ShaderStage::Count, 0, state);
+	Bind(&rasterizerState, state);
+	if (target) target->SetRasterizerState(state);
+}
+
+// Set the depth stencil state
+void RecordingRenderDevice::SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef)
+{
+	Record(RenderCommandType::SetDepthStencilState, ShaderStage::Count, stencilRef, state);
+	if (depthStencilState == state && this->stencilRef == stencilRef)
+		stats.redundantBinds++;
+	else
+	{
+		depthStencilState = state;
+		this->stencilRef = stencilRef;
+		stats.stateChanges++;
+	}
+	if (target) target->SetDepthStencilState(state, stencilRef);
+}
+
+// Set the blend state
+void RecordingRenderDevice::SetBlendState(RenderBlendState* state)
+{
+	Record(RenderCommandType::SetBlendState, ShaderStage::Count, 0, state);
+	Bind(&blendState, state);
+	if (target) target->SetBlendState(state);
+}
+
+// Bind a render target and depth buffer
+void RecordingRenderDevice::SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil)
+{
+	Record(RenderCommandType::SetRenderTarget, ShaderStage::Count, 0, target);
+	if (renderTarget == target && this->depthStencil == depthStencil)
+		stats.redundantBinds++;
+	else
+	{
+		renderTarget = target;
+		this->depthStencil = depthStencil;
+		stats.stateChanges++;
+	}
+	if (this->target) this->target->SetRenderTarget(target, depthStencil);
+}
+
+// Set the viewport
+void RecordingRenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	Record(RenderCommandType::SetViewport, ShaderStage::Count, 0, nullptr);
+	if (memcmp(&this->viewport, &viewport, sizeof(RenderViewport)) == 0)
+		stats.redundantBinds++;
+	else
+	{
+		this->viewport = viewport;
+		stats.stateChanges++;
+	}
+	if (target) target->SetViewport(viewport);
+}
+
+// Clear a render target to a color
+void RecordingRenderDevice::ClearRenderTarget(RenderTargetView* target, const float color[4])
+{
+	Record(RenderCommandType::ClearRenderTarget, ShaderStage::Count, 0, target);
+	if (this->target) this->target->ClearRenderTarget(target, color);
+}
+
+// Clear a depth buffer
+void RecordingRenderDevice::ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil)
+{
+	Record(RenderCommandType::ClearDepthStencil, ShaderStage::Count, (unsigned int)clear, depthStencil);
+	if (target) target->ClearDepthStencil(depthStencil, clear, depth, stencil);
+}
+
+// Draw indexed triangles with the bound buffers
+void RecordingRenderDevice::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	Record(RenderCommandType::DrawIndexed, ShaderStage::Count, indexCount, nullptr);
+	stats.drawCalls++;
+	stats.indices += indexCount;
+	stats.instances++;
+	if (target) target->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+// Draw instances of indexed triangles with the bound buffers
+void RecordingRenderDevice::DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	Record(RenderCommandType::DrawIndexedInstanced, ShaderStage::Count, indexCount, nullptr);
+	stats.drawCalls++;
+	stats.indices += (size_t)indexCount * instanceCount;
+	stats.instances += instanceCount;
+	if (target) target->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+// Get the target's backend (null if commands are dropped)
+RenderDevice* RecordingRenderDevice::GetBackend()
+{
+	return target ? target->GetBackend() : nullptr;
+}
+
+// Get the commands recorded since the last reset
+const std::vector<RenderCommand>& RecordingRenderDevice::GetCommands()
+{
+	return commands;
+}
+
+// Get the counters since the last reset
+RenderDeviceStats RecordingRenderDevice::GetStats()
+{
+	return stats;
+}
+
+// Clear the counters and recorded commands
+void RecordingRenderDevice::ResetStats()
+{
+	memset(&stats, 0, sizeof(RenderDeviceStats));
+	commands.clear();
+}
+
+// Forget what is bound
+void RecordingRenderDevice::ResetState()
+{
+	memset(shaders, 0, sizeof(shaders));
+	memset(constantBuffers, 0, sizeof(constantBuffers));
+	memset(shaderResources, 0, sizeof(shaderResources));
+	memset(samplers, 0, sizeof(samplers));
+	vertexBuffer = nullptr;
+	vertexStride = 0;
+	vertexOffset = 0;
+	instanceBuffer = nullptr;
+	instanceStride = 0;
+	instanceOffset = 0;
+	indexBuffer = nullptr;
+	inputLayout = nullptr;
+	topology = RenderTopology::Undefined;
+	rasterizerState = nullptr;
+	depthStencilState = nullptr;
+	stencilRef = 0;
+	blendState = nullptr;
+	renderTarget = nullptr;
+	depthStencil = nullptr;
+	memset(&viewport, 0, sizeof(RenderViewport));
+}
+
+// Print the recorded commands
+void RecordingRenderDevice::PrintCommands()
+{
+	static const char* stageNames[] = { "VS", "PS", "DS", "HS", "GS", "CS", "" };
+
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		const RenderCommand& c = commands[i];
+		printf("%5zu %-22s %s %u %p\n", i, GetCommandName(c.type), stageNames[(size_t)c.stage], c.value, c.object);
+	}
+	printf("%zu commands: %zu draws, %zu state changes, %zu redundant binds, %zu buffer updates\n",
+		stats.commands, stats.drawCalls, stats.stateChanges, stats.redundantBinds, stats.bufferUpdates);
+}
+
+// Get the name of a command type
+const char* RecordingRenderDevice::GetCommandName(RenderCommandType type)
+{
+	switch (type)
+	{
+		case RenderCommandType::SetVertexBuffer: return "SetVertexBuffer";
+		case RenderCommandType::SetIndexBuffer: return "SetIndexBuffer";
+		case RenderCommandType::UpdateBuffer: return "UpdateBuffer";
+		case RenderCommandType::SetShader: return "SetShader";
+		case RenderCommandType::SetConstantBuffer: return "SetConstantBuffer";
+		case RenderCommandType::SetShaderResources: return "SetShaderResources";
+		case RenderCommandType::SetSampler: return "SetSampler";
+		case RenderCommandType::SetInputLayout: return "SetInputLayout";
+		case RenderCommandType::SetPrimitiveTopology: return "SetPrimitiveTopology";
+		case RenderCommandType::SetRasterizerState: return "SetRasterizerState";
+		case RenderCommandType::SetDepthStencilState: return "SetDepthStencilState";
+		case RenderCommandType::SetBlendState: return "SetBlendState";
+		case RenderCommandType::SetRenderTarget: return "SetRenderTarget";
+		case RenderCommandType::SetViewport: return "SetViewport";
+		case RenderCommandType::ClearRenderTarget: return "ClearRenderTarget";
+		case RenderCommandType::ClearDepthStencil: return "ClearDepthStencil";
+		case RenderCommandType::DrawIndexed: return "DrawIndexed";
+		case RenderCommandType::SetInstanceBuffer: return "SetInstanceBuffer";
+		case RenderCommandType::WriteBuffer: return "WriteBuffer";
+		case RenderCommandType::DrawIndexedInstanced: return "DrawIndexedInstanced";
+		default: return "Unknown";
+	}
+}
\ No newline at end of file
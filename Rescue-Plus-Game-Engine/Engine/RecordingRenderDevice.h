@@ -0,0 +1,184 @@
+#pragma once
+#include <vector>
+#include "RenderDevice.h"
+
+//Resource slots per stage that binds are tracked for, binds
+// to higher slots always count as a state change
+#define RENDER_DEVICE_TRACKED_SLOTS 16
+
+// --------------------------------------------------------
+// Kinds of render commands
+// --------------------------------------------------------
+enum class RenderCommandType
+{
+	SetVertexBuffer,
+	SetIndexBuffer,
+	UpdateBuffer,
+	SetShader,
+	SetConstantBuffer,
+	SetShaderResources,
+	SetSampler,
+	SetInputLayout,
+	SetPrimitiveTopology,
+	SetRasterizerState,
+	SetDepthStencilState,
+	SetBlendState,
+	SetRenderTarget,
+	SetViewport,
+	ClearRenderTarget,
+	ClearDepthStencil,
+	DrawIndexed,
+	SetInstanceBuffer,
+	WriteBuffer,
+	DrawIndexedInstanced,
+	Count
+};
+
+// --------------------------------------------------------
+// A recorded render command
+// --------------------------------------------------------
+struct RenderCommand
+{
+	RenderCommandType type;
+	ShaderStage stage;	//For shader commands
+	unsigned int value;			//Slot for binds, index count for draws
+	const void* object;	//What was bound or cleared
+};
+
+// --------------------------------------------------------
+// Counters for recorded render commands
+// --------------------------------------------------------
+struct RenderDeviceStats
+{
+	size_t commands;		//Every command sent
+	size_t drawCalls;
+	size_t indices;			//Indices drawn (over every instance)
+	size_t instances;		//Instances drawn (1 per non-instanced draw)
+	size_t bufferUpdates;
+	size_t stateChanges;	//Binds that changed what was bound
+	size_t redundantBinds;	//Binds of what was already bound
+	size_t shaderChanges;	//State changes that were shaders
+	size_t commandCounts[(size_t)RenderCommandType::Count];
+};
+
+// --------------------------------------------------------
+// Records render commands and counts them.
+//
+// Commands can be forwarded to another device to count what a
+// real frame does, or dropped to run the renderer without a
+// GPU (the null backend). Binds are compared against what is
+// already bound to count real state changes.
+// --------------------------------------------------------
+class RecordingRenderDevice : public RenderDevice
+{
+private:
+	RenderDevice* target;
+	bool logCommands;
+	std::vector<RenderCommand> commands;
+	RenderDeviceStats stats;
+
+	//What is bound right now
+	RenderShader* shaders[(size_t)ShaderStage::Count];
+	RenderBuffer* constantBuffers[(size_t)ShaderStage::Count][RENDER_DEVICE_TRACKED_SLOTS];
+	RenderShaderResource* shaderResources[(size_t)ShaderStage::Count][RENDER_DEVICE_TRACKED_SLOTS];
+	RenderSampler* samplers[(size_t)ShaderStage::Count][RENDER_DEVICE_TRACKED_SLOTS];
+	RenderBuffer* vertexBuffer;
+	unsigned int vertexStride;
+	unsigned int vertexOffset;
+	RenderBuffer* instanceBuffer;
+	unsigned int instanceStride;
+	unsigned int instanceOffset;
+	RenderBuffer* indexBuffer;
+	RenderInputLayout* inputLayout;
+	RenderTopology topology;
+	RenderRasterizerState* rasterizerState;
+	RenderDepthStencilState* depthStencilState;
+	unsigned int stencilRef;
+	RenderBlendState* blendState;
+	RenderTargetView* renderTarget;
+	RenderDepthStencilView* depthStencil;
+	RenderViewport viewport;
+
+	// --------------------------------------------------------
+	// Count a command and log it
+	// --------------------------------------------------------
+	void Record(RenderCommandType type, ShaderStage stage, unsigned int value, const void* object);
+
+	// --------------------------------------------------------
+	// Count a bind as a state change or a redundant bind
+	// returns true if it changed the state
+	// --------------------------------------------------------
+	template <typename T>
+	bool Bind(T* bound, T value);
+
+public:
+	// --------------------------------------------------------
+	// Create a recording device
+	//
+	// target - device to forward commands to (null drops them)
+	// logCommands - keep every command for GetCommands()
+	// --------------------------------------------------------
+	RecordingRenderDevice(RenderDevice* target = nullptr, bool logCommands = true);
+
+	void SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format);
+	void UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size);
+	void SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void WriteBuffer(RenderBuffer* buffer, const void* data, size_t size);
+
+	void SetShader(ShaderStage stage, RenderShader* shader);
+	void SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer);
+	void SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs);
+	void SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler);
+
+	void SetInputLayout(RenderInputLayout* inputLayout);
+	void SetPrimitiveTopology(RenderTopology topology);
+	void SetRasterizerState(RenderRasterizerState* state);
+	void SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef);
+	void SetBlendState(RenderBlendState* state);
+
+	void SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil);
+	void SetViewport(const RenderViewport& viewport);
+	void ClearRenderTarget(RenderTargetView* target, const float color[4]);
+	void ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil);
+
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex);
+	void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance);
+
+	// --------------------------------------------------------
+	// Get the target's backend (null if commands are dropped)
+	// --------------------------------------------------------
+	RenderDevice* GetBackend();
+
+	// --------------------------------------------------------
+	// Get the commands recorded since the last reset
+	// --------------------------------------------------------
+	const std::vector<RenderCommand>& GetCommands();
+
+	// --------------------------------------------------------
+	// Get the counters since the last reset
+	// --------------------------------------------------------
+	RenderDeviceStats GetStats();
+
+	// --------------------------------------------------------
+	// Clear the counters and recorded commands. What is bound
+	// is kept, like a real device between frames
+	// --------------------------------------------------------
+	void ResetStats();
+
+	// --------------------------------------------------------
+	// Forget what is bound (the next bind of anything counts
+	// as a state change)
+	// --------------------------------------------------------
+	void ResetState();
+
+	// --------------------------------------------------------
+	// Print the recorded commands
+	// --------------------------------------------------------
+	void PrintCommands();
+
+	// --------------------------------------------------------
+	// Get the name of a command type
+	// --------------------------------------------------------
+	static const char* GetCommandName(RenderCommandType type);
+};
\ No newline at end of file
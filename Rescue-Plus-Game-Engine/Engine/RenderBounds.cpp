@@ -0,0 +1,235 @@
+#include "RenderBounds.h"
+#include <emmintrin.h>
+#include <cmath>
+#include <cstdio>
+#include "MeshRenderer.h"
+#include "EntityManager.h"
+#include "ParallelFor.h"
+
+// For the DirectX Math library
+using namespace DirectX;
+
+// Test four spheres at a time against the frustums of a set of chunks
+static void CullChunks(RenderBoundsCullChunk* chunks, unsigned int count)
+{
+	for (unsigned int c = 0; c < count; c++)
+	{
+		RenderBoundsCullChunk& chunk = chunks[c];
+		for (size_t i = chunk.begin; i < chunk.end; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(chunk.centerX + i);
+			__m128 y = _mm_loadu_ps(chunk.centerY + i);
+			__m128 z = _mm_loadu_ps(chunk.centerZ + i);
+			__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(chunk.radius + i));
+
+			uint32_t bits[4] = { 0, 0, 0, 0 };
+			for (size_t f = 0; f < chunk.frustumCount; f++)
+			{
+				//Inside while no plane has the sphere fully behind it
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				const XMFLOAT4* planes = chunk.planes + f * 6;
+				for (int p = 0; p < 6; p++)
+				{
+					__m128 dist = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p].x)), _mm_mul_ps(y, _mm_set1_ps(planes[p].y))),
+						_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negRadius));
+				}
+
+				int mask = _mm_movemask_ps(inside);
+				for (int lane = 0; lane < 4; lane++)
+					bits[lane] |= (uint32_t)((mask >> lane) & 1) << f;
+			}
+
+			chunk.visibility[i] = bits[0];
+			chunk.visibility[i + 1] = bits[1];
+			chunk.visibility[i + 2] = bits[2];
+			chunk.visibility[i + 3] = bits[3];
+		}
+	}
+}
+
+// Constructor
+RenderBounds::RenderBounds()
+{
+	count = 0;
+	readingChanges = false;
+	changeReader = 0;
+}
+
+// Resize the arrays to hold the bounds (and padding)
+void RenderBounds::Resize()
+{
+	size_t padded = (count + 3) & ~(size_t)3;
+	centerX.resize(padded, 0);
+	centerY.resize(padded, 0);
+	centerZ.resize(padded, 0);
+	radius.resize(padded, 0);
+	visibility.resize(padded, 0);
+}
+
+// Recalculate a world sphere from its mesh and transform
+void RenderBounds::Calculate(size_t index)
+{
+	MeshRenderer* mr = owners[index];
+	Mesh* mesh = mr->GetMesh();
+	XMFLOAT4X4 world = mr->gameObject()->GetRawWorldMatrix();
+	XMMATRIX worldMat = XMLoadFloat4x4(&world);
+
+	XMFLOAT3 localCenter = mesh->GetBoundsCenter();
+	XMFLOAT3 center;
+	XMStoreFloat3(&center, XMVector3TransformCoord(XMLoadFloat3(&localCenter), worldMat));
+
+	//The longest axis of the world matrix scales the radius
+	float scaleSq = 0;
+	for (int r = 0; r < 3; r++)
+	{
+		float lengthSq = world.m[r][0] * world.m[r][0] + world.m[r][1] * world.m[r][1] + world.m[r][2] * world.m[r][2];
+		if (lengthSq > scaleSq)
+			scaleSq = lengthSq;
+	}
+
+	centerX[index] = center.x;
+	centerY[index] = center.y;
+	centerZ[index] = center.z;
+	radius[index] = mesh->GetBoundsRadius() * sqrtf(scaleSq);
+}
+
+// Add a mesh renderer's bounds
+void RenderBounds::Add(MeshRenderer* mr)
+{
+	mr->boundsIndex = count;
+	owners.push_back(mr);
+	count++;
+	Resize();
+	Calculate(mr->boundsIndex);
+}
+
+// Remove a mesh renderer's bounds
+void RenderBounds::Remove(MeshRenderer* mr)
+{
+	size_t index = mr->boundsIndex;
+	if (index >= count || owners[index] != mr)
+	{
+		printf("Tried to remove bounds that are not in the render bounds\n");
+		return;
+	}
+
+	//Move the last bounds into the hole
+	size_t last = count - 1;
+	if (index != last)
+	{
+		owners[index] = owners[last];
+		owners[index]->boundsIndex = index;
+		centerX[index] = centerX[last];
+		centerY[index] = centerY[last];
+		centerZ[index] = centerZ[last];
+		radius[index] = radius[last];
+		visibility[index] = visibility[last];
+	}
+
+	owners.pop_back();
+	count--;
+	Resize();
+
+	//Clear the padding so culling never reads stale spheres
+	if (last < centerX.size())
+	{
+		centerX[last] = centerY[last] = centerZ[last] = 0;
+		radius[last] = 0;
+	}
+}
+
+// Recalculate the bounds of renderers that moved since the last sync
+void RenderBounds::Sync()
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+
+	//Renderers could have moved before the log was read
+	if (!readingChanges)
+	{
+		changeReader = entityManager->AddTransformReader();
+		readingChanges = true;
+		for (size_t i = 0; i < count; i++)
+			Calculate(i);
+		return;
+	}
+
+	entityManager->ReadTransformChanges(changeReader, [this](GameObject* obj) {
+		obj->ForEachComponent<MeshRenderer>([this](MeshRenderer* mr) {
+			//Disabled renderers are recalculated when they are added back
+			size_t index = mr->boundsIndex;
+			if (index < count && owners[index] == mr)
+				Calculate(index);
+		});
+	});
+}
+
+// Test every sphere against a set of frustums
+void RenderBounds::Cull(const Frustum* frustums, size_t frustumCount)
+{
+	if (frustumCount > RENDER_BOUNDS_MAX_FRUSTUMS)
+	{
+		printf("Can only cull against %d frustums at once\n", RENDER_BOUNDS_MAX_FRUSTUMS);
+		frustumCount = RENDER_BOUNDS_MAX_FRUSTUMS;
+	}
+	if (count == 0)
+		return;
+
+	cullPlanes.resize(frustumCount * 6);
+	for (size_t f = 0; f < frustumCount; f++)
+	{
+		for (int p = 0; p < 6; p++)
+			cullPlanes[f * 6 + p] = frustums[f].planes[p];
+	}
+
+	//Split into chunks for the jobs
+	size_t padded = centerX.size();
+	size_t chunkCount = 1;
+	if (padded >= RENDER_BOUNDS_PARALLEL_SIZE)
+		chunkCount = (padded + RENDER_BOUNDS_CHUNK_SIZE - 1) / RENDER_BOUNDS_CHUNK_SIZE;
+	cullChunks.resize(chunkCount);
+	for (size_t c = 0; c < chunkCount; c++)
+	{
+		RenderBoundsCullChunk& chunk = cullChunks[c];
+		chunk.centerX = centerX.data();
+		chunk.centerY = centerY.data();
+		chunk.centerZ = centerZ.data();
+		chunk.radius = radius.data();
+		chunk.visibility = visibility.data();
+		chunk.planes = cullPlanes.data();
+		chunk.frustumCount = frustumCount;
+		chunk.begin = c * RENDER_BOUNDS_CHUNK_SIZE;
+		chunk.end = padded < (c + 1) * RENDER_BOUNDS_CHUNK_SIZE ? padded : (c + 1) * RENDER_BOUNDS_CHUNK_SIZE;
+	}
+	if (chunkCount == 1)
+	{
+		cullChunks[0].end = padded;
+		CullChunks(cullChunks.data(), 1);
+		return;
+	}
+
+	Job* job = parallel_for(cullChunks.data(), (unsigned int)chunkCount, &CullChunks, CountSplitter(1));
+	JobSystem::Run(job);
+	JobSystem::Wait(job);
+}
+
+// Get the frustums a renderer's bounds were inside in the last Cull()
+uint32_t RenderBounds::GetVisibility(const MeshRenderer* mr)
+{
+	return visibility[mr->boundsIndex];
+}
+
+// Get the world bounding sphere of a renderer
+void RenderBounds::GetSphere(const MeshRenderer* mr, XMFLOAT3* center, float* sphereRadius)
+{
+	size_t index = mr->boundsIndex;
+	*center = XMFLOAT3(centerX[index], centerY[index], centerZ[index]);
+	*sphereRadius = radius[index];
+}
+
+// Get the amount of bounds
+size_t RenderBounds::GetCount()
+{
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "SpatialIndex.h"
+
+class MeshRenderer;
+
+//Most frustums that can be culled against at once (one visibility bit each)
+#define RENDER_BOUNDS_MAX_FRUSTUMS 32
+//Bounds counts smaller than this are culled on the calling thread
+#define RENDER_BOUNDS_PARALLEL_SIZE 16384
+//Bounds each culling job tests (must be a multiple of 4)
+#define RENDER_BOUNDS_CHUNK_SIZE 4096
+
+// --------------------------------------------------------
+// Counters for one frame of culling
+// --------------------------------------------------------
+struct CullingStats
+{
+	size_t cameraVisible;	//Draws inside the camera frustum
+	size_t cameraCulled;
+	size_t shadowVisible;	//Shadow draws inside a light's frustum (summed over lights)
+	size_t shadowCulled;
+};
+
+// --------------------------------------------------------
+// A range of bounds one culling job tests
+// --------------------------------------------------------
+struct RenderBoundsCullChunk
+{
+	const float* centerX;
+	const float* centerY;
+	const float* centerZ;
+	const float* radius;
+	uint32_t* visibility;
+	const DirectX::XMFLOAT4* planes;	//Six per frustum
+	size_t frustumCount;
+	size_t begin;
+	size_t end;
+};
+
+// --------------------------------------------------------
+// World space bounding spheres of every mesh renderer,
+// stored as separate arrays so four can be tested against
+// a plane at once with SSE.
+//
+// Spheres are synced once per frame from the EntityManager's
+// transform change log, so only renderers whose gameobject
+// moved are looked at and recalculated. Culling
+// tests every sphere against a set of frustums and stores
+// a bit per frustum
+// --------------------------------------------------------
+class RenderBounds
+{
+private:
+	//Arrays are padded to a multiple of 4
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+	std::vector<uint32_t> visibility;
+	std::vector<MeshRenderer*> owners;
+	size_t count;
+
+	std::vector<DirectX::XMFLOAT4> cullPlanes;
+	std::vector<RenderBoundsCullChunk> cullChunks;
+	bool readingChanges;	//False until the first sync
+	size_t changeReader;
+
+	// --------------------------------------------------------
+	// Recalculate a world sphere from its mesh and transform
+	// --------------------------------------------------------
+	void Calculate(size_t index);
+
+	// --------------------------------------------------------
+	// Resize the arrays to hold the bounds (and padding)
+	// --------------------------------------------------------
+	void Resize();
+
+public:
+	RenderBounds();
+
+	// --------------------------------------------------------
+	// Add a mesh renderer's bounds
+	// --------------------------------------------------------
+	void Add(MeshRenderer* mr);
+
+	// --------------------------------------------------------
+	// Remove a mesh renderer's bounds
+	// --------------------------------------------------------
+	void Remove(MeshRenderer* mr);
+
+	// --------------------------------------------------------
+	// Recalculate the bounds of renderers that moved since
+	// the last sync (once per frame). The first sync
+	// recalculates every renderer
+	// --------------------------------------------------------
+	void Sync();
+
+	// --------------------------------------------------------
+	// Test every sphere against a set of frustums. Large sets
+	// are split over parallel jobs
+	//
+	// frustums - the frustums, bit i of a visibility is frustum i
+	// frustumCount - up to RENDER_BOUNDS_MAX_FRUSTUMS
+	// --------------------------------------------------------
+	void Cull(const Frustum* frustums, size_t frustumCount);
+
+	// --------------------------------------------------------
+	// Get the frustums a renderer's bounds were inside
+	// in the last Cull()
+	// --------------------------------------------------------
+	uint32_t GetVisibility(const MeshRenderer* mr);
+
+	// --------------------------------------------------------
+	// Get the world bounding sphere of a renderer
+	// --------------------------------------------------------
+	void GetSphere(const MeshRenderer* mr, DirectX::XMFLOAT3* center, float* sphereRadius);
+
+	// --------------------------------------------------------
+	// Get the amount of bounds
+	// --------------------------------------------------------
+	size_t GetCount();
+};
\ No newline at end of file
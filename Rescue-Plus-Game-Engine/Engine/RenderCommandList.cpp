@@ -0,0 +1,325 @@
+#include "RenderCommandList.h"
+#include <cstring>
+
+// The bucket a staging key is kept in
+static inline size_t StagingBucket(const void* key)
+{
+	return ((uintptr_t)key >> 4) % RENDER_STAGING_BUCKETS;
+}
+
+// Create an empty list
+RenderCommandList::RenderCommandList()
+{
+	arena = nullptr;
+	first = nullptr;
+	last = nullptr;
+	commandCount = 0;
+	memset(staging, 0, sizeof(staging));
+}
+
+// Add a command to the end of the list
+RenderListCommand& RenderCommandList::Add(RenderCommandType type, ShaderStage stage, const void* object)
+{
+	//Start a new page from the recording thread's block when the last one is full
+	if (last == nullptr || last->count == RENDER_COMMAND_PAGE_SIZE)
+	{
+		RenderCommandPage* page = (RenderCommandPage*)arena->AllocateLocal(sizeof(RenderCommandPage), alignof(RenderCommandPage));
+		page->next = nullptr;
+		page->count = 0;
+		if (last == nullptr)
+			first = page;
+		else
+			last->next = page;
+		last = page;
+	}
+
+	RenderListCommand& command = last->commands[last->count++];
+	command = RenderListCommand{ type, stage, const_cast<void*>(object), nullptr, { 0, 0, 0, 0, 0 }, nullptr, 0 };
+	commandCount++;
+	return command;
+}
+
+// Copy bytes into the list's arena
+const void* RenderCommandList::CopyData(const void* source, size_t size)
+{
+	if (size == 0)
+		return nullptr;
+
+	//Keep pointers and floats read back from the data aligned
+	void* copy = arena->AllocateLocal(size, 8);
+	memcpy(copy, source, size);
+	return copy;
+}
+
+// Record binding a vertex buffer to slot 0
+void RenderCommandList::SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	RenderListCommand& command = Add(RenderCommandType::SetVertexBuffer, ShaderStage::Count, buffer);
+	command.args[0] = stride;
+	command.args[1] = offset;
+}
+
+// Record binding an index buffer
+void RenderCommandList::SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format)
+{
+	Add(RenderCommandType::SetIndexBuffer, ShaderStage::Count, buffer).args[0] = (unsigned int)format;
+}
+
+// Record copying data into a whole buffer (the data is copied now)
+void RenderCommandList::UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	RenderListCommand& command = Add(RenderCommandType::UpdateBuffer, ShaderStage::Count, buffer);
+	command.data = CopyData(data, size);
+	command.dataSize = size;
+}
+
+// Record binding a per-instance vertex buffer to slot 1
+void RenderCommandList::SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	RenderListCommand& command = Add(RenderCommandType::SetInstanceBuffer, ShaderStage::Count, buffer);
+	command.args[0] = stride;
+	command.args[1] = offset;
+}
+
+// Record overwriting the start of a dynamic buffer (the data is copied now)
+void RenderCommandList::WriteBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	RenderListCommand& command = Add(RenderCommandType::WriteBuffer, ShaderStage::Count, buffer);
+	command.data = CopyData(data, size);
+	command.dataSize = size;
+}
+
+// Record binding a shader to a stage
+void RenderCommandList::SetShader(ShaderStage stage, RenderShader* shader)
+{
+	Add(RenderCommandType::SetShader, stage, shader);
+}
+
+// Record binding a constant buffer to a stage
+void RenderCommandList::SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer)
+{
+	Add(RenderCommandType::SetConstantBuffer, stage, buffer).args[0] = slot;
+}
+
+// Record binding shader resource views to a stage (the array is copied now)
+void RenderCommandList::SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs)
+{
+	RenderListCommand& command = Add(RenderCommandType::SetShaderResources, stage, nullptr);
+	command.args[0] = startSlot;
+	command.args[1] = count;
+	command.data = CopyData(srvs, count * sizeof(RenderShaderResource*));
+	command.dataSize = count * sizeof(RenderShaderResource*);
+}
+
+// Record binding a sampler to a stage
+void RenderCommandList::SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler)
+{
+	Add(RenderCommandType::SetSampler, stage, sampler).args[0] = slot;
+}
+
+// Record setting the input layout
+void RenderCommandList::SetInputLayout(RenderInputLayout* inputLayout)
+{
+	Add(RenderCommandType::SetInputLayout, ShaderStage::Count, inputLayout);
+}
+
+// Record setting the primitive topology
+void RenderCommandList::SetPrimitiveTopology(RenderTopology topology)
+{
+	Add(RenderCommandType::SetPrimitiveTopology, ShaderStage::Count, nullptr).args[0] = (unsigned int)topology;
+}
+
+// Record setting the rasterizer state
+void RenderCommandList::SetRasterizerState(RenderRasterizerState* state)
+{
+	Add(RenderCommandType::SetRasterizerState, ShaderStage::Count, state);
+}
+
+// Record setting the depth stencil state
+void RenderCommandList::SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef)
+{
+	Add(RenderCommandType::SetDepthStencilState, ShaderStage::Count, state).args[0] = stencilRef;
+}
+
+// Record setting the blend state
+void RenderCommandList::SetBlendState(RenderBlendState* state)
+{
+	Add(RenderCommandType::SetBlendState, ShaderStage::Count, state);
+}
+
+// Record binding a render target and depth buffer
+void RenderCommandList::SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil)
+{
+	Add(RenderCommandType::SetRenderTarget, ShaderStage::Count, target).object2 = depthStencil;
+}
+
+// Record setting the viewport
+void RenderCommandList::SetViewport(const RenderViewport& viewport)
+{
+	RenderListCommand& command = Add(RenderCommandType::SetViewport, ShaderStage::Count, nullptr);
+	command.data = CopyData(&viewport, sizeof(RenderViewport));
+	command.dataSize = sizeof(RenderViewport);
+}
+
+// Record clearing a render target
+void RenderCommandList::ClearRenderTarget(RenderTargetView* target, const float color[4])
+{
+	RenderListCommand& command = Add(RenderCommandType::ClearRenderTarget, ShaderStage::Count, target);
+	command.data = CopyData(color, sizeof(float) * 4);
+	command.dataSize = sizeof(float) * 4;
+}
+
+// Record clearing a depth buffer
+void RenderCommandList::ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil)
+{
+	RenderListCommand& command = Add(RenderCommandType::ClearDepthStencil, ShaderStage::Count, depthStencil);
+	command.args[0] = (unsigned int)clear;
+	command.args[1] = stencil;
+	memcpy(&command.args[2], &depth, sizeof(float));
+}
+
+// Record drawing indexed vertices
+void RenderCommandList::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	RenderListCommand& command = Add(RenderCommandType::DrawIndexed, ShaderStage::Count, nullptr);
+	command.args[0] = indexCount;
+	command.args[1] = startIndex;
+	command.args[2] = (unsigned int)baseVertex;
+}
+
+// Record drawing instances of indexed vertices
+void RenderCommandList::DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	RenderListCommand& command = Add(RenderCommandType::DrawIndexedInstanced, ShaderStage::Count, nullptr);
+	command.args[0] = indexCount;
+	command.args[1] = instanceCount;
+	command.args[2] = startIndex;
+	command.args[3] = (unsigned int)baseVertex;
+	command.args[4] = startInstance;
+}
+
+// Always null, recorded commands only reach a backend when submitted
+RenderDevice* RenderCommandList::GetBackend()
+{
+	return nullptr;
+}
+
+// Get this list's copy of some data
+void* RenderCommandList::GetStagingData(const void* key, const void* shared, size_t size)
+{
+	RenderStagingData** bucket = &staging[StagingBucket(key)];
+	for (RenderStagingData* s = *bucket; s != nullptr; s = s->next)
+	{
+		if (s->key == key)
+			return s->data;
+	}
+
+	//First time this list sees the data, copy it from the recording thread's block
+	RenderStagingData* s = (RenderStagingData*)arena->AllocateLocal(sizeof(RenderStagingData), alignof(RenderStagingData));
+	s->key = key;
+	s->data = arena->AllocateLocal(size, 16);
+	memcpy(s->data, shared, size);
+	s->next = *bucket;
+	*bucket = s;
+	return s->data;
+}
+
+// Send every recorded command to a device, in order
+void RenderCommandList::Submit(RenderDevice* device) const
+{
+	for (const RenderCommandPage* page = first; page != nullptr; page = page->next)
+	{
+		for (size_t c = 0; c < page->count; c++)
+		{
+			const RenderListCommand& command = page->commands[c];
+			const void* commandData = command.data;
+			switch (command.type)
+			{
+			case RenderCommandType::SetVertexBuffer:
+				device->SetVertexBuffer((RenderBuffer*)command.object, command.args[0], command.args[1]);
+				break;
+			case RenderCommandType::SetIndexBuffer:
+				device->SetIndexBuffer((RenderBuffer*)command.object, (RenderIndexFormat)command.args[0]);
+				break;
+			case RenderCommandType::UpdateBuffer:
+				device->UpdateBuffer((RenderBuffer*)command.object, commandData, command.dataSize);
+				break;
+			case RenderCommandType::SetInstanceBuffer:
+				device->SetInstanceBuffer((RenderBuffer*)command.object, command.args[0], command.args[1]);
+				break;
+			case RenderCommandType::WriteBuffer:
+				device->WriteBuffer((RenderBuffer*)command.object, commandData, command.dataSize);
+				break;
+			case RenderCommandType::SetShader:
+				device->SetShader(command.stage, (RenderShader*)command.object);
+				break;
+			case RenderCommandType::SetConstantBuffer:
+				device->SetConstantBuffer(command.stage, command.args[0], (RenderBuffer*)command.object);
+				break;
+			case RenderCommandType::SetShaderResources:
+				device->SetShaderResources(command.stage, command.args[0], command.args[1],
+					(RenderShaderResource* const*)commandData);
+				break;
+			case RenderCommandType::SetSampler:
+				device->SetSampler(command.stage, command.args[0], (RenderSampler*)command.object);
+				break;
+			case RenderCommandType::SetInputLayout:
+				device->SetInputLayout((RenderInputLayout*)command.object);
+				break;
+			case RenderCommandType::SetPrimitiveTopology:
+				device->SetPrimitiveTopology((RenderTopology)command.args[0]);
+				break;
+			case RenderCommandType::SetRasterizerState:
+				device->SetRasterizerState((RenderRasterizerState*)command.object);
+				break;
+			case RenderCommandType::SetDepthStencilState:
+				device->SetDepthStencilState((RenderDepthStencilState*)command.object, command.args[0]);
+				break;
+			case RenderCommandType::SetBlendState:
+				device->SetBlendState((RenderBlendState*)command.object);
+				break;
+			case RenderCommandType::SetRenderTarget:
+				device->SetRenderTarget((RenderTargetView*)command.object, (RenderDepthStencilView*)command.object2);
+				break;
+			case RenderCommandType::SetViewport:
+				device->SetViewport(*(const RenderViewport*)commandData);
+				break;
+			case RenderCommandType::ClearRenderTarget:
+				device->ClearRenderTarget((RenderTargetView*)command.object, (const float*)commandData);
+				break;
+			case RenderCommandType::ClearDepthStencil:
+			{
+				float depth;
+				memcpy(&depth, &command.args[2], sizeof(float));
+				device->ClearDepthStencil((RenderDepthStencilView*)command.object, (DepthClear)command.args[0], depth, (uint8_t)command.args[1]);
+				break;
+			}
+			case RenderCommandType::DrawIndexed:
+				device->DrawIndexed(command.args[0], command.args[1], (int)command.args[2]);
+				break;
+			case RenderCommandType::DrawIndexedInstanced:
+				device->DrawIndexedInstanced(command.args[0], command.args[1], command.args[2],
+					(int)command.args[3], command.args[4]);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+// Remove every command and record the next ones into an arena
+void RenderCommandList::Reset(FrameArena* arena)
+{
+	this->arena = arena;
+	first = nullptr;
+	last = nullptr;
+	commandCount = 0;
+	memset(staging, 0, sizeof(staging));
+}
+
+// Get the amount of recorded commands
+size_t RenderCommandList::GetCommandCount() const
+{
+	return commandCount;
+}
\ No newline at end of file
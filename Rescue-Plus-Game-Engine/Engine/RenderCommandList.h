@@ -0,0 +1,156 @@
+#pragma once
+#include "RecordingRenderDevice.h"
+#include "FrameArena.h"
+
+//Commands in each page of a command list
+#define RENDER_COMMAND_PAGE_SIZE 256
+//Buckets a command list looks its staging data up in
+#define RENDER_STAGING_BUCKETS 32
+
+// --------------------------------------------------------
+// A command in a render command list
+// --------------------------------------------------------
+struct RenderListCommand
+{
+	RenderCommandType type;
+	ShaderStage stage;		//For shader commands
+	void* object;			//What was bound, cleared or updated
+	void* object2;			//Depth stencil for SetRenderTarget
+	unsigned int args[5];			//Slots, strides, counts and offsets
+	const void* data;		//Copied arrays and buffer contents in the list's arena
+	size_t dataSize;
+};
+
+// --------------------------------------------------------
+// A page of commands in a render command list
+// --------------------------------------------------------
+struct RenderCommandPage
+{
+	RenderCommandPage* next;
+	size_t count;
+	RenderListCommand commands[RENDER_COMMAND_PAGE_SIZE];
+};
+
+// --------------------------------------------------------
+// A command list's own copy of data that changes while it
+// records
+// --------------------------------------------------------
+struct RenderStagingData
+{
+	const void* key;		//What the data belongs to
+	void* data;
+	RenderStagingData* next;
+};
+
+// --------------------------------------------------------
+// Records render commands to send to another device later.
+//
+// Lists are recorded on any thread without touching a
+// device context, then submitted in order on the thread that
+// owns the context. What commands point at (arrays, clear
+// colors and buffer contents) is copied when recorded, so
+// shader variables can change right after a buffer update.
+//
+// This is the backend agnostic version of a D3D11 deferred
+// context: submitting a list to a D3D11RenderDevice replays
+// it on the immediate context, and submitting it to a
+// RecordingRenderDevice counts it.
+//
+// Commands and their data live in pages allocated from a
+// frame arena, from the block of the thread recording, so
+// lists recorded in parallel don't share memory and
+// recording never allocates from the heap. A list is only
+// valid until its arena resets.
+//
+// Lists also keep their own staging copy of shader constant
+// buffers, so jobs recording in parallel set shader
+// variables without sharing memory
+// --------------------------------------------------------
+class RenderCommandList : public RenderDevice
+{
+private:
+	FrameArena* arena;
+	RenderCommandPage* first;
+	RenderCommandPage* last;
+	size_t commandCount;
+	RenderStagingData* staging[RENDER_STAGING_BUCKETS];
+
+	// --------------------------------------------------------
+	// Add a command to the end of the list
+	// --------------------------------------------------------
+	RenderListCommand& Add(RenderCommandType type, ShaderStage stage, const void* object);
+
+	// --------------------------------------------------------
+	// Copy bytes into the list's arena, returns the copy
+	// --------------------------------------------------------
+	const void* CopyData(const void* source, size_t size);
+
+public:
+	// --------------------------------------------------------
+	// Create an empty list, Reset() it with an arena before
+	// recording
+	// --------------------------------------------------------
+	RenderCommandList();
+
+	void SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format);
+	void UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size);
+	void SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void WriteBuffer(RenderBuffer* buffer, const void* data, size_t size);
+
+	void SetShader(ShaderStage stage, RenderShader* shader);
+	void SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer);
+	void SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs);
+	void SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler);
+
+	void SetInputLayout(RenderInputLayout* inputLayout);
+	void SetPrimitiveTopology(RenderTopology topology);
+	void SetRasterizerState(RenderRasterizerState* state);
+	void SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef);
+	void SetBlendState(RenderBlendState* state);
+
+	void SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil);
+	void SetViewport(const RenderViewport& viewport);
+	void ClearRenderTarget(RenderTargetView* target, const float color[4]);
+	void ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil);
+
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex);
+	void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance);
+
+	// --------------------------------------------------------
+	// Always null, recorded commands only reach a backend
+	// when the list is submitted
+	// --------------------------------------------------------
+	RenderDevice* GetBackend();
+
+	// --------------------------------------------------------
+	// Get this list's copy of some data. It is copied from the
+	// shared data the first time its key is asked for, and is
+	// freed with the list's commands
+	//
+	// key - what the data belongs to
+	// shared - what the copy starts as
+	// size - bytes in the data
+	// --------------------------------------------------------
+	void* GetStagingData(const void* key, const void* shared, size_t size);
+
+	// --------------------------------------------------------
+	// Send every recorded command to a device, in order.
+	// The list is kept, so it can be submitted again
+	// --------------------------------------------------------
+	void Submit(RenderDevice* device) const;
+
+	// --------------------------------------------------------
+	// Remove every command and record the next ones into an
+	// arena
+	//
+	// arena - where commands are allocated, the list is only
+	//		   valid until it resets
+	// --------------------------------------------------------
+	void Reset(FrameArena* arena);
+
+	// --------------------------------------------------------
+	// Get the amount of recorded commands
+	// --------------------------------------------------------
+	size_t GetCommandCount() const;
+};
\ No newline at end of file
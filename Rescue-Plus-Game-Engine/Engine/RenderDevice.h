@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// --------------------------------------------------------
+// Programmable pipeline stages
+// --------------------------------------------------------
+enum class ShaderStage
+{
+	Vertex,
+	Pixel,
+	Domain,
+	Hull,
+	Geometry,
+	Compute,
+	Count
+};
+
+// --------------------------------------------------------
+// Handles to GPU objects. The engine never looks inside
+// them, each backend decides what they point at
+// --------------------------------------------------------
+struct RenderBuffer;
+struct RenderShader;
+struct RenderShaderResource;
+struct RenderSampler;
+struct RenderInputLayout;
+struct RenderRasterizerState;
+struct RenderDepthStencilState;
+struct RenderBlendState;
+struct RenderTargetView;
+struct RenderDepthStencilView;
+
+// --------------------------------------------------------
+// Sizes of the indices in an index buffer
+// --------------------------------------------------------
+enum class RenderIndexFormat
+{
+	UInt16,
+	UInt32
+};
+
+// --------------------------------------------------------
+// How vertices are put together into primitives
+// --------------------------------------------------------
+enum class RenderTopology
+{
+	Undefined,
+	PointList,
+	LineList,
+	LineStrip,
+	TriangleList,
+	TriangleStrip
+};
+
+// --------------------------------------------------------
+// What a depth stencil clear clears
+// --------------------------------------------------------
+enum class DepthClear
+{
+	Depth,
+	Stencil,
+	DepthStencil
+};
+
+// --------------------------------------------------------
+// The area of the render target drawn to
+// --------------------------------------------------------
+struct RenderViewport
+{
+	float x;
+	float y;
+	float width;
+	float height;
+	float minDepth;
+	float maxDepth;
+};
+
+// --------------------------------------------------------
+// The commands the engine sends to the GPU while drawing.
+//
+// Resources are still created by the backend, this only
+// covers binding them and drawing, which is where the
+// per-frame CPU cost is. Everything is passed as engine
+// handles and enums, only a backend knows the API types
+// behind them. Implementations:
+//
+// D3D11RenderDevice - sends commands to a device context
+// RecordingRenderDevice - counts and logs commands, and can
+//		forward them to another device or drop them (null backend)
+// RenderCommandList - records commands on any thread to
+//		submit to another device later
+// StateCacheRenderDevice - drops binds of what is already
+//		bound before they reach another device
+// --------------------------------------------------------
+class RenderDevice
+{
+public:
+	virtual ~RenderDevice() { }
+
+	// Buffers
+	virtual void SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset) = 0;
+	virtual void SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format) = 0;
+	virtual void UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size) = 0;		//Size of the whole buffer
+	virtual void SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset) = 0;	//Slot 1
+	virtual void WriteBuffer(RenderBuffer* buffer, const void* data, size_t size) = 0;		//Dynamic buffers, discards the old contents
+
+	// Shaders and their resources
+	virtual void SetShader(ShaderStage stage, RenderShader* shader) = 0;
+	virtual void SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer) = 0;
+	virtual void SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs) = 0;
+	virtual void SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler) = 0;
+	void SetShaderResource(ShaderStage stage, unsigned int slot, RenderShaderResource* srv)
+	{
+		SetShaderResources(stage, slot, 1, &srv);
+	}
+
+	// Fixed function state (null sets the default state)
+	virtual void SetInputLayout(RenderInputLayout* inputLayout) = 0;
+	virtual void SetPrimitiveTopology(RenderTopology topology) = 0;
+	virtual void SetRasterizerState(RenderRasterizerState* state) = 0;
+	virtual void SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef) = 0;
+	virtual void SetBlendState(RenderBlendState* state) = 0;
+
+	// Render targets (a null target binds only the depth buffer)
+	virtual void SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil) = 0;
+	virtual void SetViewport(const RenderViewport& viewport) = 0;
+	virtual void ClearRenderTarget(RenderTargetView* target, const float color[4]) = 0;
+	virtual void ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil) = 0;
+
+	// Drawing
+	virtual void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex) = 0;
+	virtual void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance) = 0;
+
+	// --------------------------------------------------------
+	// Get the backend commands end up on, for code that has to
+	// talk to it directly (null if they are dropped)
+	// --------------------------------------------------------
+	virtual RenderDevice* GetBackend() = 0;
+};
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <DirectXMath.h>
+#include "Lights.h"
+#include "DebugShapes.h"
+#include "RenderQueue.h"
+#include "RenderCommandList.h"
+#include "FrameArena.h"
+
+class Mesh;
+class Material;
+
+// --------------------------------------------------------
+// A mesh renderer's data for one frame
+// --------------------------------------------------------
+struct RenderProxy
+{
+	DirectX::XMFLOAT4X4 world;			//Transposed for the shaders
+	DirectX::XMFLOAT4X4 worldInvTrans;
+	DirectX::XMFLOAT3 position;
+	uint32_t visibility;				//Frustums it was inside, bit 0 is the camera
+	Mesh* mesh;
+	Material* material;
+	unsigned int layer;
+};
+
+// --------------------------------------------------------
+// What instanced vertex shaders read per instance. Matrices
+// are transposed, the same as the per object constant
+// buffer the non-instanced shaders use
+// --------------------------------------------------------
+struct InstanceData
+{
+	DirectX::XMFLOAT4X4 world;
+	DirectX::XMFLOAT4X4 worldInvTrans;
+};
+
+// --------------------------------------------------------
+// A shadow casting light's data for one frame
+// --------------------------------------------------------
+struct ShadowLightProxy
+{
+	LightType type;
+	DirectX::XMFLOAT4X4 view;			//Transposed for the shaders
+	DirectX::XMFLOAT4X4 projection;
+	ID3D11DepthStencilView* shadowDSV;
+	ID3D11ShaderResourceView* shadowSRV;
+};
+
+// --------------------------------------------------------
+// The camera's data for one frame
+// --------------------------------------------------------
+struct CameraProxy
+{
+	DirectX::XMFLOAT4X4 view;			//Transposed for the shaders
+	DirectX::XMFLOAT4X4 projection;
+	DirectX::XMFLOAT4X4 rawView;
+	DirectX::XMFLOAT4X4 rawProjection;
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT3 forward;
+	float farClip;
+};
+
+// --------------------------------------------------------
+// Everything the renderer reads to draw a frame, copied
+// out of the scene when the frame's update ends.
+//
+// Nothing in a frame points back at GameObjects or
+// components, so a frame can be drawn on another thread
+// while the scene is updated for the next one. Meshes and
+// materials must outlive the frame
+// --------------------------------------------------------
+struct RenderFrame
+{
+	//Transient data rebuilt every extraction (command lists and
+	//debug shapes), reset when the frame is extracted again
+	FrameArena arena;
+
+	CameraProxy camera;
+
+	//Visible mesh renderers and their draws, sorted by key.
+	//Queue entries index the proxies
+	std::vector<RenderProxy> proxies;
+	RenderQueue queue;
+	uint32_t queueUnloadCount;	//ResourceManager unload count when the queue's ids were last reset
+
+	//Shadow casting lights, proxy visibility bit 1 + i is light i
+	std::vector<ShadowLightProxy> shadowLights;
+
+	//Every light for the shaders
+	LightStruct lights[MAX_LIGHTS];
+	int lightCount;
+	AmbientLightStruct ambientLight;
+
+	//Instances for the queue. Camera pass entries use the instance
+	//at their index past the shadow pass, then each shadow casting
+	//light's visible shadow entries follow in queue order. Each
+	//frame has its own buffer, so one can grow while the other draws
+	std::vector<InstanceData> instances;
+	std::vector<size_t> shadowInstanceStarts;
+	size_t cameraInstanceEntry;
+	ID3D11Buffer* instanceBuffer;
+	size_t instanceCapacity;
+
+	//The draws recorded into the arena when the frame was extracted,
+	//submitted in this order between the targets and states the
+	//drawing thread sets. Camera passes are recorded in chunks, in
+	//sort order
+	RenderCommandList shadowCommands;
+	std::vector<RenderCommandList> opaqueCommands;
+	RenderCommandList skyCommands;
+	std::vector<RenderCommandList> transparentCommands;
+
+	//Debug shapes to draw this frame, in the arena
+	FrameArray<ShapeXMFloat3Data> debugCubes;
+	FrameArray<ShapeFloat1Data> debugSpheres;
+	FrameArray<ShapeXMFloat2Data> debugCapsules;
+	FrameArray<ShapeFloat1Data> debugRays;
+};
\ No newline at end of file
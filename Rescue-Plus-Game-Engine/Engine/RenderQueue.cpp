@@ -0,0 +1,338 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+#include "ParallelFor.h"
+
+//Where each field starts in a key
+static const unsigned int PASS_SHIFT = 64 - RENDER_KEY_PASS_BITS;
+static const unsigned int LAYER_SHIFT = PASS_SHIFT - RENDER_KEY_LAYER_BITS;
+static const uint64_t DEPTH_MAX = (1ull << RENDER_KEY_DEPTH_BITS) - 1;
+
+// Mask a value to the bits of a field and move it into place
+static inline uint64_t Field(uint64_t value, unsigned int bits, unsigned int shift)
+{
+	return (value & ((1ull << bits) - 1)) << shift;
+}
+
+// Count the digits in a set of chunks
+static void CountChunks(RenderQueueSortChunk* chunks, unsigned int count)
+{
+	for (unsigned int c = 0; c < count; c++)
+	{
+		RenderQueueSortChunk& chunk = chunks[c];
+		memset(chunk.counts, 0, sizeof(chunk.counts));
+		for (size_t i = chunk.begin; i < chunk.end; i++)
+			chunk.counts[(chunk.source[i].key >> chunk.shift) & 0xFF]++;
+	}
+}
+
+// Move the entries in a set of chunks to where their digit goes
+static void ScatterChunks(RenderQueueSortChunk* chunks, unsigned int count)
+{
+	for (unsigned int c = 0; c < count; c++)
+	{
+		RenderQueueSortChunk& chunk = chunks[c];
+		for (size_t i = chunk.begin; i < chunk.end; i++)
+		{
+			const RenderQueueEntry& entry = chunk.source[i];
+			chunk.dest[chunk.counts[(entry.key >> chunk.shift) & 0xFF]++] = entry;
+		}
+	}
+}
+
+// Run a function over every chunk, one job per chunk if there are several
+static void RunChunks(std::vector<RenderQueueSortChunk>* chunks, void(*function)(RenderQueueSortChunk*, unsigned int))
+{
+	if (chunks->size() == 1)
+	{
+		function(chunks->data(), 1);
+		return;
+	}
+
+	Job* job = parallel_for(chunks->data(), (unsigned int)chunks->size(), function, CountSplitter(1));
+	JobSystem::Run(job);
+	JobSystem::Wait(job);
+}
+
+// Insertion sort entries by key, giving up after a number of moves.
+// Returns false if it gave up (the entries are still all there)
+static bool InsertionSort(RenderQueueEntry* entries, size_t count, size_t maxMoves)
+{
+	size_t moves = 0;
+	for (size_t i = 1; i < count; i++)
+	{
+		RenderQueueEntry entry = entries[i];
+		size_t j = i;
+		for (; j > 0 && entries[j - 1].key > entry.key; j--)
+		{
+			entries[j] = entries[j - 1];
+			if (++moves > maxMoves)
+			{
+				entries[j - 1] = entry;
+				return false;
+			}
+		}
+		entries[j] = entry;
+	}
+	return true;
+}
+
+// Constructor
+RenderQueue::RenderQueue()
+{
+	coherentSorting = true;
+	transparentCoherent = false;
+}
+
+// Get the id of an object in a map, adding it if needed
+uint32_t RenderQueue::GetId(std::unordered_map<const void*, uint32_t>* ids, const void* object)
+{
+	auto iter = ids->find(object);
+	if (iter != ids->end())
+		return iter->second;
+
+	uint32_t id = (uint32_t)ids->size();
+	ids->emplace(object, id);
+	return id;
+}
+
+// Get the small id of a shader
+uint32_t RenderQueue::GetShaderId(const void* shader)
+{
+	return GetId(&shaderIds, shader);
+}
+
+// Get the small id of a material
+uint32_t RenderQueue::GetMaterialId(const void* material)
+{
+	return GetId(&materialIds, material);
+}
+
+// Get the small id of a mesh
+uint32_t RenderQueue::GetMeshId(const void* mesh)
+{
+	return GetId(&meshIds, mesh);
+}
+
+// Forget every shader, material and mesh id
+void RenderQueue::ResetIds()
+{
+	shaderIds.clear();
+	materialIds.clear();
+	meshIds.clear();
+}
+
+// Make the key for a draw in the shadow pass
+uint64_t RenderQueue::MakeShadowKey(unsigned int layer, uint32_t mesh)
+{
+	return Field((uint64_t)RenderPass::Shadow, RENDER_KEY_PASS_BITS, PASS_SHIFT)
+		| Field(layer, RENDER_KEY_LAYER_BITS, LAYER_SHIFT)
+		| Field(mesh, RENDER_KEY_MESH_BITS, LAYER_SHIFT - RENDER_KEY_MESH_BITS);
+}
+
+// Make the key for a draw in the opaque pass
+uint64_t RenderQueue::MakeOpaqueKey(unsigned int layer, uint32_t vertexShader, uint32_t pixelShader,
+	uint32_t material, uint32_t mesh, uint32_t depth)
+{
+	unsigned int shift = LAYER_SHIFT;
+	uint64_t key = Field((uint64_t)RenderPass::Opaque, RENDER_KEY_PASS_BITS, PASS_SHIFT)
+		| Field(layer, RENDER_KEY_LAYER_BITS, shift);
+	key |= Field(vertexShader, RENDER_KEY_SHADER_BITS, shift -= RENDER_KEY_SHADER_BITS);
+	key |= Field(pixelShader, RENDER_KEY_SHADER_BITS, shift -= RENDER_KEY_SHADER_BITS);
+	key |= Field(material, RENDER_KEY_MATERIAL_BITS, shift -= RENDER_KEY_MATERIAL_BITS);
+	key |= Field(mesh, RENDER_KEY_MESH_BITS, shift -= RENDER_KEY_MESH_BITS);
+	return key | Field(depth, RENDER_KEY_DEPTH_BITS, 0);
+}
+
+// Make the key for a draw in the transparent pass (farthest first)
+uint64_t RenderQueue::MakeTransparentKey(unsigned int layer, uint32_t vertexShader, uint32_t pixelShader,
+	uint32_t material, uint32_t mesh, uint32_t depth)
+{
+	unsigned int shift = LAYER_SHIFT;
+	uint64_t key = Field((uint64_t)RenderPass::Transparent, RENDER_KEY_PASS_BITS, PASS_SHIFT)
+		| Field(layer, RENDER_KEY_LAYER_BITS, shift);
+	key |= Field(DEPTH_MAX - depth, RENDER_KEY_DEPTH_BITS, shift -= RENDER_KEY_DEPTH_BITS);
+	key |= Field(vertexShader, RENDER_KEY_SHADER_BITS, shift -= RENDER_KEY_SHADER_BITS);
+	key |= Field(pixelShader, RENDER_KEY_SHADER_BITS, shift -= RENDER_KEY_SHADER_BITS);
+	key |= Field(material, RENDER_KEY_MATERIAL_BITS, shift -= RENDER_KEY_MATERIAL_BITS);
+	return key | Field(mesh, RENDER_KEY_MESH_BITS, 0);
+}
+
+// Get the pass a key is in
+RenderPass RenderQueue::GetPass(uint64_t key)
+{
+	return (RenderPass)(key >> PASS_SHIFT);
+}
+
+// Quantize a view depth between 0 and farClip
+uint32_t RenderQueue::QuantizeDepth(float depth, float farClip)
+{
+	if (depth <= 0 || farClip <= 0)
+		return 0;
+	if (depth >= farClip)
+		return (uint32_t)DEPTH_MAX;
+	return (uint32_t)(depth / farClip * DEPTH_MAX);
+}
+
+// Remove all entries
+void RenderQueue::Clear()
+{
+	entries.clear();
+	transparent.clear();
+	transparentItems.clear();
+	transparentSources.clear();
+}
+
+// Add a draw of an item to the queue
+void RenderQueue::Add(uint64_t key, uint32_t item, const void* source)
+{
+	if (GetPass(key) != RenderPass::Transparent)
+	{
+		entries.push_back(RenderQueueEntry{ key, item });
+		return;
+	}
+
+	//Transparent entries point at the order they were added in until sorted
+	transparent.push_back(RenderQueueEntry{ key, (uint32_t)transparentItems.size() });
+	transparentItems.push_back(item);
+	transparentSources.push_back(source);
+}
+
+// Sort the entries by key
+void RenderQueue::Sort(bool passOnly)
+{
+	RadixSort(&entries, passOnly ? PASS_SHIFT : 0);
+
+	//The transparent pass is last, so it goes after everything else
+	SortTransparent(passOnly);
+	entries.insert(entries.end(), transparent.begin(), transparent.end());
+}
+
+// Sort the transparent pass, from last time's order if it has the same sources
+void RenderQueue::SortTransparent(bool passOnly)
+{
+	size_t count = transparent.size();
+	transparentCoherent = false;
+	if (!passOnly)
+	{
+		//Start from last time's order if the same sources were added the same way
+		if (coherentSorting && count > 0 && transparentSources == lastTransparentSources)
+		{
+			sortBuffer.resize(count);
+			for (size_t i = 0; i < count; i++)
+				sortBuffer[i] = transparent[lastTransparentOrder[i]];
+			transparent.swap(sortBuffer);
+			transparentCoherent = InsertionSort(transparent.data(), count, count * RENDER_QUEUE_COHERENT_MOVES);
+		}
+		if (!transparentCoherent)
+			RadixSort(&transparent, 0);
+	}
+
+	//Keep the order for next time, then point the entries at their items
+	lastTransparentSources.swap(transparentSources);
+	lastTransparentOrder.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		lastTransparentOrder[i] = transparent[i].item;
+		transparent[i].item = transparentItems[transparent[i].item];
+	}
+}
+
+// Radix sort a list of entries by key, starting from a bit
+void RenderQueue::RadixSort(std::vector<RenderQueueEntry>* sorted, unsigned int firstShift)
+{
+	size_t count = sorted->size();
+	if (count < 2)
+		return;
+
+	//Split into chunks for the jobs
+	size_t chunkCount = 1;
+	if (count >= RENDER_QUEUE_PARALLEL_SORT_SIZE)
+		chunkCount = (count + RENDER_QUEUE_SORT_CHUNK_SIZE - 1) / RENDER_QUEUE_SORT_CHUNK_SIZE;
+	sortChunks.resize(chunkCount);
+	sortBuffer.resize(count);
+	for (size_t c = 0; c < chunkCount; c++)
+	{
+		sortChunks[c].begin = c * RENDER_QUEUE_SORT_CHUNK_SIZE;
+		sortChunks[c].end = std::min(count, (c + 1) * RENDER_QUEUE_SORT_CHUNK_SIZE);
+	}
+	if (chunkCount == 1)
+		sortChunks[0].end = count;
+
+	//Sort a byte at a time from the least significant
+	RenderQueueEntry* source = sorted->data();
+	RenderQueueEntry* dest = sortBuffer.data();
+	bool swapped = false;
+	for (unsigned int shift = firstShift; shift < 64; shift += 8)
+	{
+		for (RenderQueueSortChunk& chunk : sortChunks)
+		{
+			chunk.source = source;
+			chunk.dest = dest;
+			chunk.shift = shift;
+		}
+		RunChunks(&sortChunks, &CountChunks);
+
+		//Turn the counts into where each chunk writes each digit,
+		// skipping digits every entry shares
+		size_t offset = 0;
+		bool skip = false;
+		for (unsigned int digit = 0; digit < 256 && !skip; digit++)
+		{
+			size_t digitStart = offset;
+			for (RenderQueueSortChunk& chunk : sortChunks)
+			{
+				size_t digitCount = chunk.counts[digit];
+				chunk.counts[digit] = offset;
+				offset += digitCount;
+			}
+			skip = offset - digitStart == count;
+		}
+		if (skip)
+			continue;
+
+		RunChunks(&sortChunks, &ScatterChunks);
+		std::swap(source, dest);
+		swapped = !swapped;
+	}
+
+	//Odd number of scatters, the sorted entries are in the buffer
+	if (swapped)
+		sorted->swap(sortBuffer);
+}
+
+// Turn starting the transparent pass from the last sorted order on or off
+void RenderQueue::SetCoherentSorting(bool coherent)
+{
+	coherentSorting = coherent;
+}
+
+// Check if the last Sort() insertion sorted the transparent pass
+bool RenderQueue::GetTransparentCoherent()
+{
+	return transparentCoherent;
+}
+
+// Get the entries of the queue
+const RenderQueueEntry* RenderQueue::GetEntries()
+{
+	return entries.data();
+}
+
+// Get the number of entries in the queue
+size_t RenderQueue::GetCount()
+{
+	return entries.size();
+}
+
+// Find the range of sorted entries in a pass
+void RenderQueue::GetPassRange(RenderPass pass, size_t* begin, size_t* end)
+{
+	auto first = std::partition_point(entries.begin(), entries.end(),
+		[pass](const RenderQueueEntry& entry) { return GetPass(entry.key) < pass; });
+	auto last = std::partition_point(first, entries.end(),
+		[pass](const RenderQueueEntry& entry) { return GetPass(entry.key) == pass; });
+
+	*begin = first - entries.begin();
+	*end = last - entries.begin();
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+//Bits in each field of a render key
+#define RENDER_KEY_PASS_BITS 2
+#define RENDER_KEY_LAYER_BITS 4
+#define RENDER_KEY_SHADER_BITS 8
+#define RENDER_KEY_MATERIAL_BITS 12
+#define RENDER_KEY_MESH_BITS 14
+#define RENDER_KEY_DEPTH_BITS 16
+
+//Queues smaller than this are sorted on the calling thread
+#define RENDER_QUEUE_PARALLEL_SORT_SIZE 16384
+//Entries each sort job counts and scatters
+#define RENDER_QUEUE_SORT_CHUNK_SIZE 4096
+//Moves per entry the transparent pass's insertion sort can make
+// before it falls back to a radix sort
+#define RENDER_QUEUE_COHERENT_MOVES 8
+
+// --------------------------------------------------------
+// The passes of a frame, in the order they are drawn
+// --------------------------------------------------------
+enum class RenderPass
+{
+	Shadow,
+	Opaque,
+	Transparent,
+	Count
+};
+
+// --------------------------------------------------------
+// A sort key and the item it draws
+// --------------------------------------------------------
+struct RenderQueueEntry
+{
+	uint64_t key;
+	uint32_t item;
+};
+
+// --------------------------------------------------------
+// A range of entries one sort job counts and scatters
+// --------------------------------------------------------
+struct RenderQueueSortChunk
+{
+	const RenderQueueEntry* source;
+	RenderQueueEntry* dest;
+	size_t begin;
+	size_t end;
+	unsigned int shift;
+	size_t counts[256];	//Digit counts, then where each digit is written next
+};
+
+// --------------------------------------------------------
+// A per-frame queue of draws sorted by packed 64-bit keys.
+//
+// Keys hold, from the most significant bits down:
+//	Shadow		- pass, layer, mesh
+//	Opaque		- pass, layer, vertex shader, pixel shader,
+//				  material, mesh, depth (front to back)
+//	Transparent	- pass, layer, depth (back to front), vertex
+//				  shader, pixel shader, material, mesh
+// so walking the sorted queue changes shaders, materials and
+// meshes as rarely as it can. Ids are handed out the first
+// time an object is seen and wrap if a field runs out of bits,
+// so two objects can share an id (that only costs sorting).
+// Ids are kept until ResetIds(), which should be called when
+// resources are unloaded so the maps don't fill with objects
+// that are gone
+//
+// The transparent pass is sorted on its own. If it was made
+// from the same sources, in the same order, as the last time
+// the queue was sorted, it starts from that sorted order and
+// is insertion sorted, which is close to linear while the
+// camera moves little. Otherwise, or if the insertion sort
+// moves entries too far, it is radix sorted
+// --------------------------------------------------------
+class RenderQueue
+{
+private:
+	std::vector<RenderQueueEntry> entries;
+	std::vector<RenderQueueEntry> sortBuffer;
+	std::vector<RenderQueueSortChunk> sortChunks;
+
+	//The transparent pass, its entries hold the order they were
+	//added in until it is sorted
+	std::vector<RenderQueueEntry> transparent;
+	std::vector<uint32_t> transparentItems;
+	std::vector<const void*> transparentSources;
+	bool coherentSorting;
+	bool transparentCoherent;
+
+	//The sources the transparent pass was last sorted with, and the
+	//order they were added in for each sorted entry
+	std::vector<const void*> lastTransparentSources;
+	std::vector<uint32_t> lastTransparentOrder;
+
+	//Small ids for the objects in a key
+	std::unordered_map<const void*, uint32_t> shaderIds;
+	std::unordered_map<const void*, uint32_t> materialIds;
+	std::unordered_map<const void*, uint32_t> meshIds;
+
+	// --------------------------------------------------------
+	// Get the id of an object in a map, adding it if needed
+	// --------------------------------------------------------
+	static uint32_t GetId(std::unordered_map<const void*, uint32_t>* ids, const void* object);
+
+	// --------------------------------------------------------
+	// Radix sort a list of entries by key, starting from a bit
+	// --------------------------------------------------------
+	void RadixSort(std::vector<RenderQueueEntry>* sorted, unsigned int firstShift);
+
+	// --------------------------------------------------------
+	// Sort the transparent pass, from last time's order if it
+	// has the same sources
+	// --------------------------------------------------------
+	void SortTransparent(bool passOnly);
+
+public:
+	// --------------------------------------------------------
+	// Constructor
+	// --------------------------------------------------------
+	RenderQueue();
+
+	// --------------------------------------------------------
+	// Get the small id of a shader, material or mesh
+	// --------------------------------------------------------
+	uint32_t GetShaderId(const void* shader);
+	uint32_t GetMaterialId(const void* material);
+	uint32_t GetMeshId(const void* mesh);
+
+	// --------------------------------------------------------
+	// Forget every shader, material and mesh id
+	// --------------------------------------------------------
+	void ResetIds();
+
+	// --------------------------------------------------------
+	// Make the key for a draw in a pass
+	//
+	// depth - quantized view depth (see QuantizeDepth)
+	// --------------------------------------------------------
+	static uint64_t MakeShadowKey(unsigned int layer, uint32_t mesh);
+	static uint64_t MakeOpaqueKey(unsigned int layer, uint32_t vertexShader, uint32_t pixelShader,
+		uint32_t material, uint32_t mesh, uint32_t depth);
+	static uint64_t MakeTransparentKey(unsigned int layer, uint32_t vertexShader, uint32_t pixelShader,
+		uint32_t material, uint32_t mesh, uint32_t depth);
+
+	// --------------------------------------------------------
+	// Get the pass a key is in
+	// --------------------------------------------------------
+	static RenderPass GetPass(uint64_t key);
+
+	// --------------------------------------------------------
+	// Quantize a view depth between 0 and farClip to the bits
+	// a key has for it
+	// --------------------------------------------------------
+	static uint32_t QuantizeDepth(float depth, float farClip);
+
+	// --------------------------------------------------------
+	// Remove all entries (keeps memory and ids)
+	// --------------------------------------------------------
+	void Clear();
+
+	// --------------------------------------------------------
+	// Add a draw of an item to the queue
+	//
+	// source - what the item was made from, the same object
+	//	every frame (lets the transparent pass start from the
+	//	last sorted order)
+	// --------------------------------------------------------
+	void Add(uint64_t key, uint32_t item, const void* source = nullptr);
+
+	// --------------------------------------------------------
+	// Sort the entries by key with a radix sort. Large queues
+	// are counted and scattered with parallel jobs. The
+	// transparent pass is sorted on its own (see above)
+	//
+	// passOnly - only group the entries by pass, keeping the
+	//	order they were added in (for comparing against)
+	// --------------------------------------------------------
+	void Sort(bool passOnly = false);
+
+	// --------------------------------------------------------
+	// Turn starting the transparent pass from the last sorted
+	// order on or off. Off always radix sorts it (for
+	// comparing against)
+	// --------------------------------------------------------
+	void SetCoherentSorting(bool coherent);
+
+	// --------------------------------------------------------
+	// Check if the last Sort() insertion sorted the
+	// transparent pass from the order before it
+	// --------------------------------------------------------
+	bool GetTransparentCoherent();
+
+	// --------------------------------------------------------
+	// Get the entries of the queue
+	// --------------------------------------------------------
+	const RenderQueueEntry* GetEntries();
+	size_t GetCount();
+
+	// --------------------------------------------------------
+	// Find the range of sorted entries in a pass
+	// --------------------------------------------------------
+	void GetPassRange(RenderPass pass, size_t* begin, size_t* end);
+};
\ No newline at end of file
@@ -2,19 +2,83 @@
 #include "LightManager.h"
 #include "ResourceManager.h"
 #include "ExtendedMath.h"
+#include "D3D11RenderDevice.h"
+#include "ParallelFor.h"
+#include <bitset>
+#include <cstring>
 
 using namespace DirectX;
 
+//The command list this thread is recording into, shaders bind through it
+static thread_local RenderCommandList* recordingList = nullptr;
+
+// Check if a shadow casting light's frustum had a renderer in it
+// (lights past the last visibility bit see everything)
+static inline bool ShadowVisible(uint32_t visibility, size_t lightIndex)
+{
+	if (lightIndex + 1 >= RENDER_BOUNDS_MAX_FRUSTUMS)
+		return true;
+	return ((visibility >> (lightIndex + 1)) & 1) != 0;
+}
+
+// Copy a list of debug shapes into a frame's arena, then age them
+template <typename T>
+static inline void ExtractShapeList(std::vector<T>* list, FrameArray<T>* frameList, FrameArena* arena, float deltaTime)
+{
+	*frameList = arena->AllocateArray<T>(list->size());
+	if (!list->empty())
+		memcpy(frameList->data, list->data(), sizeof(T) * list->size());
+
+	//Keep the shapes that still draw in one pass instead of erasing each one
+	size_t kept = 0;
+	for (size_t i = 0; i < list->size(); i++)
+	{
+		T& shape = (*list)[i];
+		if (shape.type == ShapeDrawType::ForDuration)
+			shape.duration -= deltaTime;
+		if (shape.type == ShapeDrawType::SingleFrame ||
+			(shape.type == ShapeDrawType::ForDuration && shape.duration <= 0))
+			continue;
+		if (kept != i)
+			(*list)[kept] = shape;
+		kept++;
+	}
+	list->erase(list->begin() + kept, list->end());
+}
+
 // Initialize values in the renderer
 void Renderer::Init(ID3D11Device* device, ID3D11DeviceContext* context, UINT width, UINT height)
 {
 	// Assign default clear color
 	this->SetClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
+	// Send draw commands to the context through the state cache until told otherwise
+	d3d11Device = new D3D11RenderDevice(context);
+	stateCache = new StateCacheRenderDevice(d3d11Device);
+	stateCacheStats = StateCacheStats{ 0, 0 };
+	renderDevice = stateCache;
+	this->device = device;
+	extractIndex = 0;
+	frameExtracted = false;
+	frame = nullptr;
+	sortRenderQueue = true;
+	cullingStats = CullingStats{ 0, 0, 0, 0 };
+	instancing = true;
+	parallelRecording = true;
+	objectInstanceBuffer = nullptr;
+	frameArenaStats = FrameArenaStats{ 0, 0, 0, 0 };
+	for (RenderFrame& f : frames)
+	{
+		f.cameraInstanceEntry = 0;
+		f.instanceBuffer = nullptr;
+		f.instanceCapacity = 0;
+		f.queueUnloadCount = ResourceManager::GetInstance()->GetUnloadCount();
+	}
+
 	// Tell the input assembler stage of the pipeline what kind of
 	// geometric primitives (points, lines or triangles) we want to draw.
 	// Essentially: "What kind of shape should the GPU draw with our data?"
-	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	renderDevice->SetPrimitiveTopology(RenderTopology::TriangleList);
 
 	// --------------------------------------------------------
 	//Get skybox information
@@ -94,11 +158,41 @@ void Renderer::Init(ID3D11Device* device, ID3D11DeviceContext* context, UINT wid
 	shadowRastDesc.DepthBiasClamp = 0.0f;
 	shadowRastDesc.SlopeScaledDepthBias = 1.0f;
 	device->CreateRasterizerState(&shadowRastDesc, &shadowRasterizer);
+
+	// --------------------------------------------------------
+	//Instanced shaders draw one object at a time from this buffer
+	// when a frame's instance buffer could not be made
+	D3D11_BUFFER_DESC objectInstanceDesc = {};
+	objectInstanceDesc.ByteWidth = sizeof(InstanceData);
+	objectInstanceDesc.Usage = D3D11_USAGE_DYNAMIC;
+	objectInstanceDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	objectInstanceDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	if (FAILED(device->CreateBuffer(&objectInstanceDesc, 0, &objectInstanceBuffer)))
+	{
+		printf("Failed to create the single object instance buffer\n");
+		objectInstanceBuffer = nullptr;
+	}
+
+	// --------------------------------------------------------
+	//Start drawing frames on the render thread
+	drawRequested = false;
+	drawing = false;
+	renderThreadRunning = true;
+	renderThread = std::thread(&Renderer::RenderThread, this);
 }
 
 // Destructor for when the singleton instance is deleted
 void Renderer::Release()
 {
+	//Stop the render thread once its frame is done
+	WaitForDraw();
+	{
+		std::lock_guard<std::mutex> lock(drawLock);
+		renderThreadRunning = false;
+	}
+	drawCondition.notify_all();
+	renderThread.join();
+
 	//Clean up skybox
 	skyDepthState->Release();
 	skyRasterState->Release();
@@ -109,357 +203,879 @@ void Renderer::Release()
 
 	//Clean up shadow map
 	shadowRasterizer->Release();
+
+	//Clean up instancing
+	if (objectInstanceBuffer != nullptr)
+		objectInstanceBuffer->Release();
+	objectInstanceBuffer = nullptr;
+	for (RenderFrame& f : frames)
+	{
+		if (f.instanceBuffer != nullptr)
+			f.instanceBuffer->Release();
+		f.instanceBuffer = nullptr;
+		f.instanceCapacity = 0;
+	}
+
+	delete stateCache;
+	stateCache = nullptr;
+	delete d3d11Device;
+	d3d11Device = nullptr;
+	renderDevice = nullptr;
+}
+
+// Get the device draw commands are sent through
+RenderDevice* Renderer::GetRenderDevice()
+{
+	if (recordingList != nullptr)
+		return recordingList;
+	return renderDevice;
+}
+
+// Get the command list this thread is recording
+RenderCommandList* Renderer::GetRecordingList()
+{
+	return recordingList;
+}
+
+// Send draw commands through another device (null restores the state cached D3D11 device)
+void Renderer::SetRenderDevice(RenderDevice* device)
+{
+	WaitForDraw();
+	renderDevice = device != nullptr ? device : stateCache;
+}
+
+// Get the binds the state cache sent on and dropped while drawing the last frame
+StateCacheStats Renderer::GetStateCacheStats()
+{
+	std::lock_guard<std::mutex> lock(drawLock);
+	return stateCacheStats;
+}
+
+// Make the state cache forget what is bound
+void Renderer::InvalidateStateCache()
+{
+	WaitForDraw();
+	stateCache->Invalidate();
+}
+
+// Turn sorting the render queue by key on or off
+void Renderer::SetRenderQueueSorting(bool sort)
+{
+	sortRenderQueue = sort;
+}
+
+// Check if the render queue is sorted by key
+bool Renderer::GetRenderQueueSorting()
+{
+	return sortRenderQueue;
+}
+
+// Get the visible and culled draws of the last frame
+CullingStats Renderer::GetCullingStats()
+{
+	return cullingStats;
+}
+
+// Turn drawing runs of the same material and mesh as one instanced draw on or off
+void Renderer::SetInstancing(bool instanced)
+{
+	WaitForDraw();
+	instancing = instanced;
+}
+
+// Check if runs of the same material and mesh are drawn as one instanced draw
+bool Renderer::GetInstancing()
+{
+	return instancing;
+}
+
+// Turn recording the camera passes in parallel chunks on or off
+void Renderer::SetParallelRecording(bool parallel)
+{
+	parallelRecording = parallel;
+}
+
+// Check if the camera passes are recorded in parallel
+bool Renderer::GetParallelRecording()
+{
+	return parallelRecording;
+}
+
+// Get how much of its arena the last extracted frame used
+FrameArenaStats Renderer::GetFrameArenaStats()
+{
+	return frameArenaStats;
+}
+
+// Cull the scene and copy what this frame draws into the next render frame
+void Renderer::ExtractFrame(Camera* camera, float deltaTime)
+{
+	RenderFrame* extracted = &frames[extractIndex];
+
+	//The drawing thread is done with this frame, its transient data can go
+	extracted->arena.Reset();
+
+	//Camera
+	CameraProxy& cam = extracted->camera;
+	cam.view = camera->GetViewMatrix();
+	cam.projection = camera->GetProjectionMatrix();
+	cam.rawView = camera->GetRawViewMatrix();
+	cam.rawProjection = camera->GetRawProjectionMatrix();
+	cam.position = camera->gameObject()->GetPosition();
+	cam.forward = camera->gameObject()->GetForwardAxis();
+	cam.farClip = camera->GetFarClip();
+
+	//Lights, shadow maps are created here so the render thread only reads them
+	LightManager* lightManager = LightManager::GetInstance();
+	memcpy(extracted->lights, lightManager->GetLightStructArray(), sizeof(LightStruct) * MAX_LIGHTS);
+	extracted->lightCount = lightManager->GetLightAmnt();
+	extracted->ambientLight = *lightManager->GetAmbientLight();
+
+	const std::vector<Light*>& lights = lightManager->GetShadowCastingLights();
+	extracted->shadowLights.resize(lights.size());
+	for (size_t l = 0; l < lights.size(); l++)
+	{
+		if (lights[l]->GetShadowSRV() == nullptr)
+			lights[l]->InitShadowMap(device);
+
+		ShadowLightProxy& proxy = extracted->shadowLights[l];
+		proxy.type = lights[l]->GetType();
+		proxy.view = lights[l]->GetViewMatrix();
+		proxy.projection = lights[l]->GetProjectionMatrix();
+		proxy.shadowDSV = lights[l]->GetShadowDSV();
+		proxy.shadowSRV = lights[l]->GetShadowSRV();
+	}
+
+	CullRenderBounds(*extracted);
+
+	ExtractRenderQueue(extracted);
+
+	BuildInstanceBuffer(extracted);
+
+	RecordCommandLists(extracted);
+
+	//Debug shapes are drawn from the frame and aged here
+	ExtractShapeList(&debugCubes, &extracted->debugCubes, &extracted->arena, deltaTime);
+	ExtractShapeList(&debugSpheres, &extracted->debugSpheres, &extracted->arena, deltaTime);
+	ExtractShapeList(&debugCapsules, &extracted->debugCapsules, &extracted->arena, deltaTime);
+	ExtractShapeList(&debugRays, &extracted->debugRays, &extracted->arena, deltaTime);
+
+	frameArenaStats = extracted->arena.GetStats();
+	frameExtracted = true;
+}
+
+// Take the last extracted frame to draw it
+bool Renderer::TakeExtractedFrame()
+{
+	if (!frameExtracted)
+		return false;
+
+	//The next frame is extracted into the other buffer
+	frame = &frames[extractIndex];
+	extractIndex = 1 - extractIndex;
+	frameExtracted = false;
+	return true;
 }
 
-// Draw all entities in the render list
+// Draw the last extracted frame on this thread
 void Renderer::Draw(ID3D11DeviceContext* context, 
 					ID3D11Device* device,
-					Camera* camera,
 					ID3D11RenderTargetView* backBufferRTV,
 					ID3D11DepthStencilView* depthStencilView,
 					ID3D11SamplerState* sampler,
-					UINT width, UINT height, float deltaTime)
+					UINT width, UINT height)
+{
+	WaitForDraw();
+	if (!TakeExtractedFrame())
+		return;
+
+	DrawFrame(RenderTargets{ context, device, backBufferRTV, depthStencilView, sampler, width, height });
+}
+
+// Hand the last extracted frame to the render thread
+void Renderer::BeginDraw(ID3D11DeviceContext* context,
+					ID3D11Device* device,
+					ID3D11RenderTargetView* backBufferRTV,
+					ID3D11DepthStencilView* depthStencilView,
+					ID3D11SamplerState* sampler,
+					UINT width, UINT height)
+{
+	WaitForDraw();
+	if (!TakeExtractedFrame())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(drawLock);
+		drawTargets = RenderTargets{ context, device, backBufferRTV, depthStencilView, sampler, width, height };
+		drawRequested = true;
+		drawing = true;
+	}
+	drawCondition.notify_all();
+}
+
+// Wait for the render thread to finish the frame it is drawing
+void Renderer::WaitForDraw()
+{
+	std::unique_lock<std::mutex> lock(drawLock);
+	drawCondition.wait(lock, [this] { return !drawing; });
+}
+
+// Draw frames handed over by BeginDraw() until the renderer is released
+void Renderer::RenderThread()
+{
+	while (true)
+	{
+		RenderTargets targets;
+		{
+			std::unique_lock<std::mutex> lock(drawLock);
+			drawCondition.wait(lock, [this] { return !renderThreadRunning || drawRequested; });
+			if (!renderThreadRunning)
+				return;
+
+			targets = drawTargets;
+			drawRequested = false;
+		}
+
+		DrawFrame(targets);
+
+		{
+			std::lock_guard<std::mutex> lock(drawLock);
+			drawing = false;
+		}
+		drawCondition.notify_all();
+	}
+}
+
+// Draw the frame being drawn by submitting its command lists
+void Renderer::DrawFrame(const RenderTargets& targets)
 {
 	// Clear the render target and depth buffer (erases what's on the screen)
 	//  - Do this ONCE PER FRAME
 	//  - At the beginning of Draw (before drawing *anything*)
-	context->ClearRenderTargetView(backBufferRTV, this->clearColor);
-	context->ClearDepthStencilView(
-		depthStencilView,
-		D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL,
+	renderDevice->ClearRenderTarget(ToHandle(targets.backBufferRTV), this->clearColor);
+	renderDevice->ClearDepthStencil(
+		ToHandle(targets.depthStencilView),
+		DepthClear::DepthStencil,
 		1.0f,
 		0);
 
-	RenderShadowMaps(context, device, camera, backBufferRTV, depthStencilView, width, height);
+	//Upload this frame's instances
+	if (frame->instanceBuffer != nullptr && !frame->instances.empty())
+	{
+		renderDevice->WriteBuffer(ToHandle(frame->instanceBuffer), frame->instances.data(), frame->instances.size() * sizeof(InstanceData));
+		renderDevice->SetInstanceBuffer(ToHandle(frame->instanceBuffer), sizeof(InstanceData), 0);
+	}
 
-	DrawOpaqueObjects(context, camera);
+	frame->shadowCommands.Submit(renderDevice);
 
-	DrawSky(context, camera);
+	// Revert to original pipeline state
+	RenderViewport vp = {};
+	vp.width = (float)targets.width;
+	vp.height = (float)targets.height;
+	vp.minDepth = 0.0f;
+	vp.maxDepth = 1.0f;
+	renderDevice->SetRenderTarget(ToHandle(targets.backBufferRTV), ToHandle(targets.depthStencilView));
+	renderDevice->SetViewport(vp);
+	renderDevice->SetRasterizerState(0);
+
+	//Opaque chunks in sort order
+	for (const RenderCommandList& commands : frame->opaqueCommands)
+		commands.Submit(renderDevice);
+
+	frame->skyCommands.Submit(renderDevice);
 	
-	DrawDebugShapes(context, camera, deltaTime);
+	DrawDebugShapes(renderDevice->GetBackend() == d3d11Device ? d3d11Device->GetContext() : nullptr);
 
-	DrawTransparentObjects(context, camera);
+	DrawTransparentObjects();
 
 	// Need to unbind the shadow map from pixel shader stage
 	// so it can be rendered into properly next frame
 	// (Just unbinding all since we don't know which register its in)
-	ID3D11ShaderResourceView* nullSRVs[16] = {};
-	context->PSSetShaderResources(0, 16, nullSRVs);
+	RenderShaderResource* nullSRVs[16] = {};
+	renderDevice->SetShaderResources(ShaderStage::Pixel, 0, 16, nullSRVs);
+
+	//Keep what the state cache did this frame
+	std::lock_guard<std::mutex> lock(drawLock);
+	stateCacheStats = stateCache->GetStats();
+	stateCache->ResetStats();
 }
 
-// Render shadow maps for all lights that cast shadows
-void Renderer::RenderShadowMaps(ID3D11DeviceContext* context,
-	ID3D11Device* device,
-	Camera* camera,
-	ID3D11RenderTargetView* backBufferRTV,
-	ID3D11DepthStencilView* depthStencilView,
-	UINT width, UINT height)
+// Sync the render bounds and cull them against the camera and shadow casting lights
+void Renderer::CullRenderBounds(const RenderFrame& extracted)
 {
-	std::vector<Light*> lights = LightManager::GetInstance()->GetShadowCastingLights();
-	context->RSSetState(shadowRasterizer);
-	context->PSSetShader(0, 0, 0); // Turns OFF the pixel shader
+	renderBounds.Sync();
 
-	// SET A VIEWPORT!!!
-	D3D11_VIEWPORT vp = {};
-	vp.TopLeftX = 0;
-	vp.TopLeftY = 0;
-	vp.Width = (float)SHADOW_MAP_SIZE;
-	vp.Height = (float)SHADOW_MAP_SIZE;
-	vp.MinDepth = 0.0f;
-	vp.MaxDepth = 1.0f;
-	context->RSSetViewports(1, &vp);
+	//Lights past the last bit are never culled
+	const std::vector<ShadowLightProxy>& lights = extracted.shadowLights;
+	cullFrustums.clear();
+	cullFrustums.push_back(Frustum(extracted.camera.rawView, extracted.camera.rawProjection));
+	for (size_t l = 0; l < lights.size() && cullFrustums.size() < RENDER_BOUNDS_MAX_FRUSTUMS; l++)
+	{
+		//Only directional lights have shadow matrices, the rest see everything
+		if (lights[l].type != LightType::DirectionalLight)
+		{
+			cullFrustums.push_back(Frustum());
+			continue;
+		}
 
-	//Loop through all lights that cast shadows and draw to their textures
-	for (auto l : lights)
+		//Light matrices are transposed for the shaders
+		XMFLOAT4X4 view;
+		XMFLOAT4X4 projection;
+		XMStoreFloat4x4(&view, XMMatrixTranspose(XMLoadFloat4x4(&lights[l].view)));
+		XMStoreFloat4x4(&projection, XMMatrixTranspose(XMLoadFloat4x4(&lights[l].projection)));
+		cullFrustums.push_back(Frustum(view, projection));
+	}
+
+	renderBounds.Cull(cullFrustums.data(), cullFrustums.size());
+	cullingStats = CullingStats{ 0, 0, 0, 0 };
+}
+
+// Copy every visible enabled mesh renderer into a frame and fill its render queue
+void Renderer::ExtractRenderQueue(RenderFrame* extracted)
+{
+	RenderQueue& renderQueue = extracted->queue;
+	std::vector<RenderProxy>& proxies = extracted->proxies;
+	renderQueue.Clear();
+	proxies.clear();
+
+	//Unloaded resources leave ids behind, and their addresses can be
+	// reused by new ones
+	uint32_t unloadCount = ResourceManager::GetInstance()->GetUnloadCount();
+	if (extracted->queueUnloadCount != unloadCount)
 	{
-		//Create shadow SRV if it does not exist
-		if (l->GetShadowSRV() == nullptr)
-			l->InitShadowMap(device);
+		renderQueue.ResetIds();
+		extracted->queueUnloadCount = unloadCount;
+	}
 
-		ID3D11DepthStencilView* shadowDSV = l->GetShadowDSV();
-		ID3D11ShaderResourceView* shadowSRV = l->GetShadowSRV();
+	XMVECTOR eye = XMLoadFloat3(&extracted->camera.position);
+	XMVECTOR forward = XMLoadFloat3(&extracted->camera.forward);
+	float farClip = extracted->camera.farClip;
 
-		// Initial setup - No RTV necessary - Clear shadow map
-		context->OMSetRenderTargets(0, 0, shadowDSV);
-		context->ClearDepthStencilView(shadowDSV, D3D11_CLEAR_DEPTH, 1.0f, 0);
+	//Lights past the last visibility bit draw every shadow
+	size_t lightCount = cullFrustums.size() - 1;
+	bool drawAllShadows = extracted->shadowLights.size() > lightCount;
 
-		// Set up the shaders
-		shadowVS->SetShader();
-		shadowVS->SetMatrix4x4("view", l->GetViewMatrix());
-		shadowVS->SetMatrix4x4("projection", l->GetProjectionMatrix());
-		shadowVS->CopyBufferData("once");
+	for (auto const& mapPair : renderMap)
+	{
+		//Skip lists with nothing enabled
+		const RenderList& list = mapPair.second;
+		if (list.activeCount < 1)
+			continue;
 
-		//Loop through entities (simplified. Look at DrawOpaqueObjects for better documentation)
-		for (auto const& mapPair : renderMap)
+		//Everything in a list shares these parts of its keys
+		Material* mat = mapPair.first.material;
+		Mesh* mesh = mapPair.first.mesh;
+		uint32_t vsId = renderQueue.GetShaderId(mat->GetVertexShader());
+		uint32_t psId = renderQueue.GetShaderId(mat->GetPixelShader());
+		uint32_t matId = renderQueue.GetMaterialId(mat);
+		uint32_t meshId = renderQueue.GetMeshId(mesh);
+		bool transparent = mat->GetAlpha() < 1;
+
+		for (size_t i = 0; i < list.activeCount; i++)
 		{
-			if (mapPair.second.size() < 1)
-				return;
+			MeshRenderer* mr = list.renderers[i];
+
+			//Skip anything no frustum can see
+			uint32_t visibility = renderBounds.GetVisibility(mr);
+			size_t shadowVisible = std::bitset<32>(visibility & ~1u).count();
+			cullingStats.shadowVisible += shadowVisible;
+			cullingStats.shadowCulled += lightCount - shadowVisible;
+			if ((visibility & 1) == 0)
+				cullingStats.cameraCulled++;
+			if (visibility == 0 && !drawAllShadows)
+				continue;
+
+			//Copy what drawing it reads
+			GameObject* obj = mr->gameObject();
+			uint32_t item = (uint32_t)proxies.size();
+			proxies.push_back(RenderProxy{ obj->GetWorldMatrix(), obj->GetWorldInvTransMatrix(),
+				obj->GetPosition(), visibility, mesh, mat, mr->GetRenderLayer() });
+			const RenderProxy& proxy = proxies.back();
+
+			//Distance along the view direction
+			float depth = XMVectorGetX(XMVector3Dot(XMVectorSubtract(XMLoadFloat3(&proxy.position), eye), forward));
+			uint32_t quantized = RenderQueue::QuantizeDepth(depth, farClip);
+
+			unsigned int layer = proxy.layer;
+			if ((visibility & ~1u) || drawAllShadows)
+				renderQueue.Add(RenderQueue::MakeShadowKey(layer, meshId), item);
+			if ((visibility & 1) == 0)
+				continue;
 
-			std::vector<MeshRenderer*> list = mapPair.second;
+			cullingStats.cameraVisible++;
 
-			Mesh* mesh = list[0]->GetMesh();
+			//Transparent draws are found in the last sorted order by their renderer
+			if (transparent)
+				renderQueue.Add(RenderQueue::MakeTransparentKey(layer, vsId, psId, matId, meshId, quantized), item, mr);
+			else renderQueue.Add(RenderQueue::MakeOpaqueKey(layer, vsId, psId, matId, meshId, quantized), item);
+		}
+	}
 
-			// Set buffers in the input assembler
-			UINT stride = sizeof(Vertex);
-			UINT offset = 0;
-			ID3D11Buffer* vertexBuffer = mesh->GetVertexBuffer();
-			ID3D11Buffer* indexBuffer = mesh->GetIndexBuffer();
-			context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-			context->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-
-			//Loop through each entity in the list
-			for (size_t i = 0; i < list.size(); i++)
-			{
-				//Don't draw disabled entities
-				if (!list[i]->gameObject()->GetEnabled())
-					continue;
+	//Without sorting passes are still grouped, but draws keep render list order
+	renderQueue.Sort(!sortRenderQueue);
+}
+
+// Fill a frame's instances for its sorted render queue and grow its instance buffer
+void Renderer::BuildInstanceBuffer(RenderFrame* extracted)
+{
+	RenderQueue& renderQueue = extracted->queue;
+	const std::vector<RenderProxy>& proxies = extracted->proxies;
+	std::vector<InstanceData>& instanceData = extracted->instances;
+	size_t shadowBegin, shadowEnd;
+	renderQueue.GetPassRange(RenderPass::Shadow, &shadowBegin, &shadowEnd);
+	const RenderQueueEntry* entries = renderQueue.GetEntries();
+	size_t count = renderQueue.GetCount();
+
+	//The camera passes follow the shadow pass, one instance per entry
+	extracted->cameraInstanceEntry = shadowEnd;
+	instanceData.resize(count - shadowEnd);
+	for (size_t i = shadowEnd; i < count; i++)
+	{
+		const RenderProxy& proxy = proxies[entries[i].item];
+		if (!proxy.material->GetVertexShader()->GetPerInstanceCompatible())
+			continue;
 
-				shadowVS->SetMatrix4x4("world", list[i]->gameObject()->GetWorldMatrix());
-				shadowVS->CopyBufferData("perObject");
+		InstanceData& instance = instanceData[i - shadowEnd];
+		instance.world = proxy.world;
+		instance.worldInvTrans = proxy.worldInvTrans;
+	}
 
-				// Finally do the actual drawing
-				context->DrawIndexed(mesh->GetIndexCount(), 0, 0);
-			}
+	//Each light's visible shadow entries (the shadow shader only reads the world matrix)
+	const std::vector<ShadowLightProxy>& lights = extracted->shadowLights;
+	extracted->shadowInstanceStarts.resize(lights.size());
+	for (size_t l = 0; l < lights.size(); l++)
+	{
+		extracted->shadowInstanceStarts[l] = instanceData.size();
+		for (size_t i = shadowBegin; i < shadowEnd; i++)
+		{
+			const RenderProxy& proxy = proxies[entries[i].item];
+			if (ShadowVisible(proxy.visibility, l))
+				instanceData.push_back(InstanceData{ proxy.world });
 		}
 	}
 
-	// Revert to original pipeline state
-	context->OMSetRenderTargets(1, &backBufferRTV, depthStencilView);
-	vp.Width = (float)width;
-	vp.Height = (float)height;
-	context->RSSetViewports(1, &vp);
-	context->RSSetState(0);
+	//Grow the buffer if this frame has more instances than it holds.
+	// The render thread never uses this frame's buffer while it is extracted
+	if (instanceData.size() > extracted->instanceCapacity)
+	{
+		size_t& capacity = extracted->instanceCapacity;
+		if (extracted->instanceBuffer != nullptr)
+			extracted->instanceBuffer->Release();
+		extracted->instanceBuffer = nullptr;
+		capacity = instanceData.size() > capacity * 2 ? instanceData.size() : capacity * 2;
+
+		D3D11_BUFFER_DESC desc = {};
+		desc.ByteWidth = (UINT)(capacity * sizeof(InstanceData));
+		desc.Usage = D3D11_USAGE_DYNAMIC;
+		desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		if (FAILED(device->CreateBuffer(&desc, 0, &extracted->instanceBuffer)))
+		{
+			printf("Failed to create an instance buffer for %zu instances\n", capacity);
+			extracted->instanceBuffer = nullptr;
+			capacity = 0;
+		}
+	}
 }
 
-// Draw opaque objects
-void Renderer::DrawOpaqueObjects(ID3D11DeviceContext* context, Camera* camera)
+// Record a frame's draws into its command lists
+void Renderer::RecordCommandLists(RenderFrame* extracted)
 {
-	//TODO: Apply attenuation
-	//context->OMSetDepthStencilState(waterDepthState, 0);
-	for (auto const& mapPair : renderMap)
+	RecordShadowMaps(extracted);
+
+	//Split the camera passes into chunks and record them at once
+	recordChunks.clear();
+	AddRecordChunks(extracted, RenderPass::Opaque, &extracted->opaqueCommands);
+	AddRecordChunks(extracted, RenderPass::Transparent, &extracted->transparentCommands);
+	if (recordChunks.size() == 1)
+		RecordChunks(recordChunks.data(), 1);
+	else if (recordChunks.size() > 1)
 	{
-		if (mapPair.second.size() < 1)
-			return;
+		Job* job = parallel_for(recordChunks.data(), (unsigned int)recordChunks.size(), &Renderer::RecordChunks, CountSplitter(1));
+		JobSystem::Run(job);
+		JobSystem::Wait(job);
+	}
 
-		//Get list, material, and mesh
-		std::vector<MeshRenderer*> list = mapPair.second;
+	RecordSky(extracted);
+}
 
-		Material* mat = list[0]->GetMaterial();
-		Mesh* mesh = list[0]->GetMesh();
+// Split a camera pass of a frame into chunks to record
+void Renderer::AddRecordChunks(RenderFrame* extracted, RenderPass pass, std::vector<RenderCommandList>* lists)
+{
+	size_t begin, end;
+	extracted->queue.GetPassRange(pass, &begin, &end);
+	const RenderQueueEntry* entries = extracted->queue.GetEntries();
+	const std::vector<RenderProxy>& proxies = extracted->proxies;
+
+	//Small passes are one chunk
+	size_t chunkSize = RENDER_COMMAND_CHUNK_SIZE;
+	if (!parallelRecording || end - begin < RENDER_COMMAND_PARALLEL_SIZE)
+		chunkSize = end - begin;
+	size_t first = recordChunks.size();
+	for (size_t i = begin; i < end;)
+	{
+		//Move the end past the run it lands in, a run is one instanced draw
+		size_t chunkEnd = end - i > chunkSize ? i + chunkSize : end;
+		while (chunkEnd < end && proxies[entries[chunkEnd].item].material == proxies[entries[chunkEnd - 1].item].material
+			&& proxies[entries[chunkEnd].item].mesh == proxies[entries[chunkEnd - 1].item].mesh)
+			chunkEnd++;
+
+		recordChunks.push_back(RenderRecordChunk{ extracted, i, chunkEnd, nullptr });
+		i = chunkEnd;
+	}
 
-		//Since materials are shared, if the alpha is below 1 add them all to the transparency list
-		if (mat->GetAlpha() < 1)
+	//One list per chunk, its commands are allocated from the frame's arena
+	lists->resize(recordChunks.size() - first);
+	for (size_t c = first; c < recordChunks.size(); c++)
+	{
+		recordChunks[c].commands = &(*lists)[c - first];
+		recordChunks[c].commands->Reset(&extracted->arena);
+	}
+}
+
+// Record a set of chunks into their command lists
+void Renderer::RecordChunks(RenderRecordChunk* chunks, unsigned int count)
+{
+	Renderer* renderer = GetInstance();
+	for (unsigned int c = 0; c < count; c++)
+		renderer->RecordRenderQueue(*chunks[c].frame, chunks[c].commands, chunks[c].begin, chunks[c].end);
+}
+
+// Record a range of render queue entries with their materials
+void Renderer::RecordRenderQueue(const RenderFrame& recorded, RenderCommandList* commands, size_t begin, size_t end)
+{
+	const RenderQueueEntry* entries = recorded.queue.GetEntries();
+	const std::vector<RenderProxy>& proxies = recorded.proxies;
+	recordingList = commands;
+
+	//Only rebind what changes between draws. Each chunk starts with nothing bound
+	Material* currentMat = nullptr;
+	Mesh* currentMesh = nullptr;
+	SimpleVertexShader* currentVS = nullptr;
+	SimplePixelShader* currentPS = nullptr;
+	for (size_t i = begin; i < end;)
+	{
+		const RenderProxy& proxy = proxies[entries[i].item];
+		Material* mat = proxy.material;
+		Mesh* mesh = proxy.mesh;
+
+		if (mat != currentMat)
 		{
-			for (size_t i = 0; i < list.size(); i++)
+			// Turn shaders on
+			if (mat->GetVertexShader() != currentVS)
 			{
-				transparentObjList.push_back(list[0]);
+				currentVS = mat->GetVertexShader();
+				currentVS->SetShader();
+			}
+			if (mat->GetPixelShader() != currentPS)
+			{
+				currentPS = mat->GetPixelShader();
+				currentPS->SetShader();
 			}
-			continue;
-		}
-
-		// Turn shaders on
-		mat->GetVertexShader()->SetShader();
-		mat->GetPixelShader()->SetShader();
-
-		//Prepare the material's combo specific variables
-		mat->PrepareMaterialCombo(list[0]->gameObject(), camera);
 
-		// Set buffers in the input assembler
-		UINT stride = sizeof(Vertex);
-		UINT offset = 0;
-		ID3D11Buffer* vertexBuffer = mesh->GetVertexBuffer();
-		ID3D11Buffer* indexBuffer = mesh->GetIndexBuffer();
-		context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-		context->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+			//Prepare the material's combo specific variables
+			mat->PrepareMaterialCombo(recorded);
+			currentMat = mat;
+		}
 
-		//Loop through each entity in the list
-		for (size_t i = 0; i < list.size(); i++)
+		if (mesh != currentMesh)
 		{
-			//Don't draw disabled entities
-			if (!list[i]->gameObject()->GetEnabled())
-				continue;
+			// Set buffers in the input assembler
+			commands->SetVertexBuffer(ToHandle(mesh->GetVertexBuffer()), sizeof(Vertex), 0);
+			commands->SetIndexBuffer(ToHandle(mesh->GetIndexBuffer()), RenderIndexFormat::UInt32);
+			currentMesh = mesh;
+		}
 
+		//Shaders without per instance data draw one object at a time
+		if (!currentVS->GetPerInstanceCompatible() || recorded.instanceBuffer == nullptr)
+		{
 			//Prepare the material's object specific variables
-			mat->PrepareMaterialObject(list[i]->gameObject());
+			mat->PrepareMaterialObject(proxy);
+
+			//Instanced shaders read the object from its own one instance buffer
+			if (currentVS->GetPerInstanceCompatible())
+			{
+				if (objectInstanceBuffer != nullptr)
+				{
+					InstanceData objectInstance = { proxy.world, proxy.worldInvTrans };
+					commands->WriteBuffer(ToHandle(objectInstanceBuffer), &objectInstance, sizeof(InstanceData));
+					commands->SetInstanceBuffer(ToHandle(objectInstanceBuffer), sizeof(InstanceData), 0);
+					commands->DrawIndexedInstanced(mesh->GetIndexCount(), 1, 0, 0, 0);
+				}
+				i++;
+				continue;
+			}
 
 			// Finally do the actual drawing
 			//  - Do this ONCE PER OBJECT you intend to draw
 			//  - This will use all of the currently set DirectX "stuff" (shaders, buffers, etc)
 			//  - DrawIndexed() uses the currently set INDEX BUFFER to look up corresponding
 			//     vertices in the currently set VERTEX BUFFER
-			context->DrawIndexed(
+			commands->DrawIndexed(
 				mesh->GetIndexCount(),     // The number of indices to use (we could draw a subset if we wanted)
 				0,     // Offset to the first index we want to use
 				0);    // Offset to add to each index when looking up vertices
+			i++;
+			continue;
 		}
+
+		//Draw the run of entries with this material and mesh at once
+		size_t runEnd = i + 1;
+		if (instancing)
+		{
+			while (runEnd < end && proxies[entries[runEnd].item].material == mat
+				&& proxies[entries[runEnd].item].mesh == mesh)
+				runEnd++;
+		}
+		commands->DrawIndexedInstanced(mesh->GetIndexCount(), (UINT)(runEnd - i), 0, 0,
+			(UINT)(i - recorded.cameraInstanceEntry));
+		i = runEnd;
 	}
-	//context->OMSetDepthStencilState(0, 0);
+
+	recordingList = nullptr;
 }
 
-// Draw transparent objects
-//TODO: Sort objects by distance from camera
-void Renderer::DrawTransparentObjects(ID3D11DeviceContext * context, Camera * camera)
+// Record rendering shadow maps for all lights that cast shadows
+void Renderer::RecordShadowMaps(RenderFrame* extracted)
 {
-	if (transparentObjList.size() < 1)
-		return;
+	RenderCommandList* commands = &extracted->shadowCommands;
+	commands->Reset(&extracted->arena);
+	recordingList = commands;
 
-	//Set render states
-	context->OMSetBlendState(transparentBlendState, 0, 0xFFFFFFFF);
-	context->OMSetDepthStencilState(transparentDepthState, 0);
+	const std::vector<ShadowLightProxy>& lights = extracted->shadowLights;
+	commands->SetRasterizerState(ToHandle(shadowRasterizer));
+	commands->SetShader(ShaderStage::Pixel, 0); // Turns OFF the pixel shader
+
+	// SET A VIEWPORT!!!
+	RenderViewport vp = {};
+	vp.x = 0;
+	vp.y = 0;
+	vp.width = (float)SHADOW_MAP_SIZE;
+	vp.height = (float)SHADOW_MAP_SIZE;
+	vp.minDepth = 0.0f;
+	vp.maxDepth = 1.0f;
+	commands->SetViewport(vp);
+
+	size_t begin, end;
+	extracted->queue.GetPassRange(RenderPass::Shadow, &begin, &end);
+	const RenderQueueEntry* entries = extracted->queue.GetEntries();
+	const std::vector<RenderProxy>& proxies = extracted->proxies;
 
-	//Loop through each entity in the transparent list
-	for (size_t i = 0; i < transparentObjList.size(); i++)
+	//Loop through all lights that cast shadows and draw to their textures
+	for (size_t lightIndex = 0; lightIndex < lights.size(); lightIndex++)
 	{
-		//Don't draw disabled entities
-		if (!transparentObjList[i]->gameObject()->GetEnabled())
-			continue;
+		const ShadowLightProxy& l = lights[lightIndex];
 
-		Material* mat = transparentObjList[0]->GetMaterial();
-		Mesh* mesh = transparentObjList[0]->GetMesh();
+		// Initial setup - No RTV necessary - Clear shadow map
+		commands->SetRenderTarget(0, ToHandle(l.shadowDSV));
+		commands->ClearDepthStencil(ToHandle(l.shadowDSV), DepthClear::Depth, 1.0f, 0);
 
-		// Turn shaders on
-		mat->GetVertexShader()->SetShader();
-		mat->GetPixelShader()->SetShader();
+		// Set up the shaders
+		shadowVS->SetShader();
+		shadowVS->SetMatrix4x4(SID("view"), l.view);
+		shadowVS->SetMatrix4x4(SID("projection"), l.projection);
+		shadowVS->CopyBufferData(SID("once"));
+
+		//Loop through the shadow pass, which is sorted by mesh. This light's
+		// instances are its visible entries in order
+		Mesh* currentMesh = nullptr;
+		size_t instance = extracted->shadowInstanceStarts[lightIndex];
+		for (size_t i = begin; i < end;)
+		{
+			//Skip what is outside this light's frustum
+			const RenderProxy& proxy = proxies[entries[i].item];
+			if (!ShadowVisible(proxy.visibility, lightIndex))
+			{
+				i++;
+				continue;
+			}
 
-		//Prepare the material's combo specific variables
-		mat->PrepareMaterialCombo(transparentObjList[0]->gameObject(), camera);
+			Mesh* mesh = proxy.mesh;
+			if (mesh != currentMesh)
+			{
+				// Set buffers in the input assembler
+				commands->SetVertexBuffer(ToHandle(mesh->GetVertexBuffer()), sizeof(Vertex), 0);
+				commands->SetIndexBuffer(ToHandle(mesh->GetIndexBuffer()), RenderIndexFormat::UInt32);
+				currentMesh = mesh;
+			}
 
-		// Set buffers in the input assembler
-		UINT stride = sizeof(Vertex);
-		UINT offset = 0;
-		ID3D11Buffer* vertexBuffer = mesh->GetVertexBuffer();
-		ID3D11Buffer* indexBuffer = mesh->GetIndexBuffer();
-		context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-		context->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+			//Without the frame's instance buffer, draw each caster from its own
+			if (extracted->instanceBuffer == nullptr)
+			{
+				if (objectInstanceBuffer != nullptr)
+				{
+					InstanceData objectInstance = { proxy.world };
+					commands->WriteBuffer(ToHandle(objectInstanceBuffer), &objectInstance, sizeof(InstanceData));
+					commands->SetInstanceBuffer(ToHandle(objectInstanceBuffer), sizeof(InstanceData), 0);
+					commands->DrawIndexedInstanced(mesh->GetIndexCount(), 1, 0, 0, 0);
+				}
+				i++;
+				continue;
+			}
 
-		//Prepare the material's object specific variables
-		mat->PrepareMaterialObject(transparentObjList[i]->gameObject());
+			//Draw the run of visible entries with this mesh at once
+			UINT instanceCount = 1;
+			size_t next = i + 1;
+			for (; instancing && next < end; next++)
+			{
+				const RenderProxy& other = proxies[entries[next].item];
+				if (!ShadowVisible(other.visibility, lightIndex))
+					continue;
+				if (other.mesh != mesh)
+					break;
+				instanceCount++;
+			}
 
-		// Finally do the actual drawing
-		//  - Do this ONCE PER OBJECT you intend to draw
-		//  - This will use all of the currently set DirectX "stuff" (shaders, buffers, etc)
-		//  - DrawIndexed() uses the currently set INDEX BUFFER to look up corresponding
-		//     vertices in the currently set VERTEX BUFFER
-		context->DrawIndexed(
-			mesh->GetIndexCount(),     // The number of indices to use (we could draw a subset if we wanted)
-			0,     // Offset to the first index we want to use
-			0);    // Offset to add to each index when looking up vertices
+			commands->DrawIndexedInstanced(mesh->GetIndexCount(), instanceCount, 0, 0, (UINT)instance);
+			instance += instanceCount;
+			i = next;
+		}
 	}
 
+	recordingList = nullptr;
+}
+
+// Draw transparent objects, farthest first
+void Renderer::DrawTransparentObjects()
+{
+	if (frame->transparentCommands.empty())
+		return;
+
+	//Set render states
+	renderDevice->SetBlendState(ToHandle(transparentBlendState));
+	renderDevice->SetDepthStencilState(ToHandle(transparentDepthState), 0);
+
+	//Chunks in sort order
+	for (const RenderCommandList& commands : frame->transparentCommands)
+		commands.Submit(renderDevice);
+
 	// Reset states
-	context->OMSetDepthStencilState(0, 0);
-	context->OMSetBlendState(0, 0, 0xFFFFFFFF);
+	renderDevice->SetDepthStencilState(0, 0);
+	renderDevice->SetBlendState(0);
 }
 
 template <typename T, typename F>
-static inline void DrawShapeList(std::vector<T>* list, F drawFunc, 
-	PrimitiveBatch<VertexPositionColor>* batch, float deltaTime)
+static inline void DrawShapeList(const FrameArray<T>& list, F drawFunc, 
+	PrimitiveBatch<VertexPositionColor>* batch)
 {
-	auto iter = list->end();
-	while (iter > list->begin())
-	{
-		iter--;
-		drawFunc(batch, *iter, Colors::LightGreen);
-		
-		if (iter->type == ShapeDrawType::ForDuration)
-			iter->duration -= deltaTime;
-		//Erase objs that need to be
-		if (iter->type == ShapeDrawType::SingleFrame ||
-			(iter->type == ShapeDrawType::ForDuration && iter->duration <= 0))
-			iter = list->erase(iter);
-	}
+	for (const T& shape : list)
+		drawFunc(batch, shape, Colors::LightGreen);
 }
 // Draw debug shapes
-void Renderer::DrawDebugShapes(ID3D11DeviceContext* context, Camera* camera, float deltaTime)
+void Renderer::DrawDebugShapes(ID3D11DeviceContext* context)
 {
-	if (debugCubes.size() < 1 && debugSpheres.size() < 1 && debugCapsules.size() < 1
-		&& debugRays.size() < 1)
+	if (frame->debugCubes.size() < 1 && frame->debugSpheres.size() < 1 && frame->debugCapsules.size() < 1
+		&& frame->debugRays.size() < 1)
+		return;
+
+	//The debug batch draws with the context directly
+	if (context == nullptr)
 		return;
 	
-	db_effect->SetProjection(XMLoadFloat4x4(&camera->GetRawProjectionMatrix()));
-	db_effect->SetView(XMLoadFloat4x4(&camera->GetRawViewMatrix()));
+	db_effect->SetProjection(XMLoadFloat4x4(&frame->camera.rawProjection));
+	db_effect->SetView(XMLoadFloat4x4(&frame->camera.rawView));
 
-	context->OMSetBlendState(db_states->Opaque(), nullptr, 0xFFFFFFFF);
-	context->RSSetState(db_states->CullNone());
+	renderDevice->SetBlendState(ToHandle(db_states->Opaque()));
+	renderDevice->SetRasterizerState(ToHandle(db_states->CullNone()));
 
 	db_effect->Apply(context);
 
-	context->IASetInputLayout(db_inputLayout.Get());
+	renderDevice->SetInputLayout(ToHandle(db_inputLayout.Get()));
 
 	//Do the actual drawing
 	db_batch->Begin();
 
-	DrawShapeList<ShapeXMFloat3Data>(&debugCubes, &DrawCube, db_batch.get(), deltaTime);
-	DrawShapeList<ShapeFloat1Data>(&debugSpheres, &DrawSphere, db_batch.get(), deltaTime);
-	DrawShapeList<ShapeXMFloat2Data>(&debugCapsules, &DrawCapsule, db_batch.get(), deltaTime);
-	DrawShapeList<ShapeFloat1Data>(&debugRays, &DrawRay, db_batch.get(), deltaTime);
+	DrawShapeList<ShapeXMFloat3Data>(frame->debugCubes, &DrawCube, db_batch.get());
+	DrawShapeList<ShapeFloat1Data>(frame->debugSpheres, &DrawSphere, db_batch.get());
+	DrawShapeList<ShapeXMFloat2Data>(frame->debugCapsules, &DrawCapsule, db_batch.get());
+	DrawShapeList<ShapeFloat1Data>(frame->debugRays, &DrawRay, db_batch.get());
 
 	db_batch->End();
 
+	//The effect and batch bound to the context behind the state cache's back
+	stateCache->Invalidate();
+
 	//Cleanup
-	context->IASetInputLayout(0);
-	context->RSSetState(0);
-	context->OMSetBlendState(0, 0, 0xFFFFFFFF);
-	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	renderDevice->SetInputLayout(0);
+	renderDevice->SetRasterizerState(0);
+	renderDevice->SetBlendState(0);
+	renderDevice->SetPrimitiveTopology(RenderTopology::TriangleList);
 }
 
-void Renderer::DrawSky(ID3D11DeviceContext* context, Camera* camera)
+// Record drawing the skybox
+void Renderer::RecordSky(RenderFrame* extracted)
 {
+	RenderCommandList* commands = &extracted->skyCommands;
+	commands->Reset(&extracted->arena);
+
 	//Return if we don't have a skybox
 	if (!skyboxMat)
 		return;
 
 	// Set up the shaders
-	skyboxMat->PrepareMaterialCombo(nullptr, camera);
+	recordingList = commands;
+	skyboxMat->PrepareMaterialCombo(*extracted);
+	recordingList = nullptr;
 
 	// Set buffers in the input assembler
 	UINT stride = sizeof(Vertex);
 	UINT offset = 0;
 	ID3D11Buffer* vertexBuffer = cubeMesh->GetVertexBuffer();
 	ID3D11Buffer* indexBuffer = cubeMesh->GetIndexBuffer();
-	context->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-	context->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	commands->SetVertexBuffer(ToHandle(vertexBuffer), stride, offset);
+	commands->SetIndexBuffer(ToHandle(indexBuffer), RenderIndexFormat::UInt32);
 
 	// Set up any new render states
-	context->RSSetState(skyRasterState);
-	context->OMSetDepthStencilState(skyDepthState, 0);
+	commands->SetRasterizerState(ToHandle(skyRasterState));
+	commands->SetDepthStencilState(ToHandle(skyDepthState), 0);
 
 	// Draw
-	context->DrawIndexed(cubeMesh->GetIndexCount(), 0, 0);
+	commands->DrawIndexed(cubeMesh->GetIndexCount(), 0, 0);
 
 	// Reset states
-	context->RSSetState(0);
-	context->OMSetDepthStencilState(0, 0);
+	commands->SetRasterizerState(0);
+	commands->SetDepthStencilState(0, 0);
+}
+
+// Make room for a number of mesh renderers using a mesh and material
+void Renderer::ReserveMeshRenderers(Mesh* mesh, Material* material, size_t count)
+{
+	MatMeshIdentifier identifier = MeshRenderer::MakeMatMeshIdentifier(mesh, material);
+	auto mapIt = renderMap.find(identifier);
+	if (mapIt == renderMap.end())
+		mapIt = renderMap.emplace(identifier, RenderList{ std::vector<MeshRenderer*>(), 0 }).first;
+
+	std::vector<MeshRenderer*>& renderers = mapIt->second.renderers;
+	renderers.reserve(renderers.size() + count);
 }
 
 // Add an entity to the render list
 void Renderer::AddMeshRenderer(MeshRenderer* mr)
 {
-	//Get identifier
-	std::string identifier = mr->GetMatMeshIdentifier();
+	//Get the render list for the mat/mesh combo (makes a new entry if needed)
+	MatMeshIdentifier identifier = mr->GetMatMeshIdentifier();
+	auto mapIt = renderMap.find(identifier);
+	if (mapIt == renderMap.end())
+		mapIt = renderMap.emplace(identifier, RenderList{ std::vector<MeshRenderer*>(), 0 }).first;
+	RenderList& list = mapIt->second;
 
-	//Check if we already have the mat/mesh combo in the map
-	if (renderMap.find(identifier) != renderMap.end())
+	//Check if the entity is already in the list
+	if (mr->renderIndex < list.renderers.size() && list.renderers[mr->renderIndex] == mr)
 	{
-		//Get render list
-		std::vector<MeshRenderer*> list = renderMap[identifier];
+		printf("Cannot add entity %s because it is already in renderer", mr->gameObject()->GetName().c_str());
+		return;
+	}
 
-		//Check the iterator of the entity
-		if (std::find(list.begin(), list.end(), mr) != list.end())
-		{
-			printf("Cannot add entity %s because it is already in renderer", mr->gameObject()->GetName().c_str());
-			return;
-		}
+	//Add to the list and bounds
+	mr->renderIndex = list.renderers.size();
+	list.renderers.push_back(mr);
+	renderBounds.Add(mr);
 
-		//Add to the list
-		renderMap[identifier].push_back(mr);
-	}
-	//else make a new entry
-	else
+	//Move to the end of the active range
+	if (mr->gameObject()->GetEnabled())
 	{
-		std::vector<MeshRenderer*> list;
-		list.push_back(mr);
-		renderMap.emplace(identifier, list);
+		SwapMeshRenderers(&list, mr->renderIndex, list.activeCount);
+		list.activeCount++;
 	}
 }
 
@@ -467,8 +1083,7 @@ void Renderer::AddMeshRenderer(MeshRenderer* mr)
 void Renderer::RemoveMeshRenderer(MeshRenderer* mr)
 {
 	//Get iterator
-	std::string identifier = mr->GetMatMeshIdentifier();
-	auto mapIt = renderMap.find(identifier);
+	auto mapIt = renderMap.find(mr->GetMatMeshIdentifier());
 
 	//Check if we are in the map
 	if (mapIt == renderMap.end())
@@ -477,31 +1092,85 @@ void Renderer::RemoveMeshRenderer(MeshRenderer* mr)
 		return;
 	}
 
-	//Get correct render list
-	std::vector<MeshRenderer*> list = renderMap[identifier];
-
-	//Get the iterator of the entity
-	std::vector<MeshRenderer*>::iterator listIt = std::find(list.begin(), list.end(), mr);
-
 	//Check if we are in the list
-	if (listIt == list.end())
+	RenderList& list = mapIt->second;
+	if (mr->renderIndex >= list.renderers.size() || list.renderers[mr->renderIndex] != mr)
 	{
 		printf("Cannot remove entity because it is not in renderer");
 		return;
 	}
 
-	//Swap it for the last one
-	std::swap(*listIt, list.back());
+	//Keep the active range packed
+	if (mr->renderIndex < list.activeCount)
+	{
+		list.activeCount--;
+		SwapMeshRenderers(&list, mr->renderIndex, list.activeCount);
+	}
 
-	//Pop the last one
-	list.pop_back();
+	//Swap it for the last one and pop
+	SwapMeshRenderers(&list, mr->renderIndex, list.renderers.size() - 1);
+	list.renderers.pop_back();
+	renderBounds.Remove(mr);
 
 	//Check if the list is empty
-	if (list.size() == 0)
+	if (list.renderers.size() == 0)
 	{
 		//Erase
-		renderMap.erase(mr->GetMatMeshIdentifier());
+		renderMap.erase(mapIt);
+	}
+}
+
+// Move a mesh renderer into the active or inactive range of its render list
+void Renderer::SetMeshRendererActive(MeshRenderer* mr, bool active)
+{
+	//Batched renderers are not in a list
+	if (mr->batched)
+		return;
+
+	auto mapIt = renderMap.find(mr->GetMatMeshIdentifier());
+	if (mapIt == renderMap.end())
+		return;
+
+	RenderList& list = mapIt->second;
+	if (active && mr->renderIndex >= list.activeCount)
+	{
+		SwapMeshRenderers(&list, mr->renderIndex, list.activeCount);
+		list.activeCount++;
 	}
+	else if (!active && mr->renderIndex < list.activeCount)
+	{
+		list.activeCount--;
+		SwapMeshRenderers(&list, mr->renderIndex, list.activeCount);
+	}
+}
+
+// Take a mesh renderer out of the render lists for a static batch, or put it back
+void Renderer::SetMeshRendererBatched(MeshRenderer* mr, bool batched)
+{
+	if (mr->batched == batched)
+		return;
+
+	if (batched)
+	{
+		RemoveMeshRenderer(mr);
+		mr->batched = true;
+	}
+	else
+	{
+		mr->batched = false;
+		AddMeshRenderer(mr);
+	}
+}
+
+// Swap two mesh renderers in a render list
+void Renderer::SwapMeshRenderers(RenderList* list, size_t a, size_t b)
+{
+	if (a == b)
+		return;
+
+	std::swap(list->renderers[a], list->renderers[b]);
+	list->renderers[a]->renderIndex = a;
+	list->renderers[b]->renderIndex = b;
 }
 
 
@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
 #include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "SimpleShader.h"
 #include "MeshRenderer.h"
 #include "Camera.h"
@@ -8,25 +11,111 @@
 #include <Effects.h>
 #include <wrl/client.h>
 #include "DebugShapes.h"
+#include "D3D11RenderDevice.h"
+#include "StateCacheRenderDevice.h"
+#include "RenderQueue.h"
+#include "RenderBounds.h"
+#include "RenderFrame.h"
+
+// --------------------------------------------------------
+// A list of mesh renderers that share a material and mesh.
+// Renderers on enabled GameObjects are kept in [0, activeCount)
+// --------------------------------------------------------
+struct RenderList
+{
+	std::vector<MeshRenderer*> renderers;
+	size_t activeCount;
+};
+
+//Camera passes with at least this many entries are recorded in
+// parallel chunks of about this many entries
+#define RENDER_COMMAND_PARALLEL_SIZE 2048
+#define RENDER_COMMAND_CHUNK_SIZE 512
+
+// --------------------------------------------------------
+// A range of a render pass recorded into one command list
+// --------------------------------------------------------
+struct RenderRecordChunk
+{
+	const RenderFrame* frame;
+	size_t begin;
+	size_t end;
+	RenderCommandList* commands;
+};
+
+// --------------------------------------------------------
+// Where a frame is drawn to
+// --------------------------------------------------------
+struct RenderTargets
+{
+	ID3D11DeviceContext* context;
+	ID3D11Device* device;
+	ID3D11RenderTargetView* backBufferRTV;
+	ID3D11DepthStencilView* depthStencilView;
+	ID3D11SamplerState* sampler;
+	UINT width;
+	UINT height;
+};
 
 // Basis from: https://stackoverflow.com/questions/1008019/c-singleton-design-pattern
 
 // --------------------------------------------------------
 // Singleton
 //
-// Handles rendering entities to the screen
+// Handles rendering entities to the screen.
+//
+// At the end of a frame's update the scene is culled and
+// copied into a RenderFrame, and the frame's draws are
+// recorded into command lists (the camera passes in parallel
+// jobs). Frames are double buffered,
+// so the render thread draws one while the main thread
+// updates the scene and extracts the next, and the frame
+// on screen is at most one behind the simulation
 // --------------------------------------------------------
 class Renderer
 {
 private:
 	//Render list management
 	//renderMap uses Mat/Mesh identifiers to point to the correct list
-	std::unordered_map<std::string, std::vector<MeshRenderer*>> renderMap;
-	std::vector<MeshRenderer*> transparentObjList;
+	std::unordered_map<MatMeshIdentifier, RenderList> renderMap;
+
+	//Frames copied out of the scene. The main thread extracts into
+	//one while the render thread draws the other
+	RenderFrame frames[2];
+	size_t extractIndex;
+	bool frameExtracted;
+	RenderFrame* frame;		//The frame being drawn
+	bool sortRenderQueue;
+
+	//Draws frames handed to it by BeginDraw()
+	std::thread renderThread;
+	std::mutex drawLock;
+	std::condition_variable drawCondition;
+	RenderTargets drawTargets;
+	bool drawRequested;
+	bool drawing;
+	bool renderThreadRunning;
+
+	//World bounds of every mesh renderer and this frame's culling.
+	//Visibility bit 0 is the camera, bit 1 + i is shadow casting light i
+	RenderBounds renderBounds;
+	std::vector<Frustum> cullFrustums;
+	CullingStats cullingStats;
+
+	//Instancing and command recording. Materials set shader variables
+	//in the recording list's own copy, so jobs prepare them in parallel
+	bool instancing;
+	bool parallelRecording;
+	ID3D11Buffer* objectInstanceBuffer;	//One instance, for instanced shaders when a frame has no buffer
+	std::vector<RenderRecordChunk> recordChunks;
+	FrameArenaStats frameArenaStats;		//Last extracted frame's
 
 	//Debug meshes
 	Mesh* cubeMesh;
 
+	//Creates shadow maps for new lights
+	ID3D11Device* device;
+
 	//Debugging
 	std::vector<ShapeXMFloat3Data> debugCubes;
 	std::vector<ShapeFloat1Data> debugSpheres;
@@ -55,6 +144,13 @@ private:
 	// Clear color.
 	float clearColor[4];
 
+	//Where draw commands are sent. By default they go through a
+	//state cache that drops redundant binds before the D3D11 device
+	RenderDevice* renderDevice;
+	D3D11RenderDevice* d3d11Device;
+	StateCacheRenderDevice* stateCache;
+	StateCacheStats stateCacheStats;		//Last frame's, guarded by drawLock
+
 	// --------------------------------------------------------
 	// Singleton Constructor - Set up the singleton instance of the renderer
 	// --------------------------------------------------------
@@ -66,38 +162,96 @@ private:
 	~Renderer() { };
 
 	// --------------------------------------------------------
-	// Render shadow maps for all lights that cast shadows
+	// Swap two mesh renderers in a render list
 	// --------------------------------------------------------
-	void RenderShadowMaps(ID3D11DeviceContext* context,
-		ID3D11Device* device,
-		Camera* camera,
-		ID3D11RenderTargetView* backBufferRTV,
-		ID3D11DepthStencilView* depthStencilView,
-		UINT width, UINT height);
+	void SwapMeshRenderers(RenderList* list, size_t a, size_t b);
 
 	// --------------------------------------------------------
-	// Draw opaque objects
+	// Draw frames handed over by BeginDraw() until the
+	// renderer is released
 	// --------------------------------------------------------
-	void DrawOpaqueObjects(ID3D11DeviceContext* context, Camera* camera);
+	void RenderThread();
 
 	// --------------------------------------------------------
-	// Draw transparent objects
+	// Take the last extracted frame to draw it, returns false
+	// if nothing was extracted since the last draw
 	// --------------------------------------------------------
-	void DrawTransparentObjects(ID3D11DeviceContext* context, Camera* camera);
+	bool TakeExtractedFrame();
 
+	// --------------------------------------------------------
+	// Sync the render bounds and cull them against the camera
+	// and every shadow casting light of a frame
+	// --------------------------------------------------------
+	void CullRenderBounds(const RenderFrame& extracted);
 
+	// --------------------------------------------------------
+	// Copy every enabled mesh renderer that is visible to the
+	// camera or a light into a frame's proxies, and fill and
+	// sort its render queue
+	// --------------------------------------------------------
+	void ExtractRenderQueue(RenderFrame* extracted);
 
 	// --------------------------------------------------------
-	// Draw the skybox
+	// Fill a frame's instances for its sorted render queue and
+	// grow its instance buffer to hold them
 	// --------------------------------------------------------
-	void DrawSky(ID3D11DeviceContext* context, Camera* camera);
+	void BuildInstanceBuffer(RenderFrame* extracted);
 
-public:
+	// --------------------------------------------------------
+	// Record a frame's draws into its command lists
+	// --------------------------------------------------------
+	void RecordCommandLists(RenderFrame* extracted);
+
+	// --------------------------------------------------------
+	// Split a camera pass of a frame into chunks to record,
+	// one command list each. Runs of the same material and
+	// mesh are never split
+	// --------------------------------------------------------
+	void AddRecordChunks(RenderFrame* extracted, RenderPass pass, std::vector<RenderCommandList>* lists);
+
+	// --------------------------------------------------------
+	// Record a set of chunks into their command lists (the
+	// parallel_for job function)
+	// --------------------------------------------------------
+	static void RecordChunks(RenderRecordChunk* chunks, unsigned int count);
+
+	// --------------------------------------------------------
+	// Record a range of render queue entries with their
+	// materials, only rebinding what changes between draws.
+	// Runs of entries with the same material and mesh are one
+	// instanced draw if the material's vertex shader reads
+	// per instance data. Safe to call from several jobs at once
+	// --------------------------------------------------------
+	void RecordRenderQueue(const RenderFrame& recorded, RenderCommandList* commands, size_t begin, size_t end);
+
+	// --------------------------------------------------------
+	// Record rendering shadow maps for all lights that cast
+	// shadows
+	// --------------------------------------------------------
+	void RecordShadowMaps(RenderFrame* extracted);
+
+	// --------------------------------------------------------
+	// Record drawing the skybox
+	// --------------------------------------------------------
+	void RecordSky(RenderFrame* extracted);
+
+	// --------------------------------------------------------
+	// Draw the frame being drawn (on any one thread) by
+	// submitting its command lists
+	// --------------------------------------------------------
+	void DrawFrame(const RenderTargets& targets);
+
+	// --------------------------------------------------------
+	// Draw transparent objects, farthest first
+	// --------------------------------------------------------
+	void DrawTransparentObjects();
 
 	// --------------------------------------------------------
 	// Draw debug shapes
 	// --------------------------------------------------------
-	void DrawDebugShapes(ID3D11DeviceContext* context, Camera* camera, float deltaTime);
+	void DrawDebugShapes(ID3D11DeviceContext* context);
+
+public:
 
 	// --------------------------------------------------------
 	// Get the singleton instance of the renderer
@@ -115,31 +269,141 @@ public:
 	void Release();
 
 	// --------------------------------------------------------
-	// Initialize values in the renderer
+	// Initialize values in the renderer and start the
+	// render thread
 	// --------------------------------------------------------
 	void Init(ID3D11Device* device, ID3D11DeviceContext* context, UINT width, UINT height);
 
+	// --------------------------------------------------------
+	// Get the device draw commands are sent through. While a
+	// thread records a frame this is its command list
+	// --------------------------------------------------------
+	RenderDevice* GetRenderDevice();
+
+	// --------------------------------------------------------
+	// Get the command list this thread is recording (null if
+	// it is not recording one)
+	// --------------------------------------------------------
+	RenderCommandList* GetRecordingList();
+
+	// --------------------------------------------------------
+	// Send draw commands through another device, like a
+	// RecordingRenderDevice to count them (null restores the
+	// state cached D3D11 device). The renderer does not own
+	// the device. Waits for the frame being drawn first
+	// --------------------------------------------------------
+	void SetRenderDevice(RenderDevice* device);
+
+	// --------------------------------------------------------
+	// Get the binds the state cache sent on and dropped while
+	// drawing the last frame
+	// --------------------------------------------------------
+	StateCacheStats GetStateCacheStats();
+
+	// --------------------------------------------------------
+	// Make the state cache forget what is bound, after code
+	// outside the renderer binds to the context directly.
+	// Waits for the frame being drawn first
+	// --------------------------------------------------------
+	void InvalidateStateCache();
+
+	// --------------------------------------------------------
+	// Turn sorting the render queue by key on or off. Unsorted
+	// draws are in render list order (for comparing against)
+	// --------------------------------------------------------
+	void SetRenderQueueSorting(bool sort);
+
+	// --------------------------------------------------------
+	// Check if the render queue is sorted by key
+	// --------------------------------------------------------
+	bool GetRenderQueueSorting();
+
+	// --------------------------------------------------------
+	// Get the visible and culled draws of the last frame
+	// --------------------------------------------------------
+	CullingStats GetCullingStats();
+
+	// --------------------------------------------------------
+	// Turn drawing runs of the same material and mesh as one
+	// instanced draw on or off. Off draws one instance at a
+	// time (for comparing against). Waits for the frame being
+	// drawn first
+	// --------------------------------------------------------
+	void SetInstancing(bool instanced);
+
+	// --------------------------------------------------------
+	// Check if runs of the same material and mesh are drawn
+	// as one instanced draw
+	// --------------------------------------------------------
+	bool GetInstancing();
+
+	// --------------------------------------------------------
+	// Turn recording the camera passes in parallel chunks on
+	// or off. Off records each pass in one command list on
+	// the main thread (for comparing against)
+	// --------------------------------------------------------
+	void SetParallelRecording(bool parallel);
+
+	// --------------------------------------------------------
+	// Check if the camera passes are recorded in parallel
+	// --------------------------------------------------------
+	bool GetParallelRecording();
+
+	// --------------------------------------------------------
+	// Get how much of its arena the last extracted frame used
+	// --------------------------------------------------------
+	FrameArenaStats GetFrameArenaStats();
+
 	//Delete this
 	Renderer(Renderer const&) = delete;
 	void operator=(Renderer const&) = delete;
 
 	// --------------------------------------------------------
-	// Draw all entities in the render list
+	// Cull the scene and copy what this frame draws into the
+	// next render frame. Call on the main thread once the
+	// frame's update is done
 	//
-	// context - DirectX device context
 	// camera - The active camera object
+	// deltaTime - ages debug shapes drawn for a duration
+	// --------------------------------------------------------
+	void ExtractFrame(Camera* camera, float deltaTime);
+
+	// --------------------------------------------------------
+	// Draw the last extracted frame on this thread, after the
+	// frame being drawn on the render thread is done
+	//
+	// context - DirectX device context
 	// --------------------------------------------------------
 	void Draw(ID3D11DeviceContext* context,
 			  ID3D11Device* device,
-			  Camera* camera,
 			  ID3D11RenderTargetView* backBufferRTV,
 		      ID3D11DepthStencilView* depthStencilView,
 			  ID3D11SamplerState* sampler,
 			  UINT width,
-		      UINT height,
-			  float deltaTIme
+		      UINT height
+	);
+
+	// --------------------------------------------------------
+	// Hand the last extracted frame to the render thread and
+	// return, after the frame being drawn there is done. The
+	// targets must stay alive until WaitForDraw()
+	// --------------------------------------------------------
+	void BeginDraw(ID3D11DeviceContext* context,
+			  ID3D11Device* device,
+			  ID3D11RenderTargetView* backBufferRTV,
+		      ID3D11DepthStencilView* depthStencilView,
+			  ID3D11SamplerState* sampler,
+			  UINT width,
+		      UINT height
 	);
 
+	// --------------------------------------------------------
+	// Wait for the render thread to finish the frame it is
+	// drawing (before presenting, resizing or releasing
+	// anything it uses)
+	// --------------------------------------------------------
+	void WaitForDraw();
+
 	// --------------------------------------------------------
 	// Add an entity to the render list
 	// --------------------------------------------------------
@@ -150,6 +414,24 @@ public:
 	// --------------------------------------------------------
 	void RemoveMeshRenderer(MeshRenderer* mr);
 
+	// --------------------------------------------------------
+	// Make room for a number of mesh renderers using a mesh and
+	// material (used when spawning in bulk)
+	// --------------------------------------------------------
+	void ReserveMeshRenderers(Mesh* mesh, Material* material, size_t count);
+
+	// --------------------------------------------------------
+	// Move a mesh renderer into the active or inactive range
+	// of its render list (called by GameObject::SetEnabled)
+	// --------------------------------------------------------
+	void SetMeshRendererActive(MeshRenderer* mr, bool active);
+
+	// --------------------------------------------------------
+	// Take a mesh renderer out of the render lists because a
+	// static batch draws it, or put it back
+	// --------------------------------------------------------
+	void SetMeshRendererBatched(MeshRenderer* mr, bool batched);
+
 	// --------------------------------------------------------
 	// Tell the renderer to render a cube this frame
 	//
@@ -1,5 +1,4 @@
 #include "ResourceManager.h"
-#include <sstream>
 
 using namespace DirectX;
 
@@ -27,6 +26,17 @@ struct ThreeParamLoadData
 		: address(address), device(device), context(context) { };
 };
 
+//The name a key was interned from, or its hash when it was only looked up
+// (lookups don't intern, so a key that was never added has no name)
+static std::string KeyName(StringId key)
+{
+	if (!key.GetString().empty())
+		return key.GetString();
+	char hash[16];
+	snprintf(hash, sizeof(hash), "#%08x", key.id);
+	return hash;
+}
+
 void ResourceManager::Release()
 {
 	//Delete Texture2Ds
@@ -77,22 +87,23 @@ void ResourceManager::Release()
 		if (pair.second) { delete pair.second; }
 	}
 	physicsMatMap.clear();
+	unloadCount++;
 }
 
 // Load a Texture2D from the specified address with MipMaps
 bool ResourceManager::LoadTexture2D(const char* address, ID3D11Device* device, ID3D11DeviceContext* context)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << address;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(address);
+	std::string str = address;
 	std::wstring lStr = std::wstring(str.begin(), str.end());
 	const wchar_t* lAddress = lStr.c_str();
 
 	//Check if the Texture2D is already in the map
 	texture2DLock.lock();
-	if (texture2DMap.find(str) != texture2DMap.end())
+	if (texture2DMap.find(key) != texture2DMap.end())
 	{
+		texture2DLock.unlock();
 		printf("Texture2D at address \"%s\" already exists in the resource manager\n", address);
 		return false;
 	}
@@ -104,6 +115,7 @@ bool ResourceManager::LoadTexture2D(const char* address, ID3D11Device* device, I
 	contextLock.lock();
 	if (CreateWICTextureFromFile(device, context, lAddress, 0, &tex) != S_OK)
 	{
+		contextLock.unlock();
 		printf("Could not load texture2D %s\n", address);
 		return false;
 	}
@@ -111,7 +123,7 @@ bool ResourceManager::LoadTexture2D(const char* address, ID3D11Device* device, I
 
 	//Add to map
 	texture2DLock.lock();
-	texture2DMap.emplace(str, tex);
+	texture2DMap.emplace(key, tex);
 	texture2DLock.unlock();
 	return true;
 }
@@ -119,17 +131,17 @@ bool ResourceManager::LoadTexture2D(const char* address, ID3D11Device* device, I
 // Load a Texture2D from the specified address with NO MipMaps
 bool ResourceManager::LoadTexture2D(const char* address, ID3D11Device * device)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << address;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(address);
+	std::string str = address;
 	std::wstring lStr = std::wstring(str.begin(), str.end());
 	const wchar_t* lAddress = lStr.c_str();
 
 	//Check if the Texture2D is already in the map
 	texture2DLock.lock();
-	if (texture2DMap.find(str) != texture2DMap.end())
+	if (texture2DMap.find(key) != texture2DMap.end())
 	{
+		texture2DLock.unlock();
 		printf("Texture2D at address \"%s\" already exists in the resource manager\n", address);
 		return false;
 	}
@@ -146,7 +158,7 @@ bool ResourceManager::LoadTexture2D(const char* address, ID3D11Device * device)
 
 	//Add to map
 	texture2DLock.lock();
-	texture2DMap.emplace(str, tex);
+	texture2DMap.emplace(key, tex);
 	texture2DLock.unlock();
 	return true;
 }
@@ -189,17 +201,17 @@ Job* ResourceManager::LoadTexture2DAsync(const char* address, ID3D11Device* devi
 // Load a CubeMap from the specified address with MipMaps
 bool ResourceManager::LoadCubeMap(const char* address, ID3D11Device* device, ID3D11DeviceContext* context)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << address;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(address);
+	std::string str = address;
 	std::wstring lStr = std::wstring(str.begin(), str.end());
 	const wchar_t* lAddress = lStr.c_str();
 
 	//Check if the CubeMap is already in the map
 	cubemapLock.lock();
-	if (cubemapMap.find(str) != cubemapMap.end())
+	if (cubemapMap.find(key) != cubemapMap.end())
 	{
+		cubemapLock.unlock();
 		printf("CubeMap at address \"%s\" already exists in the resource manager\n", address);
 		return false;
 	}
@@ -218,7 +230,7 @@ bool ResourceManager::LoadCubeMap(const char* address, ID3D11Device* device, ID3
 
 	//Add to map
 	cubemapLock.lock();
-	cubemapMap.emplace(str, tex);
+	cubemapMap.emplace(key, tex);
 	cubemapLock.unlock();
 	return true;
 }
@@ -226,17 +238,17 @@ bool ResourceManager::LoadCubeMap(const char* address, ID3D11Device* device, ID3
 // Load a CubeMap from the specified address with NO MipMaps
 bool ResourceManager::LoadCubeMap(const char* address, ID3D11Device* device)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << address;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(address);
+	std::string str = address;
 	std::wstring lStr = std::wstring(str.begin(), str.end());
 	const wchar_t* lAddress = lStr.c_str();
 
 	//Check if the CubeMap is already in the map
 	cubemapLock.lock();
-	if (cubemapMap.find(str) != cubemapMap.end())
+	if (cubemapMap.find(key) != cubemapMap.end())
 	{
+		cubemapLock.unlock();
 		printf("CubeMap at address \"%s\" already exists in the resource manager\n", address);
 		return false;
 	}
@@ -252,7 +264,7 @@ bool ResourceManager::LoadCubeMap(const char* address, ID3D11Device* device)
 
 	//Add to map
 	cubemapLock.lock();
-	cubemapMap.emplace(str, tex);
+	cubemapMap.emplace(key, tex);
 	cubemapLock.unlock();
 	return true;
 }
@@ -294,15 +306,14 @@ Job* ResourceManager::LoadCubeMapAsync(const char* address, ID3D11Device* device
 // Load a Mesh from the specified address
 bool ResourceManager::LoadMesh(const char* address, ID3D11Device* device)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << address;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(address);
 
 	//Check if the Mesh is already in the map
 	meshLock.lock();
-	if (meshMap.find(str) != meshMap.end())
+	if (meshMap.find(key) != meshMap.end())
 	{
+		meshLock.unlock();
 		printf("Mesh at address \"%s\" already exists in the resource manager\n", address);
 		return false;
 	}
@@ -319,7 +330,7 @@ bool ResourceManager::LoadMesh(const char* address, ID3D11Device* device)
 
 	//Add to map
 	meshLock.lock();
-	meshMap.emplace(str, mesh);
+	meshMap.emplace(key, mesh);
 	meshLock.unlock();
 	return true;
 }
@@ -342,40 +353,64 @@ Job* ResourceManager::LoadMeshAsync(const char* address, ID3D11Device* device, J
 	return job;
 }
 
+// Delete a loaded Mesh
+bool ResourceManager::UnloadMesh(StringId address)
+{
+	//Take it out of the map
+	meshLock.lock();
+	auto iter = meshMap.find(address);
+	if (iter == meshMap.end())
+	{
+		meshLock.unlock();
+		return false;
+	}
+	Mesh* mesh = iter->second;
+	meshMap.erase(iter);
+	meshLock.unlock();
+
+	delete mesh;
+	unloadCount++;
+	return true;
+}
+
+// Get how many times resources have been unloaded
+uint32_t ResourceManager::GetUnloadCount()
+{
+	return unloadCount.load();
+}
+
 // Load a Material from the specified address
 bool ResourceManager::AddMaterial(const char* name, Material* material)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << name;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(name);
 
 	//Check if the Material is already in the map
-	if (materialMap.find(str) != materialMap.end())
+	if (materialMap.find(key) != materialMap.end())
 	{
 		printf("Material of name \"%s\" already exists in the resource manager\n", name);
 		return false;
 	}
 	
 	//Add to map
-	materialMap.emplace(str, material);
+	materialMap.emplace(key, material);
 	return true;
 }
 
 // Load a Pixel Shader from the specified address
 bool ResourceManager::LoadPixelShader(const char* name, ID3D11Device* device, ID3D11DeviceContext* context)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << name;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(name);
+	std::string str = name;
 	std::wstring lStr = std::wstring(str.begin(), str.end());
 	const wchar_t* lName = lStr.c_str();
 
 	//Check if the Pixel Shader is already in the map
 	pixelShaderLock.lock();
-	if (pixelShaderMap.find(str) != pixelShaderMap.end())
+	if (pixelShaderMap.find(key) != pixelShaderMap.end())
 	{
+		pixelShaderLock.unlock();
 		printf("Pixel Shader of name \"%s\" already exists in the resource manager\n", name);
 		return false;
 	}
@@ -391,7 +426,7 @@ bool ResourceManager::LoadPixelShader(const char* name, ID3D11Device* device, ID
 
 	//Add to map
 	pixelShaderLock.lock();
-	pixelShaderMap.emplace(str, ps);
+	pixelShaderMap.emplace(key, ps);
 	pixelShaderLock.unlock();
 	return false;
 }
@@ -417,17 +452,17 @@ Job* ResourceManager::LoadPixelShaderAsync(const char* address, ID3D11Device* de
 // Load a Vertex Shader from the specified address
 bool ResourceManager::LoadVertexShader(const char* name, ID3D11Device* device, ID3D11DeviceContext* context)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << name;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(name);
+	std::string str = name;
 	std::wstring lStr = std::wstring(str.begin(), str.end());
 	const wchar_t* lName = lStr.c_str();
 
 	//Check if the Vertex Shader is already in the map
 	vertexShaderLock.lock();
-	if (vertexShaderMap.find(str) != vertexShaderMap.end())
+	if (vertexShaderMap.find(key) != vertexShaderMap.end())
 	{
+		vertexShaderLock.unlock();
 		printf("Vertex Shader of name \"%s\" already exists in the resource manager\n", name);
 		return false;
 	}
@@ -443,7 +478,7 @@ bool ResourceManager::LoadVertexShader(const char* name, ID3D11Device* device, I
 
 	//Add to map
 	vertexShaderLock.lock();
-	vertexShaderMap.emplace(str, vs);
+	vertexShaderMap.emplace(key, vs);
 	vertexShaderLock.unlock();
 	return false;
 }
@@ -469,109 +504,199 @@ Job* ResourceManager::LoadVertexShaderAsync(const char* address, ID3D11Device* d
 // Add an existing Physics Material to the manager
 bool ResourceManager::AddPhysicsMaterial(const char* name, PhysicsMaterial* material)
 {
-	//Create a string
-	std::stringstream ss;
-	ss << name;
-	std::string str = ss.str();
+	//Intern the key
+	StringId key = StringId::Intern(name);
 
 	//Check if the Physics Material is already in the map
-	if (materialMap.find(str) != materialMap.end())
+	if (physicsMatMap.find(key) != physicsMatMap.end())
 	{
 		printf("Physics Material of name \"%s\" already exists in the resource manager\n", name);
 		return false;
 	}
 
 	//Add to map
-	physicsMatMap.emplace(str, material);
+	physicsMatMap.emplace(key, material);
 	return true;
 }
 
 // Get a loaded Texture2D
 ID3D11ShaderResourceView* ResourceManager::GetTexture2D(std::string address)
+{
+	return GetTexture2D(StringId(address));
+}
+
+// Get a loaded Texture2D by id
+ID3D11ShaderResourceView* ResourceManager::GetTexture2D(StringId address)
 {
 	//Check if the Texture2D is in the map
-	if (texture2DMap.find(address) == texture2DMap.end())
+	auto iter = texture2DMap.find(address);
+	if (iter == texture2DMap.end())
 	{
-		printf("Texture2D at address \"%s\" does not exist in the resource manager\n", address.c_str());
+		printf("Texture2D at address \"%s\" does not exist in the resource manager\n", KeyName(address).c_str());
 		return nullptr;
 	}
 
-	return texture2DMap[address];
+	return iter->second;
 }
 
 // Get a loaded CubeMap
 ID3D11ShaderResourceView* ResourceManager::GetCubeMap(std::string address)
+{
+	return GetCubeMap(StringId(address));
+}
+
+// Get a loaded CubeMap by id
+ID3D11ShaderResourceView* ResourceManager::GetCubeMap(StringId address)
 {
 	//Check if the CubeMap is in the map
-	if (cubemapMap.find(address) == cubemapMap.end())
+	auto iter = cubemapMap.find(address);
+	if (iter == cubemapMap.end())
 	{
-		printf("CubeMap at address \"%s\" does not exist in the resource manager\n", address.c_str());
+		printf("CubeMap at address \"%s\" does not exist in the resource manager\n", KeyName(address).c_str());
 		return nullptr;
 	}
 
-	return cubemapMap[address];
+	return iter->second;
 }
 
 // Get a loaded Mesh
 Mesh* ResourceManager::GetMesh(std::string address)
 {
-	//Check if the Mesh is in the map
-	if (meshMap.find(address) == meshMap.end())
+	return GetMesh(StringId(address));
+}
+
+// Get a loaded Mesh by id
+Mesh* ResourceManager::GetMesh(StringId address)
+{
+	//Check if the Mesh is in the map (meshes can be added by streaming threads)
+	std::lock_guard<std::mutex> lock(meshLock);
+	auto iter = meshMap.find(address);
+	if (iter == meshMap.end())
 	{
-		printf("Mesh at address \"%s\" does not exist in the resource manager\n", address.c_str());
+		printf("Mesh at address \"%s\" does not exist in the resource manager\n", KeyName(address).c_str());
 		return nullptr;
 	}
 
-	return meshMap[address];
+	return iter->second;
+}
+
+// Check if a Mesh has been loaded
+bool ResourceManager::HasMesh(std::string address)
+{
+	std::lock_guard<std::mutex> lock(meshLock);
+	return meshMap.find(StringId(address)) != meshMap.end();
 }
 
 // Get a added Material
 Material* ResourceManager::GetMaterial(std::string name)
+{
+	return GetMaterial(StringId(name));
+}
+
+// Get a added Material by id
+Material* ResourceManager::GetMaterial(StringId name)
 {
 	//Check if the Material is in the map
-	if (materialMap.find(name) == materialMap.end())
+	auto iter = materialMap.find(name);
+	if (iter == materialMap.end())
 	{
-		printf("Material of name \"%s\" does not exist in the resource manager\n", name.c_str());
+		printf("Material of name \"%s\" does not exist in the resource manager\n", KeyName(name).c_str());
 		return nullptr;
 	}
 
-	return materialMap[name];
+	return iter->second;
 }
 
 // Get a loaded Pixel Shader
 SimplePixelShader* ResourceManager::GetPixelShader(std::string name)
+{
+	return GetPixelShader(StringId(name));
+}
+
+// Get a loaded Pixel Shader by id
+SimplePixelShader* ResourceManager::GetPixelShader(StringId name)
 {
 	//Check if the Pixel Shader is in the map
-	if (pixelShaderMap.find(name) == pixelShaderMap.end())
+	auto iter = pixelShaderMap.find(name);
+	if (iter == pixelShaderMap.end())
 	{
-		printf("Pixel Shader of name \"%s\" does not exist in the resource manager\n", name.c_str());
+		printf("Pixel Shader of name \"%s\" does not exist in the resource manager\n", KeyName(name).c_str());
 		return nullptr;
 	}
 
-	return pixelShaderMap[name];
+	return iter->second;
 }
 
 // Get a loaded Vertex Shader
 SimpleVertexShader* ResourceManager::GetVertexShader(std::string name)
+{
+	return GetVertexShader(StringId(name));
+}
+
+// Get a loaded Vertex Shader by id
+SimpleVertexShader* ResourceManager::GetVertexShader(StringId name)
 {
 	//Check if the Vertex Shader is in the map
-	if (vertexShaderMap.find(name) == vertexShaderMap.end())
+	auto iter = vertexShaderMap.find(name);
+	if (iter == vertexShaderMap.end())
 	{
-		printf("Vertex Shader of name \"%s\" does not exist in the resource manager\n", name.c_str());
+		printf("Vertex Shader of name \"%s\" does not exist in the resource manager\n", KeyName(name).c_str());
 		return nullptr;
 	}
 
-	return vertexShaderMap[name];
+	return iter->second;
 }
 
+// Get a added Physics Material
 PhysicsMaterial* ResourceManager::GetPhysicsMaterial(std::string name)
+{
+	return GetPhysicsMaterial(StringId(name));
+}
+
+// Get a added Physics Material by id
+PhysicsMaterial* ResourceManager::GetPhysicsMaterial(StringId name)
 {
 	//Check if the Physics Material is in the map
-	if (physicsMatMap.find(name) == physicsMatMap.end())
+	auto iter = physicsMatMap.find(name);
+	if (iter == physicsMatMap.end())
 	{
-		printf("Physics Material of name \"%s\" does not exist in the resource manager\n", name.c_str());
+		printf("Physics Material of name \"%s\" does not exist in the resource manager\n", KeyName(name).c_str());
 		return nullptr;
 	}
 
-	return physicsMatMap[name];
+	return iter->second;
+}
+
+// Find the address a mesh was loaded from
+std::string ResourceManager::FindMeshAddress(Mesh* mesh)
+{
+	std::lock_guard<std::mutex> lock(meshLock);
+	for (auto iter = meshMap.begin(); iter != meshMap.end(); iter++)
+	{
+		if (iter->second == mesh)
+			return iter->first.GetString();
+	}
+	return "";
+}
+
+// Find the name a material was added under
+std::string ResourceManager::FindMaterialName(Material* material)
+{
+	for (auto iter = materialMap.begin(); iter != materialMap.end(); iter++)
+	{
+		if (iter->second == material)
+			return iter->first.GetString();
+	}
+	return "";
+}
+
+// Find the name a physics material was added under
+std::string ResourceManager::FindPhysicsMaterialName(PhysicsMaterial* physicsMaterial)
+{
+	for (auto iter = physicsMatMap.begin(); iter != physicsMatMap.end(); iter++)
+	{
+		if (iter->second == physicsMaterial)
+			return iter->first.GetString();
+	}
+	return "";
 }
@@ -6,7 +6,9 @@
 #include "Material.h"
 #include "PhysicsMaterial.h"
 #include "JobSystem.h"
+#include "StringId.h"
 #include <mutex>
+#include <atomic>
 
 class ResourceManager
 {
@@ -14,17 +16,20 @@ private:
 	// --------------------------------------------------------
 	// Singleton Constructor - Set up the singleton instance of the ResourceManager
 	// --------------------------------------------------------
-	ResourceManager() { }
+	ResourceManager() { unloadCount = 0; }
 	~ResourceManager() { };
 
-	//Resource maps
-	std::unordered_map<std::string, ID3D11ShaderResourceView*> texture2DMap;
-	std::unordered_map<std::string, ID3D11ShaderResourceView*> cubemapMap;
-	std::unordered_map<std::string, Mesh*> meshMap;
-	std::unordered_map<std::string, Material*> materialMap;
-	std::unordered_map<std::string, SimplePixelShader*> pixelShaderMap;
-	std::unordered_map<std::string, SimpleVertexShader*> vertexShaderMap;
-	std::unordered_map<std::string, PhysicsMaterial*> physicsMatMap;
+	//Times resources were unloaded
+	std::atomic<uint32_t> unloadCount;
+
+	//Resource maps, keyed by interned address or name
+	std::unordered_map<StringId, ID3D11ShaderResourceView*> texture2DMap;
+	std::unordered_map<StringId, ID3D11ShaderResourceView*> cubemapMap;
+	std::unordered_map<StringId, Mesh*> meshMap;
+	std::unordered_map<StringId, Material*> materialMap;
+	std::unordered_map<StringId, SimplePixelShader*> pixelShaderMap;
+	std::unordered_map<StringId, SimpleVertexShader*> vertexShaderMap;
+	std::unordered_map<StringId, PhysicsMaterial*> physicsMatMap;
 
 public:
 	// --------------------------------------------------------
@@ -98,6 +103,18 @@ public:
 	// --------------------------------------------------------
 	Job* LoadMeshAsync(const char* address, ID3D11Device* device, Job* parent = nullptr);
 
+	// --------------------------------------------------------
+	// Delete a loaded Mesh (nothing may still use it)
+	// returns false if it isn't loaded
+	// --------------------------------------------------------
+	bool UnloadMesh(StringId address);
+
+	// --------------------------------------------------------
+	// Get how many times resources have been unloaded, so
+	// anything keyed by resource pointers knows to reset
+	// --------------------------------------------------------
+	uint32_t GetUnloadCount();
+
 	// --------------------------------------------------------
 	// Add an existing Material to the manager
 	// --------------------------------------------------------
@@ -134,6 +151,7 @@ public:
 	// address - The file address of the Texture2D
 	// --------------------------------------------------------
 	ID3D11ShaderResourceView* GetTexture2D(std::string address);
+	ID3D11ShaderResourceView* GetTexture2D(StringId address);
 
 	// --------------------------------------------------------
 	// Get a loaded CubeMap
@@ -141,6 +159,7 @@ public:
 	// address - The file address of the CubeMap
 	// --------------------------------------------------------
 	ID3D11ShaderResourceView* GetCubeMap(std::string address);
+	ID3D11ShaderResourceView* GetCubeMap(StringId address);
 
 	// --------------------------------------------------------
 	// Get a loaded Mesh
@@ -148,6 +167,14 @@ public:
 	// address - The file address of the Mesh
 	// --------------------------------------------------------
 	Mesh* GetMesh(std::string address);
+	Mesh* GetMesh(StringId address);
+
+	// --------------------------------------------------------
+	// Check if a Mesh has been loaded (safe to call from any thread)
+	//
+	// address - The file address of the Mesh
+	// --------------------------------------------------------
+	bool HasMesh(std::string address);
 
 	// --------------------------------------------------------
 	// Get an added Material
@@ -155,6 +182,7 @@ public:
 	// name - The name of the Material
 	// --------------------------------------------------------
 	Material* GetMaterial(std::string name);
+	Material* GetMaterial(StringId name);
 
 	// --------------------------------------------------------
 	// Get a loaded Pixel Shader
@@ -162,6 +190,7 @@ public:
 	// name - The name of the Pixel Shader file
 	// --------------------------------------------------------
 	SimplePixelShader* GetPixelShader(std::string name);
+	SimplePixelShader* GetPixelShader(StringId name);
 
 	// --------------------------------------------------------
 	// Get a loaded Vertex Shader
@@ -169,10 +198,21 @@ public:
 	// name - The name of the Vertex Shader file
 	// --------------------------------------------------------
 	SimpleVertexShader* GetVertexShader(std::string name);
+	SimpleVertexShader* GetVertexShader(StringId name);
 
 	// --------------------------------------------------------
 	// Get an added Physics Material
 	// --------------------------------------------------------
 	PhysicsMaterial* GetPhysicsMaterial(std::string name);
+	PhysicsMaterial* GetPhysicsMaterial(StringId name);
+
+	// --------------------------------------------------------
+	// Find the address or name a resource was added under
+	// (empty if it is not in the resource manager).
+	// These scan every resource, use them for saving, not per frame
+	// --------------------------------------------------------
+	std::string FindMeshAddress(Mesh* mesh);
+	std::string FindMaterialName(Material* material);
+	std::string FindPhysicsMaterialName(PhysicsMaterial* physicsMaterial);
 };
 
@@ -20,12 +20,14 @@ RigidBody::RigidBody(GameObject* gameObject, float mass) : Component::Component(
 
 	//Add to the scene
 	body->userData = this;
-	PhysicsManager::GetInstance()->AddActor(body);
+	pendingActorIndex = PHYSICS_NOT_PENDING;
+	if (gameObject->GetEnabled())
+		PhysicsManager::GetInstance()->AddActor(body, &pendingActorIndex);
 
-	gameObject->AddListenerOnPositionChanged(std::bind(&RigidBody::UpdateRigidbodyPosition, this,
-		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-	gameObject->AddListenerOnRotationChanged(std::bind(&RigidBody::UpdateRigidbodyRotation, this,
-		std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+	positionListener = gameObject->AddListenerOnPositionChanged(
+		MakeDelegate<&RigidBody::UpdateRigidbodyPosition>(this));
+	rotationListener = gameObject->AddListenerOnRotationChanged(
+		MakeDelegate<&RigidBody::UpdateRigidbodyRotation>(this));
 
 	//See if there is already a collider attached to this or any child gameobjects
 	FindChildrenColliders(gameObject, true);
@@ -33,6 +35,9 @@ RigidBody::RigidBody(GameObject* gameObject, float mass) : Component::Component(
 
 RigidBody::~RigidBody()
 {
+	gameObject()->RemoveListenerOnPositionChanged(positionListener);
+	gameObject()->RemoveListenerOnRotationChanged(rotationListener);
+
 	if (body != nullptr)
 	{
 		//Detatch all shapes
@@ -45,7 +50,7 @@ RigidBody::~RigidBody()
 		}
 		delete[] shapes;
 	}
-	PhysicsManager::GetInstance()->RemoveActor(body);
+	PhysicsManager::GetInstance()->RemoveActor(body, &pendingActorIndex);
 	body->release();
 	body = nullptr;
 	if (collisionResolver != nullptr)
@@ -200,6 +205,27 @@ void RigidBody::SetContraints(bool lockPosX, bool lockPosY, bool lockPosZ,
 	body->setRigidDynamicLockFlags(PxRigidDynamicLockFlags(flags));
 }
 
+// --------------------------------------------------------
+// WARNING: THIS IS FOR INTERNAL ENGINE USE ONLY. DO NOT USE
+// Add or remove the body from the physics scene
+void RigidBody::SetInScene(bool inScene)
+{
+	if (!inScene)
+	{
+		PhysicsManager::GetInstance()->RemoveActor(body, &pendingActorIndex);
+		return;
+	}
+
+	//Start again at rest wherever the gameobject is now
+	if (!(body->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+	{
+		body->setLinearVelocity(PxVec3(0, 0, 0));
+		body->setAngularVelocity(PxVec3(0, 0, 0));
+	}
+	UpdateRigidbodyWorld();
+	PhysicsManager::GetInstance()->AddActor(body, &pendingActorIndex);
+}
+
 // --------------------------------------------------------
 // WARNING: THIS IS FOR INTERNAL ENGINE USE ONLY. DO NOT USE
 // Get the collision resolver for this rigidbody.
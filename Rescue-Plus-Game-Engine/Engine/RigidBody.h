@@ -12,7 +12,10 @@ class RigidBody : public Component
 {
 private:
 	physx::PxRigidDynamic* body;
+	uint32_t pendingActorIndex;	//The body's place in the PhysicsManager's actor batch
 	CollisionResolver* collisionResolver;
+	ListenerToken positionListener;
+	ListenerToken rotationListener;
 
 	// --------------------------------------------------------
 	// Attach all children colliders to this GO
@@ -35,6 +38,8 @@ private:
 	void UpdateRigidbodyRotation(DirectX::XMFLOAT4 rot, bool fromParent, bool fromRigidBody);
 
 public:
+	typedef ComponentLookupBases<RigidBody, Component> LookupBases;
+
 	RigidBody(GameObject* gameObject, float mass);
 
 	~RigidBody();
@@ -119,6 +124,13 @@ public:
 	void SetContraints(bool lockPosX, bool lockPosY, bool lockPosZ,
 		bool lockRotX, bool lockRotY, bool lockRotZ);
 
+	// --------------------------------------------------------
+	// WARNING: THIS IS FOR INTERNAL ENGINE USE ONLY. DO NOT USE
+	// Add or remove the body from the physics scene
+	// (called by GameObject::SetEnabled)
+	// --------------------------------------------------------
+	void SetInScene(bool inScene);
+
 	// --------------------------------------------------------
 	// WARNING: THIS IS FOR INTERNAL ENGINE USE ONLY. DO NOT USE
 	// Get the collision resolver for this rigidbody.
@@ -0,0 +1,691 @@
+#include "SceneFile.h"
+#include <fstream>
+#include <unordered_map>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "GameObject.h"
+#include "EntityManager.h"
+#include "ResourceManager.h"
+#include "PhysicsManager.h"
+#include "Renderer.h"
+#include "MeshRenderer.h"
+#include "RigidBody.h"
+#include "Collider.h"
+
+using namespace DirectX;
+using namespace std;
+
+//Records are read straight out of the mapped file, so their layout is fixed
+static_assert(sizeof(SceneFileHeader) == 40, "Scene file header layout changed");
+static_assert(sizeof(SceneFileObject) == 60, "Scene file object layout changed");
+static_assert(sizeof(SceneFileComponent) == 40, "Scene file component layout changed");
+static_assert(sizeof(SceneFileString) == 8, "Scene file string layout changed");
+
+// --------------------------------------------------------
+// A read only view of a whole file mapped into memory
+// --------------------------------------------------------
+class MappedFile
+{
+private:
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#else
+	int file;
+#endif
+	const uint8_t* data;
+	size_t size;
+
+public:
+	MappedFile(const string& path);
+	~MappedFile();
+
+	//Delete this
+	MappedFile(MappedFile const&) = delete;
+	void operator=(MappedFile const&) = delete;
+
+	const uint8_t* GetData() { return data; }
+	size_t GetSize() { return size; }
+};
+
+// Map a file, the data is null if it couldn't be mapped
+MappedFile::MappedFile(const string& path)
+{
+	data = nullptr;
+	size = 0;
+
+#ifdef _WIN32
+	mapping = NULL;
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		return;
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+		return;
+
+	data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data != nullptr)
+		size = (size_t)fileSize.QuadPart;
+#else
+	file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+		return;
+
+	void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (view == MAP_FAILED)
+		return;
+
+	data = (const uint8_t*)view;
+	size = (size_t)fileStat.st_size;
+#endif
+}
+
+// Unmap the file
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mapping != NULL)
+		CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE)
+		CloseHandle(file);
+#else
+	if (data != nullptr)
+		munmap((void*)data, size);
+	if (file >= 0)
+		close(file);
+#endif
+}
+
+// Check that a table of records fits in the file
+static bool TableFits(uint32_t offset, uint32_t count, size_t recordSize, size_t fileSize)
+{
+	return (uint64_t)offset + (uint64_t)count * recordSize <= fileSize && offset % 4 == 0;
+}
+
+// Check that a capsule's stored direction is one of the CapsuleDirection values
+// (compared as floats, casting NaN or a huge value to int first is undefined)
+static bool CapsuleDirectionValid(float value)
+{
+	return value == (float)CapsuleDirection::X || value == (float)CapsuleDirection::Y
+		|| value == (float)CapsuleDirection::Z;
+}
+
+// Check that every offset and index in a scene file is in range,
+// so the records can be used without checking them again
+static bool ValidateScene(const uint8_t* data, size_t size, const string& path)
+{
+	if (size < sizeof(SceneFileHeader))
+	{
+		printf("Scene file \"%s\" is too small\n", path.c_str());
+		return false;
+	}
+
+	const SceneFileHeader* header = (const SceneFileHeader*)data;
+	if (header->magic != SCENE_FILE_MAGIC)
+	{
+		printf("\"%s\" is not a scene file\n", path.c_str());
+		return false;
+	}
+	if (header->version != SCENE_FILE_VERSION)
+	{
+		printf("Scene file \"%s\" is version %u, expected version %u\n",
+			path.c_str(), header->version, SCENE_FILE_VERSION);
+		return false;
+	}
+	if (header->fileSize != size
+		|| !TableFits(header->objectOffset, header->objectCount, sizeof(SceneFileObject), size)
+		|| !TableFits(header->componentOffset, header->componentCount, sizeof(SceneFileComponent), size)
+		|| !TableFits(header->stringOffset, header->stringCount, sizeof(SceneFileString), size)
+		|| header->stringDataOffset > size)
+	{
+		printf("Scene file \"%s\" is truncated or corrupt\n", path.c_str());
+		return false;
+	}
+
+	//Strings
+	const SceneFileString* strings = (const SceneFileString*)(data + header->stringOffset);
+	size_t stringDataSize = size - header->stringDataOffset;
+	for (uint32_t i = 0; i < header->stringCount; i++)
+	{
+		if ((uint64_t)strings[i].offset + strings[i].length > stringDataSize)
+		{
+			printf("Scene file \"%s\" has a string out of range\n", path.c_str());
+			return false;
+		}
+	}
+
+	//Components
+	const SceneFileComponent* components = (const SceneFileComponent*)(data + header->componentOffset);
+	for (uint32_t i = 0; i < header->componentCount; i++)
+	{
+		const SceneFileComponent& c = components[i];
+		if (c.type > SceneComponentType::CapsuleCollider
+			|| (c.resources[0] != SCENE_NO_STRING && c.resources[0] >= header->stringCount)
+			|| (c.resources[1] != SCENE_NO_STRING && c.resources[1] >= header->stringCount)
+			|| (c.type == SceneComponentType::CapsuleCollider && !CapsuleDirectionValid(c.values[2])))
+		{
+			printf("Scene file \"%s\" has an invalid component\n", path.c_str());
+			return false;
+		}
+	}
+
+	//Objects
+	const SceneFileObject* objects = (const SceneFileObject*)(data + header->objectOffset);
+	for (uint32_t i = 0; i < header->objectCount; i++)
+	{
+		const SceneFileObject& o = objects[i];
+		if (o.name >= header->stringCount
+			|| (o.parent != SCENE_NO_PARENT && o.parent >= i)
+			|| (uint64_t)o.firstComponent + o.componentCount > header->componentCount)
+		{
+			printf("Scene file \"%s\" has an invalid object\n", path.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Flags for which resources a string has been looked up as
+#define LOOKED_UP_MESH 1
+#define LOOKED_UP_MATERIAL 2
+#define LOOKED_UP_PHYSICS_MATERIAL 4
+
+// Set up an empty reader
+SceneFileReader::SceneFileReader()
+{
+	file = nullptr;
+	header = nullptr;
+	objects = nullptr;
+	components = nullptr;
+	strings = nullptr;
+	stringData = nullptr;
+	nextObject = 0;
+}
+
+// Unmap the file
+SceneFileReader::~SceneFileReader()
+{
+	Close();
+}
+
+// Map a scene file and check every record in it
+bool SceneFileReader::Open(const string& path)
+{
+	Close();
+
+	file = new MappedFile(path);
+	if (file->GetData() == nullptr)
+	{
+		printf("Could not open scene file \"%s\"\n", path.c_str());
+		Close();
+		return false;
+	}
+
+	const uint8_t* data = file->GetData();
+	if (!ValidateScene(data, file->GetSize(), path))
+	{
+		Close();
+		return false;
+	}
+
+	header = (const SceneFileHeader*)data;
+	objects = (const SceneFileObject*)(data + header->objectOffset);
+	components = (const SceneFileComponent*)(data + header->componentOffset);
+	strings = (const SceneFileString*)(data + header->stringOffset);
+	stringData = (const char*)(data + header->stringDataOffset);
+
+	//Validating read every table but the string data, read that too
+	volatile uint8_t touch = 0;
+	for (size_t i = header->stringDataOffset; i < file->GetSize(); i += 4096)
+	{
+		touch += data[i];
+	}
+
+	created.assign(header->objectCount, EntityHandle());
+	nextObject = 0;
+	meshes.assign(header->stringCount, nullptr);
+	materials.assign(header->stringCount, nullptr);
+	physicsMaterials.assign(header->stringCount, nullptr);
+	lookedUp.assign(header->stringCount, 0);
+	return true;
+}
+
+// Unmap the file
+void SceneFileReader::Close()
+{
+	delete file;
+	file = nullptr;
+	header = nullptr;
+	objects = nullptr;
+	components = nullptr;
+	strings = nullptr;
+	stringData = nullptr;
+	nextObject = 0;
+	created.clear();
+}
+
+// Get a string from the string table
+string SceneFileReader::GetString(uint32_t index)
+{
+	return string(stringData + strings[index].offset, strings[index].length);
+}
+
+// Get the mesh a string names
+Mesh* SceneFileReader::GetMesh(uint32_t index)
+{
+	if (index == SCENE_NO_STRING)
+		return nullptr;
+	if ((lookedUp[index] & LOOKED_UP_MESH) == 0)
+	{
+		lookedUp[index] |= LOOKED_UP_MESH;
+		meshes[index] = ResourceManager::GetInstance()->GetMesh(GetString(index));
+	}
+	return meshes[index];
+}
+
+// Get the material a string names
+Material* SceneFileReader::GetMaterial(uint32_t index)
+{
+	if (index == SCENE_NO_STRING)
+		return nullptr;
+	if ((lookedUp[index] & LOOKED_UP_MATERIAL) == 0)
+	{
+		lookedUp[index] |= LOOKED_UP_MATERIAL;
+		materials[index] = ResourceManager::GetInstance()->GetMaterial(GetString(index));
+	}
+	return materials[index];
+}
+
+// Get the physics material a string names
+PhysicsMaterial* SceneFileReader::GetPhysicsMaterial(uint32_t index)
+{
+	if (index == SCENE_NO_STRING)
+		return nullptr;
+	if ((lookedUp[index] & LOOKED_UP_PHYSICS_MATERIAL) == 0)
+	{
+		lookedUp[index] |= LOOKED_UP_PHYSICS_MATERIAL;
+		physicsMaterials[index] = ResourceManager::GetInstance()->GetPhysicsMaterial(GetString(index));
+	}
+	return physicsMaterials[index];
+}
+
+// Get the address of every mesh the scene uses
+vector<string> SceneFileReader::GetMeshAddresses()
+{
+	vector<string> addresses;
+	if (header == nullptr)
+		return addresses;
+
+	vector<bool> added(header->stringCount, false);
+	for (uint32_t i = 0; i < header->componentCount; i++)
+	{
+		uint32_t mesh = components[i].resources[0];
+		if (components[i].type == SceneComponentType::MeshRenderer && mesh != SCENE_NO_STRING && !added[mesh])
+		{
+			added[mesh] = true;
+			addresses.push_back(GetString(mesh));
+		}
+	}
+	return addresses;
+}
+
+// Grow entity and component storage for every object in the file
+void SceneFileReader::Reserve()
+{
+	if (header == nullptr)
+		return;
+
+	//Count components so storage is only grown once
+	size_t typeCounts[5] = { };
+	unordered_map<uint64_t, size_t> meshRendererCounts;
+	for (uint32_t i = 0; i < header->componentCount; i++)
+	{
+		typeCounts[(uint32_t)components[i].type]++;
+		if (components[i].type == SceneComponentType::MeshRenderer)
+			meshRendererCounts[((uint64_t)components[i].resources[0] << 32) | components[i].resources[1]]++;
+	}
+
+	ComponentManager* componentManager = ComponentManager::GetInstance();
+	componentManager->GetPool<RigidBody>()->Reserve(typeCounts[(uint32_t)SceneComponentType::RigidBody]);
+	componentManager->GetPool<MeshRenderer>()->Reserve(typeCounts[(uint32_t)SceneComponentType::MeshRenderer]);
+	componentManager->GetPool<BoxCollider>()->Reserve(typeCounts[(uint32_t)SceneComponentType::BoxCollider]);
+	componentManager->GetPool<SphereCollider>()->Reserve(typeCounts[(uint32_t)SceneComponentType::SphereCollider]);
+	componentManager->GetPool<CapsuleCollider>()->Reserve(typeCounts[(uint32_t)SceneComponentType::CapsuleCollider]);
+	for (auto iter = meshRendererCounts.begin(); iter != meshRendererCounts.end(); iter++)
+	{
+		Mesh* mesh = GetMesh((uint32_t)(iter->first >> 32));
+		Material* material = GetMaterial((uint32_t)iter->first);
+		if (mesh != nullptr && material != nullptr)
+			Renderer::GetInstance()->ReserveMeshRenderers(mesh, material, iter->second);
+	}
+
+	EntityManager::GetInstance()->Reserve(header->objectCount - nextObject);
+}
+
+// Create one object and its components
+GameObject* SceneFileReader::CreateObject(uint32_t index)
+{
+	const SceneFileObject& o = objects[index];
+
+	//Set the transform before any components listen to it
+	GameObject* obj = new GameObject(GetString(o.name));
+	if (o.parent != SCENE_NO_PARENT)
+	{
+		GameObject* parent = EntityManager::GetInstance()->GetEntity(created[o.parent]);
+		if (parent != nullptr)
+			obj->SetParent(parent);
+	}
+	obj->SetPosition(o.position);
+	obj->SetRotation(o.rotation);
+	obj->SetScale(o.scale);
+	created[index] = obj->GetHandle();
+
+	//Rigidbodies are added first so colliders attach straight to them
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (uint32_t c = o.firstComponent; c < o.firstComponent + o.componentCount; c++)
+		{
+			const SceneFileComponent& comp = components[c];
+			if ((comp.type == SceneComponentType::RigidBody) != (pass == 0))
+				continue;
+
+			const float* v = comp.values;
+			bool isTrigger = (comp.flags & SCENE_COMPONENT_TRIGGER) != 0;
+			switch (comp.type)
+			{
+			case SceneComponentType::RigidBody:
+				obj->AddComponent<RigidBody>(v[0]);
+				break;
+
+			case SceneComponentType::MeshRenderer:
+			{
+				Mesh* mesh = GetMesh(comp.resources[0]);
+				Material* material = GetMaterial(comp.resources[1]);
+				if (mesh != nullptr && material != nullptr)
+					obj->AddComponent<MeshRenderer>(mesh, material);
+				break;
+			}
+
+			case SceneComponentType::BoxCollider:
+				obj->AddComponent<BoxCollider>(XMFLOAT3(v[0], v[1], v[2]), isTrigger,
+					GetPhysicsMaterial(comp.resources[0]), XMFLOAT3(v[3], v[4], v[5]));
+				break;
+
+			case SceneComponentType::SphereCollider:
+				obj->AddComponent<SphereCollider>(v[0], isTrigger,
+					GetPhysicsMaterial(comp.resources[0]), XMFLOAT3(v[1], v[2], v[3]));
+				break;
+
+			case SceneComponentType::CapsuleCollider:
+				obj->AddComponent<CapsuleCollider>(v[0], v[1], (CapsuleDirection)(int)v[2], isTrigger,
+					GetPhysicsMaterial(comp.resources[0]), XMFLOAT3(v[3], v[4], v[5]));
+				break;
+			}
+		}
+	}
+
+	if (!o.enabled)
+		obj->SetEnabled(false);
+	return obj;
+}
+
+// Create the next objects in the file
+size_t SceneFileReader::Instantiate(size_t maxObjects, vector<GameObject*>* outObjects)
+{
+	if (header == nullptr)
+		return 0;
+
+	size_t end = nextObject + maxObjects;
+	if (end > header->objectCount || end < nextObject)
+		end = header->objectCount;
+	size_t count = end - nextObject;
+	if (count == 0)
+		return 0;
+	if (outObjects != nullptr)
+		outObjects->reserve(outObjects->size() + count);
+
+	//Queue actors so they are added to the scene together
+	PhysicsManager* physicsManager = PhysicsManager::GetInstance();
+	physicsManager->BeginActorBatch();
+
+	for (; nextObject < end; nextObject++)
+	{
+		GameObject* obj = CreateObject((uint32_t)nextObject);
+		if (outObjects != nullptr)
+			outObjects->push_back(obj);
+	}
+
+	physicsManager->EndActorBatch();
+	return count;
+}
+
+// Get the amount of objects in the file
+size_t SceneFileReader::GetObjectCount()
+{
+	return header == nullptr ? 0 : header->objectCount;
+}
+
+// Check if every object in the file has been created
+bool SceneFileReader::IsFinished()
+{
+	return header == nullptr || nextObject >= header->objectCount;
+}
+
+// Create every GameObject in a scene file
+bool SceneFile::Load(const string& path, vector<GameObject*>* outObjects)
+{
+	SceneFileReader reader;
+	if (!reader.Open(path))
+		return false;
+
+	reader.Reserve();
+	reader.Instantiate(reader.GetObjectCount(), outObjects);
+	return true;
+}
+
+// --------------------------------------------------------
+// Builds the tables of a scene file in memory
+// --------------------------------------------------------
+class SceneFileBuilder
+{
+private:
+	unordered_map<GameObject*, uint32_t> objectIndices;
+	unordered_map<string, uint32_t> stringIndices;
+
+public:
+	vector<SceneFileObject> objects;
+	vector<SceneFileComponent> components;
+	vector<SceneFileString> strings;
+	string stringData;
+
+	// Get the index of a string, adding it if it is new
+	uint32_t AddString(const string& s)
+	{
+		if (s.empty())
+			return SCENE_NO_STRING;
+
+		auto iter = stringIndices.find(s);
+		if (iter != stringIndices.end())
+			return iter->second;
+
+		SceneFileString entry;
+		entry.offset = (uint32_t)stringData.size();
+		entry.length = (uint32_t)s.size();
+		stringData += s;
+		strings.push_back(entry);
+
+		uint32_t index = (uint32_t)strings.size() - 1;
+		stringIndices[s] = index;
+		return index;
+	}
+
+	// Start a component record
+	SceneFileComponent& AddComponent(SceneComponentType type)
+	{
+		SceneFileComponent c = { };
+		c.type = type;
+		c.resources[0] = SCENE_NO_STRING;
+		c.resources[1] = SCENE_NO_STRING;
+		components.push_back(c);
+		return components.back();
+	}
+
+	// Fill in the parts every collider has
+	void AddColliderData(SceneFileComponent& c, Collider* collider, float* centerValues)
+	{
+		if (collider->GetTrigger())
+			c.flags |= SCENE_COMPONENT_TRIGGER;
+		if (collider->GetPhysicsMaterial() != nullptr)
+			c.resources[0] = AddString(ResourceManager::GetInstance()->FindPhysicsMaterialName(collider->GetPhysicsMaterial()));
+
+		XMFLOAT3 center = collider->GetCenter();
+		centerValues[0] = center.x;
+		centerValues[1] = center.y;
+		centerValues[2] = center.z;
+	}
+
+	// Add an object and then its children, so parents come first
+	void AddObject(GameObject* obj)
+	{
+		if (objectIndices.find(obj) != objectIndices.end())
+			return;
+
+		SceneFileObject o;
+		o.name = AddString(obj->GetName());
+		if (o.name == SCENE_NO_STRING)
+			o.name = AddString("GameObject");
+		auto parent = objectIndices.find(obj->GetParent());
+		o.parent = parent != objectIndices.end() ? parent->second : SCENE_NO_PARENT;
+		o.enabled = obj->GetEnabled() ? 1 : 0;
+		o.position = obj->GetPosition();
+		o.rotation = obj->GetRotation();
+		o.scale = obj->GetScale();
+		o.firstComponent = (uint32_t)components.size();
+
+		if (RigidBody* rb = obj->GetComponent<RigidBody>())
+			AddComponent(SceneComponentType::RigidBody).values[0] = rb->GetMass();
+
+		if (MeshRenderer* mr = obj->GetComponent<MeshRenderer>())
+		{
+			SceneFileComponent& c = AddComponent(SceneComponentType::MeshRenderer);
+			c.resources[0] = AddString(ResourceManager::GetInstance()->FindMeshAddress(mr->GetMesh()));
+			c.resources[1] = AddString(ResourceManager::GetInstance()->FindMaterialName(mr->GetMaterial()));
+		}
+
+		if (BoxCollider* box = obj->GetComponent<BoxCollider>())
+		{
+			SceneFileComponent& c = AddComponent(SceneComponentType::BoxCollider);
+			XMFLOAT3 size = box->GetSize();
+			c.values[0] = size.x;
+			c.values[1] = size.y;
+			c.values[2] = size.z;
+			AddColliderData(c, box, c.values + 3);
+		}
+
+		if (SphereCollider* sphere = obj->GetComponent<SphereCollider>())
+		{
+			SceneFileComponent& c = AddComponent(SceneComponentType::SphereCollider);
+			c.values[0] = sphere->GetRadius();
+			AddColliderData(c, sphere, c.values + 1);
+		}
+
+		if (CapsuleCollider* capsule = obj->GetComponent<CapsuleCollider>())
+		{
+			SceneFileComponent& c = AddComponent(SceneComponentType::CapsuleCollider);
+			c.values[0] = capsule->GetRadius();
+			c.values[1] = capsule->GetHeight();
+			c.values[2] = (float)(int)capsule->GetCapsuleDirection();
+			AddColliderData(c, capsule, c.values + 3);
+		}
+
+		o.componentCount = (uint32_t)components.size() - o.firstComponent;
+		objectIndices[obj] = (uint32_t)objects.size();
+		objects.push_back(o);
+
+		const vector<GameObject*>& children = obj->GetChildren();
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			AddObject(children[i]);
+		}
+	}
+};
+
+// Save GameObjects and all of their children to a file
+bool SceneFile::Save(const string& path, const vector<GameObject*>& roots)
+{
+	SceneFileBuilder builder;
+	for (size_t i = 0; i < roots.size(); i++)
+	{
+		builder.AddObject(roots[i]);
+	}
+
+	//Lay out the tables one after another
+	SceneFileHeader header = { };
+	header.magic = SCENE_FILE_MAGIC;
+	header.version = SCENE_FILE_VERSION;
+	header.objectCount = (uint32_t)builder.objects.size();
+	header.objectOffset = sizeof(SceneFileHeader);
+	header.componentCount = (uint32_t)builder.components.size();
+	header.componentOffset = header.objectOffset + header.objectCount * sizeof(SceneFileObject);
+	header.stringCount = (uint32_t)builder.strings.size();
+	header.stringOffset = header.componentOffset + header.componentCount * sizeof(SceneFileComponent);
+	header.stringDataOffset = header.stringOffset + header.stringCount * sizeof(SceneFileString);
+	header.fileSize = header.stringDataOffset + (uint32_t)builder.stringData.size();
+
+	ofstream file(path, ofstream::out | ofstream::binary | ofstream::trunc);
+	if (file.fail())
+	{
+		printf("Could not open scene file \"%s\" for writing\n", path.c_str());
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)builder.objects.data(), builder.objects.size() * sizeof(SceneFileObject));
+	file.write((const char*)builder.components.data(), builder.components.size() * sizeof(SceneFileComponent));
+	file.write((const char*)builder.strings.data(), builder.strings.size() * sizeof(SceneFileString));
+	file.write(builder.stringData.data(), builder.stringData.size());
+	file.close();
+
+	if (file.fail())
+	{
+		printf("Could not write scene file \"%s\"\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+//Passes every entity in EntityManager::ForEach
+struct AnyEntity
+{
+	static bool Test(GameObject* entity, ChangeVersion since) { return true; }
+};
+
+// Save every GameObject in the EntityManager to a file
+bool SceneFile::Save(const string& path)
+{
+	vector<GameObject*> roots;
+	EntityManager::GetInstance()->ForEach<AnyEntity>(0, [&roots](GameObject* entity) {
+		if (entity->GetParent() == nullptr)
+			roots.push_back(entity);
+	});
+	return Save(path, roots);
+}
\ No newline at end of file
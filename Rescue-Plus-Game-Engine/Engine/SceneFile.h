@@ -0,0 +1,233 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "EntityHandle.h"
+
+class GameObject;
+class MappedFile;
+class Mesh;
+class Material;
+class PhysicsMaterial;
+
+//"RSCN" read as a little endian integer
+#define SCENE_FILE_MAGIC 0x4E435352
+//Bump this when the layout of any record changes
+#define SCENE_FILE_VERSION 1
+
+#define SCENE_NO_PARENT UINT32_MAX
+#define SCENE_NO_STRING UINT32_MAX
+
+// --------------------------------------------------------
+// Component types a scene file can store
+// --------------------------------------------------------
+enum class SceneComponentType : uint32_t
+{
+	RigidBody = 0,
+	MeshRenderer = 1,
+	BoxCollider = 2,
+	SphereCollider = 3,
+	CapsuleCollider = 4
+};
+
+// --------------------------------------------------------
+// The start of a scene file. Offsets are in bytes from the
+// start of the file and every table is 4 byte aligned
+// --------------------------------------------------------
+struct SceneFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t fileSize;
+	uint32_t objectCount;
+	uint32_t objectOffset;
+	uint32_t componentCount;
+	uint32_t componentOffset;
+	uint32_t stringCount;
+	uint32_t stringOffset;		//SceneFileString table
+	uint32_t stringDataOffset;	//Characters the string table points into
+};
+
+// --------------------------------------------------------
+// A string in the scene file (not null terminated)
+// --------------------------------------------------------
+struct SceneFileString
+{
+	uint32_t offset;	//From stringDataOffset
+	uint32_t length;
+};
+
+// --------------------------------------------------------
+// A GameObject in the scene file. Parents always come before
+// their children and transforms are in world space
+// --------------------------------------------------------
+struct SceneFileObject
+{
+	uint32_t name;				//String index
+	uint32_t parent;			//Object index or SCENE_NO_PARENT
+	uint32_t firstComponent;
+	uint32_t componentCount;
+	uint32_t enabled;
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT4 rotation;
+	DirectX::XMFLOAT3 scale;
+};
+
+// --------------------------------------------------------
+// A component in the scene file. What the fields mean
+// depends on the type:
+//
+// RigidBody - values: mass
+// MeshRenderer - resources: mesh address, material name
+// BoxCollider - values: size xyz, center xyz
+// SphereCollider - values: radius, center xyz
+// CapsuleCollider - values: radius, height, direction, center xyz
+//
+// Colliders store their physics material in resources[0]
+// and their trigger flag in flags
+// --------------------------------------------------------
+struct SceneFileComponent
+{
+	SceneComponentType type;
+	uint32_t flags;
+	uint32_t resources[2];	//String indices or SCENE_NO_STRING
+	float values[6];
+};
+
+#define SCENE_COMPONENT_TRIGGER 1
+
+// --------------------------------------------------------
+// A scene file mapped into memory and checked, ready to have
+// its objects created a few at a time.
+//
+// Open() touches no engine state, so it can run on a loading
+// thread. Everything else must run on the main thread
+// --------------------------------------------------------
+class SceneFileReader
+{
+private:
+	MappedFile* file;
+	const SceneFileHeader* header;
+	const SceneFileObject* objects;
+	const SceneFileComponent* components;
+	const SceneFileString* strings;
+	const char* stringData;
+
+	//Objects are created in file order, children look up
+	// their parent by handle in case it was removed
+	std::vector<EntityHandle> created;
+	size_t nextObject;
+
+	//Resources by string index, each name is only looked up once
+	std::vector<Mesh*> meshes;
+	std::vector<Material*> materials;
+	std::vector<PhysicsMaterial*> physicsMaterials;
+	std::vector<uint8_t> lookedUp;
+
+	// --------------------------------------------------------
+	// Get a string from the string table
+	// --------------------------------------------------------
+	std::string GetString(uint32_t index);
+
+	// --------------------------------------------------------
+	// Get the resource a string names (null if there is none)
+	// --------------------------------------------------------
+	Mesh* GetMesh(uint32_t index);
+	Material* GetMaterial(uint32_t index);
+	PhysicsMaterial* GetPhysicsMaterial(uint32_t index);
+
+	// --------------------------------------------------------
+	// Create one object and its components
+	// --------------------------------------------------------
+	GameObject* CreateObject(uint32_t index);
+
+public:
+	SceneFileReader();
+	~SceneFileReader();
+
+	//Delete this
+	SceneFileReader(SceneFileReader const&) = delete;
+	void operator=(SceneFileReader const&) = delete;
+
+	// --------------------------------------------------------
+	// Map a scene file and check every record in it.
+	// The pages are read in here so creating objects later
+	// does not wait on the disk
+	//
+	// returns false if the file can't be read or is not a valid
+	//		scene file of this version
+	// --------------------------------------------------------
+	bool Open(const std::string& path);
+
+	// --------------------------------------------------------
+	// Unmap the file (called by the destructor)
+	// --------------------------------------------------------
+	void Close();
+
+	// --------------------------------------------------------
+	// Get the address of every mesh the scene uses
+	// (can be called from the loading thread after Open)
+	// --------------------------------------------------------
+	std::vector<std::string> GetMeshAddresses();
+
+	// --------------------------------------------------------
+	// Grow entity and component storage for every object in
+	// the file, so creating them never reallocates
+	// --------------------------------------------------------
+	void Reserve();
+
+	// --------------------------------------------------------
+	// Create the next objects in the file
+	//
+	// maxObjects - the most objects to create in this call
+	// outObjects - the created objects (optional output)
+	// returns the amount of objects created
+	// --------------------------------------------------------
+	size_t Instantiate(size_t maxObjects, std::vector<GameObject*>* outObjects = nullptr);
+
+	// --------------------------------------------------------
+	// Get the amount of objects in the file
+	// --------------------------------------------------------
+	size_t GetObjectCount();
+
+	// --------------------------------------------------------
+	// Check if every object in the file has been created
+	// --------------------------------------------------------
+	bool IsFinished();
+};
+
+// --------------------------------------------------------
+// Saves GameObjects to a binary scene file and loads them back.
+//
+// Loading maps the file into memory and reads the records in
+// place. Entity and component storage is grown once for the whole
+// scene, each resource name is looked up once, and every PhysX
+// actor is added to the scene in one batch.
+//
+// Only RigidBody, MeshRenderer and the collider components are
+// stored, one of each type per GameObject. Resources are stored by
+// name and must be loaded into the ResourceManager before loading
+// --------------------------------------------------------
+class SceneFile
+{
+public:
+	// --------------------------------------------------------
+	// Save GameObjects and all of their children to a file
+	// --------------------------------------------------------
+	static bool Save(const std::string& path, const std::vector<GameObject*>& roots);
+
+	// --------------------------------------------------------
+	// Save every GameObject in the EntityManager to a file
+	// --------------------------------------------------------
+	static bool Save(const std::string& path);
+
+	// --------------------------------------------------------
+	// Create every GameObject in a scene file
+	//
+	// outObjects - the created objects, in file order (optional output)
+	// returns false if the file can't be read or is not a valid
+	//		scene file of this version (nothing is created then)
+	// --------------------------------------------------------
+	static bool Load(const std::string& path, std::vector<GameObject*>* outObjects = nullptr);
+};
\ No newline at end of file
@@ -10,6 +10,9 @@
 #include <vector>
 #include <string>
 
+#include "StringId.h"
+#include "RenderDevice.h"
+
 // --------------------------------------------------------
 // Used by simple shaders to store information about
 // specific variables in constant buffers
@@ -75,41 +78,61 @@ public:
 	void SetShader();
 	void CopyAllBufferData();
 	void CopyBufferData(unsigned int index);
-	void CopyBufferData(std::string bufferName);
-
-	// Sets arbitrary shader data
-	bool SetData(std::string name, const void* data, unsigned int size);
-
-	bool SetInt(std::string name, int data);
-	bool SetFloat(std::string name, float data);
-	bool SetFloat2(std::string name, const float data[2]);
-	bool SetFloat2(std::string name, const DirectX::XMFLOAT2 data);
-	bool SetFloat3(std::string name, const float data[3]);
-	bool SetFloat3(std::string name, const DirectX::XMFLOAT3 data);
-	bool SetFloat4(std::string name, const float data[4]);
-	bool SetFloat4(std::string name, const DirectX::XMFLOAT4 data);
-	bool SetMatrix4x4(std::string name, const float data[16]);
-	bool SetMatrix4x4(std::string name, const DirectX::XMFLOAT4X4 data);
+	void CopyBufferData(StringId bufferName);
+	void CopyBufferData(std::string bufferName) { CopyBufferData(StringId(bufferName)); }
+
+	// Sets arbitrary shader data. Names can be passed as ids
+	// (SID("name") for literals) to skip hashing the string
+	bool SetData(StringId name, const void* data, unsigned int size);
+	bool SetData(std::string name, const void* data, unsigned int size) { return SetData(StringId(name), data, size); }
+
+	bool SetInt(StringId name, int data);
+	bool SetFloat(StringId name, float data);
+	bool SetFloat2(StringId name, const float data[2]);
+	bool SetFloat2(StringId name, const DirectX::XMFLOAT2 data);
+	bool SetFloat3(StringId name, const float data[3]);
+	bool SetFloat3(StringId name, const DirectX::XMFLOAT3 data);
+	bool SetFloat4(StringId name, const float data[4]);
+	bool SetFloat4(StringId name, const DirectX::XMFLOAT4 data);
+	bool SetMatrix4x4(StringId name, const float data[16]);
+	bool SetMatrix4x4(StringId name, const DirectX::XMFLOAT4X4 data);
+
+	bool SetInt(std::string name, int data) { return SetInt(StringId(name), data); }
+	bool SetFloat(std::string name, float data) { return SetFloat(StringId(name), data); }
+	bool SetFloat2(std::string name, const float data[2]) { return SetFloat2(StringId(name), data); }
+	bool SetFloat2(std::string name, const DirectX::XMFLOAT2 data) { return SetFloat2(StringId(name), data); }
+	bool SetFloat3(std::string name, const float data[3]) { return SetFloat3(StringId(name), data); }
+	bool SetFloat3(std::string name, const DirectX::XMFLOAT3 data) { return SetFloat3(StringId(name), data); }
+	bool SetFloat4(std::string name, const float data[4]) { return SetFloat4(StringId(name), data); }
+	bool SetFloat4(std::string name, const DirectX::XMFLOAT4 data) { return SetFloat4(StringId(name), data); }
+	bool SetMatrix4x4(std::string name, const float data[16]) { return SetMatrix4x4(StringId(name), data); }
+	bool SetMatrix4x4(std::string name, const DirectX::XMFLOAT4X4 data) { return SetMatrix4x4(StringId(name), data); }
 
 	// Setting shader resources
-	virtual bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv) = 0;
-	virtual bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState) = 0;
+	virtual bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv) = 0;
+	virtual bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState) = 0;
+	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv) { return SetShaderResourceView(StringId(name), srv); }
+	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState) { return SetSamplerState(StringId(name), samplerState); }
 
 	// Getting data about variables and resources
-	const SimpleShaderVariable* GetVariableInfo(std::string name);
+	const SimpleShaderVariable* GetVariableInfo(StringId name);
+	const SimpleShaderVariable* GetVariableInfo(std::string name) { return GetVariableInfo(StringId(name)); }
 	
-	const SimpleSRV* GetShaderResourceViewInfo(std::string name);
+	const SimpleSRV* GetShaderResourceViewInfo(StringId name);
+	const SimpleSRV* GetShaderResourceViewInfo(std::string name) { return GetShaderResourceViewInfo(StringId(name)); }
 	const SimpleSRV* GetShaderResourceViewInfo(unsigned int index);
 	size_t GetShaderResourceViewCount() { return textureTable.size(); }
 	
-	const SimpleSampler* GetSamplerInfo(std::string name);
+	const SimpleSampler* GetSamplerInfo(StringId name);
+	const SimpleSampler* GetSamplerInfo(std::string name) { return GetSamplerInfo(StringId(name)); }
 	const SimpleSampler* GetSamplerInfo(unsigned int index);
 	size_t GetSamplerCount() { return samplerTable.size(); }
 
 	// Get data about constant buffers
 	unsigned int GetBufferCount();
 	unsigned int GetBufferSize(unsigned int index);
-	const SimpleConstantBuffer* GetBufferInfo(std::string name);
+	const SimpleConstantBuffer* GetBufferInfo(StringId name);
+	const SimpleConstantBuffer* GetBufferInfo(std::string name) { return GetBufferInfo(StringId(name)); }
 	const SimpleConstantBuffer* GetBufferInfo(unsigned int index);
 	
 	// Misc getters
@@ -125,14 +148,14 @@ protected:
 	// Resource counts
 	unsigned int constantBufferCount;
 	
-	// Maps for variables and buffers
+	// Maps for variables and buffers, keyed by interned name
 	SimpleConstantBuffer*		constantBuffers; // For index-based lookup
 	std::vector<SimpleSRV*>		shaderResourceViews;
 	std::vector<SimpleSampler*>	samplerStates;
-	std::unordered_map<std::string, SimpleConstantBuffer*> cbTable;
-	std::unordered_map<std::string, SimpleShaderVariable> varTable;
-	std::unordered_map<std::string, SimpleSRV*> textureTable;
-	std::unordered_map<std::string, SimpleSampler*> samplerTable;
+	std::unordered_map<StringId, SimpleConstantBuffer*> cbTable;
+	std::unordered_map<StringId, SimpleShaderVariable> varTable;
+	std::unordered_map<StringId, SimpleSRV*> textureTable;
+	std::unordered_map<StringId, SimpleSampler*> samplerTable;
 
 	// Pure virtual functions for dealing with shader types
 	virtual bool CreateShader(ID3DBlob* shaderBlob) = 0;
@@ -141,8 +164,14 @@ protected:
 	virtual void CleanUp();
 
 	// Helpers for finding data by name
-	SimpleShaderVariable* FindVariable(std::string name, int size);
-	SimpleConstantBuffer* FindConstantBuffer(std::string name);
+	SimpleShaderVariable* FindVariable(StringId name, int size);
+	SimpleConstantBuffer* FindConstantBuffer(StringId name);
+
+	// The device binds and buffer copies are sent through
+	RenderDevice* GetRenderDevice();
+
+	// The data a constant buffer's variables are set in
+	unsigned char* GetLocalData(SimpleConstantBuffer* cb);
 };
 
 // --------------------------------------------------------
@@ -158,8 +187,10 @@ public:
 	ID3D11InputLayout* GetInputLayout() { return inputLayout; }
 	bool GetPerInstanceCompatible() { return perInstanceCompatible; }
 
-	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv);
-	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState);
+	using ISimpleShader::SetShaderResourceView;
+	using ISimpleShader::SetSamplerState;
+	bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv);
+	bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState);
 
 protected:
 	bool perInstanceCompatible;
@@ -181,8 +212,10 @@ public:
 	~SimplePixelShader();
 	ID3D11PixelShader* GetDirectXShader() { return shader; }
 
-	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv);
-	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState);
+	using ISimpleShader::SetShaderResourceView;
+	using ISimpleShader::SetSamplerState;
+	bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv);
+	bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState);
 
 protected:
 	ID3D11PixelShader* shader;
@@ -201,8 +234,10 @@ public:
 	~SimpleDomainShader();
 	ID3D11DomainShader* GetDirectXShader() { return shader; }
 
-	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv);
-	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState);
+	using ISimpleShader::SetShaderResourceView;
+	using ISimpleShader::SetSamplerState;
+	bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv);
+	bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState);
 
 protected:
 	ID3D11DomainShader* shader;
@@ -221,8 +256,10 @@ public:
 	~SimpleHullShader();
 	ID3D11HullShader* GetDirectXShader() { return shader; }
 
-	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv);
-	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState);
+	using ISimpleShader::SetShaderResourceView;
+	using ISimpleShader::SetSamplerState;
+	bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv);
+	bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState);
 
 protected:
 	ID3D11HullShader* shader;
@@ -241,8 +278,10 @@ public:
 	~SimpleGeometryShader();
 	ID3D11GeometryShader* GetDirectXShader() { return shader; }
 
-	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv);
-	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState);
+	using ISimpleShader::SetShaderResourceView;
+	using ISimpleShader::SetSamplerState;
+	bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv);
+	bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState);
 
 	bool CreateCompatibleStreamOutBuffer(ID3D11Buffer** buffer, int vertexCount);
 
@@ -280,8 +319,10 @@ public:
 	void DispatchByGroups(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ);
 	void DispatchByThreads(unsigned int threadsX, unsigned int threadsY, unsigned int threadsZ);
 
-	bool SetShaderResourceView(std::string name, ID3D11ShaderResourceView* srv);
-	bool SetSamplerState(std::string name, ID3D11SamplerState* samplerState);
+	using ISimpleShader::SetShaderResourceView;
+	using ISimpleShader::SetSamplerState;
+	bool SetShaderResourceView(StringId name, ID3D11ShaderResourceView* srv);
+	bool SetSamplerState(StringId name, ID3D11SamplerState* samplerState);
 	bool SetUnorderedAccessView(std::string name, ID3D11UnorderedAccessView* uav, unsigned int appendConsumeOffset = -1);
 
 	int GetUnorderedAccessViewIndex(std::string name);
@@ -0,0 +1,356 @@
+#include "SpatialIndex.h"
+#include "EntityManager.h"
+#include <cmath>
+#include <algorithm>
+#include <cfloat>
+
+using namespace DirectX;
+using namespace std;
+
+// Build a frustum that contains everything
+Frustum::Frustum()
+{
+	for (int i = 0; i < 6; i++)
+		planes[i] = XMFLOAT4(0, 0, 0, 0);
+	boundsMin = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	boundsMax = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+}
+
+// Build a frustum from a camera's raw view and projection matrices
+Frustum::Frustum(XMFLOAT4X4 view, XMFLOAT4X4 projection)
+{
+	XMMATRIX viewProj = XMMatrixMultiply(XMLoadFloat4x4(&view), XMLoadFloat4x4(&projection));
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, viewProj);
+
+	//Planes from the columns of the view projection matrix
+	// (clip space z is 0 to 1)
+	XMFLOAT4 col[4];
+	for (int c = 0; c < 4; c++)
+		col[c] = XMFLOAT4(m.m[0][c], m.m[1][c], m.m[2][c], m.m[3][c]);
+
+	planes[0] = XMFLOAT4(col[3].x + col[0].x, col[3].y + col[0].y, col[3].z + col[0].z, col[3].w + col[0].w);	//Left
+	planes[1] = XMFLOAT4(col[3].x - col[0].x, col[3].y - col[0].y, col[3].z - col[0].z, col[3].w - col[0].w);	//Right
+	planes[2] = XMFLOAT4(col[3].x + col[1].x, col[3].y + col[1].y, col[3].z + col[1].z, col[3].w + col[1].w);	//Bottom
+	planes[3] = XMFLOAT4(col[3].x - col[1].x, col[3].y - col[1].y, col[3].z - col[1].z, col[3].w - col[1].w);	//Top
+	planes[4] = col[2];																							//Near
+	planes[5] = XMFLOAT4(col[3].x - col[2].x, col[3].y - col[2].y, col[3].z - col[2].z, col[3].w - col[2].w);	//Far
+
+	//Normalize so plane distances are in world units
+	for (int i = 0; i < 6; i++)
+	{
+		float length = sqrtf(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+		planes[i] = XMFLOAT4(planes[i].x / length, planes[i].y / length,
+			planes[i].z / length, planes[i].w / length);
+	}
+
+	//Box around the corners of the clip space cube in world space
+	XMMATRIX invViewProj = XMMatrixInverse(nullptr, viewProj);
+	boundsMin = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX);
+	boundsMax = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (int i = 0; i < 8; i++)
+	{
+		XMFLOAT3 corner;
+		XMStoreFloat3(&corner, XMVector3TransformCoord(XMVectorSet(
+			(i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : 0.0f, 1.0f), invViewProj));
+
+		boundsMin = XMFLOAT3(min(boundsMin.x, corner.x), min(boundsMin.y, corner.y), min(boundsMin.z, corner.z));
+		boundsMax = XMFLOAT3(max(boundsMax.x, corner.x), max(boundsMax.y, corner.y), max(boundsMax.z, corner.z));
+	}
+}
+
+// Set up the spatial index
+SpatialIndex::SpatialIndex()
+{
+	cellSize = SPATIAL_DEFAULT_CELL_SIZE;
+	invCellSize = 1.0f / cellSize;
+	buckets.resize(SPATIAL_BUCKET_COUNT, SPATIAL_INVALID_ID);
+	entryCount = 0;
+	readingChanges = false;
+	changeReader = 0;
+}
+
+// Clear the index
+void SpatialIndex::Release()
+{
+	entries.clear();
+	freeEntries.clear();
+	largeEntries.clear();
+	fill(buckets.begin(), buckets.end(), SPATIAL_INVALID_ID);
+	entryCount = 0;
+}
+
+// Get the cell a coordinate is in
+int32_t SpatialIndex::CellCoord(float value)
+{
+	//Unbounded or far away coordinates don't fit an int, clamp them (NaN too)
+	float cell = floorf(value * invCellSize);
+	if (!(cell > -SPATIAL_MAX_CELL))
+		return -(int32_t)SPATIAL_MAX_CELL;
+	if (cell > SPATIAL_MAX_CELL)
+		return (int32_t)SPATIAL_MAX_CELL;
+	return (int32_t)cell;
+}
+
+// Get the bucket a cell is stored in
+uint32_t SpatialIndex::HashCell(int32_t x, int32_t y, int32_t z)
+{
+	uint32_t hash = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+	return hash & (SPATIAL_BUCKET_COUNT - 1);
+}
+
+// Get an object's bounding sphere
+//	(a unit cube scaled by the object's transform)
+void SpatialIndex::GetBounds(GameObject* obj, XMFLOAT3* center, float* radius)
+{
+	XMFLOAT3 scale = obj->GetScale();
+	float maxScale = max(fabsf(scale.x), max(fabsf(scale.y), fabsf(scale.z)));
+
+	*center = obj->GetPosition();
+	*radius = 0.8660254f * maxScale;
+}
+
+// Link an entry into the bucket or large list for its bounds
+void SpatialIndex::Link(uint32_t id)
+{
+	Entry& entry = entries[id];
+	entry.cell[0] = CellCoord(entry.center.x);
+	entry.cell[1] = CellCoord(entry.center.y);
+	entry.cell[2] = CellCoord(entry.center.z);
+
+	//Too big to only look one cell out for
+	if (entry.radius > cellSize)
+	{
+		entry.bucket = SPATIAL_INVALID_ID;
+		entry.prev = (uint32_t)largeEntries.size();
+		largeEntries.push_back(id);
+		return;
+	}
+
+	entry.bucket = HashCell(entry.cell[0], entry.cell[1], entry.cell[2]);
+	entry.prev = SPATIAL_INVALID_ID;
+	entry.next = buckets[entry.bucket];
+	if (entry.next != SPATIAL_INVALID_ID)
+		entries[entry.next].prev = id;
+	buckets[entry.bucket] = id;
+}
+
+// Unlink an entry from its bucket or the large list
+void SpatialIndex::Unlink(uint32_t id)
+{
+	Entry& entry = entries[id];
+	if (entry.bucket == SPATIAL_INVALID_ID)
+	{
+		//Swap with the last large entry and pop
+		uint32_t last = largeEntries.back();
+		largeEntries[entry.prev] = last;
+		entries[last].prev = entry.prev;
+		largeEntries.pop_back();
+		return;
+	}
+
+	if (entry.prev != SPATIAL_INVALID_ID)
+		entries[entry.prev].next = entry.next;
+	else buckets[entry.bucket] = entry.next;
+	if (entry.next != SPATIAL_INVALID_ID)
+		entries[entry.next].prev = entry.prev;
+}
+
+// Add an object to the index
+void SpatialIndex::Insert(GameObject* obj)
+{
+	uint32_t id;
+	if (freeEntries.size() > 0)
+	{
+		id = freeEntries.back();
+		freeEntries.pop_back();
+	}
+	else
+	{
+		id = (uint32_t)entries.size();
+		entries.push_back(Entry());
+	}
+
+	Entry& entry = entries[id];
+	entry.object = obj;
+	GetBounds(obj, &entry.center, &entry.radius);
+	Link(id);
+
+	obj->spatialId = id;
+	entryCount++;
+}
+
+// Update the bounds of an object in the index
+void SpatialIndex::Move(GameObject* obj)
+{
+	uint32_t id = obj->spatialId;
+	Entry& entry = entries[id];
+
+	XMFLOAT3 center;
+	float radius;
+	GetBounds(obj, &center, &radius);
+
+	//Only relink if it changed cells or size class
+	bool wasLarge = entry.bucket == SPATIAL_INVALID_ID;
+	bool isLarge = radius > cellSize;
+	entry.center = center;
+	entry.radius = radius;
+	if (wasLarge == isLarge && (isLarge || (entry.cell[0] == CellCoord(center.x) &&
+		entry.cell[1] == CellCoord(center.y) && entry.cell[2] == CellCoord(center.z))))
+		return;
+
+	Unlink(id);
+	Link(id);
+}
+
+// Remove an object from the index
+void SpatialIndex::Remove(GameObject* obj)
+{
+	uint32_t id = obj->spatialId;
+	if (id == SPATIAL_INVALID_ID)
+		return;
+
+	Unlink(id);
+	entries[id].object = nullptr;
+	freeEntries.push_back(id);
+	obj->spatialId = SPATIAL_INVALID_ID;
+	entryCount--;
+}
+
+// Set the size of a grid cell and re-insert every object
+void SpatialIndex::SetCellSize(float size)
+{
+	cellSize = size;
+	invCellSize = 1.0f / size;
+
+	largeEntries.clear();
+	fill(buckets.begin(), buckets.end(), SPATIAL_INVALID_ID);
+	for (uint32_t id = 0; id < entries.size(); id++)
+	{
+		if (entries[id].object != nullptr)
+			Link(id);
+	}
+}
+
+// Add enabled objects and move objects whose transform changed
+void SpatialIndex::Sync()
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+
+	//Objects from before the log was read are only found by looking at all of them
+	if (!readingChanges)
+	{
+		changeReader = entityManager->AddTransformReader();
+		readingChanges = true;
+		entityManager->ForEachActive([this](GameObject* obj) {
+			if (obj->spatialId == SPATIAL_INVALID_ID)
+				Insert(obj);
+		});
+		return;
+	}
+
+	//New and enabled objects are logged as changed too
+	entityManager->ReadTransformChanges(changeReader, [this](GameObject* obj) {
+		if (!obj->GetEnabled())
+			return;
+
+		if (obj->spatialId == SPATIAL_INVALID_ID)
+			Insert(obj);
+		else Move(obj);
+	});
+}
+
+// Run a function on every entry that may overlap a box
+template <typename Func>
+void SpatialIndex::ForEachCandidate(XMFLOAT3 min, XMFLOAT3 max, Func func)
+{
+	//Small entries can stick out of their cell by up to a cell
+	int32_t minCell[3] = { CellCoord(min.x - cellSize), CellCoord(min.y - cellSize), CellCoord(min.z - cellSize) };
+	int32_t maxCell[3] = { CellCoord(max.x + cellSize), CellCoord(max.y + cellSize), CellCoord(max.z + cellSize) };
+	double cellCount = ((double)maxCell[0] - minCell[0] + 1) *
+		((double)maxCell[1] - minCell[1] + 1) * ((double)maxCell[2] - minCell[2] + 1);
+
+	//Scanning every entry is cheaper than visiting more cells than there are entries
+	// (always true for unbounded boxes, which span the clamped cell range)
+	if (cellCount > (double)entryCount)
+	{
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			if (entries[i].object != nullptr && entries[i].bucket != SPATIAL_INVALID_ID)
+				func(entries[i]);
+		}
+	}
+	else
+	{
+		for (int32_t x = minCell[0]; x <= maxCell[0]; x++)
+		{
+			for (int32_t y = minCell[1]; y <= maxCell[1]; y++)
+			{
+				for (int32_t z = minCell[2]; z <= maxCell[2]; z++)
+				{
+					//Buckets are shared by cells, so check the entry's cell
+					for (uint32_t id = buckets[HashCell(x, y, z)]; id != SPATIAL_INVALID_ID; id = entries[id].next)
+					{
+						Entry& entry = entries[id];
+						if (entry.cell[0] == x && entry.cell[1] == y && entry.cell[2] == z)
+							func(entry);
+					}
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < largeEntries.size(); i++)
+	{
+		func(entries[largeEntries[i]]);
+	}
+}
+
+// Find objects whose bounds overlap a sphere
+size_t SpatialIndex::QuerySphere(XMFLOAT3 center, float radius, GameObject** results, size_t maxResults)
+{
+	size_t count = 0;
+	XMFLOAT3 min(center.x - radius, center.y - radius, center.z - radius);
+	XMFLOAT3 max(center.x + radius, center.y + radius, center.z + radius);
+	ForEachCandidate(min, max, [&](Entry& entry) {
+		float dx = entry.center.x - center.x;
+		float dy = entry.center.y - center.y;
+		float dz = entry.center.z - center.z;
+		float r = entry.radius + radius;
+		if (dx * dx + dy * dy + dz * dz <= r * r)
+			Output(entry.object, results, maxResults, &count);
+	});
+	return count;
+}
+
+// Find objects whose bounds overlap a box
+size_t SpatialIndex::QueryBox(XMFLOAT3 min, XMFLOAT3 max, GameObject** results, size_t maxResults)
+{
+	size_t count = 0;
+	ForEachCandidate(min, max, [&](Entry& entry) {
+		//Distance from the sphere's center to the closest point in the box
+		float dx = std::max(std::max(min.x - entry.center.x, 0.0f), entry.center.x - max.x);
+		float dy = std::max(std::max(min.y - entry.center.y, 0.0f), entry.center.y - max.y);
+		float dz = std::max(std::max(min.z - entry.center.z, 0.0f), entry.center.z - max.z);
+		if (dx * dx + dy * dy + dz * dz <= entry.radius * entry.radius)
+			Output(entry.object, results, maxResults, &count);
+	});
+	return count;
+}
+
+// Find objects whose bounds are at least partly in a frustum
+size_t SpatialIndex::QueryFrustum(const Frustum& frustum, GameObject** results, size_t maxResults)
+{
+	size_t count = 0;
+	ForEachCandidate(frustum.boundsMin, frustum.boundsMax, [&](Entry& entry) {
+		if (frustum.Intersects(entry.center, entry.radius))
+			Output(entry.object, results, maxResults, &count);
+	});
+	return count;
+}
+
+// Get the amount of objects in the index
+size_t SpatialIndex::GetCount()
+{
+	return entryCount;
+}
\ No newline at end of file
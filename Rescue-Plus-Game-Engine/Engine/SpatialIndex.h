@@ -0,0 +1,226 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+
+#define SPATIAL_INVALID_ID UINT32_MAX
+
+//Default size of a grid cell in world units
+#define SPATIAL_DEFAULT_CELL_SIZE 8.0f
+//Amount of hash buckets (must be a power of two)
+#define SPATIAL_BUCKET_COUNT 16384
+//Cell coordinates are clamped to this, so unbounded boxes still fit an int
+#define SPATIAL_MAX_CELL 1073741824.0f
+
+class GameObject;
+
+// --------------------------------------------------------
+// A view frustum as six inward facing planes and the box
+// around its corners
+// --------------------------------------------------------
+struct Frustum
+{
+	DirectX::XMFLOAT4 planes[6];
+	DirectX::XMFLOAT3 boundsMin;
+	DirectX::XMFLOAT3 boundsMax;
+
+	// --------------------------------------------------------
+	// Build a frustum that contains everything
+	// --------------------------------------------------------
+	Frustum();
+
+	// --------------------------------------------------------
+	// Build a frustum from a camera's raw (not transposed)
+	// view and projection matrices
+	// --------------------------------------------------------
+	Frustum(DirectX::XMFLOAT4X4 view, DirectX::XMFLOAT4X4 projection);
+
+	// --------------------------------------------------------
+	// Check if a sphere is at least partly inside the frustum
+	// --------------------------------------------------------
+	bool Intersects(DirectX::XMFLOAT3 center, float radius) const
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			const DirectX::XMFLOAT4& p = planes[i];
+			if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius)
+				return false;
+		}
+		return true;
+	}
+};
+
+// --------------------------------------------------------
+// A spatial index over every enabled GameObject.
+//
+// Objects are stored as bounding spheres in a loose hashed grid.
+// Each object lives in the cell its center is in, so queries
+// look one cell further out. Objects bigger than a cell are kept
+// in a separate list that every query checks.
+//
+// The index is synced once per frame from the EntityManager's
+// transform change log, so only objects that moved are touched.
+// Queries write into buffers owned by the caller and never
+// allocate. Queries with unbounded boxes (like a default
+// Frustum's) scan every object
+// --------------------------------------------------------
+class SpatialIndex
+{
+private:
+	struct Entry
+	{
+		GameObject* object;
+		DirectX::XMFLOAT3 center;
+		float radius;
+		int32_t cell[3];
+		uint32_t bucket;
+		uint32_t next;
+		uint32_t prev;
+	};
+
+	// --------------------------------------------------------
+	// Singleton Constructor - Set up the singleton instance of the SpatialIndex
+	// --------------------------------------------------------
+	SpatialIndex();
+	~SpatialIndex() { }
+
+	float cellSize;
+	float invCellSize;
+
+	//Entries by id, freed ids are reused
+	std::vector<Entry> entries;
+	std::vector<uint32_t> freeEntries;
+	size_t entryCount;
+
+	//Heads of each bucket's entry list
+	std::vector<uint32_t> buckets;
+	//Entries too big for a cell (their prev is their index here)
+	std::vector<uint32_t> largeEntries;
+
+	bool readingChanges;	//False until the first sync
+	size_t changeReader;
+
+	// --------------------------------------------------------
+	// Get the cell a coordinate is in (clamped to
+	// SPATIAL_MAX_CELL, so everything past it shares the
+	// edge cells)
+	// --------------------------------------------------------
+	int32_t CellCoord(float value);
+
+	// --------------------------------------------------------
+	// Get the bucket a cell is stored in
+	// --------------------------------------------------------
+	uint32_t HashCell(int32_t x, int32_t y, int32_t z);
+
+	// --------------------------------------------------------
+	// Link an entry into the bucket or large list for its bounds
+	// --------------------------------------------------------
+	void Link(uint32_t id);
+
+	// --------------------------------------------------------
+	// Unlink an entry from its bucket or the large list
+	// --------------------------------------------------------
+	void Unlink(uint32_t id);
+
+	// --------------------------------------------------------
+	// Add an object to the index
+	// --------------------------------------------------------
+	void Insert(GameObject* obj);
+
+	// --------------------------------------------------------
+	// Update the bounds of an object in the index
+	// --------------------------------------------------------
+	void Move(GameObject* obj);
+
+	// --------------------------------------------------------
+	// Run a function on every entry that may overlap a box
+	// (the function still has to test the entry's bounds)
+	// --------------------------------------------------------
+	template <typename Func>
+	void ForEachCandidate(DirectX::XMFLOAT3 min, DirectX::XMFLOAT3 max, Func func);
+
+	// --------------------------------------------------------
+	// Write an object to a query buffer if it has room
+	// --------------------------------------------------------
+	static void Output(GameObject* obj, GameObject** results, size_t maxResults, size_t* count)
+	{
+		if (*count < maxResults)
+			results[*count] = obj;
+		(*count)++;
+	}
+
+public:
+	// --------------------------------------------------------
+	// Get the singleton instance of the SpatialIndex
+	// --------------------------------------------------------
+	static SpatialIndex* GetInstance()
+	{
+		static SpatialIndex instance;
+		return &instance;
+	}
+
+	//Delete this
+	SpatialIndex(SpatialIndex const&) = delete;
+	void operator=(SpatialIndex const&) = delete;
+
+	// --------------------------------------------------------
+	// Clear the index (called when the EntityManager is released)
+	// --------------------------------------------------------
+	void Release();
+
+	// --------------------------------------------------------
+	// Set the size of a grid cell and re-insert every object.
+	// Cells should be a bit bigger than most objects
+	// --------------------------------------------------------
+	void SetCellSize(float size);
+
+	// --------------------------------------------------------
+	// Add enabled objects and move objects whose transform
+	// changed since the last sync (called once per frame).
+	// The first sync adds every enabled object
+	// --------------------------------------------------------
+	void Sync();
+
+	// --------------------------------------------------------
+	// FOR INTERNAL ENGINE USE ONLY
+	//
+	// Remove an object from the index (called when it is
+	// disabled or removed from the EntityManager)
+	// --------------------------------------------------------
+	void Remove(GameObject* obj);
+
+	// --------------------------------------------------------
+	// Find objects whose bounds overlap a sphere
+	//
+	// results - buffer to write the objects to
+	// maxResults - size of the buffer
+	// returns the amount of objects found, which can be more
+	//		than maxResults (only maxResults are written)
+	// --------------------------------------------------------
+	size_t QuerySphere(DirectX::XMFLOAT3 center, float radius,
+		GameObject** results, size_t maxResults);
+
+	// --------------------------------------------------------
+	// Find objects whose bounds overlap a box
+	// (see QuerySphere for the buffer and return value)
+	// --------------------------------------------------------
+	size_t QueryBox(DirectX::XMFLOAT3 min, DirectX::XMFLOAT3 max,
+		GameObject** results, size_t maxResults);
+
+	// --------------------------------------------------------
+	// Find objects whose bounds are at least partly in a frustum
+	// (see QuerySphere for the buffer and return value)
+	// --------------------------------------------------------
+	size_t QueryFrustum(const Frustum& frustum,
+		GameObject** results, size_t maxResults);
+
+	// --------------------------------------------------------
+	// Get the amount of objects in the index
+	// --------------------------------------------------------
+	size_t GetCount();
+
+	// --------------------------------------------------------
+	// Get the bounding sphere the index uses for an object
+	// --------------------------------------------------------
+	static void GetBounds(GameObject* obj, DirectX::XMFLOAT3* center, float* radius);
+};
\ No newline at end of file
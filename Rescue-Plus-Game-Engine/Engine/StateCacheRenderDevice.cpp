@@ -0,0 +1,283 @@
+#include "StateCacheRenderDevice.h"
+#include <cstdint>
+#include <cstring>
+
+// Stands for a slot the context could have anything bound to
+template <typename T>
+static inline T* UnknownState()
+{
+	return reinterpret_cast<T*>(~(uintptr_t)0);
+}
+
+// Create a state cache
+StateCacheRenderDevice::StateCacheRenderDevice(RenderDevice* target)
+{
+	this->target = target;
+	Invalidate();
+	ResetStats();
+}
+
+// Count a bind and remember it
+template <typename T>
+bool StateCacheRenderDevice::Bind(T* bound, T value)
+{
+	if (*bound == value)
+	{
+		stats.skipped++;
+		return false;
+	}
+
+	*bound = value;
+	stats.issued++;
+	return true;
+}
+
+// Bind a vertex buffer to slot 0
+void StateCacheRenderDevice::SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	if (vertexBuffer == buffer && vertexStride == stride && vertexOffset == offset)
+	{
+		stats.skipped++;
+		return;
+	}
+
+	vertexBuffer = buffer;
+	vertexStride = stride;
+	vertexOffset = offset;
+	stats.issued++;
+	target->SetVertexBuffer(buffer, stride, offset);
+}
+
+// Bind an index buffer
+void StateCacheRenderDevice::SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format)
+{
+	if (indexBuffer == buffer && indexFormat == format)
+	{
+		stats.skipped++;
+		return;
+	}
+
+	indexBuffer = buffer;
+	indexFormat = format;
+	stats.issued++;
+	target->SetIndexBuffer(buffer, format);
+}
+
+// Copy data into a whole buffer
+void StateCacheRenderDevice::UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	target->UpdateBuffer(buffer, data, size);
+}
+
+// Bind a per-instance vertex buffer to slot 1
+void StateCacheRenderDevice::SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset)
+{
+	if (instanceBuffer == buffer && instanceStride == stride && instanceOffset == offset)
+	{
+		stats.skipped++;
+		return;
+	}
+
+	instanceBuffer = buffer;
+	instanceStride = stride;
+	instanceOffset = offset;
+	stats.issued++;
+	target->SetInstanceBuffer(buffer, stride, offset);
+}
+
+// Overwrite the start of a dynamic buffer
+void StateCacheRenderDevice::WriteBuffer(RenderBuffer* buffer, const void* data, size_t size)
+{
+	target->WriteBuffer(buffer, data, size);
+}
+
+// Bind a shader to a stage
+void StateCacheRenderDevice::SetShader(ShaderStage stage, RenderShader* shader)
+{
+	if (Bind(&shaders[(size_t)stage], shader))
+		target->SetShader(stage, shader);
+}
+
+// Bind a constant buffer to a stage
+void StateCacheRenderDevice::SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer)
+{
+	if (slot >= STATE_CACHE_TRACKED_SLOTS)
+		stats.issued++;
+	else if (!Bind(&constantBuffers[(size_t)stage][slot], buffer))
+		return;
+	target->SetConstantBuffer(stage, slot, buffer);
+}
+
+// Bind shader resource views to a stage, sent whole if any slot changes
+void StateCacheRenderDevice::SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs)
+{
+	bool changed = startSlot + count > STATE_CACHE_TRACKED_SLOTS;
+	for (unsigned int i = 0; i < count && startSlot + i < STATE_CACHE_TRACKED_SLOTS; i++)
+	{
+		RenderShaderResource*& bound = shaderResources[(size_t)stage][startSlot + i];
+		if (bound != srvs[i])
+		{
+			bound = srvs[i];
+			changed = true;
+		}
+	}
+
+	if (!changed)
+	{
+		stats.skipped++;
+		return;
+	}
+	stats.issued++;
+	target->SetShaderResources(stage, startSlot, count, srvs);
+}
+
+// Bind a sampler to a stage
+void StateCacheRenderDevice::SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler)
+{
+	if (slot >= STATE_CACHE_TRACKED_SLOTS)
+		stats.issued++;
+	else if (!Bind(&samplers[(size_t)stage][slot], sampler))
+		return;
+	target->SetSampler(stage, slot, sampler);
+}
+
+// Set the input layout
+void StateCacheRenderDevice::SetInputLayout(RenderInputLayout* inputLayout)
+{
+	if (Bind(&this->inputLayout, inputLayout))
+		target->SetInputLayout(inputLayout);
+}
+
+// Set the primitive topology
+void StateCacheRenderDevice::SetPrimitiveTopology(RenderTopology topology)
+{
+	if (Bind(&this->topology, topology))
+		target->SetPrimitiveTopology(topology);
+}
+
+// Set the rasterizer state
+void StateCacheRenderDevice::SetRasterizerState(RenderRasterizerState* state)
+{
+	if (Bind(&rasterizerState, state))
+		target->SetRasterizerState(state);
+}
+
+// Set the depth stencil state
+void StateCacheRenderDevice::SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef)
+{
+	if (depthStencilState == state && this->stencilRef == stencilRef)
+	{
+		stats.skipped++;
+		return;
+	}
+
+	depthStencilState = state;
+	this->stencilRef = stencilRef;
+	stats.issued++;
+	target->SetDepthStencilState(state, stencilRef);
+}
+
+// Set the blend state
+void StateCacheRenderDevice::SetBlendState(RenderBlendState* state)
+{
+	if (Bind(&blendState, state))
+		target->SetBlendState(state);
+}
+
+// Bind a render target and depth buffer
+void StateCacheRenderDevice::SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil)
+{
+	if (renderTarget == target && this->depthStencil == depthStencil)
+	{
+		stats.skipped++;
+		return;
+	}
+
+	renderTarget = target;
+	this->depthStencil = depthStencil;
+	stats.issued++;
+	this->target->SetRenderTarget(target, depthStencil);
+}
+
+// Set the viewport
+void StateCacheRenderDevice::SetViewport(const RenderViewport& viewport)
+{
+	if (viewportKnown && memcmp(&this->viewport, &viewport, sizeof(RenderViewport)) == 0)
+	{
+		stats.skipped++;
+		return;
+	}
+
+	this->viewport = viewport;
+	viewportKnown = true;
+	stats.issued++;
+	target->SetViewport(viewport);
+}
+
+// Clear a render target to a color
+void StateCacheRenderDevice::ClearRenderTarget(RenderTargetView* target, const float color[4])
+{
+	this->target->ClearRenderTarget(target, color);
+}
+
+// Clear a depth buffer
+void StateCacheRenderDevice::ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil)
+{
+	target->ClearDepthStencil(depthStencil, clear, depth, stencil);
+}
+
+// Draw indexed triangles with the bound buffers
+void StateCacheRenderDevice::DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex)
+{
+	target->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+// Draw instances of indexed triangles with the bound buffers
+void StateCacheRenderDevice::DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance)
+{
+	target->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+// Get the target's backend
+RenderDevice* StateCacheRenderDevice::GetBackend()
+{
+	return target->GetBackend();
+}
+
+// Forget what is bound
+void StateCacheRenderDevice::Invalidate()
+{
+	for (size_t s = 0; s < (size_t)ShaderStage::Count; s++)
+	{
+		shaders[s] = UnknownState<RenderShader>();
+		for (size_t i = 0; i < STATE_CACHE_TRACKED_SLOTS; i++)
+		{
+			constantBuffers[s][i] = UnknownState<RenderBuffer>();
+			shaderResources[s][i] = UnknownState<RenderShaderResource>();
+			samplers[s][i] = UnknownState<RenderSampler>();
+		}
+	}
+	vertexBuffer = UnknownState<RenderBuffer>();
+	instanceBuffer = UnknownState<RenderBuffer>();
+	indexBuffer = UnknownState<RenderBuffer>();
+	inputLayout = UnknownState<RenderInputLayout>();
+	topology = (RenderTopology)-1;
+	rasterizerState = UnknownState<RenderRasterizerState>();
+	depthStencilState = UnknownState<RenderDepthStencilState>();
+	blendState = UnknownState<RenderBlendState>();
+	renderTarget = UnknownState<RenderTargetView>();
+	depthStencil = UnknownState<RenderDepthStencilView>();
+	viewportKnown = false;
+}
+
+// Get the counters since the last reset
+StateCacheStats StateCacheRenderDevice::GetStats()
+{
+	return stats;
+}
+
+// Clear the counters
+void StateCacheRenderDevice::ResetStats()
+{
+	stats = StateCacheStats{ 0, 0 };
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include "RenderDevice.h"
+
+//Resource slots per stage the state cache filters, binds to
+// higher slots are always sent
+#define STATE_CACHE_TRACKED_SLOTS 16
+
+// --------------------------------------------------------
+// Counters for binds sent through a state cache
+// --------------------------------------------------------
+struct StateCacheStats
+{
+	size_t issued;		//Binds sent on to the device
+	size_t skipped;		//Binds of what was already bound, dropped
+};
+
+// --------------------------------------------------------
+// Drops binds of what is already bound before they reach
+// another device.
+//
+// What is bound is tracked per stage and slot. Buffer
+// updates, clears and draws always go through. Anything
+// that binds to the backend directly (DirectXTK,
+// resizing the swap chain) must call Invalidate() after, so
+// the next bind of every slot is sent again
+// --------------------------------------------------------
+class StateCacheRenderDevice : public RenderDevice
+{
+private:
+	RenderDevice* target;
+	StateCacheStats stats;
+
+	//What the target has bound right now
+	RenderShader* shaders[(size_t)ShaderStage::Count];
+	RenderBuffer* constantBuffers[(size_t)ShaderStage::Count][STATE_CACHE_TRACKED_SLOTS];
+	RenderShaderResource* shaderResources[(size_t)ShaderStage::Count][STATE_CACHE_TRACKED_SLOTS];
+	RenderSampler* samplers[(size_t)ShaderStage::Count][STATE_CACHE_TRACKED_SLOTS];
+	RenderBuffer* vertexBuffer;
+	unsigned int vertexStride;
+	unsigned int vertexOffset;
+	RenderBuffer* instanceBuffer;
+	unsigned int instanceStride;
+	unsigned int instanceOffset;
+	RenderBuffer* indexBuffer;
+	RenderIndexFormat indexFormat;
+	RenderInputLayout* inputLayout;
+	RenderTopology topology;
+	RenderRasterizerState* rasterizerState;
+	RenderDepthStencilState* depthStencilState;
+	unsigned int stencilRef;
+	RenderBlendState* blendState;
+	RenderTargetView* renderTarget;
+	RenderDepthStencilView* depthStencil;
+	RenderViewport viewport;
+	bool viewportKnown;
+
+	// --------------------------------------------------------
+	// Count a bind and remember it, returns true if it has to
+	// be sent
+	// --------------------------------------------------------
+	template <typename T>
+	bool Bind(T* bound, T value);
+
+public:
+	// --------------------------------------------------------
+	// Create a state cache
+	//
+	// target - device the binds that change state are sent to
+	// --------------------------------------------------------
+	StateCacheRenderDevice(RenderDevice* target);
+
+	void SetVertexBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void SetIndexBuffer(RenderBuffer* buffer, RenderIndexFormat format);
+	void UpdateBuffer(RenderBuffer* buffer, const void* data, size_t size);
+	void SetInstanceBuffer(RenderBuffer* buffer, unsigned int stride, unsigned int offset);
+	void WriteBuffer(RenderBuffer* buffer, const void* data, size_t size);
+
+	void SetShader(ShaderStage stage, RenderShader* shader);
+	void SetConstantBuffer(ShaderStage stage, unsigned int slot, RenderBuffer* buffer);
+	void SetShaderResources(ShaderStage stage, unsigned int startSlot, unsigned int count, RenderShaderResource* const* srvs);
+	void SetSampler(ShaderStage stage, unsigned int slot, RenderSampler* sampler);
+
+	void SetInputLayout(RenderInputLayout* inputLayout);
+	void SetPrimitiveTopology(RenderTopology topology);
+	void SetRasterizerState(RenderRasterizerState* state);
+	void SetDepthStencilState(RenderDepthStencilState* state, unsigned int stencilRef);
+	void SetBlendState(RenderBlendState* state);
+
+	void SetRenderTarget(RenderTargetView* target, RenderDepthStencilView* depthStencil);
+	void SetViewport(const RenderViewport& viewport);
+	void ClearRenderTarget(RenderTargetView* target, const float color[4]);
+	void ClearDepthStencil(RenderDepthStencilView* depthStencil, DepthClear clear, float depth, uint8_t stencil);
+
+	void DrawIndexed(unsigned int indexCount, unsigned int startIndex, int baseVertex);
+	void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex, int baseVertex, unsigned int startInstance);
+
+	// --------------------------------------------------------
+	// Get the target's backend
+	// --------------------------------------------------------
+	RenderDevice* GetBackend();
+
+	// --------------------------------------------------------
+	// Forget what is bound, the next bind of everything is
+	// sent (after something bound to the backend directly)
+	// --------------------------------------------------------
+	void Invalidate();
+
+	// --------------------------------------------------------
+	// Get the counters since the last reset
+	// --------------------------------------------------------
+	StateCacheStats GetStats();
+
+	// --------------------------------------------------------
+	// Clear the counters
+	// --------------------------------------------------------
+	void ResetStats();
+};
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "StaticBatches.h"
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <cmath>
+#include "EntityManager.h"
+#include "MeshRenderer.h"
+#include "Renderer.h"
+
+// For the DirectX Math library
+using namespace DirectX;
+
+//Material, render layer and cell a group of static renderers share
+typedef std::tuple<Material*, unsigned int, int32_t, int32_t> StaticBatchKey;
+
+//A source mesh read back from the GPU
+struct StaticBatchGeometry
+{
+	std::vector<Vertex> vertices;
+	std::vector<unsigned> indices;
+	bool read;
+};
+
+// Add a renderer's mesh to merged geometry in world space
+static void AppendGeometry(const StaticBatchGeometry& geometry, GameObject* obj,
+	std::vector<Vertex>* vertices, std::vector<unsigned>* indices)
+{
+	XMFLOAT4X4 worldRaw = obj->GetRawWorldMatrix();
+	XMMATRIX world = XMLoadFloat4x4(&worldRaw);
+	XMMATRIX normalMatrix = XMMatrixTranspose(XMMatrixInverse(nullptr, world));
+
+	unsigned base = (unsigned)vertices->size();
+	for (const Vertex& v : geometry.vertices)
+	{
+		Vertex w = v;
+		XMStoreFloat3(&w.Position, XMVector3TransformCoord(XMLoadFloat3(&v.Position), world));
+		XMStoreFloat3(&w.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&v.Normal), normalMatrix)));
+		XMStoreFloat3(&w.Tangent, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&v.Tangent), world)));
+		vertices->push_back(w);
+	}
+
+	//Mirrored transforms flip the winding order back
+	bool mirrored = XMVectorGetX(XMMatrixDeterminant(world)) < 0;
+	for (size_t i = 0; i + 2 < geometry.indices.size(); i += 3)
+	{
+		indices->push_back(base + geometry.indices[i]);
+		indices->push_back(base + geometry.indices[mirrored ? i + 2 : i + 1]);
+		indices->push_back(base + geometry.indices[mirrored ? i + 1 : i + 2]);
+	}
+}
+
+// Merge every static MeshRenderer in the scene
+StaticBatches::StaticBatches(ID3D11Device* device, ID3D11DeviceContext* context, float cellSize)
+{
+	stats = StaticBatchStats{ 0, 0, 0, 0 };
+	enabled = true;
+
+	//Group the static renderers
+	std::map<StaticBatchKey, std::vector<MeshRenderer*>> groups;
+	EntityManager::GetInstance()->ForEachActive([&](GameObject* obj) {
+		MeshRenderer* mr = obj->GetComponent<MeshRenderer>();
+		if (mr == nullptr || !mr->GetStatic() || mr->GetBatched())
+			return;
+
+		XMFLOAT4X4 worldRaw = obj->GetRawWorldMatrix();
+		XMFLOAT3 localCenter = mr->GetMesh()->GetBoundsCenter();
+		XMFLOAT3 center;
+		XMStoreFloat3(&center, XMVector3TransformCoord(XMLoadFloat3(&localCenter), XMLoadFloat4x4(&worldRaw)));
+
+		StaticBatchKey key(mr->GetMaterial(), mr->GetRenderLayer(),
+			(int32_t)floorf(center.x / cellSize), (int32_t)floorf(center.z / cellSize));
+		groups[key].push_back(mr);
+	});
+
+	//Merge each group of two or more
+	std::unordered_map<Mesh*, StaticBatchGeometry> geometry;
+	std::vector<Vertex> vertices;
+	std::vector<unsigned> indices;
+	for (auto& group : groups)
+	{
+		if (group.second.size() < 2)
+			continue;
+
+		vertices.clear();
+		indices.clear();
+		Batch batch;
+		for (MeshRenderer* mr : group.second)
+		{
+			//Read each source mesh once
+			auto geoIt = geometry.find(mr->GetMesh());
+			if (geoIt == geometry.end())
+			{
+				geoIt = geometry.emplace(mr->GetMesh(), StaticBatchGeometry()).first;
+				geoIt->second.read = mr->GetMesh()->ReadGeometry(device, context,
+					&geoIt->second.vertices, &geoIt->second.indices);
+				if (!geoIt->second.read)
+					printf("Could not read a mesh back for static batching\n");
+			}
+			if (!geoIt->second.read)
+				continue;
+
+			AppendGeometry(geoIt->second, mr->gameObject(), &vertices, &indices);
+			batch.sources.push_back(mr->gameObject()->GetHandle());
+		}
+		if (batch.sources.size() < 2)
+			continue;
+
+		//Draw the merged mesh from an object at the origin
+		batch.mesh = new Mesh(vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size(), device);
+		batch.object = new GameObject("StaticBatch");
+		batch.object->AddComponent<MeshRenderer>(batch.mesh, std::get<0>(group.first))
+			->SetRenderLayer(std::get<1>(group.first));
+		batches.push_back(batch);
+
+		stats.batches++;
+		stats.batchedRenderers += batch.sources.size();
+		stats.vertices += vertices.size();
+		stats.indices += indices.size();
+	}
+
+	SetSourcesBatched(true);
+}
+
+// Remove the batches and draw the renderers on their own
+StaticBatches::~StaticBatches()
+{
+	SetSourcesBatched(false);
+
+	//Destroy the renderer before its mesh, the object goes with the next removals
+	EntityManager* entityManager = EntityManager::GetInstance();
+	for (Batch& batch : batches)
+	{
+		batch.object->RemoveComponent<MeshRenderer>();
+		entityManager->RemoveEntity(batch.object);
+		delete batch.mesh;
+	}
+}
+
+// Take the source renderers of every batch out of the renderer, or put them back
+void StaticBatches::SetSourcesBatched(bool batched)
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+	Renderer* renderer = Renderer::GetInstance();
+	for (Batch& batch : batches)
+	{
+		for (EntityHandle handle : batch.sources)
+		{
+			//Sources can be removed while batched
+			GameObject* obj = entityManager->GetEntity(handle);
+			if (obj == nullptr)
+				continue;
+
+			MeshRenderer* mr = obj->GetComponent<MeshRenderer>();
+			if (mr != nullptr)
+				renderer->SetMeshRendererBatched(mr, batched);
+		}
+	}
+}
+
+// Draw the batches or the renderers on their own
+void StaticBatches::SetEnabled(bool enabled)
+{
+	if (this->enabled == enabled)
+		return;
+
+	this->enabled = enabled;
+	for (Batch& batch : batches)
+		batch.object->SetEnabled(enabled);
+	SetSourcesBatched(enabled);
+}
+
+// Check if the batches are drawn
+bool StaticBatches::GetEnabled()
+{
+	return enabled;
+}
+
+// Get the counters for the batches
+StaticBatchStats StaticBatches::GetStats()
+{
+	return stats;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+#include <d3d11.h>
+#include <vector>
+#include "EntityHandle.h"
+
+class Mesh;
+class Material;
+class GameObject;
+
+//Default size of a static batch cell in world units
+#define STATIC_BATCH_DEFAULT_CELL_SIZE 64.0f
+
+// --------------------------------------------------------
+// Counters for static batching
+// --------------------------------------------------------
+struct StaticBatchStats
+{
+	size_t batches;			//Merged meshes drawn instead
+	size_t batchedRenderers;	//Static renderers merged into them
+	size_t vertices;		//Vertices in every merged mesh
+	size_t indices;
+};
+
+// --------------------------------------------------------
+// Merges static MeshRenderers into a few big meshes.
+//
+// Every enabled MeshRenderer marked static is grouped by
+// material, render layer and the square cell on the XZ plane
+// its bounds are centered in. Each group of two or more is
+// pre-transformed to world space and merged into one mesh,
+// drawn by a "StaticBatch" GameObject with an identity
+// transform, so the group is one draw with no per object
+// data and cells are still culled on their own.
+//
+// The merged renderers are taken out of the renderer but
+// keep working otherwise (colliders and so on). Static
+// renderers must not move while batched. Deleting the
+// batches, or disabling them, puts the renderers back
+// --------------------------------------------------------
+class StaticBatches
+{
+private:
+	struct Batch
+	{
+		GameObject* object;
+		Mesh* mesh;
+		std::vector<EntityHandle> sources;	//Objects with a merged renderer
+	};
+
+	std::vector<Batch> batches;
+	StaticBatchStats stats;
+	bool enabled;
+
+	// --------------------------------------------------------
+	// Take the source renderers of every batch out of the
+	// renderer, or put them back
+	// --------------------------------------------------------
+	void SetSourcesBatched(bool batched);
+
+public:
+	// --------------------------------------------------------
+	// Merge every static MeshRenderer in the scene
+	//
+	// device - creates the merged buffers
+	// context - reads back the source meshes
+	// cellSize - size of the cells batches are split into
+	// --------------------------------------------------------
+	StaticBatches(ID3D11Device* device, ID3D11DeviceContext* context,
+		float cellSize = STATIC_BATCH_DEFAULT_CELL_SIZE);
+
+	// --------------------------------------------------------
+	// Remove the batches and draw the renderers on their own
+	// --------------------------------------------------------
+	~StaticBatches();
+
+	// --------------------------------------------------------
+	// Draw the batches (true) or the renderers on their own
+	// --------------------------------------------------------
+	void SetEnabled(bool enabled);
+
+	// --------------------------------------------------------
+	// Check if the batches are drawn
+	// --------------------------------------------------------
+	bool GetEnabled();
+
+	// --------------------------------------------------------
+	// Get the counters for the batches
+	// --------------------------------------------------------
+	StaticBatchStats GetStats();
+};
\ No newline at end of file
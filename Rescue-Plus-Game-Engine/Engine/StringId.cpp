@@ -0,0 +1,55 @@
+#include "StringId.h"
+#include <unordered_map>
+#include <mutex>
+#include <cstdio>
+
+// --------------------------------------------------------
+// Every interned string by id. Strings are never removed so
+// references from GetString() stay valid
+// --------------------------------------------------------
+template<typename T>
+struct StringTable
+{
+	std::mutex lock;
+	std::unordered_map<T, std::string> strings;
+
+	static StringTable& GetInstance()
+	{
+		static StringTable instance;
+		return instance;
+	}
+};
+
+// Hash a string and add it to the global string table
+template<typename T>
+BasicStringId<T> BasicStringId<T>::Intern(const std::string& str)
+{
+	BasicStringId<T> stringId(str);
+
+	StringTable<T>& table = StringTable<T>::GetInstance();
+	std::lock_guard<std::mutex> guard(table.lock);
+	auto it = table.strings.find(stringId.id);
+	if (it == table.strings.end())
+		table.strings.emplace(stringId.id, str);
+	else if (it->second != str)
+		printf("String id collision between \"%s\" and \"%s\"\n", it->second.c_str(), str.c_str());
+
+	return stringId;
+}
+
+// Get the string this id was interned from
+template<typename T>
+const std::string& BasicStringId<T>::GetString() const
+{
+	static const std::string empty;
+
+	StringTable<T>& table = StringTable<T>::GetInstance();
+	std::lock_guard<std::mutex> guard(table.lock);
+	auto it = table.strings.find(id);
+	if (it == table.strings.end())
+		return empty;
+	return it->second;
+}
+
+template struct BasicStringId<uint32_t>;
+template struct BasicStringId<uint64_t>;
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <functional>
+#include <type_traits>
+
+// --------------------------------------------------------
+// Hash a string with FNV-1a. Runs at compile time when the
+// string is a literal (see SID())
+// --------------------------------------------------------
+template<typename T>
+constexpr T HashString(const char* str, size_t length)
+{
+	static_assert(std::is_same<T, uint32_t>::value || std::is_same<T, uint64_t>::value,
+		"Strings can only be hashed to 32 or 64 bits");
+
+	T hash = sizeof(T) == 4 ? T(2166136261u) : T(14695981039346656037ull);
+	const T prime = sizeof(T) == 4 ? T(16777619u) : T(1099511628211ull);
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= T(uint8_t(str[i]));
+		hash *= prime;
+	}
+	return hash;
+}
+
+// --------------------------------------------------------
+// A string stored as its hash, so comparing and hashing
+// it costs the same as an integer.
+//
+// Strings used as keys should be interned with Intern() so the
+// original string can be found again with GetString() and two
+// strings with the same hash are caught. Ids for literals are
+// made at compile time with SID() / SID64()
+// --------------------------------------------------------
+template<typename T>
+struct BasicStringId
+{
+	T id;
+
+	constexpr BasicStringId() : id(0) { }
+	constexpr explicit BasicStringId(T id) : id(id) { }
+
+	// --------------------------------------------------------
+	// Hash a string without interning it
+	// --------------------------------------------------------
+	explicit BasicStringId(const std::string& str) : id(HashString<T>(str.c_str(), str.size())) { }
+	explicit BasicStringId(const char* str) : id(HashString<T>(str, strlen(str))) { }
+
+	// --------------------------------------------------------
+	// Hash a string and add it to the global string table
+	// (safe to call from any thread)
+	// --------------------------------------------------------
+	static BasicStringId Intern(const std::string& str);
+
+	// --------------------------------------------------------
+	// Get the string this id was interned from
+	// (an empty string if it was never interned)
+	// --------------------------------------------------------
+	const std::string& GetString() const;
+
+	constexpr bool IsValid() const { return id != 0; }
+	constexpr bool operator==(const BasicStringId& other) const { return id == other.id; }
+	constexpr bool operator!=(const BasicStringId& other) const { return id != other.id; }
+};
+
+//32 bit ids for runtime keys, 64 bit ids for keys that are saved
+typedef BasicStringId<uint32_t> StringId;
+typedef BasicStringId<uint64_t> StringId64;
+
+//Make an id from a string literal at compile time
+#define SID(str) StringId(std::integral_constant<uint32_t, HashString<uint32_t>(str, sizeof(str) - 1)>::value)
+#define SID64(str) StringId64(std::integral_constant<uint64_t, HashString<uint64_t>(str, sizeof(str) - 1)>::value)
+
+namespace std
+{
+	//The id is already a hash
+	template<typename T>
+	struct hash<BasicStringId<T>>
+	{
+		size_t operator()(const BasicStringId<T>& stringId) const
+		{
+			return size_t(stringId.id);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "UpdateLod.h"
+#include "GameObject.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace DirectX;
+using namespace std;
+
+// Set where the viewer is and what it can see
+void UpdateLodViewer::SetViewer(XMFLOAT3 position, const Frustum& frustum)
+{
+	this->position = position;
+	this->frustum = frustum;
+	hasViewer = true;
+}
+
+// Remove the viewer so everything updates every frame
+void UpdateLodViewer::ClearViewer()
+{
+	hasViewer = false;
+}
+
+// Get the level a gameobject should update at
+uint32_t UpdateLodViewer::GetLevel(const UpdateLod& lod, GameObject* obj)
+{
+	if (!hasViewer)
+		return 0;
+
+	XMFLOAT3 center;
+	float radius;
+	SpatialIndex::GetBounds(obj, &center, &radius);
+
+	//Slow down from near to far
+	float dx = center.x - position.x;
+	float dy = center.y - position.y;
+	float dz = center.z - position.z;
+	float distance = sqrtf(dx * dx + dy * dy + dz * dz) - radius;
+	uint32_t interval = 1;
+	if (distance > lod.nearDistance)
+	{
+		float t = 1.0f;
+		if (distance < lod.farDistance)
+			t = (distance - lod.nearDistance) / (lod.farDistance - lod.nearDistance);
+		interval = 1 + (uint32_t)(t * (max(lod.farInterval, 1u) - 1));
+	}
+
+	if (!frustum.Intersects(center, radius))
+		interval = max(interval, lod.offscreenInterval);
+
+	//Round down to a power of two
+	uint32_t level = 0;
+	while (level + 1 < UPDATE_LOD_LEVELS && (2u << level) <= interval)
+	{
+		level++;
+	}
+	return level;
+}
\ No newline at end of file
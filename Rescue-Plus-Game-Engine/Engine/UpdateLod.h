@@ -0,0 +1,81 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <type_traits>
+#include "SpatialIndex.h"
+
+//Scheduled components update every 1, 2, 4, 8 or 16 frames
+#define UPDATE_LOD_LEVELS 5
+
+// --------------------------------------------------------
+// How often a component type updates based on how far it is
+// from the viewer.
+//
+// Declare one on a component to have its pool schedule Update:
+//		static constexpr UpdateLod UpdateRate = { 20.0f, 80.0f, 8, 16 };
+// --------------------------------------------------------
+struct UpdateLod
+{
+	float nearDistance;			//Closer than this updates every frame
+	float farDistance;			//Further than this updates every farInterval frames
+	uint32_t farInterval;		//Frames between updates when far away
+	uint32_t offscreenInterval;	//Frames between updates outside the view
+};
+
+// --------------------------------------------------------
+// Check if a component type declares an UpdateRate
+// --------------------------------------------------------
+template <typename T, typename = void>
+struct HasUpdateLod : std::false_type { };
+
+template <typename T>
+struct HasUpdateLod<T, std::void_t<decltype(T::UpdateRate)>> : std::true_type { };
+
+// --------------------------------------------------------
+// The point of view that update rates are picked from.
+//
+// With no viewer set every component updates every frame
+// --------------------------------------------------------
+class UpdateLodViewer
+{
+private:
+	// --------------------------------------------------------
+	// Singleton Constructor - Set up the singleton instance of the UpdateLodViewer
+	// --------------------------------------------------------
+	UpdateLodViewer() { hasViewer = false; }
+	~UpdateLodViewer() { }
+
+	bool hasViewer;
+	DirectX::XMFLOAT3 position;
+	Frustum frustum;
+
+public:
+	// --------------------------------------------------------
+	// Get the singleton instance of the UpdateLodViewer
+	// --------------------------------------------------------
+	static UpdateLodViewer* GetInstance()
+	{
+		static UpdateLodViewer instance;
+		return &instance;
+	}
+
+	//Delete this
+	UpdateLodViewer(UpdateLodViewer const&) = delete;
+	void operator=(UpdateLodViewer const&) = delete;
+
+	// --------------------------------------------------------
+	// Set where the viewer is and what it can see (once per frame)
+	// --------------------------------------------------------
+	void SetViewer(DirectX::XMFLOAT3 position, const Frustum& frustum);
+
+	// --------------------------------------------------------
+	// Remove the viewer so everything updates every frame
+	// --------------------------------------------------------
+	void ClearViewer();
+
+	// --------------------------------------------------------
+	// Get the level a gameobject should update at
+	// (its interval is 1 << level frames)
+	// --------------------------------------------------------
+	uint32_t GetLevel(const UpdateLod& lod, GameObject* obj);
+};
\ No newline at end of file
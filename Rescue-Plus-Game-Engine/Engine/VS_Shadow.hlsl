@@ -5,12 +5,6 @@ cbuffer once : register(b0)
 	matrix projection;
 };
 
-// Constant Buffer for external (C++) data
-cbuffer perObject : register(b1)
-{
-	matrix world;
-};
-
 // Struct representing a single vertex worth of data
 struct VertexShaderInput
 {
@@ -18,6 +12,13 @@ struct VertexShaderInput
 	float2 uv			: TEXCOORD;
 	float3 normal		: NORMAL;
 	float3 tangent		: TANGENT;
+
+	// Per instance world matrix from the renderer's instance
+	// buffer (each float4 is a column)
+	float4 world0		: WORLD_PER_INSTANCE0;
+	float4 world1		: WORLD_PER_INSTANCE1;
+	float4 world2		: WORLD_PER_INSTANCE2;
+	float4 world3		: WORLD_PER_INSTANCE3;
 };
 
 // Out of the vertex shader (and eventually input to the PS)
@@ -35,6 +36,7 @@ VertexToPixel main(VertexShaderInput input)
 	VertexToPixel output;
 
 	// Calculate output position
+	matrix world = transpose(matrix(input.world0, input.world1, input.world2, input.world3));
 	matrix worldViewProj = mul(mul(world, view), projection);
 	output.position = mul(float4(input.position, 1.0f), worldViewProj);
 
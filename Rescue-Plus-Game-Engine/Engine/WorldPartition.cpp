@@ -0,0 +1,486 @@
+#include "WorldPartition.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include "GameObject.h"
+#include "EntityManager.h"
+#include "ResourceManager.h"
+
+using namespace DirectX;
+using namespace std;
+
+// Create a world and start its loading thread
+WorldPartition::WorldPartition(ID3D11Device* device, float cellSize)
+{
+	this->device = device;
+	this->cellSize = cellSize;
+	loadRadius = WORLD_DEFAULT_LOAD_RADIUS;
+	unloadRadius = WORLD_DEFAULT_UNLOAD_RADIUS;
+	maxResidentCells = WORLD_DEFAULT_MAX_RESIDENT_CELLS;
+	frameBudget = WORLD_DEFAULT_FRAME_BUDGET;
+	residentCells = 0;
+
+	stats = { };
+	totalStreamMilliseconds = 0;
+
+	loadThreadRunning = true;
+	loadThread = thread(&WorldPartition::LoadThread, this);
+}
+
+// Stop the loading thread, remove every streamed object and release meshes
+WorldPartition::~WorldPartition()
+{
+	{
+		lock_guard<mutex> lock(queueLock);
+		loadThreadRunning = false;
+	}
+	queueCondition.notify_all();
+	loadThread.join();
+
+	EntityManager* entityManager = EntityManager::GetInstance();
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		for (size_t o = 0; o < cells[i]->objects.size(); o++)
+		{
+			if (entityManager->IsValid(cells[i]->objects[o]))
+				entityManager->RemoveEntity(cells[i]->objects[o]);
+		}
+		QueueMeshReleases(cells[i]);
+		delete cells[i];
+	}
+	cells.clear();
+	cellMap.clear();
+
+	//The objects are disabled, so nothing draws these meshes anymore
+	for (size_t i = 0; i < meshReleases.size(); i++)
+		ReleaseMesh(meshReleases[i]);
+	meshReleases.clear();
+}
+
+// Read cells from the load queue until the world is destroyed
+void WorldPartition::LoadThread()
+{
+	while (true)
+	{
+		Cell* cell;
+		{
+			unique_lock<mutex> lock(queueLock);
+			queueCondition.wait(lock, [this] { return !loadThreadRunning || !loadQueue.empty(); });
+			if (!loadThreadRunning)
+				return;
+
+			cell = loadQueue.front();
+			loadQueue.pop_front();
+		}
+
+		cell->loaded = cell->reader.Open(cell->path);
+
+		//Load meshes here so the main thread only has to look them up
+		if (cell->loaded)
+		{
+			vector<string> addresses = cell->reader.GetMeshAddresses();
+			for (size_t i = 0; i < addresses.size(); i++)
+				AcquireMesh(cell, addresses[i]);
+		}
+
+		lock_guard<mutex> lock(queueLock);
+		finishedLoads.push_back(cell);
+	}
+}
+
+// Get the cell a coordinate is in
+int32_t WorldPartition::CellCoord(float value)
+{
+	return (int32_t)floorf(value / cellSize);
+}
+
+// Get the key of a cell in the cell map
+uint64_t WorldPartition::CellKey(int32_t x, int32_t z)
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z;
+}
+
+// Add a cell stored in a scene file
+void WorldPartition::AddCell(int32_t x, int32_t z, const string& path)
+{
+	uint64_t key = CellKey(x, z);
+	if (cellMap.find(key) != cellMap.end())
+	{
+		printf("World cell (%d, %d) already exists\n", x, z);
+		return;
+	}
+
+	Cell* cell = new Cell();
+	cell->x = x;
+	cell->z = z;
+	cell->path = path;
+	cell->state = WorldCellState::Unloaded;
+	cell->distance = 0;
+	cell->loaded = false;
+	cell->cancel = false;
+	cell->nextUnload = 0;
+
+	cells.push_back(cell);
+	cellMap[key] = cell;
+}
+
+// Add every cell file (cell_X_Z.rscn) in a directory
+size_t WorldPartition::AddCellsFromDirectory(const string& directory)
+{
+	error_code error;
+	if (!filesystem::is_directory(directory, error))
+		return 0;
+
+	size_t added = 0;
+	for (auto& entry : filesystem::directory_iterator(directory, error))
+	{
+		int x, z;
+		string name = entry.path().stem().string();
+		if (entry.path().extension() == ".rscn" && sscanf(name.c_str(), "cell_%d_%d", &x, &z) == 2)
+		{
+			AddCell(x, z, entry.path().string());
+			added++;
+		}
+	}
+	return added;
+}
+
+// Save GameObjects into one scene file per cell and add those cells
+bool WorldPartition::BakeCells(const string& directory, const vector<GameObject*>& roots)
+{
+	error_code error;
+	filesystem::create_directories(directory, error);
+
+	//Group the objects by cell
+	unordered_map<uint64_t, vector<GameObject*>> groups;
+	for (size_t i = 0; i < roots.size(); i++)
+	{
+		XMFLOAT3 pos = roots[i]->GetPosition();
+		groups[CellKey(CellCoord(pos.x), CellCoord(pos.z))].push_back(roots[i]);
+	}
+
+	for (auto iter = groups.begin(); iter != groups.end(); iter++)
+	{
+		int32_t x = (int32_t)(iter->first >> 32);
+		int32_t z = (int32_t)(uint32_t)iter->first;
+		string path = (filesystem::path(directory) /
+			("cell_" + to_string(x) + "_" + to_string(z) + ".rscn")).string();
+
+		if (!SceneFile::Save(path, iter->second))
+			return false;
+		if (cellMap.find(iter->first) == cellMap.end())
+			AddCell(x, z, path);
+	}
+	return true;
+}
+
+// Set how far away cells are loaded and unloaded
+void WorldPartition::SetStreamingRadius(float loadRadius, float unloadRadius)
+{
+	this->loadRadius = loadRadius;
+	this->unloadRadius = max(loadRadius, unloadRadius);
+}
+
+// Set the most cells that can be loaded at once
+void WorldPartition::SetMaxResidentCells(size_t count)
+{
+	maxResidentCells = count;
+}
+
+// Set the time a frame can spend creating and removing objects
+void WorldPartition::SetFrameBudget(float milliseconds)
+{
+	frameBudget = milliseconds;
+}
+
+// Check if a frame has used up its time budget
+bool WorldPartition::OverBudget(Clock::time_point frameStart)
+{
+	return chrono::duration<float, milli>(Clock::now() - frameStart).count() >= frameBudget;
+}
+
+// Count a mesh as used by a cell, loading it if needed
+void WorldPartition::AcquireMesh(Cell* cell, const string& address)
+{
+	ResourceManager* resourceManager = ResourceManager::GetInstance();
+	StringId id = StringId(address);
+	cell->meshes.push_back(id);
+
+	//Counting the mesh first keeps the main thread from releasing it
+	// between the check and the load
+	bool load;
+	{
+		lock_guard<mutex> lock(meshLock);
+		StreamedMesh& mesh = meshUses[id];
+		mesh.cells++;
+		load = mesh.cells == 1 && !resourceManager->HasMesh(address);
+	}
+
+	if (load && device != nullptr && resourceManager->LoadMesh(address.c_str(), device))
+	{
+		lock_guard<mutex> lock(meshLock);
+		meshUses[id].owned = true;
+	}
+}
+
+// Stop counting a mesh for a cell
+void WorldPartition::ReleaseMesh(StringId mesh)
+{
+	//Unload while locked so the loading thread can't see the
+	// mesh as loaded and count on it
+	lock_guard<mutex> lock(meshLock);
+	auto iter = meshUses.find(mesh);
+	if (iter == meshUses.end() || --iter->second.cells > 0)
+		return;
+
+	if (iter->second.owned)
+		ResourceManager::GetInstance()->UnloadMesh(mesh);
+	meshUses.erase(iter);
+}
+
+// Queue the meshes of a cell that was unloaded for release
+void WorldPartition::QueueMeshReleases(Cell* cell)
+{
+	meshReleases.insert(meshReleases.end(), cell->meshes.begin(), cell->meshes.end());
+	cell->meshes.clear();
+}
+
+// Remove some of a cell's objects
+size_t WorldPartition::UnloadChunk(Cell* cell)
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+	size_t end = min(cell->nextUnload + WORLD_BUDGET_CHUNK, cell->objects.size());
+	size_t count = end - cell->nextUnload;
+	for (; cell->nextUnload < end; cell->nextUnload++)
+	{
+		EntityHandle handle = cell->objects[cell->nextUnload];
+		if (entityManager->IsValid(handle))
+			entityManager->RemoveEntity(handle);
+	}
+
+	if (cell->nextUnload >= cell->objects.size())
+	{
+		cell->objects.clear();
+		cell->nextUnload = 0;
+		cell->state = WorldCellState::Unloaded;
+		residentCells--;
+		QueueMeshReleases(cell);
+	}
+	return count;
+}
+
+// Create some of a cell's objects
+size_t WorldPartition::ActivateChunk(Cell* cell)
+{
+	//Grow storage for the whole cell on its first chunk
+	if (cell->state == WorldCellState::Loaded)
+	{
+		cell->reader.Reserve();
+		cell->objects.reserve(cell->reader.GetObjectCount());
+		cell->state = WorldCellState::Activating;
+	}
+
+	createdBuffer.clear();
+	size_t count = cell->reader.Instantiate(WORLD_BUDGET_CHUNK, &createdBuffer);
+	for (size_t i = 0; i < createdBuffer.size(); i++)
+	{
+		cell->objects.push_back(createdBuffer[i]->GetHandle());
+	}
+
+	if (cell->reader.IsFinished())
+	{
+		cell->reader.Close();
+		cell->state = WorldCellState::Active;
+
+		double ms = chrono::duration<double, milli>(Clock::now() - cell->requestTime).count();
+		totalStreamMilliseconds += ms;
+		stats.cellsActivated++;
+		stats.averageStreamMilliseconds = totalStreamMilliseconds / stats.cellsActivated;
+		stats.maxStreamMilliseconds = max(stats.maxStreamMilliseconds, ms);
+	}
+	return count;
+}
+
+// Stream cells in and out around the viewer
+void WorldPartition::Update(XMFLOAT3 viewerPosition)
+{
+	Clock::time_point frameStart = Clock::now();
+
+	//Take the cells the loading thread finished
+	{
+		lock_guard<mutex> lock(queueLock);
+		finishedBuffer.swap(finishedLoads);
+	}
+	for (size_t i = 0; i < finishedBuffer.size(); i++)
+	{
+		Cell* cell = finishedBuffer[i];
+		if (!cell->loaded)
+			printf("Could not stream in world cell (%d, %d)\n", cell->x, cell->z);
+
+		if (cell->loaded && !cell->cancel)
+			cell->state = WorldCellState::Loaded;
+		else
+		{
+			cell->reader.Close();
+			cell->state = WorldCellState::Unloaded;
+			residentCells--;
+			QueueMeshReleases(cell);
+		}
+		cell->cancel = false;
+	}
+	finishedBuffer.clear();
+
+	//Find cells to load and unload, using the distance to the
+	// closest point of each cell on the XZ plane
+	requestBuffer.clear();
+	workBuffer.clear();
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		Cell* cell = cells[i];
+		float minX = cell->x * cellSize;
+		float minZ = cell->z * cellSize;
+		float dx = max(max(minX - viewerPosition.x, viewerPosition.x - (minX + cellSize)), 0.0f);
+		float dz = max(max(minZ - viewerPosition.z, viewerPosition.z - (minZ + cellSize)), 0.0f);
+		cell->distance = sqrtf(dx * dx + dz * dz);
+		bool inLoadRange = cell->distance <= loadRadius;
+		bool outOfRange = cell->distance > unloadRadius;
+
+		switch (cell->state)
+		{
+		case WorldCellState::Unloaded:
+			if (inLoadRange)
+				requestBuffer.push_back(cell);
+			break;
+
+		case WorldCellState::Loading:
+			cell->cancel = outOfRange;
+			break;
+
+		case WorldCellState::Loaded:
+			if (outOfRange)
+			{
+				cell->reader.Close();
+				cell->state = WorldCellState::Unloaded;
+				residentCells--;
+				QueueMeshReleases(cell);
+			}
+			else workBuffer.push_back(cell);
+			break;
+
+		case WorldCellState::Activating:
+		case WorldCellState::Active:
+			if (outOfRange)
+			{
+				cell->reader.Close();
+				cell->nextUnload = 0;
+				cell->state = WorldCellState::Unloading;
+				workBuffer.push_back(cell);
+			}
+			else if (cell->state == WorldCellState::Activating)
+				workBuffer.push_back(cell);
+			break;
+
+		case WorldCellState::Unloading:
+			workBuffer.push_back(cell);
+			break;
+		}
+	}
+
+	//Request the closest cells while there is room for them
+	auto closer = [](const Cell* a, const Cell* b) { return a->distance < b->distance; };
+	sort(requestBuffer.begin(), requestBuffer.end(), closer);
+	if (!requestBuffer.empty() && residentCells < maxResidentCells)
+	{
+		{
+			lock_guard<mutex> lock(queueLock);
+			for (size_t i = 0; i < requestBuffer.size() && residentCells < maxResidentCells; i++)
+			{
+				Cell* cell = requestBuffer[i];
+				cell->state = WorldCellState::Loading;
+				cell->cancel = false;
+				cell->requestTime = frameStart;
+				loadQueue.push_back(cell);
+				residentCells++;
+			}
+		}
+		queueCondition.notify_one();
+	}
+
+	//Unload first to make room, then activate the closest cells,
+	// a chunk at a time until the frame budget is used
+	sort(workBuffer.begin(), workBuffer.end(), [](const Cell* a, const Cell* b) {
+		bool aUnloading = a->state == WorldCellState::Unloading;
+		bool bUnloading = b->state == WorldCellState::Unloading;
+		if (aUnloading != bUnloading)
+			return aUnloading;
+		return a->distance < b->distance;
+	});
+
+	//Release meshes of cells unloaded before this frame's work, cells
+	// that finish unloading below wait until their objects are removed
+	size_t released = 0;
+	for (; released < meshReleases.size() && !OverBudget(frameStart); released++)
+		ReleaseMesh(meshReleases[released]);
+	meshReleases.erase(meshReleases.begin(), meshReleases.begin() + released);
+
+	size_t frameObjects = 0;
+	for (size_t i = 0; i < workBuffer.size() && !OverBudget(frameStart); i++)
+	{
+		Cell* cell = workBuffer[i];
+		if (cell->state == WorldCellState::Unloading)
+		{
+			while (cell->state == WorldCellState::Unloading && !OverBudget(frameStart))
+				frameObjects += UnloadChunk(cell);
+		}
+		else
+		{
+			while (cell->state != WorldCellState::Active && !OverBudget(frameStart))
+				frameObjects += ActivateChunk(cell);
+		}
+	}
+
+	//Frame stats
+	stats.lastFrameObjects = frameObjects;
+	stats.lastFrameMilliseconds = chrono::duration<double, milli>(Clock::now() - frameStart).count();
+	stats.maxFrameMilliseconds = max(stats.maxFrameMilliseconds, stats.lastFrameMilliseconds);
+}
+
+// Get the streaming state of a cell
+WorldCellState WorldPartition::GetCellState(int32_t x, int32_t z)
+{
+	auto iter = cellMap.find(CellKey(x, z));
+	return iter == cellMap.end() ? WorldCellState::Unloaded : iter->second->state;
+}
+
+// Get the counters for this world
+WorldPartitionStats WorldPartition::GetStats()
+{
+	WorldPartitionStats result = stats;
+	result.cellCount = cells.size();
+	result.residentCells = residentCells;
+	result.activeCells = 0;
+	result.streamedObjects = 0;
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		if (cells[i]->state == WorldCellState::Active)
+			result.activeCells++;
+		result.streamedObjects += cells[i]->objects.size() - cells[i]->nextUnload;
+	}
+
+	lock_guard<mutex> lock(meshLock);
+	result.streamedMeshes = 0;
+	for (auto iter = meshUses.begin(); iter != meshUses.end(); iter++)
+	{
+		if (iter->second.owned)
+			result.streamedMeshes++;
+	}
+	return result;
+}
+
+// Reset the latency and frame time counters
+void WorldPartition::ResetStats()
+{
+	stats = { };
+	totalStreamMilliseconds = 0;
+}
\ No newline at end of file
@@ -0,0 +1,270 @@
+#pragma once
+#include <DirectXMath.h>
+#include <d3d11.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "SceneFile.h"
+#include "EntityHandle.h"
+#include "StringId.h"
+
+//Default size of a world cell in world units
+#define WORLD_DEFAULT_CELL_SIZE 64.0f
+//Default distances cells are loaded and unloaded at. Unloading further
+// out than loading keeps cells on a border from loading every frame
+#define WORLD_DEFAULT_LOAD_RADIUS 128.0f
+#define WORLD_DEFAULT_UNLOAD_RADIUS 160.0f
+//Default most cells that can be loaded at once
+#define WORLD_DEFAULT_MAX_RESIDENT_CELLS 64
+//Default time a frame can spend creating and removing objects (ms)
+#define WORLD_DEFAULT_FRAME_BUDGET 2.0f
+//Objects created or removed between checks of the frame budget
+#define WORLD_BUDGET_CHUNK 16
+
+// --------------------------------------------------------
+// Where a world cell is in streaming
+// --------------------------------------------------------
+enum class WorldCellState
+{
+	Unloaded,	//Nothing in memory
+	Loading,	//The loading thread is reading the file
+	Loaded,		//Read and waiting for its objects to be created
+	Activating,	//Objects are being created over a few frames
+	Active,		//Every object exists
+	Unloading	//Objects are being removed over a few frames
+};
+
+// --------------------------------------------------------
+// Counters for world streaming
+// --------------------------------------------------------
+struct WorldPartitionStats
+{
+	size_t cellCount;				//Cells in the world
+	size_t residentCells;			//Cells that are not unloaded
+	size_t activeCells;				//Cells with every object created
+	size_t streamedObjects;			//Objects created by cells right now
+	size_t streamedMeshes;			//Meshes loaded by cells right now
+	size_t cellsActivated;			//Cells that finished activating
+
+	double averageStreamMilliseconds;	//Request to fully active
+	double maxStreamMilliseconds;
+
+	double lastFrameMilliseconds;	//Time Update() took last frame
+	double maxFrameMilliseconds;	//Longest Update() so far
+	size_t lastFrameObjects;		//Objects created or removed last frame
+};
+
+// --------------------------------------------------------
+// A world split into square cells on the XZ plane, each stored
+// as a scene file. Cells near the viewer are streamed in and
+// far cells are streamed out.
+//
+// Files are mapped and checked, and any meshes they use are
+// loaded, on a background thread. The main thread then creates
+// the objects a chunk at a time under a per frame time budget,
+// so a cell coming in never causes a hitch. Cells are unloaded
+// the same way, and only a fixed amount can be loaded at once.
+//
+// Meshes are counted by the resident cells using them. A mesh
+// the world loaded itself is released, in the frame budget,
+// the frame after the last cell using it is unloaded
+// --------------------------------------------------------
+class WorldPartition
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Cell
+	{
+		int32_t x;
+		int32_t z;
+		std::string path;
+		WorldCellState state;
+		float distance;
+
+		//Only touched by the loading thread while the cell is Loading
+		SceneFileReader reader;
+		bool loaded;
+
+		//Stop loading once the read finishes
+		bool cancel;
+
+		std::vector<EntityHandle> objects;
+		size_t nextUnload;
+		Clock::time_point requestTime;
+
+		//Meshes this cell counts as using, set by the loading thread
+		std::vector<StringId> meshes;
+	};
+
+	struct StreamedMesh
+	{
+		size_t cells;	//Resident cells using the mesh
+		bool owned;		//The world loaded it, so the world releases it
+	};
+
+	ID3D11Device* device;
+	float cellSize;
+	float loadRadius;
+	float unloadRadius;
+	size_t maxResidentCells;
+	float frameBudget;
+
+	std::vector<Cell*> cells;
+	std::unordered_map<uint64_t, Cell*> cellMap;
+	size_t residentCells;
+
+	//Cells waiting for the loading thread and cells it finished
+	std::thread loadThread;
+	std::mutex queueLock;
+	std::condition_variable queueCondition;
+	std::deque<Cell*> loadQueue;
+	std::vector<Cell*> finishedLoads;
+	bool loadThreadRunning;
+
+	//Meshes used by cells, shared with the loading thread
+	std::mutex meshLock;
+	std::unordered_map<StringId, StreamedMesh> meshUses;
+
+	//Meshes of unloaded cells, released in later frames once
+	// the cells' objects are gone
+	std::vector<StringId> meshReleases;
+
+	//Reused every frame
+	std::vector<Cell*> finishedBuffer;
+	std::vector<Cell*> requestBuffer;
+	std::vector<Cell*> workBuffer;
+	std::vector<GameObject*> createdBuffer;
+
+	WorldPartitionStats stats;
+	double totalStreamMilliseconds;
+
+	// --------------------------------------------------------
+	// Read cells from the load queue until the world is destroyed
+	// --------------------------------------------------------
+	void LoadThread();
+
+	// --------------------------------------------------------
+	// Get the cell a coordinate is in
+	// --------------------------------------------------------
+	int32_t CellCoord(float value);
+
+	// --------------------------------------------------------
+	// Get the key of a cell in the cell map
+	// --------------------------------------------------------
+	static uint64_t CellKey(int32_t x, int32_t z);
+
+	// --------------------------------------------------------
+	// Count a mesh as used by a cell, loading it if needed
+	// (on the loading thread)
+	// --------------------------------------------------------
+	void AcquireMesh(Cell* cell, const std::string& address);
+
+	// --------------------------------------------------------
+	// Stop counting a mesh for a cell, releasing it when no
+	// resident cell uses it and the world loaded it
+	// --------------------------------------------------------
+	void ReleaseMesh(StringId mesh);
+
+	// --------------------------------------------------------
+	// Queue the meshes of a cell that was unloaded for release
+	// --------------------------------------------------------
+	void QueueMeshReleases(Cell* cell);
+
+	// --------------------------------------------------------
+	// Remove some of a cell's objects, returns how many
+	// --------------------------------------------------------
+	size_t UnloadChunk(Cell* cell);
+
+	// --------------------------------------------------------
+	// Create some of a cell's objects, returns how many
+	// --------------------------------------------------------
+	size_t ActivateChunk(Cell* cell);
+
+	// --------------------------------------------------------
+	// Check if a frame has used up its time budget
+	// --------------------------------------------------------
+	bool OverBudget(Clock::time_point frameStart);
+
+public:
+	// --------------------------------------------------------
+	// Create a world and start its loading thread
+	//
+	// device - used to load meshes cells need (can be null when
+	//		there is no graphics device, cells must then only use
+	//		meshes that are already loaded)
+	// cellSize - size of a cell in world units
+	// --------------------------------------------------------
+	WorldPartition(ID3D11Device* device, float cellSize = WORLD_DEFAULT_CELL_SIZE);
+
+	// --------------------------------------------------------
+	// Stop the loading thread, remove every streamed object and
+	// release the meshes the world loaded
+	// --------------------------------------------------------
+	~WorldPartition();
+
+	//Delete this
+	WorldPartition(WorldPartition const&) = delete;
+	void operator=(WorldPartition const&) = delete;
+
+	// --------------------------------------------------------
+	// Add a cell stored in a scene file
+	// --------------------------------------------------------
+	void AddCell(int32_t x, int32_t z, const std::string& path);
+
+	// --------------------------------------------------------
+	// Add every cell file (cell_X_Z.rscn) in a directory
+	// returns the amount of cells added
+	// --------------------------------------------------------
+	size_t AddCellsFromDirectory(const std::string& directory);
+
+	// --------------------------------------------------------
+	// Save GameObjects (and their children) into one scene file
+	// per cell in a directory and add those cells. Objects go in
+	// the cell their position is in
+	// --------------------------------------------------------
+	bool BakeCells(const std::string& directory, const std::vector<GameObject*>& roots);
+
+	// --------------------------------------------------------
+	// Set how far away cells are loaded and unloaded
+	// (unloadRadius should be bigger than loadRadius)
+	// --------------------------------------------------------
+	void SetStreamingRadius(float loadRadius, float unloadRadius);
+
+	// --------------------------------------------------------
+	// Set the most cells that can be loaded at once
+	// --------------------------------------------------------
+	void SetMaxResidentCells(size_t count);
+
+	// --------------------------------------------------------
+	// Set the time a frame can spend creating and removing
+	// objects in milliseconds
+	// --------------------------------------------------------
+	void SetFrameBudget(float milliseconds);
+
+	// --------------------------------------------------------
+	// Stream cells in and out around the viewer (once per frame)
+	// --------------------------------------------------------
+	void Update(DirectX::XMFLOAT3 viewerPosition);
+
+	// --------------------------------------------------------
+	// Get the streaming state of a cell (Unloaded if there is
+	// no cell there)
+	// --------------------------------------------------------
+	WorldCellState GetCellState(int32_t x, int32_t z);
+
+	// --------------------------------------------------------
+	// Get the counters for this world
+	// --------------------------------------------------------
+	WorldPartitionStats GetStats();
+
+	// --------------------------------------------------------
+	// Reset the latency and frame time counters
+	// --------------------------------------------------------
+	void ResetStats();
+};
\ No newline at end of file
@@ -0,0 +1,786 @@
+#include "Benchmarks.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include <thread>
+#include <filesystem>
+#include "GameObject.h"
+#include "EntityManager.h"
+#include "ResourceManager.h"
+#include "MeshRenderer.h"
+#include "Collider.h"
+#include "Prefab.h"
+#include "ObjectPool.h"
+#include "SpatialIndex.h"
+#include "UpdateLod.h"
+#include "ChangeVersion.h"
+#include "SceneFile.h"
+#include "WorldPartition.h"
+#include "Renderer.h"
+#include "RecordingRenderDevice.h"
+#include "StaticBatches.h"
+#include "Camera.h"
+#include "AllocationCounter.h"
+
+using namespace std;
+
+//How many times each benchmark loop runs
+#define BENCHMARK_ITERATIONS 1000000
+
+//How many objects the spawn benchmark creates
+#define BENCHMARK_SPAWN_COUNT 10000
+
+//How many objects the object pool benchmark keeps alive at once
+#define BENCHMARK_POOL_LIVE 64
+
+//How many moving objects the spatial index benchmark creates
+#define BENCHMARK_SPATIAL_COUNT 100000
+//How many queries of each kind the spatial index benchmark runs
+#define BENCHMARK_SPATIAL_QUERIES 1000
+
+//How many crowd members and frames the update rate benchmark runs
+#define BENCHMARK_CROWD_COUNT 10000
+#define BENCHMARK_CROWD_FRAMES 64
+
+//How many objects the scene file benchmark saves and loads
+#define BENCHMARK_SCENE_COUNT 50000
+#define BENCHMARK_SCENE_PATH "Assets/benchmark.rscn"
+
+//Size of the streamed world (objects per side) and the frames flown over it
+#define BENCHMARK_WORLD_SIDE 200
+#define BENCHMARK_WORLD_SPACING 2.56f
+#define BENCHMARK_WORLD_FRAMES 400
+#define BENCHMARK_WORLD_PATH "Assets/BenchmarkWorld"
+
+//How many objects and frames the render recording benchmark draws
+#define BENCHMARK_RENDER_COUNT 5000
+#define BENCHMARK_RENDER_FRAMES 32
+
+//How many draws and frames the transparent sort benchmark sorts
+#define BENCHMARK_TRANSPARENT_COUNT 20000
+#define BENCHMARK_TRANSPARENT_FRAMES 64
+
+//Distinct component types for the lookup benchmark
+template <int N>
+class BenchComponent : public Component
+{
+public:
+	typedef ComponentLookupBases<BenchComponent<N>, Component> LookupBases;
+
+	BenchComponent(GameObject* gameObject) : Component(gameObject) { }
+};
+
+//A crowd member that does some steering work every update
+class BenchCrowdMember : public Component
+{
+public:
+	typedef ComponentLookupBases<BenchCrowdMember, Component> LookupBases;
+
+	float heading;
+	float speed;
+
+	BenchCrowdMember(GameObject* gameObject) : Component(gameObject)
+	{
+		heading = 0;
+		speed = 0;
+	}
+
+	void Update(float deltaTime) override
+	{
+		//Stand in for steering and animation logic
+		for (int i = 0; i < 32; i++)
+		{
+			heading += sinf(heading + deltaTime) * 0.01f;
+			speed = 0.9f * speed + 0.1f * cosf(heading);
+		}
+	}
+};
+
+//The same crowd member with a distance based update rate
+class BenchCrowdMemberLod : public BenchCrowdMember
+{
+public:
+	typedef ComponentLookupBases<BenchCrowdMemberLod, BenchCrowdMember> LookupBases;
+
+	static constexpr UpdateLod UpdateRate = { 20.0f, 200.0f, 16, 16 };
+
+	BenchCrowdMemberLod(GameObject* gameObject) : BenchCrowdMember(gameObject) { }
+};
+
+// Get the elapsed time in milliseconds since a start point
+static double ElapsedMilliseconds(chrono::high_resolution_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+// Add one BenchComponent of each index to a gameobject
+template <int... Ns>
+static void AddBenchComponents(GameObject* obj, vector<Component*>* list, integer_sequence<int, Ns...>)
+{
+	(list->push_back(obj->AddComponent<BenchComponent<Ns>>()), ...);
+}
+
+// Find a component the way GetComponent used to
+template <typename T>
+static T* LegacyGetComponent(const vector<Component*>& list)
+{
+	for (auto iter = list.begin(); iter != list.end(); iter++)
+	{
+		T* c = dynamic_cast<T*>(*iter);
+		if (c)
+			return c;
+	}
+	return nullptr;
+}
+
+// Time looking up the last component added to a gameobject with N components
+template <int N>
+static void BenchmarkLookupCount()
+{
+	typedef BenchComponent<N - 1> Last;
+
+	GameObject* obj = new GameObject("BenchmarkLookup");
+	vector<Component*> list;
+	AddBenchComponents(obj, &list, make_integer_sequence<int, N>());
+
+	//Sum the pointers so the loops can't be optimised out
+	size_t sink = 0;
+
+	auto start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+		sink += (size_t)obj->GetComponent<Last>();
+	double lookupTime = ElapsedMilliseconds(start);
+
+	start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+		sink += (size_t)LegacyGetComponent<Last>(list);
+	double legacyTime = ElapsedMilliseconds(start);
+
+	printf("GetComponent with %2d components: %8.3f ms (dynamic_cast scan: %8.3f ms) [%zu]\n",
+		N, lookupTime, legacyTime, sink & 1);
+
+	EntityManager::GetInstance()->RemoveEntity(obj);
+}
+
+// Time GetComponent<T>() on GameObjects with 1, 8 and 32 components
+void BenchmarkComponentLookup()
+{
+	printf("Component lookup benchmark (%d lookups each)\n", BENCHMARK_ITERATIONS);
+	BenchmarkLookupCount<1>();
+	BenchmarkLookupCount<8>();
+	BenchmarkLookupCount<32>();
+}
+
+
+// Remove every gameobject in a list
+static void RemoveAll(vector<GameObject*>* objects)
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+	for (size_t i = 0; i < objects->size(); i++)
+	{
+		entityManager->RemoveEntity((*objects)[i]);
+	}
+	objects->clear();
+}
+
+// Spawn a benchmark's objects, run it on them, then remove them.
+// Returns how long spawning took in milliseconds
+static double RunWithObjects(const function<void(vector<GameObject*>*)>& spawn,
+	const function<void(vector<GameObject*>&)>& run = nullptr)
+{
+	vector<GameObject*> objects;
+	auto start = chrono::high_resolution_clock::now();
+	spawn(&objects);
+	double spawnTime = ElapsedMilliseconds(start);
+
+	if (run)
+		run(objects);
+	RemoveAll(&objects);
+	return spawnTime;
+}
+
+// Time spawning physics objects one at a time against a prefab batch
+void BenchmarkPrefabSpawn()
+{
+	Mesh* sphereMesh = ResourceManager::GetInstance()->GetMesh("Assets\\Models\\Basic\\sphere.obj");
+	Material* whiteMat = ResourceManager::GetInstance()->GetMaterial("white");
+
+	//Spread the objects out on a grid far below the scene
+	vector<PrefabTransform> transforms;
+	transforms.reserve(BENCHMARK_SPAWN_COUNT);
+	for (int i = 0; i < BENCHMARK_SPAWN_COUNT; i++)
+	{
+		transforms.push_back(PrefabTransform(
+			DirectX::XMFLOAT3((float)(i % 100), -1000.0f, (float)(i / 100))));
+	}
+
+	//One at a time, the way game code used to spawn
+	double singleTime = RunWithObjects([&](vector<GameObject*>* objects) {
+		objects->reserve(BENCHMARK_SPAWN_COUNT);
+		for (int i = 0; i < BENCHMARK_SPAWN_COUNT; i++)
+		{
+			GameObject* obj = new GameObject("BenchmarkSpawn");
+			obj->AddComponent<MeshRenderer>(sphereMesh, whiteMat);
+			obj->SetPosition(transforms[i].position);
+			obj->SetScale(0.5f, 0.5f, 0.5f);
+			obj->AddComponent<SphereCollider>(0.25f);
+			obj->AddComponent<RigidBody>(1.0f);
+			objects->push_back(obj);
+		}
+	});
+
+	//Prefab batch
+	Prefab prefab("BenchmarkSpawn", DirectX::XMFLOAT3(0.5f, 0.5f, 0.5f));
+	prefab.AddComponent<MeshRenderer>(sphereMesh, whiteMat);
+	prefab.AddComponent<SphereCollider>(0.25f);
+	prefab.AddComponent<RigidBody>(1.0f);
+
+	double prefabTime = RunWithObjects([&](vector<GameObject*>* objects) {
+		prefab.Instantiate(transforms, objects);
+	});
+
+	printf("Spawning %d physics objects: %8.3f ms (one at a time: %8.3f ms)\n",
+		BENCHMARK_SPAWN_COUNT, prefabTime, singleTime);
+}
+
+// Time creating and removing short lived objects against an object pool
+void BenchmarkObjectPool()
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+
+	Prefab prefab("BenchmarkPool", DirectX::XMFLOAT3(0.5f, 0.5f, 0.5f));
+	prefab.AddComponent<MeshRenderer>(
+		ResourceManager::GetInstance()->GetMesh("Assets\\Models\\Basic\\sphere.obj"),
+		ResourceManager::GetInstance()->GetMaterial("white"));
+	prefab.AddComponent<SphereCollider>(0.25f);
+	prefab.AddComponent<RigidBody>(1.0f);
+
+	//Keep a ring of live objects, replacing the oldest each shot
+	DirectX::XMFLOAT3 position(0, -1000.0f, 0);
+
+	//Create and remove every object (removed objects are deleted
+	// by the EntityManager later, so that cost isn't counted here)
+	double createTime = RunWithObjects([&](vector<GameObject*>* live) {
+		live->resize(BENCHMARK_POOL_LIVE, nullptr);
+		for (int i = 0; i < BENCHMARK_SPAWN_COUNT; i++)
+		{
+			GameObject*& slot = (*live)[i % BENCHMARK_POOL_LIVE];
+			if (slot != nullptr)
+				entityManager->RemoveEntity(slot);
+			slot = prefab.Instantiate(position);
+		}
+	});
+
+	//Recycle through a warm pool
+	ObjectPool pool(&prefab);
+	pool.Prewarm(BENCHMARK_POOL_LIVE);
+	pool.ResetStats();
+
+	uint64_t poolAllocations = 0;
+	double poolTime = RunWithObjects([&](vector<GameObject*>* live) {
+		live->resize(BENCHMARK_POOL_LIVE, nullptr);
+		uint64_t allocationsAtStart = GetAllocationCount();
+		for (int i = 0; i < BENCHMARK_SPAWN_COUNT; i++)
+		{
+			GameObject*& slot = (*live)[i % BENCHMARK_POOL_LIVE];
+			if (slot != nullptr)
+				pool.Release(slot);
+			slot = pool.Acquire(position);
+		}
+		poolAllocations = GetAllocationCount() - allocationsAtStart;
+	});
+	ObjectPoolStats stats = pool.GetStats();
+
+	//The live objects are removed, remove the ones waiting in the pool
+	pool.Clear();
+
+	printf("Firing %d pooled objects: %8.3f ms (create and remove: %8.3f ms)\n",
+		BENCHMARK_SPAWN_COUNT, poolTime, createTime);
+	printf("  instantiated %zu, reused %zu, released %zu\n",
+		stats.instantiated, stats.reused, stats.released);
+	if (IsCountingAllocations())
+		printf("  %llu heap allocations while firing from the pool\n", (unsigned long long)poolAllocations);
+	else
+		printf("  Heap allocations are only counted in builds with ALLOCATION_COUNTING defined\n");
+}
+
+// Get a random float in a range
+static float RandomRange(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+// Time syncing and querying the spatial index with 100k moving GameObjects
+void BenchmarkSpatialIndex()
+{
+	using namespace DirectX;
+	SpatialIndex* spatialIndex = SpatialIndex::GetInstance();
+	EntityManager::GetInstance()->Reserve(BENCHMARK_SPATIAL_COUNT);
+
+	//Scatter objects over a 1km square
+	RunWithObjects([](vector<GameObject*>* objects) {
+		objects->reserve(BENCHMARK_SPATIAL_COUNT);
+		for (int i = 0; i < BENCHMARK_SPATIAL_COUNT; i++)
+		{
+			GameObject* obj = new GameObject("BenchmarkSpatial");
+			obj->SetPosition(RandomRange(-500, 500), RandomRange(-1000, -950), RandomRange(-500, 500));
+			objects->push_back(obj);
+		}
+	}, [&](vector<GameObject*>& objects) {
+		auto start = chrono::high_resolution_clock::now();
+		spatialIndex->Sync();
+		double insertTime = ElapsedMilliseconds(start);
+
+		//Move everything a little, like a crowd
+		for (int i = 0; i < BENCHMARK_SPATIAL_COUNT; i++)
+		{
+			XMFLOAT3 pos = objects[i]->GetPosition();
+			objects[i]->SetPosition(pos.x + RandomRange(-1, 1), pos.y, pos.z + RandomRange(-1, 1));
+		}
+		start = chrono::high_resolution_clock::now();
+		spatialIndex->Sync();
+		double syncTime = ElapsedMilliseconds(start);
+
+		vector<GameObject*> results(BENCHMARK_SPATIAL_COUNT);
+		size_t found = 0;
+
+		//Sphere queries against scanning every entity
+		start = chrono::high_resolution_clock::now();
+		for (int i = 0; i < BENCHMARK_SPATIAL_QUERIES; i++)
+		{
+			XMFLOAT3 center(RandomRange(-500, 500), -975, RandomRange(-500, 500));
+			found += spatialIndex->QuerySphere(center, 20, results.data(), results.size());
+		}
+		double sphereTime = ElapsedMilliseconds(start);
+
+		//The scan is slow, so run a tenth of the queries and scale the time
+		size_t scanFound = 0;
+		start = chrono::high_resolution_clock::now();
+		for (int i = 0; i < BENCHMARK_SPATIAL_QUERIES / 10; i++)
+		{
+			XMFLOAT3 center(RandomRange(-500, 500), -975, RandomRange(-500, 500));
+			EntityManager::GetInstance()->ForEachActive([&](GameObject* obj) {
+				XMFLOAT3 pos = obj->GetPosition();
+				float dx = pos.x - center.x;
+				float dy = pos.y - center.y;
+				float dz = pos.z - center.z;
+				if (dx * dx + dy * dy + dz * dz <= 20 * 20)
+					results[scanFound++ % results.size()] = obj;
+			});
+		}
+		double scanTime = ElapsedMilliseconds(start) * 10;
+
+		//Box queries
+		start = chrono::high_resolution_clock::now();
+		for (int i = 0; i < BENCHMARK_SPATIAL_QUERIES; i++)
+		{
+			XMFLOAT3 min(RandomRange(-500, 480), -1000, RandomRange(-500, 480));
+			XMFLOAT3 max(min.x + 20, -950, min.z + 20);
+			found += spatialIndex->QueryBox(min, max, results.data(), results.size());
+		}
+		double boxTime = ElapsedMilliseconds(start);
+
+		//Frustum queries from cameras looking across the objects
+		XMFLOAT4X4 projection;
+		XMStoreFloat4x4(&projection, XMMatrixPerspectiveFovLH(0.25f * 3.1415926535f, 16.0f / 9.0f, 0.1f, 100.0f));
+		start = chrono::high_resolution_clock::now();
+		for (int i = 0; i < BENCHMARK_SPATIAL_QUERIES; i++)
+		{
+			XMFLOAT4X4 view;
+			XMVECTOR eye = XMVectorSet(RandomRange(-500, 500), -960, RandomRange(-500, 500), 0);
+			XMStoreFloat4x4(&view, XMMatrixLookToLH(eye, XMVectorSet(1, -0.2f, 1, 0), XMVectorSet(0, 1, 0, 0)));
+			found += spatialIndex->QueryFrustum(Frustum(view, projection), results.data(), results.size());
+		}
+		double frustumTime = ElapsedMilliseconds(start);
+
+		printf("Spatial index with %d objects: insert %8.3f ms, sync after moving all %8.3f ms\n",
+			BENCHMARK_SPATIAL_COUNT, insertTime, syncTime);
+		printf("  %d sphere queries: %8.3f ms (scanning every entity: %8.3f ms)\n",
+			BENCHMARK_SPATIAL_QUERIES, sphereTime, scanTime);
+		printf("  %d box queries: %8.3f ms, %d frustum queries: %8.3f ms [%zu]\n",
+			BENCHMARK_SPATIAL_QUERIES, boxTime, BENCHMARK_SPATIAL_QUERIES, frustumTime, (found + scanFound) & 1);
+	});
+}
+
+// Time updating a crowd's pool for a number of frames
+template <typename T>
+static double TimeCrowdFrames(float deltaTime)
+{
+	ComponentPool<T>* pool = ComponentManager::GetInstance()->GetPool<T>();
+
+	auto start = chrono::high_resolution_clock::now();
+	for (int i = 0; i < BENCHMARK_CROWD_FRAMES; i++)
+	{
+		//Scheduling is based on the frame version
+		AdvanceFrameVersion();
+		pool->Update(deltaTime);
+	}
+	return ElapsedMilliseconds(start);
+}
+
+// Time updating a crowd every frame against distance based update rates
+void BenchmarkUpdateLod()
+{
+	using namespace DirectX;
+
+	//Spread the crowd over a 1km square around a viewer looking down +z
+	RunWithObjects([](vector<GameObject*>* objects) {
+		objects->reserve(BENCHMARK_CROWD_COUNT * 2);
+		for (int i = 0; i < BENCHMARK_CROWD_COUNT * 2; i++)
+		{
+			GameObject* obj = new GameObject("BenchmarkCrowd");
+			obj->SetPosition(RandomRange(-500, 500), -1000, RandomRange(-500, 500));
+			if (i < BENCHMARK_CROWD_COUNT)
+				obj->AddComponent<BenchCrowdMember>();
+			else obj->AddComponent<BenchCrowdMemberLod>();
+			objects->push_back(obj);
+		}
+	}, [](vector<GameObject*>& objects) {
+		XMFLOAT4X4 view;
+		XMFLOAT4X4 projection;
+		XMStoreFloat4x4(&view, XMMatrixLookToLH(XMVectorSet(0, -998, 0, 0), XMVectorSet(0, 0, 1, 0), XMVectorSet(0, 1, 0, 0)));
+		XMStoreFloat4x4(&projection, XMMatrixPerspectiveFovLH(0.25f * 3.1415926535f, 16.0f / 9.0f, 0.1f, 1000.0f));
+		Frustum frustum(view, projection);
+		size_t visible = 0;
+		for (int i = 0; i < BENCHMARK_CROWD_COUNT; i++)
+		{
+			XMFLOAT3 center;
+			float radius;
+			SpatialIndex::GetBounds(objects[BENCHMARK_CROWD_COUNT + i], &center, &radius);
+			if (frustum.Intersects(center, radius))
+				visible++;
+		}
+
+		//The game sets its own viewer again next frame
+		UpdateLodViewer* viewer = UpdateLodViewer::GetInstance();
+		viewer->SetViewer(XMFLOAT3(0, -998, 0), frustum);
+
+		float deltaTime = 1.0f / 60.0f;
+		double fullTime = TimeCrowdFrames<BenchCrowdMember>(deltaTime);
+		double lodTime = TimeCrowdFrames<BenchCrowdMemberLod>(deltaTime);
+
+		printf("Updating %d crowd members (%zu visible) for %d frames: %8.3f ms (every frame: %8.3f ms)\n",
+			BENCHMARK_CROWD_COUNT, visible, BENCHMARK_CROWD_FRAMES, lodTime, fullTime);
+	});
+}
+
+// Time building a scene in code against loading it from a scene file
+void BenchmarkSceneLoad()
+{
+	Mesh* cubeMesh = ResourceManager::GetInstance()->GetMesh("Assets\\Models\\Basic\\cube.obj");
+	Material* whiteMat = ResourceManager::GetInstance()->GetMaterial("white");
+
+	//Build the scene the way SetupScene does, then save it
+	bool saved = false;
+	double codeTime = RunWithObjects([&](vector<GameObject*>* objects) {
+		objects->reserve(BENCHMARK_SCENE_COUNT);
+		for (int i = 0; i < BENCHMARK_SCENE_COUNT; i++)
+		{
+			GameObject* obj = new GameObject("BenchmarkScene");
+			obj->SetPosition((float)(i % 250), -1000.0f, (float)(i / 250));
+			obj->AddComponent<MeshRenderer>(cubeMesh, whiteMat);
+			obj->AddComponent<BoxCollider>();
+			objects->push_back(obj);
+		}
+	}, [&](vector<GameObject*>& objects) {
+		saved = SceneFile::Save(BENCHMARK_SCENE_PATH, objects);
+	});
+	if (!saved)
+		return;
+
+	size_t loaded = 0;
+	double loadTime = RunWithObjects([](vector<GameObject*>* objects) {
+		SceneFile::Load(BENCHMARK_SCENE_PATH, objects);
+	}, [&](vector<GameObject*>& objects) {
+		loaded = objects.size();
+	});
+
+	printf("Loading %zu objects from a scene file: %8.3f ms (built in code: %8.3f ms)\n",
+		loaded, loadTime, codeTime);
+
+	remove(BENCHMARK_SCENE_PATH);
+}
+
+// Fly a viewer across a world of streamed cells
+void BenchmarkWorldStreaming(ID3D11Device* device)
+{
+	Mesh* cubeMesh = ResourceManager::GetInstance()->GetMesh("Assets\\Models\\Basic\\cube.obj");
+	Material* whiteMat = ResourceManager::GetInstance()->GetMaterial("white");
+
+	//Bake a grid of objects into cells and remove them again
+	{
+		WorldPartition world(device);
+		bool baked = false;
+		RunWithObjects([&](vector<GameObject*>* objects) {
+			objects->reserve(BENCHMARK_WORLD_SIDE * BENCHMARK_WORLD_SIDE);
+			for (int i = 0; i < BENCHMARK_WORLD_SIDE * BENCHMARK_WORLD_SIDE; i++)
+			{
+				GameObject* obj = new GameObject("BenchmarkWorld");
+				obj->SetPosition((i % BENCHMARK_WORLD_SIDE) * BENCHMARK_WORLD_SPACING, -1000.0f,
+					(i / BENCHMARK_WORLD_SIDE) * BENCHMARK_WORLD_SPACING);
+				obj->AddComponent<MeshRenderer>(cubeMesh, whiteMat);
+				obj->AddComponent<BoxCollider>();
+				objects->push_back(obj);
+			}
+		}, [&](vector<GameObject*>& objects) {
+			baked = world.BakeCells(BENCHMARK_WORLD_PATH, objects);
+		});
+		if (baked)
+		{
+			//Fly along the middle of the world, one frame every few milliseconds
+			float worldSize = BENCHMARK_WORLD_SIDE * BENCHMARK_WORLD_SPACING;
+			float speed = (worldSize + 2 * WORLD_DEFAULT_UNLOAD_RADIUS) / BENCHMARK_WORLD_FRAMES;
+			for (int frame = 0; frame < BENCHMARK_WORLD_FRAMES; frame++)
+			{
+				world.Update(DirectX::XMFLOAT3(frame * speed - WORLD_DEFAULT_UNLOAD_RADIUS, -1000.0f, worldSize / 2));
+				this_thread::sleep_for(chrono::milliseconds(4));
+			}
+
+			WorldPartitionStats stats = world.GetStats();
+			printf("Streaming %zu cells over %d frames: %zu activated, latency %8.3f ms avg %8.3f ms max, "
+				"frame cost %8.3f ms max\n",
+				stats.cellCount, BENCHMARK_WORLD_FRAMES, stats.cellsActivated,
+				stats.averageStreamMilliseconds, stats.maxStreamMilliseconds, stats.maxFrameMilliseconds);
+		}
+	}
+
+	error_code error;
+	filesystem::remove_all(BENCHMARK_WORLD_PATH, error);
+}
+
+//Time drawing frames through a render device (null uses the D3D11 device)
+static double TimeRenderFrames(const std::function<void()>& drawFrame, RenderDevice* device)
+{
+	Renderer::GetInstance()->SetRenderDevice(device);
+	auto start = chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < BENCHMARK_RENDER_FRAMES; frame++)
+		drawFrame();
+	double time = ElapsedMilliseconds(start) / BENCHMARK_RENDER_FRAMES;
+	Renderer::GetInstance()->SetRenderDevice(nullptr);
+	return time;
+}
+
+//Spawn a wall of objects in front of the camera over every mesh and material combo
+static void SpawnRenderWall(Camera* camera, vector<GameObject*>* objects)
+{
+	ResourceManager* rm = ResourceManager::GetInstance();
+	Mesh* meshes[] = {
+		rm->GetMesh("Assets\\Models\\Basic\\cube.obj"),
+		rm->GetMesh("Assets\\Models\\Basic\\cylinder.obj")
+	};
+	Material* materials[] = { rm->GetMaterial("white"), rm->GetMaterial("gray"), rm->GetMaterial("blue") };
+
+	//Far enough ahead that the whole wall is inside the frustum
+	DirectX::XMFLOAT3 eye = camera->gameObject()->GetPosition();
+	DirectX::XMFLOAT3 forward = camera->gameObject()->GetForwardAxis();
+	objects->reserve(BENCHMARK_RENDER_COUNT);
+	for (int i = 0; i < BENCHMARK_RENDER_COUNT; i++)
+	{
+		GameObject* obj = new GameObject("BenchmarkRender");
+		obj->SetPosition(eye.x + forward.x * 60 + (float)(i % 100) - 50, eye.y + (float)(i / 100) - 25,
+			eye.z + forward.z * 60);
+		obj->AddComponent<MeshRenderer>(meshes[i % 2], materials[i % 3]);
+		objects->push_back(obj);
+	}
+}
+
+//Warn when a benchmark's frames drew nothing, so culled scenes aren't timed as empty frames
+static void CheckDrawn(const RenderDeviceStats& stats)
+{
+	if (stats.drawCalls == 0)
+		printf("Nothing was drawn, every object was culled or the scene is empty\n");
+}
+
+// Draw a wall of objects through the D3D11, recording and null devices
+void BenchmarkRenderRecording(Camera* camera, const std::function<void()>& drawFrame)
+{
+	RunWithObjects([camera](vector<GameObject*>* objects) {
+		SpawnRenderWall(camera, objects);
+	}, [&](vector<GameObject*>&) {
+		double d3d11Time = TimeRenderFrames(drawFrame, nullptr);
+
+		//Count what one frame sends to the GPU
+		RecordingRenderDevice recorder(Renderer::GetInstance()->GetRenderDevice(), false);
+		double recordTime = TimeRenderFrames(drawFrame, &recorder);
+		RenderDeviceStats stats = recorder.GetStats();
+		CheckDrawn(stats);
+
+		//Run the renderer without sending anything
+		RecordingRenderDevice nullDevice(nullptr, false);
+		double nullTime = TimeRenderFrames(drawFrame, &nullDevice);
+
+		printf("Drawing %d objects: %8.3f ms per frame (recording %8.3f ms, null device %8.3f ms)\n",
+			BENCHMARK_RENDER_COUNT, d3d11Time, recordTime, nullTime);
+		printf("Per frame: %zu commands, %zu draw calls, %zu state changes (%zu shaders), "
+			"%zu redundant binds, %zu buffer updates\n",
+			stats.commands / BENCHMARK_RENDER_FRAMES, stats.drawCalls / BENCHMARK_RENDER_FRAMES,
+			stats.stateChanges / BENCHMARK_RENDER_FRAMES, stats.shaderChanges / BENCHMARK_RENDER_FRAMES,
+			stats.redundantBinds / BENCHMARK_RENDER_FRAMES, stats.bufferUpdates / BENCHMARK_RENDER_FRAMES);
+	});
+}
+
+//Count what drawing frames sends to the GPU
+static RenderDeviceStats CountRenderFrames(const std::function<void()>& drawFrame, double* frameTime)
+{
+	RecordingRenderDevice recorder(Renderer::GetInstance()->GetRenderDevice(), false);
+	*frameTime = TimeRenderFrames(drawFrame, &recorder);
+	RenderDeviceStats stats = recorder.GetStats();
+	CheckDrawn(stats);
+	return stats;
+}
+
+//One way of drawing a benchmark's frames
+struct RenderScenario
+{
+	const char* name;
+	function<void(Renderer*)> setup;	//Changes the renderer's settings before the frames are drawn
+};
+
+//Draw frames in each scenario and print what each sent to the GPU per frame. The
+// renderer's settings are put back after each, so a scenario only sets what it changes
+static void RunRenderScenarios(const vector<RenderScenario>& scenarios, const std::function<void()>& drawFrame,
+	vector<RenderDeviceStats>* results = nullptr)
+{
+	Renderer* renderer = Renderer::GetInstance();
+	bool sorting = renderer->GetRenderQueueSorting();
+	bool instancing = renderer->GetInstancing();
+	bool parallel = renderer->GetParallelRecording();
+
+	for (size_t i = 0; i < scenarios.size(); i++)
+	{
+		scenarios[i].setup(renderer);
+		double frameTime;
+		RenderDeviceStats stats = CountRenderFrames(drawFrame, &frameTime);
+		renderer->SetRenderQueueSorting(sorting);
+		renderer->SetInstancing(instancing);
+		renderer->SetParallelRecording(parallel);
+
+		printf("%-17s: %8.3f ms per frame, %zu draw calls (%zu instances), %zu commands, "
+			"%zu state changes (%zu shaders), %zu redundant binds, %zu buffer updates\n",
+			scenarios[i].name, frameTime, stats.drawCalls / BENCHMARK_RENDER_FRAMES,
+			stats.instances / BENCHMARK_RENDER_FRAMES, stats.commands / BENCHMARK_RENDER_FRAMES,
+			stats.stateChanges / BENCHMARK_RENDER_FRAMES, stats.shaderChanges / BENCHMARK_RENDER_FRAMES,
+			stats.redundantBinds / BENCHMARK_RENDER_FRAMES, stats.bufferUpdates / BENCHMARK_RENDER_FRAMES);
+		if (results != nullptr)
+			results->push_back(stats);
+	}
+}
+
+// Draw the current scene unsorted, sorted, and sorted with instancing
+void BenchmarkRenderQueue(const std::function<void()>& drawFrame)
+{
+	RunRenderScenarios({
+		{ "Render list order", [](Renderer* r) { r->SetRenderQueueSorting(false); r->SetInstancing(false); } },
+		{ "Sorted by key", [](Renderer* r) { r->SetRenderQueueSorting(true); r->SetInstancing(false); } },
+		{ "Sorted, instanced", [](Renderer* r) { r->SetRenderQueueSorting(true); r->SetInstancing(true); } }
+	}, drawFrame);
+}
+
+// Draw the scene with and without the static batches
+void BenchmarkStaticBatching(StaticBatches* staticBatches, const std::function<void()>& drawFrame)
+{
+	StaticBatchStats batchStats = staticBatches->GetStats();
+	printf("%zu static renderers merged into %zu batches (%zu vertices, %zu indices)\n",
+		batchStats.batchedRenderers, batchStats.batches, batchStats.vertices, batchStats.indices);
+
+	bool enabled = staticBatches->GetEnabled();
+	RunRenderScenarios({
+		{ "Unbatched", [staticBatches](Renderer*) { staticBatches->SetEnabled(false); } },
+		{ "Static batches", [staticBatches](Renderer*) { staticBatches->SetEnabled(true); } }
+	}, drawFrame);
+	staticBatches->SetEnabled(enabled);
+}
+
+// Draw many objects with the camera passes recorded on one thread and in parallel
+void BenchmarkCommandRecording(Camera* camera, const std::function<void()>& drawFrame)
+{
+	//Every object is its own draw
+	vector<RenderDeviceStats> stats;
+	RunWithObjects([camera](vector<GameObject*>* objects) {
+		SpawnRenderWall(camera, objects);
+	}, [&](vector<GameObject*>&) {
+		RunRenderScenarios({
+			{ "One thread", [](Renderer* r) { r->SetInstancing(false); r->SetParallelRecording(false); } },
+			{ "Parallel chunks", [](Renderer* r) { r->SetInstancing(false); r->SetParallelRecording(true); } }
+		}, drawFrame, &stats);
+	});
+
+	//Chunks only rebind state at their starts, the draws must be the same
+	if (stats[0].drawCalls != stats[1].drawCalls || stats[0].indices != stats[1].indices
+		|| stats[0].instances != stats[1].instances)
+		printf("Parallel recording drew something different than recording on one thread\n");
+}
+
+// Sort a transparent pass while the camera moves a little every frame
+void BenchmarkTransparentSort()
+{
+	const float farClip = 1000.0f;
+	vector<float> depths(BENCHMARK_TRANSPARENT_COUNT);
+	for (float& depth : depths)
+		depth = RandomRange(1.0f, farClip - 1.0f);
+
+	double times[2];
+	int coherentFrames[2] = { 0, 0 };
+	bool sorted = true;
+	for (int i = 0; i < 2; i++)
+	{
+		RenderQueue queue;
+		queue.SetCoherentSorting(i == 1);
+
+		auto start = chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < BENCHMARK_TRANSPARENT_FRAMES; frame++)
+		{
+			//Every draw drifts a little, its depth is its source
+			queue.Clear();
+			for (size_t d = 0; d < depths.size(); d++)
+			{
+				float depth = depths[d] + sinf(frame * 0.05f + d) * 0.5f;
+				queue.Add(RenderQueue::MakeTransparentKey(0, 0, 0, 0, 0, RenderQueue::QuantizeDepth(depth, farClip)),
+					(uint32_t)d, &depths[d]);
+			}
+			queue.Sort();
+			if (queue.GetTransparentCoherent())
+				coherentFrames[i]++;
+		}
+		times[i] = ElapsedMilliseconds(start) / BENCHMARK_TRANSPARENT_FRAMES;
+
+		const RenderQueueEntry* entries = queue.GetEntries();
+		for (size_t e = 1; e < queue.GetCount(); e++)
+			sorted = sorted && entries[e - 1].key <= entries[e].key;
+	}
+
+	const char* names[] = { "Radix sort", "Last order" };
+	for (int i = 0; i < 2; i++)
+	{
+		printf("%-10s: %8.3f ms per frame for %d transparent draws (%d of %d frames insertion sorted)\n",
+			names[i], times[i], BENCHMARK_TRANSPARENT_COUNT, coherentFrames[i], BENCHMARK_TRANSPARENT_FRAMES);
+	}
+	if (!sorted)
+		printf("The transparent pass was not sorted farthest first\n");
+}
+
+// Count the heap allocations of drawing frames after the arenas have grown to fit
+void BenchmarkFrameAllocations(const std::function<void()>& drawFrame)
+{
+	//Both frame arenas fit the scene after a frame each
+	for (int frame = 0; frame < 4; frame++)
+		drawFrame();
+
+	uint64_t allocationsAtStart = GetAllocationCount();
+	auto start = chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < BENCHMARK_RENDER_FRAMES; frame++)
+		drawFrame();
+	double time = ElapsedMilliseconds(start) / BENCHMARK_RENDER_FRAMES;
+	uint64_t allocations = GetAllocationCount() - allocationsAtStart;
+
+	FrameArenaStats stats = Renderer::GetInstance()->GetFrameArenaStats();
+	printf("%8.3f ms per frame, %zu of %zu frame arena bytes used (%zu overflowed, grown %zu times)\n",
+		time, stats.used, stats.capacity, stats.overflow, stats.grows);
+	if (IsCountingAllocations())
+		printf("%.2f heap allocations per frame\n", (double)allocations / BENCHMARK_RENDER_FRAMES);
+	else
+		printf("Heap allocations are only counted in builds with ALLOCATION_COUNTING defined\n");
+}
\ No newline at end of file
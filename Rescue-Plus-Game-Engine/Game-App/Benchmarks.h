@@ -0,0 +1,119 @@
+#pragma once
+#include <functional>
+
+struct ID3D11Device;
+class StaticBatches;
+class Camera;
+
+//Builds with ENGINE_BENCHMARKS defined run the benchmarks from keys in
+// the game. Debug builds define it, they have a console to print to
+#if !defined(ENGINE_BENCHMARKS) && (defined(DEBUG) || defined(_DEBUG))
+#define ENGINE_BENCHMARKS
+#endif
+
+// --------------------------------------------------------
+// Debug benchmarks for engine systems.
+//
+// Each benchmark builds its own test data, prints its
+// timings to the console and cleans up after itself
+// --------------------------------------------------------
+
+// --------------------------------------------------------
+// Time GetComponent<T>() on GameObjects with 1, 8 and 32
+// components against the old dynamic_cast scan
+// --------------------------------------------------------
+void BenchmarkComponentLookup();
+
+
+// --------------------------------------------------------
+// Time spawning physics objects one at a time against
+// instantiating them from a prefab in one batch
+// --------------------------------------------------------
+void BenchmarkPrefabSpawn();
+
+// --------------------------------------------------------
+// Time firing short lived physics objects by creating and
+// removing them against recycling them through an object pool
+// --------------------------------------------------------
+void BenchmarkObjectPool();
+
+// --------------------------------------------------------
+// Time syncing and querying the spatial index with 100k
+// moving GameObjects against scanning every entity
+// --------------------------------------------------------
+void BenchmarkSpatialIndex();
+
+// --------------------------------------------------------
+// Time updating a crowd every frame against updating it
+// with distance based update rates
+// --------------------------------------------------------
+void BenchmarkUpdateLod();
+
+// --------------------------------------------------------
+// Time building 50k objects in code against loading
+// them from a binary scene file
+// --------------------------------------------------------
+void BenchmarkSceneLoad();
+
+// --------------------------------------------------------
+// Fly a viewer across a world of streamed cells and report
+// streaming latency and the cost of activating cells per frame
+// --------------------------------------------------------
+void BenchmarkWorldStreaming(ID3D11Device* device);
+
+// --------------------------------------------------------
+// Draw many objects in front of the camera through the D3D11
+// device, a recording device and the null device, and report
+// the CPU time per frame and the draw calls and state changes sent
+//
+// camera - the objects are spawned in front of it
+// drawFrame - draws one frame with the renderer
+// --------------------------------------------------------
+void BenchmarkRenderRecording(Camera* camera, const std::function<void()>& drawFrame);
+
+// --------------------------------------------------------
+// Draw the current scene with the render queue in render
+// list order, sorted by key, and sorted with runs of the
+// same material and mesh instanced, and report the draw
+// calls and state changes each sends per frame
+//
+// drawFrame - draws one frame with the renderer
+// --------------------------------------------------------
+void BenchmarkRenderQueue(const std::function<void()>& drawFrame);
+
+// --------------------------------------------------------
+// Draw the current scene with the static renderers on
+// their own and merged into static batches, and report the
+// draw calls and buffer updates each sends per frame
+//
+// staticBatches - the scene's static batches
+// drawFrame - draws one frame with the renderer
+// --------------------------------------------------------
+void BenchmarkStaticBatching(StaticBatches* staticBatches, const std::function<void()>& drawFrame);
+
+// --------------------------------------------------------
+// Draw many objects in front of the camera without
+// instancing, with the camera passes recorded on one thread
+// and in parallel chunks. Reports the time per frame and
+// checks both send the same draws to a recording device
+//
+// camera - the objects are spawned in front of it
+// drawFrame - draws one frame with the renderer
+// --------------------------------------------------------
+void BenchmarkCommandRecording(Camera* camera, const std::function<void()>& drawFrame);
+
+// --------------------------------------------------------
+// Time sorting a transparent pass that changes a little
+// every frame with a radix sort against insertion sorting
+// it from the last frame's order
+// --------------------------------------------------------
+void BenchmarkTransparentSort();
+
+// --------------------------------------------------------
+// Draw the current scene and count the heap allocations
+// of steady state frames, with how much of its frame arena
+// each frame used
+//
+// drawFrame - draws one frame with the renderer
+// --------------------------------------------------------
+void BenchmarkFrameAllocations(const std::function<void()>& drawFrame);
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <WindowsX.h>
 #include <sstream>
+#include "ChangeVersion.h"
+#include "Renderer.h"
 
 // Define the static instance variable so our OS-level 
 // message handling function below can talk to our object
@@ -384,6 +386,9 @@ HRESULT DXCore::Run()
 				if (titleBarStats)
 					UpdateTitleBarStats();
 
+				//Start a new frame for change tracking
+				AdvanceFrameVersion();
+
 				//Fixed update
 				static float accumulator = 0.0f;
 				accumulator += deltaTime;
@@ -456,6 +461,8 @@ void DXCore::UpdateFps()
 //  - The window's width & height
 //  - The current FPS and ms/frame
 //  - The version of DirectX actually being used (usually 11)
+//  - The draws the last frame culled
+//  - The binds the state cache sent and skipped
 // --------------------------------------------------------
 void DXCore::UpdateTitleBarStats()
 {
@@ -489,6 +496,18 @@ void DXCore::UpdateTitleBarStats()
 	default:                     output << "    DX ???";  break;
 	}
 
+	// Append what culling skipped last frame
+	CullingStats culling = Renderer::GetInstance()->GetCullingStats();
+	output << "    Visible: " << culling.cameraVisible <<
+		"    Culled: " << culling.cameraCulled <<
+		"    Shadow Visible: " << culling.shadowVisible <<
+		"    Shadow Culled: " << culling.shadowCulled;
+
+	// Append the binds the state cache sent and dropped last frame
+	StateCacheStats stateCache = Renderer::GetInstance()->GetStateCacheStats();
+	output << "    Binds: " << stateCache.issued <<
+		"    Skipped: " << stateCache.skipped;
+
 	// Actually update the title bar and reset fps data
 	SetWindowText(hWnd, output.str().c_str());
 	fps = 0;
@@ -25,6 +25,8 @@ private:
 	void Movement(float deltaTime);
 
 public:
+	typedef ComponentLookupBases<DebugMovement, UserComponent> LookupBases;
+
 	// --------------------------------------------------------
 	// Constructor - Set up the debug camera
 	// (Remember to create the projection matrix right after!)
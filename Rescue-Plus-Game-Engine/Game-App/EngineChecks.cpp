@@ -0,0 +1,182 @@
+#include "EngineChecks.h"
+#include <cstdio>
+#include "GameObject.h"
+#include "EntityManager.h"
+#include "SpatialIndex.h"
+#include "FrameArena.h"
+#include "RenderQueue.h"
+
+//A user component other user components derive from
+class CheckIntermediate : public UserComponent
+{
+public:
+	typedef ComponentLookupBases<CheckIntermediate, UserComponent> LookupBases;
+
+	CheckIntermediate(GameObject* gameObject) : UserComponent(gameObject) { }
+};
+
+//A user component that is only looked up by its bases
+class CheckDerived : public CheckIntermediate
+{
+public:
+	typedef ComponentLookupBases<CheckDerived, CheckIntermediate> LookupBases;
+
+	CheckDerived(GameObject* gameObject) : CheckIntermediate(gameObject) { }
+};
+
+// Print the result of a check
+static bool Check(bool passed, const char* name)
+{
+	printf("%s: %s\n", passed ? "PASS" : "FAIL", name);
+	return passed;
+}
+
+// Look up a derived user component by each class it derives from
+static bool CheckComponentLookupBases()
+{
+	GameObject* obj = new GameObject("CheckLookupBases");
+	CheckDerived* derived = obj->AddComponent<CheckDerived>();
+
+	bool passed = true;
+	passed &= Check(obj->GetComponent<CheckDerived>() == derived, "GetComponent finds a component by its own type");
+	passed &= Check(obj->GetComponent<CheckIntermediate>() == derived, "GetComponent finds a component by an intermediate base");
+	passed &= Check(obj->GetComponent<UserComponent>() == derived, "GetComponent finds a component by UserComponent");
+
+	EntityManager::GetInstance()->RemoveEntity(obj);
+	return passed;
+}
+
+// Check a moved object is reported as changed once per read, by queries and the change log
+static bool CheckChangedTransforms()
+{
+	EntityManager* entityManager = EntityManager::GetInstance();
+	GameObject* obj = new GameObject("CheckChanged");
+	size_t reader = entityManager->AddTransformReader();
+	ChangeVersion lastSeen = 0;
+
+	//How many times the object is reported by a query since the last read
+	auto queryChanged = [&]() {
+		ChangeVersion seen = ObserveChanges();
+		int reported = 0;
+		entityManager->ForEach<Changed<Transform>>(lastSeen, [&](GameObject* e) { reported += e == obj; });
+		lastSeen = seen;
+		return reported;
+	};
+
+	//How many times the object is read from the change log
+	auto readChanged = [&]() {
+		int reported = 0;
+		entityManager->ReadTransformChanges(reader, [&](GameObject* e) { reported += e == obj; });
+		return reported;
+	};
+
+	bool passed = true;
+	obj->SetPosition(1, 2, 3);
+	obj->SetScale(2, 2, 2);
+	passed &= Check(queryChanged() == 1, "A moved object is reported as changed");
+	passed &= Check(queryChanged() == 0, "An unchanged object is not reported twice");
+	passed &= Check(readChanged() == 1, "A moved object is read from the change log once");
+	passed &= Check(readChanged() == 0, "An unchanged object is not read from the change log twice");
+
+	//Changes right after a read are newer than it, even in the same frame
+	obj->SetPosition(4, 5, 6);
+	passed &= Check(queryChanged() == 1, "An object moved after a query is reported again");
+	passed &= Check(readChanged() == 1, "An object moved after a read is read again");
+
+	entityManager->RemoveTransformReader(reader);
+	entityManager->RemoveEntity(obj);
+	return passed;
+}
+
+// Check the spatial index follows a moved object, and unbounded queries still find it
+static bool CheckSpatialIndex()
+{
+	SpatialIndex* spatialIndex = SpatialIndex::GetInstance();
+	GameObject* obj = new GameObject("CheckSpatial");
+	obj->SetPosition(10000, -10000, 10000);
+	spatialIndex->Sync();
+
+	GameObject* results[64];
+	auto found = [&](size_t count) {
+		for (size_t i = 0; i < count && i < 64; i++)
+		{
+			if (results[i] == obj)
+				return true;
+		}
+		return false;
+	};
+
+	bool passed = true;
+	passed &= Check(found(spatialIndex->QuerySphere(DirectX::XMFLOAT3(10000, -10000, 10000), 1, results, 64)),
+		"The spatial index finds a new object");
+
+	obj->SetPosition(-10000, -10000, -10000);
+	spatialIndex->Sync();
+	passed &= Check(found(spatialIndex->QuerySphere(DirectX::XMFLOAT3(-10000, -10000, -10000), 1, results, 64)),
+		"The spatial index finds a moved object where it moved to");
+	passed &= Check(!found(spatialIndex->QuerySphere(DirectX::XMFLOAT3(10000, -10000, 10000), 1, results, 64)),
+		"The spatial index does not find a moved object where it was");
+
+	//A default frustum has no bounds, so this scans every object
+	size_t count = spatialIndex->QueryFrustum(Frustum(), nullptr, 0);
+	passed &= Check(count == spatialIndex->GetCount(), "An unbounded frustum query finds every object");
+
+	EntityManager::GetInstance()->RemoveEntity(obj);
+	return passed;
+}
+
+// Check frame arenas grow to fit a frame that overflowed, and threads keep their block in each arena
+static bool CheckFrameArenas()
+{
+	bool passed = true;
+
+	//The overflow moved the offset too, so the arena only has to fit the frame once
+	{
+		FrameArena arena(1024);
+		arena.Allocate(4096, 16);
+		arena.Reset();
+		passed &= Check(arena.GetStats().capacity == 8192, "A frame arena grows to fit a frame that overflowed");
+	}
+
+	//Alternating between arenas keeps allocating from the same blocks
+	{
+		FrameArena first(1024 * 1024);
+		FrameArena second(1024 * 1024);
+		unsigned char* a = (unsigned char*)first.AllocateLocal(16, 16);
+		unsigned char* b = (unsigned char*)second.AllocateLocal(16, 16);
+		unsigned char* c = (unsigned char*)first.AllocateLocal(16, 16);
+		unsigned char* d = (unsigned char*)second.AllocateLocal(16, 16);
+		passed &= Check(c == a + 16 && d == b + 16, "A thread alternating between arenas keeps its blocks");
+	}
+
+	return passed;
+}
+
+// Check render queue ids start over after a reset
+static bool CheckRenderQueueIds()
+{
+	bool passed = true;
+	RenderQueue queue;
+	int first, second;
+	queue.GetMeshId(&first);
+	uint32_t id = queue.GetMeshId(&second);
+	queue.ResetIds();
+	passed &= Check(queue.GetMeshId(&second) == 0 && id == 1, "Render queue ids start over after a reset");
+	return passed;
+}
+
+// Run every check
+bool RunEngineChecks()
+{
+	printf("Engine checks\n");
+
+	bool passed = true;
+	passed &= CheckComponentLookupBases();
+	passed &= CheckChangedTransforms();
+	passed &= CheckSpatialIndex();
+	passed &= CheckFrameArenas();
+	passed &= CheckRenderQueueIds();
+
+	printf("Engine checks %s\n", passed ? "passed" : "failed");
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+// --------------------------------------------------------
+// Engine checks run by the Headless configuration.
+//
+// Each check builds its own test data, prints what it
+// tested and cleans up after itself. They need the engine
+// singletons, so run them while a game is alive
+// --------------------------------------------------------
+
+// --------------------------------------------------------
+// Run every check
+// returns true if they all passed
+// --------------------------------------------------------
+bool RunEngineChecks();
\ No newline at end of file
@@ -40,7 +40,7 @@ FirstPersonMovement::FirstPersonMovement(GameObject* gameObject) : UserComponent
 
 	controller = gameObject->GetComponent<CharacterController>();
 
-	auto children = gameObject->GetChildren();
+	const auto& children = gameObject->GetChildren();
 
 	//Get Camera
 	camera = children[0]->GetComponent<Camera>();
@@ -97,6 +97,8 @@ private:
 	void CalculateCameraRotFromMouse(float deltaTime);
 	
 public:
+	typedef ComponentLookupBases<FirstPersonMovement, UserComponent> LookupBases;
+
 	FirstPersonMovement(GameObject* gameObject);
 	~FirstPersonMovement();
 
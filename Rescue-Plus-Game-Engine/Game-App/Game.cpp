@@ -6,6 +6,7 @@
 #include "JobSystem.h"
 #include "Raycast.h"
 #include "PerlinNoise.h"
+#include "UpdateLod.h"
 
 // For the DirectX Math library
 using namespace DirectX;
@@ -33,6 +34,9 @@ Game::Game(HINSTANCE hInstance)
 	printf("Console window created successfully.  Feel free to printf() here.\n");
 #endif
 
+	boxPrefab = nullptr;
+	world = nullptr;
+	staticBatches = nullptr;
 }
 
 // --------------------------------------------------------
@@ -42,6 +46,13 @@ Game::Game(HINSTANCE hInstance)
 // --------------------------------------------------------
 Game::~Game()
 {
+	//Finish the frame being drawn before anything it uses is released
+	renderer->WaitForDraw();
+
+	//Remove streamed cells before the entities are released
+	delete world;
+	delete staticBatches;
+
 	//Release singletons
 	entityManager->Release();
 	lightManager->Release();
@@ -54,6 +65,8 @@ Game::~Game()
 	samplerState->Release();
 	shadowSampler->Release();
 
+	delete boxPrefab;
+
 	//Release jobs system
 	JobSystem::Release();
 }
@@ -141,6 +154,13 @@ void Game::Init()
 	//Setup the scene
 	SetupScene();
 
+	//Merge the static scenery into a few draws
+	staticBatches = new StaticBatches(device, context);
+
+	//Stream in any world cells around the camera
+	world = new WorldPartition(device);
+	world->AddCellsFromDirectory("Assets/World");
+
 	//Set new gravity
 	physicsManager->SetGravity(-15.0f);
 
@@ -163,9 +183,15 @@ void Game::Init()
 // --------------------------------------------------------
 void Game::OnResize()
 {
+	//The render thread may still be drawing to the old buffers
+	renderer->WaitForDraw();
+
 	// Handle base-level DX resize stuff
 	DXCore::OnResize();
 
+	//The new targets were bound to the context directly
+	renderer->InvalidateStateCache();
+
 	// Update our projection matrix since the window size changed
 	camera->SetAspectRatio((float)width / height);
 }
@@ -195,7 +221,11 @@ void Game::Update(float deltaTime, float totalTime)
 {
 	inputManager->UpdateFocus();
 	if (!inputManager->IsWindowFocused())
+	{
+		//Keep drawing the paused scene
+		renderer->ExtractFrame(camera, deltaTime);
 		return;
+	}
 
 	//The only call to UpdateMousePos() for the InputManager
 	//Get the current mouse position
@@ -208,21 +238,18 @@ void Game::Update(float deltaTime, float totalTime)
 	if (inputManager->GetKey(Key::Escape))
 		Quit();
 
+	//Far away and offscreen components update less often
+	UpdateLodViewer::GetInstance()->SetViewer(camera->gameObject()->GetPosition(),
+		Frustum(camera->GetRawViewMatrix(), camera->GetRawProjectionMatrix()));
+
+	//Stream world cells in and out
+	world->Update(camera->gameObject()->GetPosition());
+
 	//Update all entities
 	entityManager->Update(deltaTime);
 
 	if (inputManager->GetKey(Key::G))
-	{
-		GameObject* box4 = new GameObject("Box4");
-		box4->AddComponent<MeshRenderer>(
-			resourceManager->GetMesh("Assets\\Models\\Basic\\cube.obj"),
-			resourceManager->GetMaterial("white")
-			);
-		box4->MoveAbsolute(XMFLOAT3(0, 8, 8));
-		box4->SetScale(1, 2, 2);
-		box4->AddComponent<RigidBody>(1.0f);
-		box4->AddComponent<BoxCollider>(box4->GetScale());
-	}
+		boxPrefab->Instantiate(XMFLOAT3(0, 8, 8));
 
 	if (inputManager->GetKey(Key::T))
 	{
@@ -259,6 +286,10 @@ void Game::Update(float deltaTime, float totalTime)
 		}
 	}
 
+	//Benchmarks
+#ifdef ENGINE_BENCHMARKS
+	UpdateBenchmarks(deltaTime);
+#endif
 
 	//All game code goes above
 	// --------------------------------------------------------
@@ -269,20 +300,67 @@ void Game::Update(float deltaTime, float totalTime)
 
 	//Delete finished jobs
 	JobSystem::DeleteFinishedJobs();
+
+	//Copy what this frame draws out of the scene
+	renderer->ExtractFrame(camera, deltaTime);
 }
 
+#ifdef ENGINE_BENCHMARKS
+// --------------------------------------------------------
+// Run a benchmark when its key is pressed
+// --------------------------------------------------------
+void Game::UpdateBenchmarks(float deltaTime)
+{
+	//Draws one frame with the renderer
+	auto drawFrame = [this, deltaTime]() {
+		renderer->ExtractFrame(camera, deltaTime);
+		renderer->Draw(context, device, backBufferRTV, depthStencilView, samplerState, width, height);
+	};
+
+	if (inputManager->GetKeyDown(Key::One))
+		BenchmarkComponentLookup();
+	if (inputManager->GetKeyDown(Key::Two))
+		BenchmarkPrefabSpawn();
+	if (inputManager->GetKeyDown(Key::Three))
+		BenchmarkObjectPool();
+	if (inputManager->GetKeyDown(Key::Four))
+		BenchmarkSpatialIndex();
+	if (inputManager->GetKeyDown(Key::Five))
+		BenchmarkUpdateLod();
+	if (inputManager->GetKeyDown(Key::Six))
+		BenchmarkSceneLoad();
+	if (inputManager->GetKeyDown(Key::Seven))
+		BenchmarkWorldStreaming(device);
+	if (inputManager->GetKeyDown(Key::Eight))
+		BenchmarkRenderRecording(camera, drawFrame);
+	if (inputManager->GetKeyDown(Key::Nine))
+		BenchmarkRenderQueue(drawFrame);
+	if (inputManager->GetKeyDown(Key::Zero))
+		BenchmarkStaticBatching(staticBatches, drawFrame);
+	if (inputManager->GetKeyDown(Key::B))
+		BenchmarkCommandRecording(camera, drawFrame);
+	if (inputManager->GetKeyDown(Key::C))
+		BenchmarkTransparentSort();
+	if (inputManager->GetKeyDown(Key::P))
+		BenchmarkFrameAllocations(drawFrame);
+}
+#endif
+
 // --------------------------------------------------------
 // Clear the screen, redraw everything, present to the user
 // --------------------------------------------------------
 void Game::Draw(float deltaTime, float totalTime)
 {
-	//Draw all entities in the renderer
-	renderer->Draw(context, device, camera, backBufferRTV, depthStencilView, samplerState, width, height, deltaTime);
+	//Finish drawing the last frame
+	renderer->WaitForDraw();
 
 	// Present the back buffer to the user
 	//  - Puts the final frame we're drawing into the window so the user can see it
 	//  - Do this exactly ONCE PER FRAME (always at the very end of the frame)
 	swapChain->Present(0, 0);
+
+	//Draw this frame on the render thread while the next one updates
+	renderer->BeginDraw(context, device, backBufferRTV, depthStencilView, samplerState, width, height);
 }
 
 
@@ -9,6 +9,10 @@
 #include "PhysicsManager.h"
 #include "LightManager.h"
 #include "FirstPersonMovement.h"
+#include "Prefab.h"
+#include "WorldPartition.h"
+#include "StaticBatches.h"
+#include "Benchmarks.h"
 
 class Game 
 	: public DXCore
@@ -55,9 +59,17 @@ private:
 	GameObject* crate10C;
 	GameObject* trigger;
 	FirstPersonMovement* player;
+	Prefab* boxPrefab;
+	WorldPartition* world;
+	StaticBatches* staticBatches;
 
 	// Initialization helper methods - feel free to customize, combine, etc.
 	void LoadAssets();
 	void SetupScene();
+
+#ifdef ENGINE_BENCHMARKS
+	// Run a benchmark when its key is pressed
+	void UpdateBenchmarks(float deltaTime);
+#endif
 };
 
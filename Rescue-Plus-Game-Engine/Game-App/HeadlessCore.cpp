@@ -0,0 +1,160 @@
+#include "HeadlessCore.h"
+
+#include <thread>
+#include "ChangeVersion.h"
+#include "AllocationCounter.h"
+
+using namespace std;
+
+// --------------------------------------------------------
+// Constructor - Set up fields
+//
+// fixedUpdateStepSize - Length of a fixed update in seconds
+// frameStepSize - Length of a frame in seconds
+// realtime - Pace frames to the wall clock instead of
+//		running them back to back
+// --------------------------------------------------------
+HeadlessCore::HeadlessCore(float fixedUpdateStepSize, float frameStepSize, bool realtime)
+	: fixedUpdateStepSize(fixedUpdateStepSize), frameStepSize(frameStepSize), realtime(realtime)
+{
+	running = false;
+	totalTime = 0.0f;
+	deltaTime = 0.0f;
+
+	frameCount = 0;
+	ResetFrameStats();
+}
+
+// --------------------------------------------------------
+// Destructor
+// --------------------------------------------------------
+HeadlessCore::~HeadlessCore()
+{ }
+
+// --------------------------------------------------------
+// Run the game loop until Quit() is called or the frame
+// limit is reached (0 runs until Quit())
+// --------------------------------------------------------
+int HeadlessCore::Run(uint64_t maxFrames)
+{
+	// Give subclass a chance to initialize
+	Init();
+
+	// Grab the start time now that
+	// the game loop is running
+	startTime = Clock::now();
+	previousTime = startTime;
+	running = true;
+
+	float accumulator = 0.0f;
+	while (running && (maxFrames == 0 || frameCount < maxFrames))
+	{
+		Clock::time_point frameStart = Clock::now();
+		uint64_t allocationsAtStart = GetAllocationCount();
+		UpdateTimer();
+
+		//Start a new frame for change tracking
+		AdvanceFrameVersion();
+
+		//Fixed update
+		accumulator += deltaTime;
+		while (accumulator >= fixedUpdateStepSize)
+		{
+			accumulator -= fixedUpdateStepSize;
+			FixedUpdate(fixedUpdateStepSize, totalTime);
+		}
+
+		// The normal game loop
+		Update(deltaTime, totalTime);
+
+		//Frame stats
+		double ms = chrono::duration<double, milli>(Clock::now() - frameStart).count();
+		frameMilliseconds += ms;
+		if (ms > maxFrameMilliseconds)
+			maxFrameMilliseconds = ms;
+		uint64_t allocations = GetAllocationCount() - allocationsAtStart;
+		frameAllocations += allocations;
+		if (allocations > maxFrameAllocations)
+			maxFrameAllocations = allocations;
+		frameCount++;
+		statsFrameCount++;
+
+		//Wait for the next frame
+		if (realtime)
+		{
+			this_thread::sleep_until(frameStart +
+				chrono::duration_cast<Clock::duration>(chrono::duration<float>(frameStepSize)));
+		}
+	}
+
+	running = false;
+	return 0;
+}
+
+// --------------------------------------------------------
+// Stop the game loop after the current frame
+// --------------------------------------------------------
+void HeadlessCore::Quit()
+{
+	running = false;
+}
+
+// --------------------------------------------------------
+// Advance the game clock. Realtime runs use the wall clock,
+// other runs step it by exactly one frame
+// --------------------------------------------------------
+void HeadlessCore::UpdateTimer()
+{
+	if (realtime)
+	{
+		Clock::time_point now = Clock::now();
+		deltaTime = chrono::duration<float>(now - previousTime).count();
+		totalTime = chrono::duration<float>(now - startTime).count();
+		previousTime = now;
+	}
+	else
+	{
+		deltaTime = frameStepSize;
+		totalTime += deltaTime;
+	}
+}
+
+// Get the amount of frames run so far
+uint64_t HeadlessCore::GetFrameCount()
+{
+	return frameCount;
+}
+
+// Get the average time a frame took to run in milliseconds
+double HeadlessCore::GetAverageFrameMilliseconds()
+{
+	return statsFrameCount == 0 ? 0 : frameMilliseconds / statsFrameCount;
+}
+
+// Get the longest time a frame took to run in milliseconds
+double HeadlessCore::GetMaxFrameMilliseconds()
+{
+	return maxFrameMilliseconds;
+}
+
+// Get the heap allocations made during frames
+uint64_t HeadlessCore::GetFrameAllocations()
+{
+	return frameAllocations;
+}
+
+// Get the most heap allocations made in one frame
+uint64_t HeadlessCore::GetMaxFrameAllocations()
+{
+	return maxFrameAllocations;
+}
+
+// Reset the frame timings and allocation counts
+void HeadlessCore::ResetFrameStats()
+{
+	statsFrameCount = 0;
+	frameMilliseconds = 0;
+	maxFrameMilliseconds = 0;
+	frameAllocations = 0;
+	maxFrameAllocations = 0;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// --------------------------------------------------------
+// Game loop without a window or a graphics device.
+//
+// Runs the same FixedUpdate/Update loop as DXCore but times
+// it with std::chrono, so it can drive the entity, physics
+// and job systems on a server or in a benchmark run.
+//
+// In realtime mode frames are paced to the frame step like a
+// normal game. Otherwise every frame advances the game clock by
+// exactly one frame step and the loop runs as fast as it can,
+// which makes runs repeatable
+// --------------------------------------------------------
+class HeadlessCore
+{
+public:
+	HeadlessCore(
+		float fixedUpdateStepSize,	// Length of a fixed update (Ex: 1/60)
+		float frameStepSize,		// Length of a frame (Ex: 1/60)
+		bool realtime);				// Pace frames to the wall clock?
+	virtual ~HeadlessCore();
+
+	// --------------------------------------------------------
+	// Run the game loop until Quit() is called or the frame
+	// limit is reached (0 runs until Quit())
+	// --------------------------------------------------------
+	int Run(uint64_t maxFrames = 0);
+
+	// --------------------------------------------------------
+	// Stop the game loop after the current frame
+	// --------------------------------------------------------
+	void Quit();
+
+	// Pure virtual methods for setup and game functionality
+	virtual void Init()										= 0;
+	virtual void FixedUpdate(float constantStepSize, float totalTime) = 0;
+	virtual void Update(float deltaTime, float totalTime)	= 0;
+
+protected:
+	// --------------------------------------------------------
+	// Get the amount of frames run so far
+	// --------------------------------------------------------
+	uint64_t GetFrameCount();
+
+	// --------------------------------------------------------
+	// Get the average and longest time a frame took to
+	// run (not counting the time spent waiting) in milliseconds
+	// --------------------------------------------------------
+	double GetAverageFrameMilliseconds();
+	double GetMaxFrameMilliseconds();
+
+	// --------------------------------------------------------
+	// Get the heap allocations made during frames and the most
+	// made in one frame (always 0 unless the build defines
+	// ALLOCATION_COUNTING)
+	// --------------------------------------------------------
+	uint64_t GetFrameAllocations();
+	uint64_t GetMaxFrameAllocations();
+
+	// --------------------------------------------------------
+	// Reset the frame timings and allocation counts, so they
+	// only cover the frames after this one
+	// --------------------------------------------------------
+	void ResetFrameStats();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	const float fixedUpdateStepSize;
+	const float frameStepSize;
+	const bool realtime;
+	bool running;
+
+	// Timing related data
+	float totalTime;
+	float deltaTime;
+	Clock::time_point startTime;
+	Clock::time_point previousTime;
+
+	// Frame stats
+	uint64_t frameCount;
+	uint64_t statsFrameCount;
+	double frameMilliseconds;
+	double maxFrameMilliseconds;
+	uint64_t frameAllocations;
+	uint64_t maxFrameAllocations;
+
+	void UpdateTimer();		// Updates the game clock for this frame
+};
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "HeadlessGame.h"
+#include <ctime>
+#include "JobSystem.h"
+#include "Collider.h"
+#include "RigidBody.h"
+#include "AllocationCounter.h"
+
+using namespace DirectX;
+using namespace std;
+
+//Fixed update and frame rate of a headless run
+#define HEADLESS_STEP_SIZE (1.0f / 60)
+//Boxes dropped per second
+#define HEADLESS_SPAWN_RATE 120.0f
+//Time to let the pool recycle boxes before frames count as steady state
+#define HEADLESS_WARMUP_TIME 2.0f
+
+// Get a random float between min and max
+static float RandomRange(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+// --------------------------------------------------------
+// Constructor
+//
+// realtime - Pace frames to the wall clock?
+// maxBoxes - Amount of boxes alive at once
+// checkAllocations - Count heap allocations in steady state frames?
+// --------------------------------------------------------
+HeadlessGame::HeadlessGame(bool realtime, size_t maxBoxes, bool checkAllocations)
+	: HeadlessCore(HEADLESS_STEP_SIZE, HEADLESS_STEP_SIZE, realtime)
+{
+	entityManager = nullptr;
+	physicsManager = nullptr;
+	floor = nullptr;
+	boxPrefab = nullptr;
+	boxPool = nullptr;
+
+	boxes.resize(maxBoxes);
+	nextBox = 0;
+	spawnTimer = 0;
+	statsTimer = 0;
+
+	this->checkAllocations = checkAllocations;
+	steadyState = false;
+	steadyStateFrame = 0;
+	steadyStateShots = 0;
+	shotAllocations = 0;
+}
+
+// --------------------------------------------------------
+// Destructor - Release the singletons and the job system
+// --------------------------------------------------------
+HeadlessGame::~HeadlessGame()
+{
+	//Release singletons
+	entityManager->Release();
+	physicsManager->Release();
+
+	delete boxPool;
+	delete boxPrefab;
+
+	//Release jobs system
+	JobSystem::Release();
+}
+
+// --------------------------------------------------------
+// Called once before the game loop
+// --------------------------------------------------------
+void HeadlessGame::Init()
+{
+	//Seed the box positions so runs are repeatable
+	srand(0);
+
+	//Initialize job system
+	JobSystem::Init();
+
+	//Initialize singletons
+	entityManager = EntityManager::GetInstance();
+	physicsManager = PhysicsManager::GetInstance();
+	physicsManager->SetGravity(-15.0f);
+
+	//Create the floor
+	floor = new GameObject("Floor");
+	floor->MoveAbsolute(XMFLOAT3(0, -2, 0));
+	floor->SetScale(200, 1, 200);
+	floor->AddComponent<BoxCollider>(floor->GetScale());
+
+	//Boxes dropped onto the floor
+	boxPrefab = new Prefab("Box", XMFLOAT3(1, 1, 1));
+	boxPrefab->AddComponent<RigidBody>(1.0f);
+	boxPrefab->AddComponent<BoxCollider>(XMFLOAT3(1, 1, 1));
+	boxPool = new ObjectPool(boxPrefab);
+	boxPool->Prewarm(boxes.size());
+
+	//Clear loading jobs
+	JobSystem::DeleteFinishedJobs();
+
+	printf("Headless run with up to %zu boxes\n", boxes.size());
+}
+
+// --------------------------------------------------------
+// Update physics at a fixed time interval
+// --------------------------------------------------------
+void HeadlessGame::FixedUpdate(float constantStepSize, float totalTime)
+{
+	//Update physics
+	physicsManager->Simulate(constantStepSize);
+
+	//FixedUpdate entities
+	entityManager->FixedUpdate(constantStepSize);
+
+	//Delete finished jobs
+	JobSystem::DeleteFinishedJobs();
+}
+
+// --------------------------------------------------------
+// Spawn boxes and update every entity
+// --------------------------------------------------------
+void HeadlessGame::Update(float deltaTime, float totalTime)
+{
+	//Drop boxes at a steady rate
+	spawnTimer += deltaTime * HEADLESS_SPAWN_RATE;
+	while (spawnTimer >= 1.0f)
+	{
+		spawnTimer -= 1.0f;
+		SpawnBox();
+	}
+
+	//Update all entities
+	entityManager->Update(deltaTime);
+
+	//Every box has been spawned and recycled for a while,
+	// only count frame stats from here on
+	if (checkAllocations && !steadyState &&
+		totalTime >= boxes.size() / HEADLESS_SPAWN_RATE + HEADLESS_WARMUP_TIME)
+	{
+		steadyState = true;
+		steadyStateFrame = GetFrameCount();
+		ResetFrameStats();
+		printf("Steady state from frame %llu, counting allocations\n", (unsigned long long)steadyStateFrame);
+	}
+
+	//Print stats once per second of game time
+	statsTimer += deltaTime;
+	if (statsTimer >= 1.0f)
+	{
+		statsTimer -= 1.0f;
+		PrintStats();
+	}
+
+	//Delete finished jobs
+	JobSystem::DeleteFinishedJobs();
+}
+
+// --------------------------------------------------------
+// Drop a box, recycling the oldest one if they are all in use
+// --------------------------------------------------------
+void HeadlessGame::SpawnBox()
+{
+	if (boxes.empty())
+		return;
+
+	XMFLOAT3 pos(RandomRange(-20, 20), RandomRange(5, 25), RandomRange(-20, 20));
+	uint64_t allocationsAtStart = GetAllocationCount();
+
+	GameObject* oldest = entityManager->GetEntity(boxes[nextBox]);
+	if (oldest != nullptr)
+		boxPool->Release(oldest);
+
+	boxes[nextBox] = boxPool->Acquire(pos)->GetHandle();
+	nextBox = (nextBox + 1) % boxes.size();
+
+	if (steadyState)
+	{
+		shotAllocations += GetAllocationCount() - allocationsAtStart;
+		steadyStateShots++;
+	}
+}
+
+// --------------------------------------------------------
+// Print the frame timings and pool counters
+// --------------------------------------------------------
+void HeadlessGame::PrintStats()
+{
+	ObjectPoolStats stats = boxPool->GetStats();
+	printf("Frame %llu: %.3f ms avg, %.3f ms max | boxes created %zu, reused %zu\n",
+		(unsigned long long)GetFrameCount(), GetAverageFrameMilliseconds(), GetMaxFrameMilliseconds(),
+		stats.instantiated, stats.reused);
+	if (IsCountingAllocations())
+	{
+		printf("\t%llu allocations, %llu max in one frame\n",
+			(unsigned long long)GetFrameAllocations(), (unsigned long long)GetMaxFrameAllocations());
+	}
+}
+
+// --------------------------------------------------------
+// Print the allocations made in steady state frames
+// returns true if there were none
+// --------------------------------------------------------
+bool HeadlessGame::CheckAllocations()
+{
+	if (!IsCountingAllocations())
+	{
+		printf("Allocation check FAILED: build with ALLOCATION_COUNTING defined to count allocations\n");
+		return false;
+	}
+	if (!steadyState)
+	{
+		printf("Allocation check FAILED: the run ended before reaching a steady state (frame %llu)\n",
+			(unsigned long long)GetFrameCount());
+		return false;
+	}
+
+	uint64_t allocations = GetFrameAllocations();
+	printf("Allocation check %s: %llu allocations in %llu steady state frames (%llu max in one frame)\n",
+		allocations == 0 ? "passed" : "FAILED", (unsigned long long)allocations,
+		(unsigned long long)(GetFrameCount() - steadyStateFrame), (unsigned long long)GetMaxFrameAllocations());
+	printf("Pool check %s: %llu allocations in %llu recycled shots\n",
+		shotAllocations == 0 ? "passed" : "FAILED", (unsigned long long)shotAllocations,
+		(unsigned long long)steadyStateShots);
+	return allocations == 0 && shotAllocations == 0 && steadyStateShots > 0;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "HeadlessCore.h"
+#include "EntityManager.h"
+#include "PhysicsManager.h"
+#include "Prefab.h"
+#include "ObjectPool.h"
+
+// --------------------------------------------------------
+// A scene that runs without a window or a graphics device.
+//
+// Boxes are dropped onto a floor from an object pool and
+// recycled once they have been alive for a while, which keeps
+// the entity, physics and job systems busy for soak tests and
+// benchmarks. Frame timings are printed to the console.
+//
+// With allocation checking on, heap allocations are counted once
+// every box has been spawned and the pool is recycling them, since
+// a steady state frame should not allocate at all. Allocations made
+// by the pool's release and acquire are counted per shot as well
+// --------------------------------------------------------
+class HeadlessGame
+	: public HeadlessCore
+{
+public:
+	HeadlessGame(bool realtime, size_t maxBoxes, bool checkAllocations = false);
+	~HeadlessGame();
+
+	// Overridden setup and game loop methods, which
+	// will be called automatically
+	void Init();
+	void FixedUpdate(float constantStepSize, float totalTime);
+	void Update(float deltaTime, float totalTime);
+
+	// --------------------------------------------------------
+	// Print the frame timings and pool counters
+	// --------------------------------------------------------
+	void PrintStats();
+
+	// --------------------------------------------------------
+	// Print the allocations made in steady state frames
+	// returns true if there were none
+	// --------------------------------------------------------
+	bool CheckAllocations();
+
+private:
+	//Singletons
+	EntityManager* entityManager;
+	PhysicsManager* physicsManager;
+
+	GameObject* floor;
+	Prefab* boxPrefab;
+	ObjectPool* boxPool;
+
+	//Live boxes, used as a ring
+	std::vector<EntityHandle> boxes;
+	size_t nextBox;
+	float spawnTimer;
+	float statsTimer;
+
+	//Allocation checking
+	bool checkAllocations;
+	bool steadyState;
+	uint64_t steadyStateFrame;
+	uint64_t steadyStateShots;
+	uint64_t shotAllocations;	//Made while recycling boxes through the pool
+
+	// --------------------------------------------------------
+	// Drop a box, recycling the oldest one if they are all in use
+	// --------------------------------------------------------
+	void SpawnBox();
+};
\ No newline at end of file
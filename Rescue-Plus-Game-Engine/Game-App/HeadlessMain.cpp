@@ -0,0 +1,64 @@
+#ifdef HEADLESS
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "HeadlessGame.h"
+#include "EngineChecks.h"
+
+// --------------------------------------------------------
+// Entry point for a headless (no window, no graphics) run,
+// built by the Headless|x64 configuration as a console program
+//
+// --frames N	Stop after N frames (default runs until killed)
+// --realtime	Pace frames to the wall clock
+// --boxes N	Amount of boxes alive at once (default 512)
+// --check-allocations	Fail if steady state frames allocate
+//		(needs a build with ALLOCATION_COUNTING defined, the
+//		Headless configuration defines it)
+// --run-checks	Run the engine checks once the frames are done,
+//		and fail if any of them do
+//
+// run-headless-checks.bat builds this configuration and runs
+// it with --frames 900 --check-allocations --run-checks
+//
+// This is still a Windows only build. The engine headers pull
+// in d3d11.h and the engine links the prebuilt Windows PhysX
+// libraries even when nothing is drawn, so a Linux server
+// would need a PhysX build and the graphics headers split out
+// --------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	unsigned long long frames = 0;
+	bool realtime = false;
+	size_t boxes = 512;
+	bool checkAllocations = false;
+	bool runChecks = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			frames = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--boxes") == 0 && i + 1 < argc)
+			boxes = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--realtime") == 0)
+			realtime = true;
+		else if (strcmp(argv[i], "--check-allocations") == 0)
+			checkAllocations = true;
+		else if (strcmp(argv[i], "--run-checks") == 0)
+			runChecks = true;
+		else printf("Unknown argument: %s\n", argv[i]);
+	}
+
+	int result;
+	{
+		HeadlessGame game(realtime, boxes, checkAllocations);
+		result = game.Run(frames);
+		game.PrintStats();
+		if (checkAllocations && !game.CheckAllocations())
+			result = 1;
+		if (runChecks && !RunEngineChecks())
+			result = 1;
+	}
+	return result;
+}
+#endif
\ No newline at end of file
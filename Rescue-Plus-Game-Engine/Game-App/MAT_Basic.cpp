@@ -24,49 +24,45 @@ MAT_Basic::~MAT_Basic()
 { }
 
 // Prepare this material's shader's per MatMesh combo variables
-void MAT_Basic::PrepareMaterialCombo(GameObject* entityObj, Camera* cam)
+void MAT_Basic::PrepareMaterialCombo(const RenderFrame& frame)
 {
-	LightManager* lightManager = LightManager::GetInstance();
-	std::vector<Light*> lights = LightManager::GetInstance()->GetShadowCastingLights();
+	const ShadowLightProxy& shadowLight = frame.shadowLights[0];
 
 	// Vertex shader data
-	vertexShader->SetMatrix4x4("projection", cam->GetProjectionMatrix());
-	vertexShader->SetMatrix4x4("view", cam->GetViewMatrix());
-	vertexShader->SetFloat2("uvScale", uvScale);
-	vertexShader->SetMatrix4x4("shadowView", lights[0]->GetViewMatrix());
-	vertexShader->SetMatrix4x4("shadowProj", lights[0]->GetProjectionMatrix());
+	vertexShader->SetMatrix4x4(SID("projection"), frame.camera.projection);
+	vertexShader->SetMatrix4x4(SID("view"), frame.camera.view);
+	vertexShader->SetFloat2(SID("uvScale"), uvScale);
+	vertexShader->SetMatrix4x4(SID("shadowView"), shadowLight.view);
+	vertexShader->SetMatrix4x4(SID("shadowProj"), shadowLight.projection);
 
 	//Pixel shader data
-	pixelShader->SetFloat3("CameraPosition", cam->gameObject()->GetPosition());
-	pixelShader->SetFloat("Shininess", shininess);
-	pixelShader->SetFloat("Roughness", roughness);
+	pixelShader->SetFloat3(SID("CameraPosition"), frame.camera.position);
+	pixelShader->SetFloat(SID("Shininess"), shininess);
+	pixelShader->SetFloat(SID("Roughness"), roughness);
 
 	//Set lights
-	int amnt = lightManager->GetLightAmnt();
-	LightStruct* arr = lightManager->GetLightStructArray();
-	pixelShader->SetData("Lights", (void*)arr,
+	pixelShader->SetData(SID("Lights"), frame.lights,
 		sizeof(LightStruct) * MAX_LIGHTS);
-	pixelShader->SetInt("LightCount", amnt);
-	pixelShader->SetData("AmbLight", lightManager->GetAmbientLight(), sizeof(AmbientLightStruct));
+	pixelShader->SetInt(SID("LightCount"), frame.lightCount);
+	pixelShader->SetData(SID("AmbLight"), &frame.ambientLight, sizeof(AmbientLightStruct));
 
 	//Set PBR vars
-	pixelShader->SetShaderResourceView("AlbedoTexture", albedoSRV);
-	pixelShader->SetShaderResourceView("NormalTexture", normalSRV);
-	pixelShader->SetSamplerState("BasicSampler", sampler);
+	pixelShader->SetShaderResourceView(SID("AlbedoTexture"), albedoSRV);
+	pixelShader->SetShaderResourceView(SID("NormalTexture"), normalSRV);
+	pixelShader->SetSamplerState(SID("BasicSampler"), sampler);
 
 	//Set shadow vars
-	ID3D11ShaderResourceView* shadowSRV = lights[0]->GetShadowSRV();
-	pixelShader->SetShaderResourceView("ShadowMap", shadowSRV);
-	pixelShader->SetSamplerState("ShadowSampler", shadowSampler);
+	pixelShader->SetShaderResourceView(SID("ShadowMap"), shadowLight.shadowSRV);
+	pixelShader->SetSamplerState(SID("ShadowSampler"), shadowSampler);
 
-	vertexShader->CopyBufferData("perCombo");
-	pixelShader->CopyBufferData("perCombo");
+	vertexShader->CopyBufferData(SID("perCombo"));
+	pixelShader->CopyBufferData(SID("perCombo"));
 }
 
 // Prepare this material's shader's per object variables
-void MAT_Basic::PrepareMaterialObject(GameObject* entityObj)
+void MAT_Basic::PrepareMaterialObject(const RenderProxy& proxy)
 {
-	vertexShader->SetMatrix4x4("world", entityObj->GetWorldMatrix());
-	vertexShader->SetMatrix4x4("worldInvTrans", entityObj->GetWorldInvTransMatrix());
-	vertexShader->CopyBufferData("perObject");
+	vertexShader->SetMatrix4x4(SID("world"), proxy.world);
+	vertexShader->SetMatrix4x4(SID("worldInvTrans"), proxy.worldInvTrans);
+	vertexShader->CopyBufferData(SID("perObject"));
 }
\ No newline at end of file
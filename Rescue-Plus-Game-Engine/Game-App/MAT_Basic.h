@@ -36,11 +36,11 @@ public:
 	// --------------------------------------------------------
 	// Prepare this material's shader's per MatMesh combo variables
 	// --------------------------------------------------------
-	void PrepareMaterialCombo(GameObject* entityObj, Camera* cam) override;
+	void PrepareMaterialCombo(const RenderFrame& frame) override;
 
 	// --------------------------------------------------------
 	// Prepare this material's shader's per object variables
 	// --------------------------------------------------------
-	void PrepareMaterialObject(GameObject* entityObj) override;
+	void PrepareMaterialObject(const RenderProxy& proxy) override;
 };
 
@@ -1,4 +1,5 @@
 
+#ifndef HEADLESS
 #include <Windows.h>
 #include "Game.h"
 
@@ -65,3 +66,4 @@ int WINAPI WinMain(
 	// whatever we get back once the game loop is over
 	return dxGame.Run();
 }
+#endif
@@ -25,6 +25,7 @@ void Game::LoadAssets()
 
 	//Load shaders
 	resourceManager->LoadVertexShaderAsync("VertexShader.cso", device, context, root);
+	resourceManager->LoadVertexShaderAsync("VS_Instanced.cso", device, context, root);
 	resourceManager->LoadPixelShaderAsync("PixelShader.cso", device, context, root);
 
 	resourceManager->LoadVertexShaderAsync("VS_Sky.cso", device, context, root);
@@ -74,7 +75,8 @@ void Game::LoadAssets()
 	JobSystem::Run(root);
 	JobSystem::Wait(root);
 
-	SimpleVertexShader* vs = resourceManager->GetVertexShader("VertexShader.cso");
+	//Instanced variant, so each material/mesh pair is one draw
+	SimpleVertexShader* vs = resourceManager->GetVertexShader("VS_Instanced.cso");
 	SimplePixelShader* ps_basic = resourceManager->GetPixelShader("PixelShader.cso");
 
 	//Skybox material
@@ -155,12 +157,12 @@ void Game::LoadAssets()
 }
 
 //Create crane
-static GameObject* CreateCraneObj(ResourceManager* rm, const char* name, const char* mat, GameObject* parent)
+static GameObject* CreateCraneObj(ResourceManager* rm, const char* name, const char* mat, GameObject* parent, bool isStatic = false)
 {
 	GameObject* go = new GameObject(name);
 	go->AddComponent<MeshRenderer>(
 		rm->GetMesh("Assets\\Models\\Basic\\cube.obj"),
-		rm->GetMaterial(mat));
+		rm->GetMaterial(mat))->SetStatic(isStatic);
 	go->SetParent(parent);
 	return go;
 }
@@ -170,7 +172,7 @@ static void CreateCrane(ResourceManager* rm)
 	//Create pillars
 	for (int i = 1; i < 5; i++)
 	{
-		GameObject* pillar = CreateCraneObj(rm, "Pillar", "blue", craneGO);
+		GameObject* pillar = CreateCraneObj(rm, "Pillar", "blue", craneGO, true);
 		pillar->SetScale(3, 30, 3);
 		switch (i)
 		{
@@ -192,21 +194,21 @@ static void CreateCrane(ResourceManager* rm)
 	}
 
 	//Create tops
-	GameObject* top1 = CreateCraneObj(rm, "Top1", "blue", craneGO);
+	GameObject* top1 = CreateCraneObj(rm, "Top1", "blue", craneGO, true);
 	top1->SetScale(43, 2, 3);
 	top1->SetLocalPosition(0, 15, -15);
 	top1->AddComponent<BoxCollider>(top1->GetScale());
-	GameObject* top2 = CreateCraneObj(rm, "Top2", "blue", craneGO);
+	GameObject* top2 = CreateCraneObj(rm, "Top2", "blue", craneGO, true);
 	top2->SetScale(43, 2, 3);
 	top2->SetLocalPosition(0, 15, 15);
 	top2->AddComponent<BoxCollider>(top2->GetScale());
 
 	//Create sides
-	GameObject* side1 = CreateCraneObj(rm, "Side1", "blue", craneGO);
+	GameObject* side1 = CreateCraneObj(rm, "Side1", "blue", craneGO, true);
 	side1->SetScale(1, 3, 30);
 	side1->SetLocalPosition(20, 6, 0);
 	side1->AddComponent<BoxCollider>(side1->GetScale());
-	GameObject* side2 = CreateCraneObj(rm, "Side1", "blue", craneGO);
+	GameObject* side2 = CreateCraneObj(rm, "Side1", "blue", craneGO, true);
 	side2->SetScale(1, 3, 30);
 	side2->SetLocalPosition(-20, 6, 0);
 	side2->AddComponent<BoxCollider>(side2->GetScale());
@@ -275,7 +277,7 @@ static GameObject* CreateContainer(ResourceManager* rm, const char* name)
 	GameObject* cont = new GameObject(name);
 	cont->AddComponent<MeshRenderer>(
 		rm->GetMesh("Assets\\Models\\Shipyard\\shipyard_container.obj"),
-		rm->GetMaterial("shipyard_container"));
+		rm->GetMaterial("shipyard_container"))->SetStatic(true);
 	cont->AddComponent<BoxCollider>(XMFLOAT3(25.5f, 10, 10), false, nullptr, XMFLOAT3(-0.2f, 5.1f, 0))->SetDebug(true);
 	return cont;
 }
@@ -313,7 +315,7 @@ void Game::SetupScene()
 	floor->AddComponent<MeshRenderer>(
 		resourceManager->GetMesh("Assets\\Models\\Basic\\cube.obj"),
 		resourceManager->GetMaterial("shipyard_concrete")
-		);
+		)->SetStatic(true);
 	floor->MoveAbsolute(XMFLOAT3(0, -2, 0));
 	floor->SetScale(200, 1, 200);
 	floor->AddComponent<BoxCollider>(floor->GetScale());
@@ -378,6 +380,15 @@ void Game::SetupScene()
 	trigger->AddComponent<BoxCollider>(XMFLOAT3(3, 3, 3), true)->SetDebug(true);
 	//trigger->AddComponent<TestCallbacks>();
 
+	//Box spawned with the G key
+	boxPrefab = new Prefab("Box4", XMFLOAT3(1, 2, 2));
+	boxPrefab->AddComponent<MeshRenderer>(
+		resourceManager->GetMesh("Assets\\Models\\Basic\\cube.obj"),
+		resourceManager->GetMaterial("white")
+		);
+	boxPrefab->AddComponent<RigidBody>(1.0f);
+	boxPrefab->AddComponent<BoxCollider>(XMFLOAT3(1, 2, 2));
+
 	//Create a capsule
 	//GameObject* capsule = new GameObject("Capsule");
 	//capsule->SetPosition(0, 0, 3);
@@ -7,6 +7,8 @@ private:
 	GameObject* hook;
 
 public:
+	typedef ComponentLookupBases<ShipyardCrane, UserComponent> LookupBases;
+
 	ShipyardCrane(GameObject* gameObject, GameObject* hook);
 	~ShipyardCrane();
 
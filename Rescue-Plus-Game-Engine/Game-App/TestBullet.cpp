@@ -2,14 +2,23 @@
 #include "ResourceManager.h"
 #include "MeshRenderer.h"
 #include "Collider.h"
+#include "EntityManager.h"
 
 using namespace DirectX;
 
-TestBullet::TestBullet(GameObject* gameObject) : UserComponent(gameObject)
+TestBullet::TestBullet(GameObject* gameObject) : UserComponent(gameObject),
+	bulletPrefab("Bullet", XMFLOAT3(0.5f, 0.5f, 0.5f)), bulletPool(&bulletPrefab)
 {
-	sphereMesh = ResourceManager::GetInstance()->GetMesh("Assets\\Models\\Basic\\sphere.obj");
-	whiteMat = ResourceManager::GetInstance()->GetMaterial("white");
+	bulletPrefab.AddComponent<MeshRenderer>(
+		ResourceManager::GetInstance()->GetMesh(SID("Assets\\Models\\Basic\\sphere.obj")),
+		ResourceManager::GetInstance()->GetMaterial(SID("white")));
+	bulletPrefab.AddComponent<SphereCollider>(0.25f);
+	bulletPrefab.AddComponent<RigidBody>(1.0f);
 	inputManager = InputManager::GetInstance();
+
+	//Create every bullet now so firing never allocates
+	bulletPool.Prewarm(MAX_BULLETS);
+	nextBullet = 0;
 }
 
 void TestBullet::Update(float deltaTime)
@@ -17,22 +26,21 @@ void TestBullet::Update(float deltaTime)
 	//Temp workaround until I get input manager working fully
 	if (inputManager->GetKeyDown(Key::F))
 	{
-		//Spawn bullet
-		GameObject* bullet = new GameObject("Bullet");
-		bullet->AddComponent<MeshRenderer>(
-			sphereMesh,
-			whiteMat);
+		//Recycle the oldest bullet if they are all in use
+		GameObject* oldest = EntityManager::GetInstance()->GetEntity(bullets[nextBullet]);
+		if (oldest != nullptr)
+			bulletPool.Release(oldest);
 
-		//Set initial transforms
+		//Spawn bullet
 		XMFLOAT3 pos = gameObject()->GetPosition();
-		bullet->SetPosition(pos.x, pos.y - 0.5f, pos.z);
-		bullet->SetScale(0.5f, 0.5f, 0.5f);
+		GameObject* bullet = bulletPool.Acquire(XMFLOAT3(pos.x, pos.y - 0.5f, pos.z));
+		bullets[nextBullet] = bullet->GetHandle();
+		nextBullet = (nextBullet + 1) % MAX_BULLETS;
 
-		//Physics, add a force
-		bullet->AddComponent<SphereCollider>(0.25f);
+		//Physics, add a force (the actor is in the scene once Acquire returns)
 		XMFLOAT3 force;
 		XMStoreFloat3(&force, XMVectorScale(XMLoadFloat3(&gameObject()->GetForwardAxis()), 3000.0f));
-		bullet->AddComponent<RigidBody>(1.0f)->AddForce(force);
+		bullet->GetComponent<RigidBody>()->AddForce(force);
 	}
 }
 
@@ -3,16 +3,27 @@
 #include "Mesh.h"
 #include "Material.h"
 #include "InputManager.h"
+#include "Prefab.h"
+#include "ObjectPool.h"
+
+//Bullets alive at once, the oldest is recycled when firing another
+#define MAX_BULLETS 32
 
 class TestBullet :
 	public UserComponent
 {
 private:
-	Mesh* sphereMesh;
-	Material* whiteMat;
+	Prefab bulletPrefab;
+	ObjectPool bulletPool;
 	InputManager* inputManager;
 
+	//Live bullets, used as a ring
+	EntityHandle bullets[MAX_BULLETS];
+	size_t nextBullet;
+
 public:
+	typedef ComponentLookupBases<TestBullet, UserComponent> LookupBases;
+
 	TestBullet(GameObject* gameObject);
 	~TestBullet();
 
@@ -4,6 +4,8 @@ class TestCallbacks :
 	public UserComponent
 {
 public:
+	typedef ComponentLookupBases<TestCallbacks, UserComponent> LookupBases;
+
 	TestCallbacks(GameObject* gameObject);
 	~TestCallbacks();
 
@@ -0,0 +1,12 @@
+@echo off
+rem Build the Headless configuration and run its checks:
+rem a 900 frame soak that fails if steady state frames allocate,
+rem then the engine checks. Run it from a Visual Studio developer
+rem command prompt, or from CI. Exits with 1 if anything fails
+setlocal
+cd /d "%~dp0"
+
+msbuild Rescue-Plus-Game-Engine.sln /p:Configuration=Headless /p:Platform=x64 /m /v:minimal || exit /b 1
+
+cd /d "%~dp0x64\Headless"
+Game-App.exe --frames 900 --check-allocations --run-checks || exit /b 1